@@ -28,6 +28,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 #include <glpk.h>
 #include "DSMemoryManager.h"
 #include "DSCase.h"
@@ -39,6 +40,7 @@
 #include "DSMatrix.h"
 #include "DSMatrixArray.h"
 #include "DSCyclicalCase.h"
+#include "DSVertices.h"
 #include "DSGMASystemParsingAux.h"
 
 #if defined (__APPLE__) && defined (__MACH__)
@@ -152,23 +154,232 @@ bail:
 #pragma mark - Factory functions
 #endif
 
-extern void DSCaseRemoveRedundantBoundaries(DSCase *aCase)
+/**
+ * \brief The number of fractional bits kept in the hash keys of the
+ * directions of normalized boundaries.
+ */
+#define DS_CASE_BOUNDARY_DIRECTION_BITS         40
+
+/**
+ * \brief The number of values of the temporary matrices used to build the
+ * boundaries of a case that are kept on the stack.
+ *
+ * \details Larger workspaces, which depend on the size of the model, are
+ * allocated on the heap.
+ */
+#define DS_CASE_STACK_WORKSPACE_SIZE            512
+
+/**
+ * \brief Scales the boundaries of a case so the largest coefficient of each
+ * boundary is one.
+ *
+ * \details The hash key of each normalized boundary is its direction rounded
+ * to DS_CASE_BOUNDARY_DIRECTION_BITS fractional bits, so boundaries that only
+ * differ by a positive factor have equal keys even if the scaling introduces
+ * rounding errors.  Boundaries without independent variables are not scaled.
+ */
+static void dsCaseNormalizeBoundaries(const DSMatrix * U, const DSMatrix * zeta, DSMatrix * normalU, DSMatrix * normalZeta, DSMatrix * keyU)
 {
-        DSMatrix *temp1, *temp2;
-        temp1 = DSMatrixAppendMatrices(DSCaseU(aCase), DSCaseZeta(aCase), true);
-        temp2 = DSMatrixWithUniqueRows(temp1);
-        DSMatrixFree(temp1);
-        if (temp2 == NULL)
+        DSUInteger i, j;
+        double scale;
+        for (i = 0; i < DSMatrixRows(U); i++) {
+                scale = 0.0;
+                for (j = 0; j < DSMatrixColumns(U); j++)
+                        if (fabs(DSMatrixElement(U, i, j)) > scale)
+                                scale = fabs(DSMatrixElement(U, i, j));
+                if (scale == 0.0)
+                        scale = 1.0;
+                for (j = 0; j < DSMatrixColumns(U); j++) {
+                        DSMatrixElement(normalU, i, j) = DSMatrixElement(U, i, j)/scale;
+                        DSMatrixElement(keyU, i, j) = ldexp(round(ldexp(DSMatrixElement(normalU, i, j), DS_CASE_BOUNDARY_DIRECTION_BITS)), -DS_CASE_BOUNDARY_DIRECTION_BITS);
+                }
+                DSMatrixElement(normalZeta, i, 0) = DSMatrixElement(zeta, i, 0)/scale;
+        }
+}
+
+static bool dsCaseBoundaryDirectionsAreEqual(const DSMatrix * normalU, const DSUInteger row1, const DSUInteger row2)
+{
+        DSUInteger j;
+        for (j = 0; j < DSMatrixColumns(normalU); j++)
+                if (DSMatrixElement(normalU, row1, j) != DSMatrixElement(normalU, row2, j))
+                        return false;
+        return true;
+}
+
+/**
+ * \brief Finds the first boundary with the same normalized direction as each
+ * boundary.
+ *
+ * \details Boundaries with equal hash keys are chained in order, and each
+ * boundary is compared exactly with the earlier boundaries of its chain, so
+ * boundaries that are only nearly parallel are never treated as repeated.
+ *
+ * \return An array with one element per boundary, with the index of the first
+ *         boundary with an identical normalized direction.  The caller is
+ *         responsible for freeing the array.
+ */
+static DSUInteger * dsCaseFirstBoundaryWithDirection(const DSMatrix * normalU, const DSMatrix * keyU)
+{
+        DSUInteger *firstKeys = NULL, *firstDirections = NULL, *nextWithKey, *lastWithKey;
+        DSUInteger i, j, first, numberOfBoundaries = DSMatrixRows(normalU);
+        firstKeys = DSMatrixFirstOccurrenceOfRows(keyU);
+        if (firstKeys == NULL)
+                goto bail;
+        firstDirections = DSSecureMalloc(sizeof(DSUInteger)*3*numberOfBoundaries);
+        nextWithKey = firstDirections+numberOfBoundaries;
+        lastWithKey = nextWithKey+numberOfBoundaries;
+        for (i = 0; i < numberOfBoundaries; i++) {
+                first = firstKeys[i];
+                firstDirections[i] = i;
+                if (first == i) {
+                        lastWithKey[i] = i;
+                        continue;
+                }
+                for (j = first; ; j = nextWithKey[j]) {
+                        if (dsCaseBoundaryDirectionsAreEqual(normalU, j, i) == true) {
+                                firstDirections[i] = j;
+                                break;
+                        }
+                        if (j == lastWithKey[first])
+                                break;
+                }
+                nextWithKey[lastWithKey[first]] = i;
+                lastWithKey[first] = i;
+        }
+        DSSecureFree(firstKeys);
+bail:
+        return firstDirections;
+}
+
+static bool dsCaseBoundaryIsConstant(const DSMatrix * U, const DSUInteger row)
+{
+        DSUInteger j;
+        for (j = 0; j < DSMatrixColumns(U); j++)
+                if (DSMatrixElement(U, row, j) != 0.0)
+                        return false;
+        return true;
+}
+
+/**
+ * \brief Removes boundaries of a case that do not change its region.
+ *
+ * \details The boundaries U*log(Xi) + zeta > 0 are first normalized and
+ * hashed, so among boundaries with identical normalized directions only the
+ * most restrictive is kept in linear expected time, and boundaries without
+ * independent variables that are always satisfied are removed.  If requested,
+ * each remaining boundary is then tested with a linear problem, in parallel,
+ * and those strictly implied by the others are removed.  The rows that are
+ * kept are not modified, and keep their relative order.  If every boundary is
+ * always satisfied, the boundaries are left unchanged.
+ */
+static void dsCaseRemoveBoundaries(DSCase *aCase, const bool removeImplied)
+{
+        DSMatrix *U, *zeta, *normalU = NULL, *normalZeta = NULL, *keyU = NULL, *candidateU = NULL, *candidateZeta = NULL;
+        DSUInteger *firstRows = NULL, *mostRestrictive = NULL, *rows = NULL;
+        bool *isRedundant = NULL;
+        DSUInteger i, numberOfBoundaries, numberOfCandidates, numberOfRows;
+        if (aCase == NULL) {
+                DSError(M_DS_CASE_NULL, A_DS_ERROR);
                 goto bail;
-        DSMatrixFree(DSCaseU(aCase));
-        DSMatrixFree(DSCaseZeta(aCase));
-        DSCaseU(aCase) = DSMatrixSubMatrixExcludingColumnList(temp2, 1, DSMatrixColumns(temp2)-1);
-        DSCaseZeta(aCase) = DSMatrixSubMatrixIncludingColumnList(temp2, 1, DSMatrixColumns(temp2)-1);
-        DSMatrixFree(temp2);
+        }
+        U = DSCaseU(aCase);
+        zeta = DSCaseZeta(aCase);
+        if (U == NULL || zeta == NULL)
+                goto bail;
+        numberOfBoundaries = DSMatrixRows(U);
+        normalU = DSMatrixAlloc(numberOfBoundaries, DSMatrixColumns(U));
+        normalZeta = DSMatrixAlloc(numberOfBoundaries, 1);
+        keyU = DSMatrixAlloc(numberOfBoundaries, DSMatrixColumns(U));
+        dsCaseNormalizeBoundaries(U, zeta, normalU, normalZeta, keyU);
+        firstRows = dsCaseFirstBoundaryWithDirection(normalU, keyU);
+        if (firstRows == NULL)
+                goto bail;
+        mostRestrictive = DSSecureMalloc(sizeof(DSUInteger)*numberOfBoundaries);
+        for (i = 0; i < numberOfBoundaries; i++)
+                mostRestrictive[i] = numberOfBoundaries;
+        for (i = 0; i < numberOfBoundaries; i++) {
+                if (DSMatrixElement(normalZeta, i, 0) > 0.0 && dsCaseBoundaryIsConstant(normalU, i) == true)
+                        continue;
+                if (mostRestrictive[firstRows[i]] == numberOfBoundaries
+                    || DSMatrixElement(normalZeta, i, 0) < DSMatrixElement(normalZeta, mostRestrictive[firstRows[i]], 0))
+                        mostRestrictive[firstRows[i]] = i;
+        }
+        rows = DSSecureMalloc(sizeof(DSUInteger)*numberOfBoundaries);
+        numberOfCandidates = 0;
+        for (i = 0; i < numberOfBoundaries; i++) {
+                if (mostRestrictive[firstRows[i]] == i)
+                        rows[numberOfCandidates++] = i;
+        }
+        if (numberOfCandidates == 0)
+                goto bail;
+        numberOfRows = numberOfCandidates;
+        if (removeImplied == true) {
+                candidateU = DSMatrixSubMatrixIncludingRows(normalU, numberOfCandidates, rows);
+                candidateZeta = DSMatrixSubMatrixIncludingRows(normalZeta, numberOfCandidates, rows);
+                isRedundant = DSCaseRedundantBoundaryRows(candidateU, candidateZeta);
+                if (isRedundant == NULL)
+                        goto bail;
+                numberOfRows = 0;
+                for (i = 0; i < numberOfCandidates; i++) {
+                        if (isRedundant[i] == false)
+                                rows[numberOfRows++] = rows[i];
+                }
+        }
+        if (numberOfRows == numberOfBoundaries || numberOfRows == 0)
+                goto bail;
+        DSCaseU(aCase) = DSMatrixSubMatrixIncludingRows(U, numberOfRows, rows);
+        DSCaseZeta(aCase) = DSMatrixSubMatrixIncludingRows(zeta, numberOfRows, rows);
+        DSMatrixFree(U);
+        DSMatrixFree(zeta);
 bail:
+        if (normalU != NULL)
+                DSMatrixFree(normalU);
+        if (normalZeta != NULL)
+                DSMatrixFree(normalZeta);
+        if (keyU != NULL)
+                DSMatrixFree(keyU);
+        if (candidateU != NULL)
+                DSMatrixFree(candidateU);
+        if (candidateZeta != NULL)
+                DSMatrixFree(candidateZeta);
+        if (firstRows != NULL)
+                DSSecureFree(firstRows);
+        if (mostRestrictive != NULL)
+                DSSecureFree(mostRestrictive);
+        if (rows != NULL)
+                DSSecureFree(rows);
+        if (isRedundant != NULL)
+                DSSecureFree(isRedundant);
         return;
 }
 
+/**
+ * \brief Removes the boundaries of a case that repeat the direction of a more
+ * restrictive boundary, or that are always satisfied.
+ *
+ * \details Only hashing is used, so this function takes linear expected time
+ * and does not solve linear problems.
+ *
+ * \see DSCaseRemoveRedundantBoundaries
+ */
+extern void DSCaseRemoveDuplicateBoundaries(DSCase *aCase)
+{
+        dsCaseRemoveBoundaries(aCase, false);
+}
+
+/**
+ * \brief Removes the boundaries of a case that do not change its region.
+ *
+ * \details Duplicate boundaries are removed as in
+ * DSCaseRemoveDuplicateBoundaries, and the remaining boundaries that are
+ * strictly implied by the others are found with one linear problem per
+ * boundary, solved in parallel by the thread pool.
+ */
+extern void DSCaseRemoveRedundantBoundaries(DSCase *aCase)
+{
+        dsCaseRemoveBoundaries(aCase, true);
+}
+
 extern void DSCaseRemoveZeroBoundaries(DSCase *aCase)
 {
         DSUInteger * zeroRows = NULL;
@@ -215,10 +426,22 @@ bail:
         return;
 }
 
+/**
+ * \brief Calculates the boundaries U*log(Xi) + zeta > 0 of a case.
+ *
+ * \details The boundaries are zeta = Cd*M*B + delta and U = Ci - Cd*M*Ai.
+ * The products with M are calculated first, in storage on the stack, and
+ * accumulated into zeta and U, so that the only matrices allocated are the
+ * boundaries themselves.
+ */
 static void dsCaseCreateBoundaryMatrices(DSCase *aCase)
 {
-        DSUInteger numberOfXi = 0;
-        DSMatrix * W = NULL, *B, *Ai;
+        DSUInteger numberOfXi = 0, numberOfEquations;
+        const DSSSystem * ssys;
+        DSMatrix *B, *MB, *MAi;
+        DSMatrixView BView, MBView, MAiView;
+        double stackWorkspace[DS_CASE_STACK_WORKSPACE_SIZE];
+        double *workspace = stackWorkspace, *BValues, *MBValues, *MAiValues;
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
                 goto bail;
@@ -229,24 +452,36 @@ static void dsCaseCreateBoundaryMatrices(DSCase *aCase)
         if (DSCaseCd(aCase) == NULL) {
                 goto bail;
         }
-        B = DSSSystemB(DSCaseSSys(aCase));
+        ssys = DSCaseSSys(aCase);
         numberOfXi =DSVariablePoolNumberOfVariables(DSCaseXi(aCase));
-        
-        W = DSMatrixByMultiplyingMatrix(DSCaseCd(aCase), DSSSystemM(DSCaseSSys(aCase)));
-        DSCaseZeta(aCase) = DSMatrixByMultiplyingMatrix(W, B);
-        DSMatrixAddByMatrix(DSCaseZeta(aCase), DSCaseDelta(aCase));
-        if (numberOfXi != 0) {
-                Ai = DSSSystemAi(DSCaseSSys(aCase));
-                DSCaseU(aCase) = DSMatrixByMultiplyingMatrix(W, Ai);
-                if (DSCaseCi(aCase) != NULL)
-                        DSMatrixSubstractByMatrix(DSCaseU(aCase), DSCaseCi(aCase));
-                DSMatrixMultiplyByScalar(DSCaseU(aCase), -1.0);
-//                DSCaseRemoveRedundantBoundaries(aCase);
-                DSMatrixFree(Ai);
-        }
-        DSMatrixFree(W);
-        DSMatrixFree(B);
+        numberOfEquations = DSMatrixRows(DSSSystemM(ssys));
+        if (numberOfEquations*(numberOfXi+2) > DS_CASE_STACK_WORKSPACE_SIZE)
+                workspace = DSSecureMalloc(sizeof(double)*numberOfEquations*(numberOfXi+2));
+        BValues = workspace;
+        MBValues = BValues+numberOfEquations;
+        MAiValues = MBValues+numberOfEquations;
+        {
+                B = DSMatrixViewWithData(&BView, numberOfEquations, 1, BValues);
+                MB = DSMatrixViewWithData(&MBView, numberOfEquations, 1, MBValues);
+                DSSSystemBInto(ssys, B);
+                DSMatrixMultiplyMatricesInto(MB, 1.0, DSSSystemM(ssys), B, 0.0);
+                DSCaseZeta(aCase) = DSMatrixCopy(DSCaseDelta(aCase));
+                DSMatrixMultiplyMatricesInto(DSCaseZeta(aCase), 1.0, DSCaseCd(aCase), MB, 1.0);
+                if (numberOfXi != 0) {
+                        MAi = DSMatrixViewWithData(&MAiView, numberOfEquations, numberOfXi, MAiValues);
+                        DSMatrixMultiplyMatricesInto(MAi, 1.0, DSSSystemM(ssys), DSSSystemGi(ssys), 0.0);
+                        DSMatrixMultiplyMatricesInto(MAi, -1.0, DSSSystemM(ssys), DSSSystemHi(ssys), 1.0);
+                        if (DSCaseCi(aCase) != NULL)
+                                DSCaseU(aCase) = DSMatrixCopy(DSCaseCi(aCase));
+                        else
+                                DSCaseU(aCase) = DSMatrixCalloc(DSMatrixRows(DSCaseCd(aCase)), numberOfXi);
+                        DSMatrixMultiplyMatricesInto(DSCaseU(aCase), -1.0, DSCaseCd(aCase), MAi, 1.0);
+//                        DSCaseRemoveRedundantBoundaries(aCase);
+                }
+        }
 bail:
+        if (workspace != stackWorkspace)
+                DSSecureFree(workspace);
         return;
 }
 
@@ -277,15 +512,22 @@ bail:
 }
 
 
-static void dsCaseCreateConditionMatrices(DSCase *aCase, const DSGMASystem * gma)
+/**
+ * \brief Calculates the conditions Cd*log(Xd) + Ci*log(Xi) + delta > 0 of a
+ * case.
+ *
+ * \details The conditions of the dominant terms are followed by the
+ * additional conditions of the design space, if any, which are copied into
+ * the same matrices instead of being appended to them.
+ */
+static void dsCaseCreateConditionMatrices(DSCase *aCase, const DSGMASystem * gma, const DSDesignSpace * ds)
 {
-        DSUInteger i, j, k, l, numberOfConditions, numberOfEquations;
+        DSUInteger i, j, l, numberOfConditions, numberOfEquations, numberOfAdditional = 0;
+        DSMatrixView rowsView;
         DSUInteger numberOfXi, numberOfXd;
         const DSUInteger *termArray;
-        double value;
+        double value, *xdRow, *xiRow;
         const DSMatrix * (*a)(const DSGMASystem * gma);
-        const DSMatrixArray * (*kd)(const DSGMASystem * gma);
-        const DSMatrixArray * (*ki)(const DSGMASystem * gma);
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
                 goto bail;
@@ -301,41 +543,39 @@ static void dsCaseCreateConditionMatrices(DSCase *aCase, const DSGMASystem * gma
         termArray = DSCaseSig(aCase);
         for (i = 0; i < 2*numberOfEquations; i++)
                 numberOfConditions += DSGMASystemSignature(gma)[i]-1;
-        if (numberOfConditions == 0) {
+        if (ds != NULL && ds->Cd != NULL)
+                numberOfAdditional = DSMatrixRows(ds->Cd);
+        if (numberOfConditions+numberOfAdditional == 0) {
                 goto bail;
         }
-        DSCaseCd(aCase) = DSMatrixCalloc(numberOfConditions, numberOfXd);
-        DSCaseCi(aCase) = DSMatrixCalloc(numberOfConditions, numberOfXi);
-        DSCaseDelta(aCase) = DSMatrixCalloc(numberOfConditions, 1);
+        DSCaseCd(aCase) = DSMatrixCalloc(numberOfConditions+numberOfAdditional, numberOfXd);
+        if (numberOfXi > 0)
+                DSCaseCi(aCase) = DSMatrixCalloc(numberOfConditions+numberOfAdditional, numberOfXi);
+        DSCaseDelta(aCase) = DSMatrixCalloc(numberOfConditions+numberOfAdditional, 1);
         for (i = 0, l = 0; i < 2*numberOfEquations; i++) {
-                if (i % 2 == 0) {
+                if (i % 2 == 0)
                         a =  DSGMASystemAlpha;
-                        kd = DSGMASystemGd;
-                        ki = DSGMASystemGi;
-                } else {
+                else
                         a =  DSGMASystemBeta;
-                        kd = DSGMASystemHd;
-                        ki = DSGMASystemHi;
-                }
                 for (j = 0; j < DSGMASystemSignature(gma)[i]; j++) {
                         if (j == termArray[i]-1)
                                 continue;
                         value = log10(DSMatrixDoubleValue(a(gma), i/2, termArray[i]-1)
                                  /DSMatrixDoubleValue(a(gma), i/2, j));
                         DSMatrixSetDoubleValue(DSCaseDelta(aCase), l, 0, value);
-                        for (k = 0; k < numberOfXd; k++) {
-                                value = DSMatrixArrayDoubleWithIndices(kd(gma), i/2, termArray[i]-1, k);
-                                value -= DSMatrixArrayDoubleWithIndices(kd(gma), i/2, j, k);
-                                DSMatrixSetDoubleValue(DSCaseCd(aCase), l, k, value);
-                        }
-                        for (k = 0; k < numberOfXi; k++) {
-                                value = DSMatrixArrayDoubleWithIndices(ki(gma), i/2, termArray[i]-1, k);
-                                value -= DSMatrixArrayDoubleWithIndices(ki(gma), i/2, j, k);
-                                DSMatrixSetDoubleValue(DSCaseCi(aCase), l, k, value);
-                        }
+                        xdRow = &DSMatrixElement(DSCaseCd(aCase), l, 0);
+                        xiRow = (numberOfXi > 0) ? &DSMatrixElement(DSCaseCi(aCase), l, 0) : NULL;
+                        DSGMASystemAddTermExponents(gma, i, termArray[i]-1, 1.0, xdRow, xiRow);
+                        DSGMASystemAddTermExponents(gma, i, j, -1.0, xdRow, xiRow);
                         l++;
                 }
         }
+        if (numberOfAdditional == 0)
+                goto bail;
+        DSMatrixCopyInto(DSMatrixViewOfRows(&rowsView, DSCaseCd(aCase), numberOfConditions, numberOfAdditional), ds->Cd);
+        DSMatrixCopyInto(DSMatrixViewOfRows(&rowsView, DSCaseDelta(aCase), numberOfConditions, numberOfAdditional), ds->delta);
+        if (numberOfXi > 0)
+                DSMatrixCopyInto(DSMatrixViewOfRows(&rowsView, DSCaseCi(aCase), numberOfConditions, numberOfAdditional), ds->Ci);
 bail:
         return;
 }
@@ -409,7 +649,7 @@ extern DSCase * DSCaseWithTermsFromGMA(const DSGMASystem * gma, const DSUInteger
                         break;
         }
         if (i == 2*numberOfEquations) {
-                dsCaseCreateConditionMatrices(aCase, gma);
+                dsCaseCreateConditionMatrices(aCase, gma, NULL);
                 dsCaseCreateBoundaryMatrices(aCase);
                 dsCaseCalculateCaseNumber(aCase, gma, endian);
                 dsCaseCalculateCaseIdentifier(aCase, gma, endian, NULL);
@@ -421,45 +661,56 @@ bail:
         return aCase;
 }
 
-static void dsCaseAppendDesignSpaceConditions(DSCase * aCase, const DSDesignSpace * ds)
+extern DSCase * DSCaseWithTermsFromDesignSpace(const DSDesignSpace * ds, const DSUInteger * termArray, const char * prefix)
 {
-        DSMatrix * temp;
-        if (aCase == NULL) {
-                DSError(M_DS_CASE_NULL, A_DS_ERROR);
-                goto bail;
-        }
-        if (ds == NULL) {
-                DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
-                goto bail;
-        }
-        if (ds->Cd == NULL) 
-                goto bail;
-        if (DSCaseCd(aCase) == NULL) {
-                DSCaseCd(aCase) = DSMatrixCopy(ds->Cd);
-                DSCaseDelta(aCase) = DSMatrixCopy(ds->delta);
-                if (DSVariablePoolNumberOfVariables(DSCaseXi(aCase)) > 0)
-                        DSCaseCi(aCase) = DSMatrixCopy(ds->Ci);
-        } else {
-                temp = DSMatrixAppendMatrices(DSCaseCd(aCase), ds->Cd, false);
-                DSMatrixFree(DSCaseCd(aCase));
-                DSCaseCd(aCase) = temp;
-                temp = DSMatrixAppendMatrices(DSCaseDelta(aCase), ds->delta, false);
-                DSMatrixFree(DSCaseDelta(aCase));
-                DSCaseDelta(aCase) = temp;
-                if (DSVariablePoolNumberOfVariables(DSCaseXi(aCase)) > 0) {
-                        temp = DSMatrixAppendMatrices(DSCaseCi(aCase), ds->Ci, false);
-                        DSMatrixFree(DSCaseCi(aCase));
-                        DSCaseCi(aCase) = temp;
-                }
+        return DSCaseWithTermsFromDesignSpaceAndNeighbor(ds, termArray, prefix, NULL);
+}
 
-        }
-bail:
-        return;
+/**
+ * \brief Creates a case with the dominant terms of a design space, reusing the
+ * S-System solution of a neighboring case.
+ *
+ * \details Cases whose signatures differ in a few terms share most of the rows
+ * of Ad, and the solution of the new S-System is updated from the solution of
+ * the neighbor when possible (see DSSSystemWithTermsFromGMAAndNeighbor).
+ *
+ * \param ds The DSDesignSpace with the terms of the case.
+ * \param termArray The signature with the dominant terms, starting at 1.
+ * \param prefix The prefix of the case identifier.
+ * \param neighbor A case of the same design space, or NULL.
+ *
+ * \return A new DSCase with the dominant terms.
+ */
+extern DSCase * DSCaseWithTermsFromDesignSpaceAndNeighbor(const DSDesignSpace * ds, const DSUInteger * termArray, const char * prefix, const DSCase * neighbor)
+{
+        DSCase *aCase = NULL;
+        aCase = DSCaseLazyWithTermsFromDesignSpace(ds, termArray);
+        if (aCase != NULL)
+                DSCaseCompleteConstruction(aCase, neighbor);
+        return aCase;
 }
 
-extern DSCase * DSCaseWithTermsFromDesignSpace(const DSDesignSpace * ds, const DSUInteger * termArray, const char * prefix)
+/**
+ * \brief Creates a lazy case with the dominant terms of a design space.
+ *
+ * \details A lazy case only calculates its signature, case number and
+ * condition matrices, which is all that is needed to reject most invalid
+ * cases (see DSCaseSteadyStateConditionsAreValid).  The S-System, the
+ * boundary matrices and the case identifier are NULL until the case is
+ * completed by DSCaseCompleteConstruction, which must be called before any of
+ * them is accessed.  The design space must not be freed before the case is
+ * complete.
+ *
+ * \param ds The DSDesignSpace with the terms of the case.
+ * \param termArray The signature with the dominant terms, starting at 1.
+ *
+ * \return A new lazy DSCase with the dominant terms, or NULL if the signature
+ *         is out of bounds.
+ */
+extern DSCase * DSCaseLazyWithTermsFromDesignSpace(const DSDesignSpace * ds, const DSUInteger * termArray)
 {
         DSCase *aCase = NULL;
+        const DSGMASystem * gma;
         DSUInteger i, term1, term2, numberOfEquations;
         if (ds == NULL) {
                 DSError(M_DS_NULL ": Template GMA to make S-System is NULL", A_DS_ERROR);
@@ -469,12 +720,12 @@ extern DSCase * DSCaseWithTermsFromDesignSpace(const DSDesignSpace * ds, const D
                 DSError(M_DS_DESIGN_SPACE_NULL ": Array of dominant terms is NULL", A_DS_ERROR);
                 goto bail;
         }
+        gma = DSDesignSpaceGMASystem(ds);
         aCase = DSCaseAlloc();
-        DSCaseSSys(aCase) = DSSSystemWithTermsFromGMA(DSDesignSpaceGMASystem(ds), termArray);
-        aCase->Xi = DSSSystemXi(DSCaseSSys(aCase));
-        aCase->Xd = DSSSystemXd(DSCaseSSys(aCase));
-        aCase->Xd_a = DSSSystemXd_a(DSCaseSSys(aCase));
-        numberOfEquations = DSGMASystemNumberOfEquations(DSDesignSpaceGMASystem(ds));
+        aCase->Xi = DSGMASystemXi(gma);
+        aCase->Xd = DSGMASystemXd(gma);
+        aCase->Xd_a = DSGMASystemXd_a(gma);
+        numberOfEquations = DSGMASystemNumberOfEquations(gma);
         DSCaseSig(aCase) = DSSecureMalloc(sizeof(DSUInteger)*(2*numberOfEquations));
 //        DSCaseSSys(aCase)->fluxDictionary = DSDesignSpaceCycleDictionaryForSignature(ds, termArray);
 //        DSDictionaryPrintWithFunction(DSCaseSSys(aCase)->fluxDictionary, DSExpressionPrint);
@@ -483,17 +734,16 @@ extern DSCase * DSCaseWithTermsFromDesignSpace(const DSDesignSpace * ds, const D
                 term2 = termArray[i+1];
                 DSCaseSig(aCase)[i] = term1;
                 DSCaseSig(aCase)[i+1] = term2;
-                if (term1 > DSGMASystemSignature(DSDesignSpaceGMASystem(ds))[i] || term2 > DSGMASystemSignature(DSDesignSpaceGMASystem(ds))[i+1])
+                if (term1 > DSGMASystemSignature(gma)[i] || term2 > DSGMASystemSignature(gma)[i+1])
                         break;
                 if (term1 <= 0 || term2 <= 0)
                         break;
         }
         if (i == 2*numberOfEquations) {
-                dsCaseCreateConditionMatrices(aCase, DSDesignSpaceGMASystem(ds));
-                dsCaseAppendDesignSpaceConditions(aCase, ds);
-                dsCaseCreateBoundaryMatrices(aCase);
-                dsCaseCalculateCaseNumber(aCase, DSDesignSpaceGMASystem(ds), endian);
-                dsCaseCalculateCaseIdentifier(aCase, DSDesignSpaceGMASystem(ds), endian, DSDesignSpaceCasePrefix(ds));
+                dsCaseCreateConditionMatrices(aCase, gma, ds);
+                dsCaseCalculateCaseNumber(aCase, gma, endian);
+                aCase->pendingGMA = gma;
+                aCase->pendingPrefix = DSDesignSpaceCasePrefix(ds);
         } else {
                 DSCaseFree(aCase);
                 aCase = NULL;
@@ -502,6 +752,53 @@ bail:
         return aCase;
 }
 
+/**
+ * \brief Calculates the S-System, boundary matrices and identifier of a lazy
+ * case.
+ *
+ * \details The S-System is solved by updating the solution of the neighboring
+ * case when possible (see DSSSystemWithTermsFromGMAAndNeighbor).  Completing
+ * a case that is already complete has no effect.  Lazy cases should not be
+ * shared between threads before they are complete.
+ *
+ * \param aCase The DSCase being completed.
+ * \param neighbor A complete case of the same design space, or NULL.
+ */
+extern void DSCaseCompleteConstruction(DSCase * aCase, const DSCase * neighbor)
+{
+        const DSGMASystem * gma;
+        const char * prefix;
+        if (aCase == NULL) {
+                DSError(M_DS_CASE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        gma = aCase->pendingGMA;
+        prefix = aCase->pendingPrefix;
+        if (gma == NULL)
+                goto bail;
+        aCase->pendingGMA = NULL;
+        aCase->pendingPrefix = NULL;
+        DSCaseSSys(aCase) = DSSSystemWithTermsFromGMAAndNeighbor(gma,
+                                                                 DSCaseSig(aCase),
+                                                                 (neighbor != NULL) ? neighbor->ssys : NULL);
+        dsCaseCreateBoundaryMatrices(aCase);
+        dsCaseCalculateCaseIdentifier(aCase, gma, endian, prefix);
+bail:
+        return;
+}
+
+extern bool DSCaseIsLazy(const DSCase * aCase)
+{
+        bool isLazy = false;
+        if (aCase == NULL) {
+                DSError(M_DS_CASE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        isLazy = (aCase->pendingGMA != NULL);
+bail:
+        return isLazy;
+}
+
 
 #if defined (__APPLE__) && defined (__MACH__)
 #pragma mark - Getter functions
@@ -993,8 +1290,8 @@ extern DSStack * DSCaseVertexEquationsFor2DSlice(const DSCase *aCase, const DSVa
                 variables[1] = xVariable;
         }
         for (i = 0; i < vertices->numberOfVertices; i++) {
-                DSMatrixSetDoubleValue(vars, xIndex, 0, vertices->vertices[i][0]);
-                DSMatrixSetDoubleValue(vars, yIndex, 0, vertices->vertices[i][1]);
+                DSMatrixSetDoubleValue(vars, xIndex, 0, DSVerticesVertexAtIndex(vertices, i)[0]);
+                DSMatrixSetDoubleValue(vars, yIndex, 0, DSVerticesVertexAtIndex(vertices, i)[1]);
                 solution = DSMatrixByMultiplyingMatrix(U, vars);
                 DSMatrixAddByMatrix(solution, Zeta);
                 k = 0;
@@ -1134,57 +1431,72 @@ bail:
 
 static void dsCaseAddBoundariesFromConditions(DSCase *aCase, const DSMatrix * Cd, const DSMatrix * Ci, const DSMatrix * delta)
 {
-        DSUInteger numberOfXi = 0;
-        DSMatrix * W = NULL, *Zeta, *U = NULL, *B, *Ai, *temp;
-        bool hasSSys;
+        DSUInteger numberOfXi = 0, numberOfEquations = 0, firstRow;
+        const DSSSystem * ssys;
+        DSMatrix *Zeta, *U, *B, *MB, *MAi, *rows;
+        DSMatrixView BView, MBView, MAiView, rowsView;
+        double stackWorkspace[DS_CASE_STACK_WORKSPACE_SIZE];
+        double *workspace = stackWorkspace, *BValues, *MBValues, *MAiValues;
+        bool hasSolution;
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
                 goto bail;
         }
-//        if (DSSSystemHasSolution(DSCaseSSys(aCase)) == false) {
-//                goto bail;
-//        }
         if (Cd == NULL) {
                 goto bail;
         }
         numberOfXi = DSVariablePoolNumberOfVariables(DSCaseXi(aCase));
-        hasSSys = DSCaseSSys(aCase) != NULL;
-        if (hasSSys == false) {
-                W = DSMatrixCalloc(DSMatrixRows(Cd), DSMatrixColumns(Cd));
-                Zeta = DSMatrixCopy(delta);
-                U = DSMatrixCopy(Ci);
-        } else if (DSSSystemHasSolution(DSCaseSSys(aCase)) == false) {
-                W = DSMatrixCalloc(DSMatrixRows(Cd), DSMatrixColumns(Cd));
-                Zeta = DSMatrixCopy(delta);
-                U = DSMatrixCopy(Ci);
-        } else {
-                
-                W = DSMatrixByMultiplyingMatrix(Cd, DSSSystemM(DSCaseSSys(aCase)));
-                B = DSSSystemB(DSCaseSSys(aCase));
-                Zeta = DSMatrixByMultiplyingMatrix(W, B);
-                DSMatrixAddByMatrix(Zeta, delta);
-                if (numberOfXi != 0) {
-                        Ai = DSSSystemAi(DSCaseSSys(aCase));
-                        U = DSMatrixByMultiplyingMatrix(W, Ai);
-                        if (Ci != NULL)
-                                DSMatrixSubstractByMatrix(U, Ci);
-                        DSMatrixMultiplyByScalar(U, -1.0);
-                        DSMatrixFree(Ai);
+        ssys = DSCaseSSys(aCase);
+        hasSolution = (ssys != NULL && DSSSystemHasSolution(ssys) == true);
+        if (hasSolution == true)
+                numberOfEquations = DSMatrixRows(DSSSystemM(ssys));
+        if (numberOfEquations*(numberOfXi+2) > DS_CASE_STACK_WORKSPACE_SIZE)
+                workspace = DSSecureMalloc(sizeof(double)*numberOfEquations*(numberOfXi+2));
+        BValues = workspace;
+        MBValues = BValues+numberOfEquations;
+        MAiValues = MBValues+numberOfEquations;
+        {
+                firstRow = (DSCaseZeta(aCase) != NULL) ? DSMatrixRows(DSCaseZeta(aCase)) : 0;
+                Zeta = DSMatrixAlloc(firstRow+DSMatrixRows(Cd), 1);
+                if (firstRow != 0)
+                        DSMatrixCopyInto(DSMatrixViewOfRows(&rowsView, Zeta, 0, firstRow), DSCaseZeta(aCase));
+                rows = DSMatrixViewOfRows(&rowsView, Zeta, firstRow, DSMatrixRows(Cd));
+                DSMatrixCopyInto(rows, delta);
+                if (hasSolution == true) {
+                        B = DSMatrixViewWithData(&BView, numberOfEquations, 1, BValues);
+                        MB = DSMatrixViewWithData(&MBView, numberOfEquations, 1, MBValues);
+                        DSSSystemBInto(ssys, B);
+                        DSMatrixMultiplyMatricesInto(MB, 1.0, DSSSystemM(ssys), B, 0.0);
+                        DSMatrixMultiplyMatricesInto(rows, 1.0, Cd, MB, 1.0);
+                }
+                if (DSCaseZeta(aCase) != NULL)
+                        DSMatrixFree(DSCaseZeta(aCase));
+                DSCaseZeta(aCase) = Zeta;
+                if (numberOfXi == 0)
+                        goto bail;
+                firstRow = (DSCaseU(aCase) != NULL) ? DSMatrixRows(DSCaseU(aCase)) : 0;
+                U = DSMatrixAlloc(firstRow+DSMatrixRows(Cd), numberOfXi);
+                if (firstRow != 0)
+                        DSMatrixCopyInto(DSMatrixViewOfRows(&rowsView, U, 0, firstRow), DSCaseU(aCase));
+                rows = DSMatrixViewOfRows(&rowsView, U, firstRow, DSMatrixRows(Cd));
+                if (Ci != NULL)
+                        DSMatrixCopyInto(rows, Ci);
+                else
+                        DSMatrixSetDoubleValueAll(rows, 0.0);
+                if (hasSolution == true) {
+                        MAi = DSMatrixViewWithData(&MAiView, numberOfEquations, numberOfXi, MAiValues);
+                        DSMatrixMultiplyMatricesInto(MAi, 1.0, DSSSystemM(ssys), DSSSystemGi(ssys), 0.0);
+                        DSMatrixMultiplyMatricesInto(MAi, -1.0, DSSSystemM(ssys), DSSSystemHi(ssys), 1.0);
+                        DSMatrixMultiplyMatricesInto(rows, -1.0, Cd, MAi, 1.0);
                 }
-                DSMatrixFree(B);
+                if (DSCaseU(aCase) != NULL)
+                        DSMatrixFree(DSCaseU(aCase));
+                DSCaseU(aCase) = U;
         }
-        temp = DSCaseZeta(aCase);
-        DSCaseZeta(aCase) = DSMatrixAppendMatrices(temp, Zeta, false);
-        DSMatrixFree(temp);
-        DSMatrixFree(Zeta);
-        temp = DSCaseU(aCase);
-        DSCaseU(aCase) = DSMatrixAppendMatrices(temp, U, false);
-        DSMatrixFree(temp);
-        if (U != NULL)
-                DSMatrixFree(U);
-        DSMatrixFree(W);
 //        DSCaseRemoveRedundantBoundaries(aCase);
 bail:
+        if (workspace != stackWorkspace)
+                DSSecureFree(workspace);
         return;
 }
 
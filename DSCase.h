@@ -77,6 +77,10 @@ extern void DSCaseFree(DSCase * aCase);
 
 extern DSCase * DSCaseWithTermsFromGMA(const DSGMASystem * gma, const DSUInteger * termArray, const char * prefix);
 extern DSCase * DSCaseWithTermsFromDesignSpace(const DSDesignSpace * ds, const DSUInteger * termArray, const char * prefix);
+extern DSCase * DSCaseWithTermsFromDesignSpaceAndNeighbor(const DSDesignSpace * ds, const DSUInteger * termArray, const char * prefix, const DSCase * neighbor);
+extern DSCase * DSCaseLazyWithTermsFromDesignSpace(const DSDesignSpace * ds, const DSUInteger * termArray);
+extern void DSCaseCompleteConstruction(DSCase * aCase, const DSCase * neighbor);
+extern bool DSCaseIsLazy(const DSCase * aCase);
 
 
 #if defined (__APPLE__) && defined (__MACH__)
@@ -117,6 +121,7 @@ extern void DSCaseRecalculateBoundaryMatrices(DSCase *aCase);
 extern DSMatrix * DSCaseDoubleValueBoundariesAtPoint(const DSCase * aCase, const DSVariablePool * point);
 extern void DSCaseAddConstraints(DSCase * aCase, const char ** strings, DSUInteger numberOfConstraints);
 
+extern void DSCaseRemoveDuplicateBoundaries(DSCase *aCase);
 extern void DSCaseRemoveRedundantBoundaries(DSCase *aCase);
 
 
@@ -124,9 +129,20 @@ extern void DSCaseRemoveRedundantBoundaries(DSCase *aCase);
 #pragma mark Linear programming functions - See DSCaseLinearProgramming.c
 #endif
 
+extern void DSCaseLinearProgrammingContextBegin(void);
+extern void DSCaseLinearProgrammingContextEnd(void);
+extern void DSCaseLinearProgrammingThreadBegin(void);
+extern void DSCaseLinearProgrammingThreadEnd(void);
+extern void DSCaseValidityScreeningCounters(DSCaseScreeningCounters * counters);
+extern void DSCaseResetValidityScreeningCounters(void);
+
+extern const bool DSCaseConditionMatricesAreValid(const DSMatrix * Cd, const DSMatrix * Ci, const DSMatrix * delta);
+extern bool * DSCaseRedundantBoundaryRows(const DSMatrix * U, const DSMatrix * zeta);
 extern const bool DSCaseConditionsAreValid(const DSCase *aCase);
+extern const bool DSCaseSteadyStateConditionsAreValid(const DSCase *aCase, const bool strict);
 
 extern const bool DSCaseIsValid(const DSCase *aCase, const bool strict);
+extern const bool DSCaseIsValidWithNeighbor(DSCase *aCase, const bool strict, const DSCase * neighbor);
 extern const bool DSCaseIsConsistent(const DSCase *aCase);
 extern const bool DSCaseIsValidInStateSpace(const DSCase *aCase);
 extern const bool DSCaseIsValidAtPoint(const DSCase *aCase, const DSVariablePool * variablesToFix);
@@ -138,6 +154,9 @@ extern DSVertices * DSCaseVerticesForSlice(const DSCase *aCase, const DSVariable
 
 extern DSVertices * DSCaseBoundingRangeForVariableWithConstraints(const DSCase *aCase, const char * variable, DSVariablePool * lowerBounds, DSVariablePool * upperBounds);
 extern DSVertices * DSCaseBoundingRangeForVariable(const DSCase *aCase, const char * variable);
+extern DSMatrix * DSCaseBoundingBox(const DSCase *aCase);
+extern DSMatrix * DSCaseBoundingBoxWithConstraints(const DSCase *aCase, const DSVariablePool * lowerBounds, const DSVariablePool * upperBounds);
+extern DSMatrixArray * DSCaseBoundingBoxesForCases(const DSUInteger numberOfCases, const DSCase ** cases, const DSVariablePool * lowerBounds, const DSVariablePool * upperBounds);
 extern DSVertices * DSCaseVerticesFor1DSlice(const DSCase *aCase, const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds, const char * xVariable);
 extern DSVertices * DSCaseVerticesFor2DSlice(const DSCase *aCase, const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds, const char * xVariable, const char *yVariable);
 
@@ -162,6 +181,17 @@ extern DSVariablePool * DSCaseValidParameterSetAtSliceByOptimizingFunction(const
 
 extern DSMatrixArray * DSCaseParseOptimizationFunction(const DSCase * aCase, const char * string);
 
+extern DSOptimizationFunction * DSOptimizationFunctionByParsingString(const DSVariablePool * Xd, const DSVariablePool * Xi, const char * string);
+extern void DSOptimizationFunctionFree(DSOptimizationFunction * function);
+extern DSMatrixArray * DSOptimizationFunctionMatricesForCase(const DSOptimizationFunction * function, const DSCase * aCase);
+
+extern DSVariablePool * DSCaseValidParameterSetWithOptimizationFunction(const DSCase *aCase, const DSOptimizationFunction * function, const bool minimize);
+extern DSVariablePool * DSCaseValidParameterSetAtSliceWithOptimizationFunction(const DSCase *aCase,
+                                                                               const DSVariablePool * lowerBounds,
+                                                                               const DSVariablePool *upperBounds,
+                                                                               const DSOptimizationFunction * function,
+                                                                               const bool minimize);
+
 #if defined (__APPLE__) && defined (__MACH__)
 #pragma mark Intersection of cases
 #endif
@@ -0,0 +1,799 @@
+/**
+ * \file DSCaseIndex.c
+ * \brief Implementation file with functions for finding the cases that are
+ * valid at a point.
+ *
+ * \details
+ *
+ * Copyright (C) 2011-2014 Jason Lomnitz.\n\n
+ *
+ * This file is part of the Design Space Toolbox V2 (C Library).
+ *
+ * The Design Space Toolbox V2 is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Design Space Toolbox V2 is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Design Space Toolbox. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * \author Jason Lomnitz.
+ * \date 2014
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "DSMemoryManager.h"
+#include "DSCaseIndex.h"
+#include "DSCase.h"
+#include "DSDesignSpace.h"
+#include "DSVariable.h"
+#include "DSMatrix.h"
+#include "DSMatrixArray.h"
+#include "DSThreadPool.h"
+
+/**
+ * \brief The distance by which a point may lie outside of a bounding box and
+ * still be tested against the conditions of its case.
+ *
+ * \details Bounding boxes are calculated by linear programming, so they are
+ * enlarged slightly to avoid missing points on the boundary of a case.
+ */
+#define DS_CASE_INDEX_TOLERANCE         1E-9
+
+/**
+ * \brief The smallest number of points located in parallel by
+ * DSCaseIndexCaseNumbersAtPoints.
+ */
+#define DS_CASE_INDEX_PARALLEL_POINTS   256
+
+/**
+ * \brief The number of points evaluated together by the batch membership
+ * kernel.
+ */
+#define DS_CASE_INDEX_TILE              64
+
+/**
+ * \brief The largest depth of a case index, which bounds the stack used to
+ * locate a point.
+ */
+#define DS_CASE_INDEX_MAXIMUM_DEPTH     64
+
+#define dsCaseIndexLower(x, i)          ((x)->lower+(i)*(x)->dimensions)
+#define dsCaseIndexUpper(x, i)          ((x)->upper+(i)*(x)->dimensions)
+#define dsCaseIndexNodeLower(x, i)      ((x)->nodeLower+(i)*(x)->dimensions)
+#define dsCaseIndexNodeUpper(x, i)      ((x)->nodeUpper+(i)*(x)->dimensions)
+
+/**
+ * \brief A case and the coordinate used to sort it when splitting a node.
+ */
+typedef struct {
+        double key;
+        DSUInteger entry;
+} ds_caseindex_key_t;
+
+/**
+ * \brief Data of one task locating a range of points.
+ */
+typedef struct {
+        const DSCaseIndex * index;
+        const DSMatrix * points;
+        DSUInteger first;
+        DSUInteger count;
+        DSUInteger * caseNumbers;
+} ds_caseindex_task_t;
+
+/**
+ * \brief Data of one task evaluating the validity masks of a range of tiles.
+ */
+typedef struct {
+        const DSCaseIndex * index;
+        const double * points;
+        DSUInteger numberOfPoints;
+        DSUInteger firstTile;
+        DSUInteger numberOfTiles;
+        DSUInteger numberOfWords;
+        unsigned long * masks;
+} ds_caseindex_tiletask_t;
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Allocation, deallocation and initialization
+#endif
+
+/**
+ * \brief Copies the bounding box of a case calculated by DSCaseBoundingBox.
+ *
+ * \details Ranges that reach DS_CASE_INDEX_BOUND are treated as unbounded.
+ */
+static void dsCaseIndexCopyBoundingBox(const DSMatrix * box, const DSUInteger dimensions, double * lower, double * upper)
+{
+        DSUInteger i;
+        for (i = 0; i < dimensions; i++) {
+                lower[i] = DSMatrixDoubleValue(box, i, 0);
+                upper[i] = DSMatrixDoubleValue(box, i, 1);
+                if (lower[i] <= -DS_CASE_INDEX_BOUND+DS_CASE_INDEX_TOLERANCE)
+                        lower[i] = -INFINITY;
+                if (upper[i] >= DS_CASE_INDEX_BOUND-DS_CASE_INDEX_TOLERANCE)
+                        upper[i] = INFINITY;
+        }
+}
+
+static int dsCaseIndexCompareKeys(const void * key1, const void * key2)
+{
+        double difference = ((const ds_caseindex_key_t *)key1)->key - ((const ds_caseindex_key_t *)key2)->key;
+        return (difference < 0) ? -1 : ((difference > 0) ? 1 : 0);
+}
+
+static double dsCaseIndexCenter(const double lower, const double upper)
+{
+        double clampedLower = (lower < -DS_CASE_INDEX_BOUND) ? -DS_CASE_INDEX_BOUND : lower;
+        double clampedUpper = (upper > DS_CASE_INDEX_BOUND) ? DS_CASE_INDEX_BOUND : upper;
+        return (clampedLower+clampedUpper)/2.;
+}
+
+/**
+ * \brief Creates a node covering a range of cases and its children.
+ *
+ * \details The cases of the node are sorted by the centers of their bounding
+ * boxes along the dimension where the centers are most spread out, and split
+ * in two halves.  Nodes with at most DS_CASE_INDEX_LEAF_SIZE cases are leaves.
+ *
+ * \param order The array of cases being ordered, indexing the lower and upper
+ *        arrays of bounding boxes.
+ * \param keys A temporary array with room for all cases.
+ *
+ * \return The number of the new node.
+ */
+static DSUInteger dsCaseIndexBuildNode(DSCaseIndex * index, DSUInteger * order, const double * lower, const double * upper, ds_caseindex_key_t * keys, const DSUInteger first, const DSUInteger count, const DSUInteger depth)
+{
+        DSUInteger i, j, node, axis = 0, half;
+        double * nodeLower, * nodeUpper, minimum, maximum, spread = -1, center;
+        DSUInteger dimensions = index->dimensions;
+        node = index->numberOfNodes++;
+        nodeLower = dsCaseIndexNodeLower(index, node);
+        nodeUpper = dsCaseIndexNodeUpper(index, node);
+        index->nodeFirst[node] = first;
+        index->nodeCount[node] = count;
+        index->nodeChildren[2*node] = 0;
+        index->nodeChildren[2*node+1] = 0;
+        for (j = 0; j < dimensions; j++) {
+                nodeLower[j] = INFINITY;
+                nodeUpper[j] = -INFINITY;
+                minimum = INFINITY;
+                maximum = -INFINITY;
+                for (i = first; i < first+count; i++) {
+                        nodeLower[j] = (lower[order[i]*dimensions+j] < nodeLower[j]) ? lower[order[i]*dimensions+j] : nodeLower[j];
+                        nodeUpper[j] = (upper[order[i]*dimensions+j] > nodeUpper[j]) ? upper[order[i]*dimensions+j] : nodeUpper[j];
+                        center = dsCaseIndexCenter(lower[order[i]*dimensions+j], upper[order[i]*dimensions+j]);
+                        minimum = (center < minimum) ? center : minimum;
+                        maximum = (center > maximum) ? center : maximum;
+                }
+                if (maximum-minimum > spread) {
+                        spread = maximum-minimum;
+                        axis = j;
+                }
+        }
+        if (count <= DS_CASE_INDEX_LEAF_SIZE || depth+1 >= DS_CASE_INDEX_MAXIMUM_DEPTH)
+                goto bail;
+        for (i = 0; i < count; i++) {
+                keys[i].entry = order[first+i];
+                keys[i].key = dsCaseIndexCenter(lower[keys[i].entry*dimensions+axis], upper[keys[i].entry*dimensions+axis]);
+        }
+        qsort(keys, count, sizeof(ds_caseindex_key_t), dsCaseIndexCompareKeys);
+        for (i = 0; i < count; i++)
+                order[first+i] = keys[i].entry;
+        half = count/2;
+        index->nodeChildren[2*node] = dsCaseIndexBuildNode(index, order, lower, upper, keys, first, half, depth+1);
+        index->nodeChildren[2*node+1] = dsCaseIndexBuildNode(index, order, lower, upper, keys, first+half, count-half, depth+1);
+bail:
+        return node;
+}
+
+/**
+ * \brief Creates a case index for a set of cases.
+ *
+ * \details The bounding boxes of the cases are calculated in parallel with
+ * DSCaseBoundingBoxesForCases and stored in a tree of bounding boxes,
+ * together with a copy of the conditions of each case.  Cases without a
+ * solution or without a region of validity are not indexed.  The cases are
+ * not referenced by the index, and may be freed once it is created.
+ *
+ * \param numberOfCases The number of cases in the array.
+ * \param cases An array of cases of the same design space.
+ *
+ * \return A new DSCaseIndex, which must be freed with DSCaseIndexFree.
+ */
+extern DSCaseIndex * DSCaseIndexForCases(const DSUInteger numberOfCases, DSCase ** cases)
+{
+        DSCaseIndex * index = NULL;
+        DSUInteger i, j, k, entry, numberOfEntries = 0, numberOfConditions = 0, offset;
+        DSUInteger * entries = NULL, * order = NULL;
+        double * lower = NULL, * upper = NULL;
+        ds_caseindex_key_t * keys = NULL;
+        const DSCase * aCase, ** indexed = NULL;
+        DSMatrixArray * boxes = NULL;
+        if (cases == NULL && numberOfCases > 0) {
+                DSError(M_DS_CASE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        index = DSSecureCalloc(sizeof(DSCaseIndex), 1);
+        for (i = 0; i < numberOfCases; i++) {
+                if (cases[i] == NULL)
+                        continue;
+                if (DSCaseHasSolution(cases[i]) == false)
+                        continue;
+                index->Xi = DSVariablePoolCopy(DSCaseXi(cases[i]));
+                index->dimensions = DSVariablePoolNumberOfVariables(index->Xi);
+                break;
+        }
+        if (index->Xi == NULL || index->dimensions == 0)
+                goto bail;
+        entries = DSSecureMalloc(sizeof(DSUInteger)*numberOfCases);
+        indexed = DSSecureMalloc(sizeof(DSCase *)*numberOfCases);
+        for (i = 0; i < numberOfCases; i++) {
+                aCase = cases[i];
+                if (aCase == NULL)
+                        continue;
+                if (DSCaseHasSolution(aCase) == false)
+                        continue;
+                if (DSMatrixColumns(DSCaseU(aCase)) != index->dimensions)
+                        continue;
+                indexed[numberOfEntries] = aCase;
+                entries[numberOfEntries++] = i;
+        }
+        if (numberOfEntries == 0)
+                goto bail;
+        boxes = DSCaseBoundingBoxesForCases(numberOfEntries, indexed, NULL, NULL);
+        if (boxes == NULL)
+                goto bail;
+        lower = DSSecureMalloc(sizeof(double)*numberOfEntries*index->dimensions);
+        upper = DSSecureMalloc(sizeof(double)*numberOfEntries*index->dimensions);
+        for (i = 0, j = 0; i < numberOfEntries; i++) {
+                /** Cases without a region of validity are not indexed **/
+                if (DSMatrixArrayMatrix(boxes, i) == NULL)
+                        continue;
+                dsCaseIndexCopyBoundingBox(DSMatrixArrayMatrix(boxes, i), index->dimensions, lower+j*index->dimensions, upper+j*index->dimensions);
+                numberOfConditions += DSMatrixRows(DSCaseU(indexed[i]));
+                entries[j++] = entries[i];
+        }
+        numberOfEntries = j;
+        if (numberOfEntries == 0)
+                goto bail;
+        index->numberOfCases = numberOfEntries;
+        index->nodeLower = DSSecureMalloc(sizeof(double)*2*numberOfEntries*index->dimensions);
+        index->nodeUpper = DSSecureMalloc(sizeof(double)*2*numberOfEntries*index->dimensions);
+        index->nodeFirst = DSSecureMalloc(sizeof(DSUInteger)*2*numberOfEntries);
+        index->nodeCount = DSSecureMalloc(sizeof(DSUInteger)*2*numberOfEntries);
+        index->nodeChildren = DSSecureMalloc(sizeof(DSUInteger)*4*numberOfEntries);
+        order = DSSecureMalloc(sizeof(DSUInteger)*numberOfEntries);
+        keys = DSSecureMalloc(sizeof(ds_caseindex_key_t)*numberOfEntries);
+        for (i = 0; i < numberOfEntries; i++)
+                order[i] = i;
+        dsCaseIndexBuildNode(index, order, lower, upper, keys, 0, numberOfEntries, 0);
+        /** The cases are stored in the order of the leaves **/
+        index->caseNumbers = DSSecureMalloc(sizeof(DSUInteger)*numberOfEntries);
+        index->lower = DSSecureMalloc(sizeof(double)*numberOfEntries*index->dimensions);
+        index->upper = DSSecureMalloc(sizeof(double)*numberOfEntries*index->dimensions);
+        index->conditions = DSSecureMalloc(sizeof(DSUInteger)*(numberOfEntries+1));
+        index->conditionValues = DSSecureMalloc(sizeof(double)*numberOfConditions*(index->dimensions+1));
+        offset = 0;
+        for (i = 0; i < numberOfEntries; i++) {
+                entry = order[i];
+                aCase = cases[entries[entry]];
+                index->caseNumbers[i] = DSCaseNumber(aCase);
+                memcpy(dsCaseIndexLower(index, i), lower+entry*index->dimensions, sizeof(double)*index->dimensions);
+                memcpy(dsCaseIndexUpper(index, i), upper+entry*index->dimensions, sizeof(double)*index->dimensions);
+                index->conditions[i] = offset;
+                for (j = 0; j < DSMatrixRows(DSCaseU(aCase)); j++) {
+                        index->conditionValues[offset*(index->dimensions+1)] = DSMatrixDoubleValue(DSCaseZeta(aCase), j, 0);
+                        for (k = 0; k < index->dimensions; k++)
+                                index->conditionValues[offset*(index->dimensions+1)+k+1] = DSMatrixDoubleValue(DSCaseU(aCase), j, k);
+                        offset++;
+                }
+        }
+        index->conditions[numberOfEntries] = offset;
+bail:
+        if (entries != NULL)
+                DSSecureFree(entries);
+        if (indexed != NULL)
+                DSSecureFree(indexed);
+        if (boxes != NULL)
+                DSMatrixArrayFree(boxes);
+        if (order != NULL)
+                DSSecureFree(order);
+        if (keys != NULL)
+                DSSecureFree(keys);
+        if (lower != NULL)
+                DSSecureFree(lower);
+        if (upper != NULL)
+                DSSecureFree(upper);
+        return index;
+}
+
+/**
+ * \brief Creates a case index for the valid cases of a design space.
+ *
+ * \details The valid cases are calculated with
+ * DSDesignSpaceCalculateAllValidCases, indexed and freed.
+ *
+ * \param ds The DSDesignSpace whose valid cases are indexed.
+ *
+ * \return A new DSCaseIndex, which must be freed with DSCaseIndexFree.
+ */
+extern DSCaseIndex * DSCaseIndexForDesignSpace(DSDesignSpace * ds)
+{
+        DSCaseIndex * index = NULL;
+        DSCase ** cases = NULL;
+        DSUInteger i, numberOfCases;
+        if (ds == NULL) {
+                DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        cases = DSDesignSpaceCalculateAllValidCases(ds);
+        numberOfCases = DSDesignSpaceNumberOfValidCases(ds);
+        if (cases == NULL)
+                numberOfCases = 0;
+        index = DSCaseIndexForCases(numberOfCases, cases);
+        for (i = 0; i < numberOfCases; i++) {
+                if (cases[i] != NULL)
+                        DSCaseFree(cases[i]);
+        }
+        if (cases != NULL)
+                DSSecureFree(cases);
+bail:
+        return index;
+}
+
+extern void DSCaseIndexFree(DSCaseIndex * index)
+{
+        if (index == NULL) {
+                DSError(M_DS_CASE_INDEX_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (index->Xi != NULL)
+                DSVariablePoolFree(index->Xi);
+        if (index->caseNumbers != NULL)
+                DSSecureFree(index->caseNumbers);
+        if (index->lower != NULL)
+                DSSecureFree(index->lower);
+        if (index->upper != NULL)
+                DSSecureFree(index->upper);
+        if (index->conditions != NULL)
+                DSSecureFree(index->conditions);
+        if (index->conditionValues != NULL)
+                DSSecureFree(index->conditionValues);
+        if (index->nodeLower != NULL)
+                DSSecureFree(index->nodeLower);
+        if (index->nodeUpper != NULL)
+                DSSecureFree(index->nodeUpper);
+        if (index->nodeFirst != NULL)
+                DSSecureFree(index->nodeFirst);
+        if (index->nodeCount != NULL)
+                DSSecureFree(index->nodeCount);
+        if (index->nodeChildren != NULL)
+                DSSecureFree(index->nodeChildren);
+        DSSecureFree(index);
+bail:
+        return;
+}
+
+extern DSUInteger DSCaseIndexNumberOfCases(const DSCaseIndex * index)
+{
+        DSUInteger numberOfCases = 0;
+        if (index == NULL) {
+                DSError(M_DS_CASE_INDEX_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        numberOfCases = index->numberOfCases;
+bail:
+        return numberOfCases;
+}
+
+/**
+ * \brief Returns the case number of the case at a position of the index.
+ *
+ * \details Bit i of the masks returned by DSCaseIndexValidityMasksAtPoints
+ * corresponds to the case at position i.
+ */
+extern DSUInteger DSCaseIndexCaseNumberAtIndex(const DSCaseIndex * index, const DSUInteger position)
+{
+        DSUInteger caseNumber = 0;
+        if (index == NULL) {
+                DSError(M_DS_CASE_INDEX_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (position >= index->numberOfCases) {
+                DSError(M_DS_WRONG ": Index out of range", A_DS_ERROR);
+                goto bail;
+        }
+        caseNumber = index->caseNumbers[position];
+bail:
+        return caseNumber;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Point location
+#endif
+
+static bool dsCaseIndexBoxContainsPoint(const double * lower, const double * upper, const double * point, const DSUInteger dimensions)
+{
+        DSUInteger j;
+        for (j = 0; j < dimensions; j++) {
+                if (point[j] < lower[j]-DS_CASE_INDEX_TOLERANCE || point[j] > upper[j]+DS_CASE_INDEX_TOLERANCE)
+                        break;
+        }
+        return (j == dimensions);
+}
+
+/**
+ * \brief Evaluates the conditions of an indexed case at a point.
+ *
+ * \details A case is valid at a point if zeta + U*x >= 0 for all of its
+ * conditions, as in DSCaseIsValidAtPoint.
+ */
+static bool dsCaseIndexCaseIsValidAtPoint(const DSCaseIndex * index, const DSUInteger position, const double * point)
+{
+        DSUInteger i, j;
+        const double * condition;
+        double value;
+        for (i = index->conditions[position]; i < index->conditions[position+1]; i++) {
+                condition = index->conditionValues+i*(index->dimensions+1);
+                value = condition[0];
+                for (j = 0; j < index->dimensions; j++)
+                        value += condition[j+1]*point[j];
+                if (value < 0)
+                        break;
+        }
+        return (i == index->conditions[position+1]);
+}
+
+/**
+ * \brief Finds the cases that are valid at a point.
+ *
+ * \param point An array with the log10 values of the independent variables.
+ * \param caseNumbers An array where the case numbers of the valid cases are
+ *        stored, with room for all cases of the index, or NULL.
+ * \param smallest A pointer where the smallest valid case number is stored,
+ *        or 0 if no case is valid at the point.
+ *
+ * \return The number of cases valid at the point.
+ */
+static DSUInteger dsCaseIndexLocatePoint(const DSCaseIndex * index, const double * point, DSUInteger * caseNumbers, DSUInteger * smallest)
+{
+        DSUInteger stack[DS_CASE_INDEX_MAXIMUM_DEPTH+1];
+        DSUInteger i, node, depth = 0, count = 0;
+        *smallest = 0;
+        if (index->numberOfNodes == 0)
+                goto bail;
+        stack[depth++] = 0;
+        while (depth > 0) {
+                node = stack[--depth];
+                if (dsCaseIndexBoxContainsPoint(dsCaseIndexNodeLower(index, node), dsCaseIndexNodeUpper(index, node), point, index->dimensions) == false)
+                        continue;
+                if (index->nodeChildren[2*node] != 0) {
+                        stack[depth++] = index->nodeChildren[2*node+1];
+                        stack[depth++] = index->nodeChildren[2*node];
+                        continue;
+                }
+                for (i = index->nodeFirst[node]; i < index->nodeFirst[node]+index->nodeCount[node]; i++) {
+                        if (dsCaseIndexBoxContainsPoint(dsCaseIndexLower(index, i), dsCaseIndexUpper(index, i), point, index->dimensions) == false)
+                                continue;
+                        if (dsCaseIndexCaseIsValidAtPoint(index, i, point) == false)
+                                continue;
+                        if (caseNumbers != NULL)
+                                caseNumbers[count] = index->caseNumbers[i];
+                        if (*smallest == 0 || index->caseNumbers[i] < *smallest)
+                                *smallest = index->caseNumbers[i];
+                        count++;
+                }
+        }
+bail:
+        return count;
+}
+
+static int dsCaseIndexCompareCaseNumbers(const void * caseNumber1, const void * caseNumber2)
+{
+        DSUInteger a = *(const DSUInteger *)caseNumber1, b = *(const DSUInteger *)caseNumber2;
+        return (a < b) ? -1 : ((a > b) ? 1 : 0);
+}
+
+/**
+ * \brief Finds the cases that are valid at a point.
+ *
+ * \param index The DSCaseIndex used to locate the point.
+ * \param point A DSVariablePool with the values of the independent variables,
+ *        as used by DSCaseIsValidAtPoint.
+ * \param numberOfCases A pointer to a DSUInteger where the number of valid
+ *        cases is stored.  May be NULL.
+ *
+ * \return A newly allocated array with the case numbers of the valid cases in
+ *         increasing order, or NULL if no case is valid at the point.  The
+ *         caller is responsible for freeing the array.
+ */
+extern DSUInteger * DSCaseIndexCaseNumbersAtPoint(const DSCaseIndex * index, const DSVariablePool * point, DSUInteger * numberOfCases)
+{
+        DSUInteger * caseNumbers = NULL;
+        DSUInteger i, count = 0, smallest;
+        double * coordinates = NULL;
+        const char * name;
+        if (numberOfCases != NULL)
+                *numberOfCases = 0;
+        if (index == NULL) {
+                DSError(M_DS_CASE_INDEX_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (point == NULL) {
+                DSError(M_DS_VAR_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (index->numberOfCases == 0)
+                goto bail;
+        coordinates = DSSecureMalloc(sizeof(double)*index->dimensions);
+        for (i = 0; i < index->dimensions; i++) {
+                name = DSVariableName(DSVariablePoolVariableAtIndex(index->Xi, i));
+                if (DSVariablePoolHasVariableWithName(point, name) == false) {
+                        DSError(M_DS_WRONG ": Point does not have independent variable", A_DS_ERROR);
+                        goto bail;
+                }
+                coordinates[i] = log10(DSVariablePoolValueForVariableWithName(point, name));
+        }
+        caseNumbers = DSSecureMalloc(sizeof(DSUInteger)*index->numberOfCases);
+        count = dsCaseIndexLocatePoint(index, coordinates, caseNumbers, &smallest);
+        if (count == 0) {
+                DSSecureFree(caseNumbers);
+                caseNumbers = NULL;
+                goto bail;
+        }
+        qsort(caseNumbers, count, sizeof(DSUInteger), dsCaseIndexCompareCaseNumbers);
+        if (numberOfCases != NULL)
+                *numberOfCases = count;
+bail:
+        if (coordinates != NULL)
+                DSSecureFree(coordinates);
+        return caseNumbers;
+}
+
+static void * dsCaseIndexLocatePointsTask(void * argument)
+{
+        ds_caseindex_task_t * task = argument;
+        DSUInteger i, j;
+        double * coordinates = DSSecureMalloc(sizeof(double)*task->index->dimensions);
+        for (i = task->first; i < task->first+task->count; i++) {
+                for (j = 0; j < task->index->dimensions; j++)
+                        coordinates[j] = DSMatrixDoubleValue(task->points, i, j);
+                dsCaseIndexLocatePoint(task->index, coordinates, NULL, task->caseNumbers+i);
+        }
+        DSSecureFree(coordinates);
+        return NULL;
+}
+
+/**
+ * \brief Finds a case that is valid at each of a batch of points.
+ *
+ * \details Large batches are located in parallel by the thread pool.
+ *
+ * \param index The DSCaseIndex used to locate the points.
+ * \param points A DSMatrix with one point per row, and one column with the
+ *        log10 value of each independent variable, in the order of the
+ *        independent variables of the cases.
+ *
+ * \return A newly allocated array with one case number per point: the
+ *         smallest case number valid at the point, or 0 if no case is valid at
+ *         the point.  The caller is responsible for freeing the array.
+ */
+extern DSUInteger * DSCaseIndexCaseNumbersAtPoints(const DSCaseIndex * index, const DSMatrix * points)
+{
+        DSUInteger * caseNumbers = NULL;
+        DSUInteger i, numberOfPoints, numberOfTasks = 1, chunk;
+        ds_caseindex_task_t * tasks = NULL;
+        if (index == NULL) {
+                DSError(M_DS_CASE_INDEX_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (points == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (DSMatrixColumns(points) != index->dimensions) {
+                DSError(M_DS_WRONG ": Points must have one column per independent variable", A_DS_ERROR);
+                goto bail;
+        }
+        numberOfPoints = DSMatrixRows(points);
+        caseNumbers = DSSecureCalloc(sizeof(DSUInteger), numberOfPoints);
+        if (numberOfPoints >= DS_CASE_INDEX_PARALLEL_POINTS)
+                numberOfTasks = DSThreadPoolNumberOfThreads();
+        if (numberOfTasks == 0)
+                numberOfTasks = 1;
+        chunk = (numberOfPoints+numberOfTasks-1)/numberOfTasks;
+        tasks = DSSecureCalloc(sizeof(ds_caseindex_task_t), numberOfTasks);
+        for (i = 0; i < numberOfTasks; i++) {
+                tasks[i].index = index;
+                tasks[i].points = points;
+                tasks[i].caseNumbers = caseNumbers;
+                tasks[i].first = (i*chunk < numberOfPoints) ? i*chunk : numberOfPoints;
+                tasks[i].count = (tasks[i].first+chunk < numberOfPoints) ? chunk : numberOfPoints-tasks[i].first;
+        }
+        if (numberOfTasks > 1)
+                DSThreadPoolRun(dsCaseIndexLocatePointsTask, tasks, sizeof(ds_caseindex_task_t), numberOfTasks);
+        else
+                dsCaseIndexLocatePointsTask(tasks);
+        DSSecureFree(tasks);
+bail:
+        return caseNumbers;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Batch membership
+#endif
+
+/**
+ * \brief Evaluates the conditions of all cases at a tile of points.
+ *
+ * \details The points of the tile are stored by coordinate, so each condition
+ * is evaluated at all points of the tile by loops over contiguous arrays that
+ * the compiler vectorizes for the instruction set of the target.  Cases whose
+ * bounding box does not intersect the bounding box of the tile are skipped,
+ * and the evaluation of a case stops when no point of the tile satisfies its
+ * conditions.
+ *
+ * \param tile A dimensions by DS_CASE_INDEX_TILE array with the coordinates of
+ *        the points, stored by coordinate.
+ * \param numberOfPoints The number of points in the tile.
+ * \param masks A numberOfPoints by numberOfWords array where the bits of the
+ *        valid cases are set.
+ * \param tileBounds A workspace of 2*dimensions values where the bounding box
+ *        of the tile is stored.
+ */
+static void dsCaseIndexEvaluateTile(const DSCaseIndex * index, const double * tile, const DSUInteger numberOfPoints, const DSUInteger numberOfWords, unsigned long * masks, double * tileBounds)
+{
+        DSUInteger i, j, k, t, dimensions = index->dimensions;
+        double values[DS_CASE_INDEX_TILE], slack[DS_CASE_INDEX_TILE];
+        double * tileLower = tileBounds, * tileUpper = tileBounds+dimensions;
+        double coefficient;
+        const double * condition, * coordinates;
+        long long anyValid;
+        for (j = 0; j < dimensions; j++) {
+                tileLower[j] = INFINITY;
+                tileUpper[j] = -INFINITY;
+                for (t = 0; t < numberOfPoints; t++) {
+                        tileLower[j] = (tile[j*DS_CASE_INDEX_TILE+t] < tileLower[j]) ? tile[j*DS_CASE_INDEX_TILE+t] : tileLower[j];
+                        tileUpper[j] = (tile[j*DS_CASE_INDEX_TILE+t] > tileUpper[j]) ? tile[j*DS_CASE_INDEX_TILE+t] : tileUpper[j];
+                }
+        }
+        for (k = 0; k < index->numberOfCases; k++) {
+                for (j = 0; j < dimensions; j++) {
+                        if (tileUpper[j] < dsCaseIndexLower(index, k)[j]-DS_CASE_INDEX_TOLERANCE)
+                                break;
+                        if (tileLower[j] > dsCaseIndexUpper(index, k)[j]+DS_CASE_INDEX_TOLERANCE)
+                                break;
+                }
+                if (j != dimensions)
+                        continue;
+                for (t = 0; t < DS_CASE_INDEX_TILE; t++)
+                        slack[t] = INFINITY;
+                anyValid = 1;
+                for (i = index->conditions[k]; i < index->conditions[k+1] && anyValid != 0; i++) {
+                        condition = index->conditionValues+i*(dimensions+1);
+                        for (t = 0; t < DS_CASE_INDEX_TILE; t++)
+                                values[t] = condition[0];
+                        for (j = 0; j < dimensions; j++) {
+                                coefficient = condition[j+1];
+                                if (coefficient == 0)
+                                        continue;
+                                coordinates = tile+j*DS_CASE_INDEX_TILE;
+                                for (t = 0; t < DS_CASE_INDEX_TILE; t++)
+                                        values[t] += coefficient*coordinates[t];
+                        }
+                        /** The slack of a point is the value of its most violated condition **/
+                        anyValid = 0;
+                        for (t = 0; t < DS_CASE_INDEX_TILE; t++) {
+                                slack[t] = (values[t] < slack[t]) ? values[t] : slack[t];
+                                anyValid |= (long long)(slack[t] >= 0);
+                        }
+                }
+                if (anyValid == 0)
+                        continue;
+                for (t = 0; t < numberOfPoints; t++) {
+                        if (slack[t] >= 0)
+                                masks[t*numberOfWords+k/(sizeof(unsigned long)*8)] |= 1UL << (k % (sizeof(unsigned long)*8));
+                }
+        }
+}
+
+static void * dsCaseIndexEvaluateTilesTask(void * argument)
+{
+        ds_caseindex_tiletask_t * task = argument;
+        DSUInteger i, j, t, first, count, dimensions = task->index->dimensions;
+        /** The tile is followed by the workspace of its bounding box **/
+        double * tile = DSSecureMalloc(sizeof(double)*dimensions*(DS_CASE_INDEX_TILE+2));
+        for (i = task->firstTile; i < task->firstTile+task->numberOfTiles; i++) {
+                first = i*DS_CASE_INDEX_TILE;
+                count = (first+DS_CASE_INDEX_TILE <= task->numberOfPoints) ? DS_CASE_INDEX_TILE : task->numberOfPoints-first;
+                /** Unused slots repeat the last point, and are not written to the masks **/
+                for (t = 0; t < DS_CASE_INDEX_TILE; t++) {
+                        for (j = 0; j < dimensions; j++)
+                                tile[j*DS_CASE_INDEX_TILE+t] = task->points[(first+((t < count) ? t : count-1))*dimensions+j];
+                }
+                dsCaseIndexEvaluateTile(task->index, tile, count, task->numberOfWords, task->masks+first*task->numberOfWords, tile+dimensions*DS_CASE_INDEX_TILE);
+        }
+        DSSecureFree(tile);
+        return NULL;
+}
+
+/**
+ * \brief Calculates which cases are valid at each of a batch of points.
+ *
+ * \details The conditions of every case are evaluated at tiles of
+ * DS_CASE_INDEX_TILE points with a vectorized kernel, and the tiles are
+ * distributed over the thread pool.  This is faster than locating each point
+ * in the tree when the points are dense, as in raster plots or Monte Carlo
+ * samples of a region.
+ *
+ * \param index The DSCaseIndex with the cases being tested.
+ * \param numberOfPoints The number of points.
+ * \param points An array with the log10 values of the independent variables
+ *        of each point, stored by point in the order of the independent
+ *        variables of the cases.
+ * \param numberOfWords A pointer to a DSUInteger where the number of words in
+ *        the mask of each point is stored.
+ *
+ * \return A newly allocated numberOfPoints by numberOfWords array of masks,
+ *         where bit i of the mask of a point is set if the case at position i
+ *         of the index is valid at the point (see
+ *         DSCaseIndexCaseNumberAtIndex).  The caller is responsible for freeing
+ *         the array.
+ */
+extern unsigned long * DSCaseIndexValidityMasksAtPoints(const DSCaseIndex * index, const DSUInteger numberOfPoints, const double * points, DSUInteger * numberOfWords)
+{
+        unsigned long * masks = NULL;
+        DSUInteger i, words, numberOfTiles, numberOfTasks = 1, chunk;
+        ds_caseindex_tiletask_t * tasks = NULL;
+        if (numberOfWords != NULL)
+                *numberOfWords = 0;
+        if (index == NULL) {
+                DSError(M_DS_CASE_INDEX_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (points == NULL || numberOfWords == NULL) {
+                DSError(M_DS_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (numberOfPoints == 0 || index->numberOfCases == 0)
+                goto bail;
+        words = (index->numberOfCases+sizeof(unsigned long)*8-1)/(sizeof(unsigned long)*8);
+        masks = DSSecureCalloc(sizeof(unsigned long), numberOfPoints*words);
+        numberOfTiles = (numberOfPoints+DS_CASE_INDEX_TILE-1)/DS_CASE_INDEX_TILE;
+        if (numberOfPoints >= DS_CASE_INDEX_PARALLEL_POINTS)
+                numberOfTasks = DSThreadPoolNumberOfThreads();
+        if (numberOfTasks == 0)
+                numberOfTasks = 1;
+        if (numberOfTasks > numberOfTiles)
+                numberOfTasks = numberOfTiles;
+        chunk = (numberOfTiles+numberOfTasks-1)/numberOfTasks;
+        tasks = DSSecureCalloc(sizeof(ds_caseindex_tiletask_t), numberOfTasks);
+        for (i = 0; i < numberOfTasks; i++) {
+                tasks[i].index = index;
+                tasks[i].points = points;
+                tasks[i].numberOfPoints = numberOfPoints;
+                tasks[i].numberOfWords = words;
+                tasks[i].masks = masks;
+                tasks[i].firstTile = (i*chunk < numberOfTiles) ? i*chunk : numberOfTiles;
+                tasks[i].numberOfTiles = (tasks[i].firstTile+chunk < numberOfTiles) ? chunk : numberOfTiles-tasks[i].firstTile;
+        }
+        if (numberOfTasks > 1)
+                DSThreadPoolRun(dsCaseIndexEvaluateTilesTask, tasks, sizeof(ds_caseindex_tiletask_t), numberOfTasks);
+        else
+                dsCaseIndexEvaluateTilesTask(tasks);
+        DSSecureFree(tasks);
+        *numberOfWords = words;
+bail:
+        return masks;
+}
@@ -0,0 +1,87 @@
+/**
+ * \file DSCaseIndex.h
+ * \brief Header file with functions for finding the cases that are valid at
+ * a point.
+ *
+ * \details A case index is built once from the valid cases of a design space.
+ * It stores the bounding box of each case in a tree, so that the cases valid
+ * at a point are found by evaluating the conditions of the few cases whose
+ * bounding boxes contain the point, rather than the conditions of every case.
+ *
+ * Copyright (C) 2011-2014 Jason Lomnitz.\n\n
+ *
+ * This file is part of the Design Space Toolbox V2 (C Library).
+ *
+ * The Design Space Toolbox V2 is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Design Space Toolbox V2 is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Design Space Toolbox. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * \author Jason Lomnitz.
+ * \date 2014
+ */
+
+#include <stdbool.h>
+#include "DSTypes.h"
+#include "DSErrors.h"
+
+#ifndef __DS_CASE_INDEX__
+#define __DS_CASE_INDEX__
+
+#define M_DS_CASE_INDEX_NULL            M_DS_NULL ": Case index is NULL"
+
+/**
+ * \brief The largest number of cases in a leaf of a case index.
+ */
+#define DS_CASE_INDEX_LEAF_SIZE         8
+
+/**
+ * \brief The log10 bound used when calculating the bounding box of a case.
+ *
+ * \details Bounding ranges are calculated within [-15, 15]; a range that
+ * reaches this bound is treated as unbounded.
+ */
+#define DS_CASE_INDEX_BOUND             15.0
+
+#ifdef __cplusplus
+__BEGIN_DECLS
+#endif
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Allocation, deallocation and initialization
+#endif
+
+extern DSCaseIndex * DSCaseIndexForCases(const DSUInteger numberOfCases, DSCase ** cases);
+extern DSCaseIndex * DSCaseIndexForDesignSpace(DSDesignSpace * ds);
+extern void DSCaseIndexFree(DSCaseIndex * index);
+
+extern DSUInteger DSCaseIndexNumberOfCases(const DSCaseIndex * index);
+extern DSUInteger DSCaseIndexCaseNumberAtIndex(const DSCaseIndex * index, const DSUInteger position);
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Point location
+#endif
+
+extern DSUInteger * DSCaseIndexCaseNumbersAtPoint(const DSCaseIndex * index, const DSVariablePool * point, DSUInteger * numberOfCases);
+extern DSUInteger * DSCaseIndexCaseNumbersAtPoints(const DSCaseIndex * index, const DSMatrix * points);
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Batch membership
+#endif
+
+extern unsigned long * DSCaseIndexValidityMasksAtPoints(const DSCaseIndex * index, const DSUInteger numberOfPoints, const double * points, DSUInteger * numberOfWords);
+
+#ifdef __cplusplus
+__END_DECLS
+#endif
+
+#endif
@@ -0,0 +1,437 @@
+/**
+ * \file DSCaseIntersection.c
+ * \brief Implementation file with functions for finding the intersections
+ * among a set of cases.
+ *
+ * \details
+ *
+ * Copyright (C) 2011-2014 Jason Lomnitz.\n\n
+ *
+ * This file is part of the Design Space Toolbox V2 (C Library).
+ *
+ * The Design Space Toolbox V2 is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Design Space Toolbox V2 is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Design Space Toolbox. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * \author Jason Lomnitz.
+ * \date 2014
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "DSMemoryManager.h"
+#include "DSCaseIntersection.h"
+#include "DSCase.h"
+#include "DSVariable.h"
+#include "DSMatrix.h"
+#include "DSMatrixArray.h"
+#include "DSThreadPool.h"
+
+/**
+ * \brief The distance by which two bounding boxes may be apart and still be
+ * considered to overlap.
+ */
+#define DS_CASE_INTERSECTION_TOLERANCE  1E-9
+
+#define dsCaseIntersectionLower(x, i)   ((x)->lower+(i)*(x)->dimensions)
+#define dsCaseIntersectionUpper(x, i)   ((x)->upper+(i)*(x)->dimensions)
+
+/**
+ * \brief The bounding boxes of the cases being intersected.
+ */
+typedef struct {
+        DSUInteger dimensions;
+        double * lower;
+        double * upper;
+} ds_intersection_boxes_t;
+
+/**
+ * \brief Data of one task testing if a combination of cases intersects.
+ */
+typedef struct {
+        const DSCase ** cases;
+        const DSVariablePool * lowerBounds;
+        const DSVariablePool * upperBounds;
+        DSUInteger size;
+        const DSUInteger * members;
+        bool * isValid;
+} ds_intersection_task_t;
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Bounding boxes
+#endif
+
+/**
+ * \brief Calculates the bounding boxes of a set of cases in parallel.
+ *
+ * \details The boxes are calculated with DSCaseBoundingBoxesForCases within
+ * the slice, if one is given.  Only the boxes of the cases listed in
+ * positions are calculated, and are stored at the index of each case in the
+ * array of cases.  A range that reaches DS_CASE_INTERSECTION_BOUND is treated
+ * as unbounded, and a box that cannot be calculated is left unbounded, so the
+ * box always contains the region of validity.
+ */
+static ds_intersection_boxes_t * dsCaseIntersectionBoundingBoxes(const DSUInteger numberOfCases, const DSCase ** cases, const DSUInteger numberOfPositions, const DSUInteger * positions, const DSVariablePool * lowerBounds, const DSVariablePool * upperBounds)
+{
+        ds_intersection_boxes_t * boxes = NULL;
+        DSMatrixArray * matrices = NULL;
+        const DSCase ** subset = NULL;
+        const DSMatrix * box;
+        double * lower, * upper;
+        DSUInteger i, j;
+        boxes = DSSecureCalloc(sizeof(ds_intersection_boxes_t), 1);
+        boxes->dimensions = DSVariablePoolNumberOfVariables(DSCaseXi(cases[0]));
+        boxes->lower = DSSecureCalloc(sizeof(double), numberOfCases*boxes->dimensions);
+        boxes->upper = DSSecureCalloc(sizeof(double), numberOfCases*boxes->dimensions);
+        subset = DSSecureMalloc(sizeof(DSCase *)*numberOfPositions);
+        for (i = 0; i < numberOfPositions; i++)
+                subset[i] = cases[positions[i]];
+        matrices = DSCaseBoundingBoxesForCases(numberOfPositions, subset, lowerBounds, upperBounds);
+        DSSecureFree(subset);
+        for (i = 0; i < numberOfPositions; i++) {
+                lower = dsCaseIntersectionLower(boxes, positions[i]);
+                upper = dsCaseIntersectionUpper(boxes, positions[i]);
+                box = (matrices != NULL) ? DSMatrixArrayMatrix(matrices, i) : NULL;
+                for (j = 0; j < boxes->dimensions; j++) {
+                        lower[j] = (box != NULL) ? DSMatrixDoubleValue(box, j, 0) : -INFINITY;
+                        upper[j] = (box != NULL) ? DSMatrixDoubleValue(box, j, 1) : INFINITY;
+                        if (lower[j] <= -DS_CASE_INTERSECTION_BOUND+DS_CASE_INTERSECTION_TOLERANCE)
+                                lower[j] = -INFINITY;
+                        if (upper[j] >= DS_CASE_INTERSECTION_BOUND-DS_CASE_INTERSECTION_TOLERANCE)
+                                upper[j] = INFINITY;
+                }
+        }
+        if (matrices != NULL)
+                DSMatrixArrayFree(matrices);
+        return boxes;
+}
+
+static void dsCaseIntersectionBoundingBoxesFree(ds_intersection_boxes_t * boxes)
+{
+        if (boxes == NULL)
+                goto bail;
+        DSSecureFree(boxes->lower);
+        DSSecureFree(boxes->upper);
+        DSSecureFree(boxes);
+bail:
+        return;
+}
+
+static bool dsCaseIntersectionBoxesOverlap(const ds_intersection_boxes_t * boxes, const DSUInteger case1, const DSUInteger case2)
+{
+        DSUInteger i;
+        bool overlap = true;
+        if (boxes == NULL)
+                goto bail;
+        for (i = 0; i < boxes->dimensions; i++) {
+                if (dsCaseIntersectionUpper(boxes, case1)[i]+DS_CASE_INTERSECTION_TOLERANCE < dsCaseIntersectionLower(boxes, case2)[i]) {
+                        overlap = false;
+                        break;
+                }
+                if (dsCaseIntersectionUpper(boxes, case2)[i]+DS_CASE_INTERSECTION_TOLERANCE < dsCaseIntersectionLower(boxes, case1)[i]) {
+                        overlap = false;
+                        break;
+                }
+        }
+bail:
+        return overlap;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Candidate combinations
+#endif
+
+static int dsCaseIntersectionCompareCombinations(const DSUInteger * combination1, const DSUInteger * combination2, const DSUInteger size)
+{
+        DSUInteger i;
+        int comparison = 0;
+        for (i = 0; i < size; i++) {
+                if (combination1[i] != combination2[i]) {
+                        comparison = (combination1[i] < combination2[i]) ? -1 : 1;
+                        break;
+                }
+        }
+        return comparison;
+}
+
+/**
+ * \brief Searches a sorted list of combinations for a combination.
+ */
+static bool dsCaseIntersectionHasCombination(const DSUInteger numberOfCombinations, const DSUInteger * combinations, const DSUInteger size, const DSUInteger * combination)
+{
+        DSUInteger first = 0, last = numberOfCombinations, middle;
+        int comparison;
+        bool found = false;
+        while (first < last) {
+                middle = first+(last-first)/2;
+                comparison = dsCaseIntersectionCompareCombinations(combinations+middle*size, combination, size);
+                if (comparison == 0) {
+                        found = true;
+                        break;
+                }
+                if (comparison < 0)
+                        first = middle+1;
+                else
+                        last = middle;
+        }
+        return found;
+}
+
+/**
+ * \brief Creates the combinations of one case more than a list of
+ * intersecting combinations.
+ *
+ * \details The combinations are sorted, so two combinations that differ only
+ * in their last case are next to each other, and joining them creates a
+ * candidate that is also sorted.  A candidate is kept only if all of its
+ * combinations with one case less intersect.  For pairs, the bounding boxes
+ * of both cases must overlap; this is enough for larger combinations, since
+ * boxes that overlap pairwise have a common point.
+ *
+ * \param numberOfCombinations The number of intersecting combinations.
+ * \param combinations The sorted list of intersecting combinations.
+ * \param size The number of cases in each combination.
+ * \param boxes The bounding boxes of the cases, or NULL if the boxes are not
+ *        used.
+ * \param numberOfCandidates A pointer to a DSUInteger where the number of
+ *        candidates is stored.
+ *
+ * \return A sorted list of candidates with size+1 cases each, or NULL if
+ *         there are none.
+ */
+static DSUInteger * dsCaseIntersectionCandidates(const DSUInteger numberOfCombinations, const DSUInteger * combinations, const DSUInteger size, const ds_intersection_boxes_t * boxes, DSUInteger * numberOfCandidates)
+{
+        DSUInteger i, j, k, l, capacity = 0, count = 0;
+        DSUInteger * candidates = NULL, candidate[size+1], subset[size];
+        const DSUInteger * first, * second;
+        for (i = 0; i < numberOfCombinations; i++) {
+                first = combinations+i*size;
+                for (j = i+1; j < numberOfCombinations; j++) {
+                        second = combinations+j*size;
+                        if (dsCaseIntersectionCompareCombinations(first, second, size-1) != 0)
+                                break;
+                        memcpy(candidate, first, sizeof(DSUInteger)*size);
+                        candidate[size] = second[size-1];
+                        if (size == 1 && dsCaseIntersectionBoxesOverlap(boxes, candidate[0], candidate[1]) == false)
+                                continue;
+                        /** The subsets without the last or second to last case are first and second **/
+                        for (k = 0; k+1 < size; k++) {
+                                for (l = 0; l < size+1; l++) {
+                                        if (l != k)
+                                                subset[(l < k) ? l : l-1] = candidate[l];
+                                }
+                                if (dsCaseIntersectionHasCombination(numberOfCombinations, combinations, size, subset) == false)
+                                        break;
+                        }
+                        if (k+1 < size)
+                                continue;
+                        if (count == capacity) {
+                                capacity = (capacity == 0) ? numberOfCombinations : 2*capacity;
+                                if (candidates == NULL)
+                                        candidates = DSSecureMalloc(sizeof(DSUInteger)*capacity*(size+1));
+                                else
+                                        candidates = DSSecureRealloc(candidates, sizeof(DSUInteger)*capacity*(size+1));
+                        }
+                        memcpy(candidates+count*(size+1), candidate, sizeof(DSUInteger)*(size+1));
+                        count++;
+                }
+        }
+        *numberOfCandidates = count;
+        return candidates;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Intersection search
+#endif
+
+static void * dsCaseIntersectionValidityTask(void * argument)
+{
+        ds_intersection_task_t * task = argument;
+        const DSCase * members[task->size];
+        DSUInteger i;
+        for (i = 0; i < task->size; i++)
+                members[i] = task->cases[task->members[i]];
+        if (task->size == 1 && task->lowerBounds == NULL)
+                *task->isValid = DSCaseIsValid(members[0], true);
+        else if (task->size == 1)
+                *task->isValid = DSCaseIsValidAtSlice(members[0], task->lowerBounds, task->upperBounds, true);
+        else if (task->lowerBounds == NULL)
+                *task->isValid = DSCaseIntersectionIsValid(task->size, members);
+        else
+                *task->isValid = DSCaseIntersectionIsValidAtSlice(task->size, members, task->lowerBounds, task->upperBounds);
+        return NULL;
+}
+
+/**
+ * \brief Removes the combinations that do not intersect from a list of
+ * combinations.
+ *
+ * \details Each combination is tested as a separate task of the thread pool,
+ * since the cost of the linear problems varies between combinations.  The
+ * order of the combinations that intersect is preserved.
+ *
+ * \return The number of combinations that intersect.
+ */
+static DSUInteger dsCaseIntersectionFilterCombinations(const DSCase ** cases, const DSVariablePool * lowerBounds, const DSVariablePool * upperBounds, const DSUInteger numberOfCombinations, DSUInteger * combinations, const DSUInteger size)
+{
+        DSUInteger i, count = 0;
+        ds_intersection_task_t * tasks = NULL;
+        bool * isValid = NULL;
+        if (numberOfCombinations == 0)
+                goto bail;
+        isValid = DSSecureCalloc(sizeof(bool), numberOfCombinations);
+        tasks = DSSecureCalloc(sizeof(ds_intersection_task_t), numberOfCombinations);
+        for (i = 0; i < numberOfCombinations; i++) {
+                tasks[i].cases = cases;
+                tasks[i].lowerBounds = lowerBounds;
+                tasks[i].upperBounds = upperBounds;
+                tasks[i].size = size;
+                tasks[i].members = combinations+i*size;
+                tasks[i].isValid = isValid+i;
+        }
+        if (numberOfCombinations > 1)
+                DSThreadPoolRun(dsCaseIntersectionValidityTask, tasks, sizeof(ds_intersection_task_t), numberOfCombinations);
+        else
+                dsCaseIntersectionValidityTask(tasks);
+        DSSecureFree(tasks);
+        for (i = 0; i < numberOfCombinations; i++) {
+                if (isValid[i] == false)
+                        continue;
+                if (i != count)
+                        memcpy(combinations+count*size, combinations+i*size, sizeof(DSUInteger)*size);
+                count++;
+        }
+        DSSecureFree(isValid);
+bail:
+        return count;
+}
+
+static DSMatrixArray * dsCaseIntersectionsForCases(const DSUInteger numberOfCases, const DSCase ** cases, const DSUInteger maximumSize, const DSVariablePool * lowerBounds, const DSVariablePool * upperBounds)
+{
+        DSMatrixArray * intersections = NULL;
+        DSMatrix * matrix;
+        ds_intersection_boxes_t * boxes = NULL;
+        DSUInteger i, j, size, count, dimensions, * combinations = NULL, * candidates;
+        if (numberOfCases == 0) {
+                DSError(M_DS_WRONG ": Number of cases must be at least one", A_DS_ERROR);
+                goto bail;
+        }
+        if (cases == NULL) {
+                DSError(M_DS_NULL ": Array of cases is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        for (i = 0; i < numberOfCases; i++) {
+                if (cases[i] == NULL) {
+                        DSError(M_DS_CASE_NULL, A_DS_ERROR);
+                        goto bail;
+                }
+        }
+        dimensions = DSVariablePoolNumberOfVariables(DSCaseXi(cases[0]));
+        for (i = 1; i < numberOfCases; i++) {
+                if (DSVariablePoolNumberOfVariables(DSCaseXi(cases[i])) != dimensions) {
+                        DSError(M_DS_WRONG ": Cases must have the same independent variables", A_DS_ERROR);
+                        goto bail;
+                }
+        }
+        intersections = DSMatrixArrayAlloc();
+        combinations = DSSecureMalloc(sizeof(DSUInteger)*numberOfCases);
+        for (i = 0; i < numberOfCases; i++)
+                combinations[i] = i;
+        count = numberOfCases;
+        for (size = 1; size <= numberOfCases; size++) {
+                count = dsCaseIntersectionFilterCombinations(cases, lowerBounds, upperBounds, count, combinations, size);
+                if (count == 0)
+                        break;
+                matrix = DSMatrixCalloc(count, size);
+                for (i = 0; i < count; i++) {
+                        for (j = 0; j < size; j++)
+                                DSMatrixSetDoubleValue(matrix, i, j, combinations[i*size+j]);
+                }
+                DSMatrixArrayAddMatrix(intersections, matrix);
+                if (size == maximumSize)
+                        break;
+                /** Bounding boxes take 2 linear problems per variable, so they are used only when pairs need more **/
+                if (size == 1 && count > 4*dimensions+1)
+                        boxes = dsCaseIntersectionBoundingBoxes(numberOfCases, cases, count, combinations, lowerBounds, upperBounds);
+                candidates = dsCaseIntersectionCandidates(count, combinations, size, boxes, &count);
+                DSSecureFree(combinations);
+                combinations = candidates;
+                if (count == 0)
+                        break;
+        }
+bail:
+        if (combinations != NULL)
+                DSSecureFree(combinations);
+        if (boxes != NULL)
+                dsCaseIntersectionBoundingBoxesFree(boxes);
+        return intersections;
+}
+
+/**
+ * \brief Finds all combinations of cases that intersect.
+ *
+ * \details The combinations are found one size at a time, starting with the
+ * valid cases.  A combination is tested only if all of its combinations with
+ * one case less intersect, since the intersection of a combination lies
+ * within the intersection of any of its subsets; the search stops at the
+ * first size without intersecting combinations.  The intersections are tested
+ * with DSCaseIntersectionIsValid in parallel.
+ *
+ * \param numberOfCases The number of cases in the array of cases.
+ * \param cases The array of cases being intersected.
+ * \param maximumSize The largest number of cases in a combination, or 0 to
+ *        find combinations of any size.
+ *
+ * \return A DSMatrixArray where matrix i has one row for each intersecting
+ *         combination of i+1 cases, with the positions of its cases in the
+ *         array of cases in increasing order.  The caller is responsible for
+ *         freeing the array and its matrices.
+ *
+ * \see DSCaseIntersectionIsValid
+ */
+extern DSMatrixArray * DSCaseIntersectionsForCases(const DSUInteger numberOfCases, const DSCase ** cases, const DSUInteger maximumSize)
+{
+        return dsCaseIntersectionsForCases(numberOfCases, cases, maximumSize, NULL, NULL);
+}
+
+/**
+ * \brief Finds all combinations of cases that intersect within a slice.
+ *
+ * \details The combinations are found as in DSCaseIntersectionsForCases, but
+ * are tested with DSCaseIntersectionIsValidAtSlice.
+ *
+ * \param numberOfCases The number of cases in the array of cases.
+ * \param cases The array of cases being intersected.
+ * \param maximumSize The largest number of cases in a combination, or 0 to
+ *        find combinations of any size.
+ * \param lowerBounds A DSVariablePool with the lower bounds of the slice.
+ * \param upperBounds A DSVariablePool with the upper bounds of the slice.
+ *
+ * \return A DSMatrixArray with the intersecting combinations of each size.
+ *         The caller is responsible for freeing the array and its matrices.
+ *
+ * \see DSCaseIntersectionIsValidAtSlice
+ */
+extern DSMatrixArray * DSCaseIntersectionsForCasesAtSlice(const DSUInteger numberOfCases, const DSCase ** cases, const DSUInteger maximumSize, const DSVariablePool * lowerBounds, const DSVariablePool * upperBounds)
+{
+        DSMatrixArray * intersections = NULL;
+        if (lowerBounds == NULL || upperBounds == NULL) {
+                DSError(M_DS_VAR_NULL ": Variable pool with bounds of the slice is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        intersections = dsCaseIntersectionsForCases(numberOfCases, cases, maximumSize, lowerBounds, upperBounds);
+bail:
+        return intersections;
+}
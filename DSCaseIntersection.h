@@ -0,0 +1,63 @@
+/**
+ * \file DSCaseIntersection.h
+ * \brief Header file with functions for finding the intersections among a set
+ * of cases.
+ *
+ * \details The intersections are found one size at a time.  A combination of
+ * cases is only tested if every combination with one case less intersects,
+ * and pairs are only tested if the bounding boxes of both cases overlap, so
+ * most combinations are discarded without solving a linear problem.  The
+ * linear problems of the remaining combinations are solved in parallel.
+ *
+ * Copyright (C) 2011-2014 Jason Lomnitz.\n\n
+ *
+ * This file is part of the Design Space Toolbox V2 (C Library).
+ *
+ * The Design Space Toolbox V2 is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Design Space Toolbox V2 is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Design Space Toolbox. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * \author Jason Lomnitz.
+ * \date 2014
+ */
+
+#include <stdbool.h>
+#include "DSTypes.h"
+#include "DSErrors.h"
+
+#ifndef __DS_CASE_INTERSECTION__
+#define __DS_CASE_INTERSECTION__
+
+/**
+ * \brief The log10 bound used when calculating the bounding box of a case.
+ *
+ * \details A range that reaches this bound is treated as unbounded.
+ */
+#define DS_CASE_INTERSECTION_BOUND      15.0
+
+#ifdef __cplusplus
+__BEGIN_DECLS
+#endif
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Intersection search
+#endif
+
+extern DSMatrixArray * DSCaseIntersectionsForCases(const DSUInteger numberOfCases, const DSCase ** cases, const DSUInteger maximumSize);
+extern DSMatrixArray * DSCaseIntersectionsForCasesAtSlice(const DSUInteger numberOfCases, const DSCase ** cases, const DSUInteger maximumSize, const DSVariablePool * lowerBounds, const DSVariablePool * upperBounds);
+
+#ifdef __cplusplus
+__END_DECLS
+#endif
+
+#endif
@@ -33,6 +33,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 #include <glpk.h>
 
 #include "DSMemoryManager.h"
@@ -44,65 +45,543 @@
 #include "DSExpression.h"
 #include "DSMatrix.h"
 #include "DSMatrixArray.h"
+#include "DSLinearProblem.h"
 #include "DSVertices.h"
+#include "DSPolytope.h"
 #include "DSNVertexEnumeration.h"
+#include "DSThreadPool.h"
 #include "DSGMASystemParsingAux.h"
 #include "DSExpressionTokenizer.h"
 #include "DSCaseOptimizationFunctionGrammar.h"
 #if defined (__APPLE__) && defined (__MACH__)
-#pragma mark Linear programming functions
+#pragma mark Linear programming context
 #endif
 
+/**
+ * \brief Linear programming context of a thread.
+ *
+ * \details The context keeps a single DSLinearProblem, lent to one linear
+ * problem at a time.  Consecutive problems overwrite the coefficients and
+ * bounds of the problem in place, and keep its workspace and the GLPK
+ * problem object used for problems too large for the dense simplex method,
+ * whose basis is used to warm start the next problem with the same number of
+ * rows and columns.
+ */
+typedef struct {
+        DSLinearProblem * problem;       //!< The backend independent problem reused by the thread.
+        bool problemInUse;               //!< Indicates if the backend independent problem is lent to a test.
+        DSUInteger depth;                //!< The number of nested calls to DSCaseLinearProgrammingContextBegin.
+        double * knownPoint;             //!< The independent variables of the last valid case, used by the validity screening.
+        DSUInteger knownPointSize;       //!< The number of independent variables in knownPoint.
+} ds_lpcontext_t;
 
-static glp_prob * dsCaseLinearProblemForMatrices(const DSMatrix *A, const DSMatrix *B)
+static pthread_key_t dsLinearProgrammingContextKey;
+static pthread_once_t dsLinearProgrammingContextOnce = PTHREAD_ONCE_INIT;
+
+static pthread_once_t dsLinearProgrammingThreadHooksOnce = PTHREAD_ONCE_INIT;
+
+static void dsCaseLinearProgrammingContextCreateKey(void)
 {
-        glp_prob *linearProblem = NULL;
-        int * ia = NULL, *ja = NULL;
-        double *ar = NULL;
-        DSUInteger i, numberOfXi, numberOfBoundaries;
-        
-        glp_term_out(GLP_OFF);
-        linearProblem = glp_create_prob();
-        if (linearProblem == NULL) {
-                DSError(M_DS_NULL ": Linear problem is NULL", A_DS_ERROR);
+        pthread_key_create(&dsLinearProgrammingContextKey, DSSecureFree);
+}
+
+/**
+ * \brief Registers DSCaseLinearProgrammingThreadBegin and
+ * DSCaseLinearProgrammingThreadEnd as hooks of the worker threads of the
+ * thread pool, the first time a case linear problem is used.
+ */
+static void dsCaseLinearProgrammingAddThreadHooks(void)
+{
+        DSThreadPoolAddThreadHooks(DSCaseLinearProgrammingThreadBegin, DSCaseLinearProgrammingThreadEnd);
+}
+
+/**
+ * \brief Starts the linear programming context of the calling thread.
+ *
+ * \details While the context is active, case validity tests performed by the
+ * thread reuse a single problem object instead of creating and deleting one
+ * for every test.  Calls may be nested, and each call must be matched by
+ * a call to DSCaseLinearProgrammingContextEnd.  The first call registers
+ * DSCaseLinearProgrammingThreadBegin as a thread hook of the thread pool, so
+ * that later tasks executed by the thread pool run inside the context of the
+ * worker thread.
+ */
+extern void DSCaseLinearProgrammingContextBegin(void)
+{
+        ds_lpcontext_t * context;
+        pthread_once(&dsLinearProgrammingThreadHooksOnce, dsCaseLinearProgrammingAddThreadHooks);
+        pthread_once(&dsLinearProgrammingContextOnce, dsCaseLinearProgrammingContextCreateKey);
+        context = pthread_getspecific(dsLinearProgrammingContextKey);
+        if (context == NULL) {
+                context = DSSecureCalloc(sizeof(ds_lpcontext_t), 1);
+                pthread_setspecific(dsLinearProgrammingContextKey, context);
+        }
+        context->depth++;
+}
+
+/**
+ * \brief Ends the linear programming context of the calling thread, deleting
+ * its problem object when the outermost context ends.
+ */
+extern void DSCaseLinearProgrammingContextEnd(void)
+{
+        ds_lpcontext_t * context;
+        pthread_once(&dsLinearProgrammingContextOnce, dsCaseLinearProgrammingContextCreateKey);
+        context = pthread_getspecific(dsLinearProgrammingContextKey);
+        if (context == NULL) {
+                DSError(M_DS_WRONG ": Linear programming context was not started", A_DS_WARN);
+                goto bail;
+        }
+        if (--context->depth > 0)
+                goto bail;
+        if (context->problem != NULL)
+                DSLinearProblemFree(context->problem);
+        if (context->knownPoint != NULL)
+                DSSecureFree(context->knownPoint);
+        DSSecureFree(context);
+        pthread_setspecific(dsLinearProgrammingContextKey, NULL);
+bail:
+        return;
+}
+
+/**
+ * \brief Prepares the calling thread for linear programming for the rest of
+ * its lifetime.
+ *
+ * \details Initializes the GLPK environment of the thread and starts a linear
+ * programming context that stays active until DSCaseLinearProgrammingThreadEnd
+ * is called.  This function is registered with DSThreadPoolAddThreadHooks,
+ * so that tasks executed by the worker threads of the thread pool, including
+ * nested tasks executed while waiting, share one environment and one context
+ * and never free either.
+ */
+extern void DSCaseLinearProgrammingThreadBegin(void)
+{
+        glp_init_env();
+        DSCaseLinearProgrammingContextBegin();
+}
+
+/**
+ * \brief Ends the linear programming context started by
+ * DSCaseLinearProgrammingThreadBegin and frees the GLPK environment of the
+ * calling thread.
+ */
+extern void DSCaseLinearProgrammingThreadEnd(void)
+{
+        DSCaseLinearProgrammingContextEnd();
+        glp_free_env();
+}
+
+/**
+ * \brief Returns a DSLinearProblem with the given number of rows and columns.
+ *
+ * \details The problem of the thread context is returned if there is an
+ * active context and its problem is not in use; otherwise a new problem is
+ * allocated.  The problem is reset by DSLinearProblemResize, and must be
+ * returned with dsCaseProblemRelease.
+ */
+static DSLinearProblem * dsCaseProblemAcquire(const DSUInteger numberOfRows, const DSUInteger numberOfColumns)
+{
+        DSLinearProblem * problem = NULL;
+        ds_lpcontext_t * context;
+        pthread_once(&dsLinearProgrammingThreadHooksOnce, dsCaseLinearProgrammingAddThreadHooks);
+        pthread_once(&dsLinearProgrammingContextOnce, dsCaseLinearProgrammingContextCreateKey);
+        context = pthread_getspecific(dsLinearProgrammingContextKey);
+        if (context == NULL || context->problemInUse == true)
+                goto bail;
+        if (context->problem == NULL)
+                context->problem = DSLinearProblemAlloc();
+        problem = context->problem;
+        context->problemInUse = true;
+bail:
+        if (problem == NULL)
+                problem = DSLinearProblemAlloc();
+        DSLinearProblemResize(problem, numberOfRows, numberOfColumns);
+        return problem;
+}
+
+static void dsCaseProblemRelease(DSLinearProblem * problem)
+{
+        ds_lpcontext_t * context;
+        if (problem == NULL)
+                goto bail;
+        pthread_once(&dsLinearProgrammingContextOnce, dsCaseLinearProgrammingContextCreateKey);
+        context = pthread_getspecific(dsLinearProgrammingContextKey);
+        if (context != NULL && context->problem == problem) {
+                context->problemInUse = false;
+                goto bail;
+        }
+        DSLinearProblemFree(problem);
+bail:
+        return;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark Validity screening
+#endif
+
+#define DS_CASE_SCREEN_UNDECIDED        0
+#define DS_CASE_SCREEN_INVALID          1
+#define DS_CASE_SCREEN_VALID            2
+
+/**
+ * \brief The smallest margin by which the conditions of a valid case must be
+ * satisfied, matching the objective value tested after the linear problem.
+ */
+#define dsCaseScreenThreshold(strict)   ((strict) == true ? 1E-14 : 0.0)
+
+static DSCaseScreeningCounters dsScreeningCounters = {0, 0, 0, 0};
+
+/**
+ * \brief Copies the number of cases decided by each stage of the validity
+ * screening since the counters were last reset.
+ *
+ * \param counters A pointer to the DSCaseScreeningCounters where the counters
+ *        are copied.
+ */
+extern void DSCaseValidityScreeningCounters(DSCaseScreeningCounters * counters)
+{
+        if (counters == NULL) {
+                DSError(M_DS_NULL ": Screening counters are NULL", A_DS_ERROR);
+                goto bail;
+        }
+        counters->zeroRows = __sync_fetch_and_add(&dsScreeningCounters.zeroRows, 0);
+        counters->opposingRows = __sync_fetch_and_add(&dsScreeningCounters.opposingRows, 0);
+        counters->knownPoint = __sync_fetch_and_add(&dsScreeningCounters.knownPoint, 0);
+        counters->linearProblems = __sync_fetch_and_add(&dsScreeningCounters.linearProblems, 0);
+bail:
+        return;
+}
+
+extern void DSCaseResetValidityScreeningCounters(void)
+{
+        __sync_fetch_and_and(&dsScreeningCounters.zeroRows, 0);
+        __sync_fetch_and_and(&dsScreeningCounters.opposingRows, 0);
+        __sync_fetch_and_and(&dsScreeningCounters.knownPoint, 0);
+        __sync_fetch_and_and(&dsScreeningCounters.linearProblems, 0);
+}
+
+/**
+ * \brief Returns the coefficient of a condition of the form
+ * [A B]*x + c > 0, where B may be NULL.
+ */
+static double dsCaseScreenCoefficient(const DSMatrix * A, const DSMatrix * B, const DSUInteger row, const DSUInteger column)
+{
+        if (column < DSMatrixColumns(A))
+                return DSMatrixDoubleValue(A, row, column);
+        return DSMatrixDoubleValue(B, row, column-DSMatrixColumns(A));
+}
+
+/**
+ * \brief Number of conditions above which opposing conditions are found by
+ * hashing instead of comparing every pair of conditions.
+ */
+#define DS_CASE_SCREEN_HASH_ROWS        24
+
+/**
+ * \brief Finds two conditions with exactly opposite coefficients whose sum
+ * cannot be satisfied, in linear expected time.
+ *
+ * \details The sign of each non-zero condition is flipped if needed so that
+ * its first non-zero coefficient is positive.  Negation is exact, so two
+ * conditions are exactly opposite if and only if their sign-normalized
+ * coefficients are equal and their signs differ.  Equal rows are grouped with
+ * DSMatrixFirstOccurrenceOfRows, and the smallest constant of each sign is
+ * kept for every group; only these two constants need to be tested.
+ *
+ * \return A boolean value indicating if two opposing conditions cannot be
+ *         satisfied.
+ */
+static bool dsCaseScreenHasOpposingRowsHashed(const DSMatrix * A, const DSMatrix * B, const DSMatrix * c, const char * isZero, const double threshold)
+{
+        bool found = false;
+        DSUInteger i, k, numberOfRows = DSMatrixRows(c), numberOfColumns = 0, * firstRows = NULL;
+        DSMatrix * normalized = NULL;
+        double sign, * minimumPositive = NULL, * minimumNegative = NULL;
+        if (A != NULL)
+                numberOfColumns += DSMatrixColumns(A);
+        if (B != NULL)
+                numberOfColumns += DSMatrixColumns(B);
+        normalized = DSMatrixCalloc(numberOfRows, numberOfColumns);
+        minimumPositive = DSSecureMalloc(sizeof(double)*2*numberOfRows);
+        minimumNegative = minimumPositive+numberOfRows;
+        for (i = 0; i < numberOfRows; i++) {
+                minimumPositive[i] = INFINITY;
+                minimumNegative[i] = INFINITY;
+                if (isZero[i] == true)
+                        continue;
+                sign = 0.0;
+                for (k = 0; k < numberOfColumns; k++) {
+                        if (sign == 0.0 && dsCaseScreenCoefficient(A, B, i, k) != 0.0)
+                                sign = (dsCaseScreenCoefficient(A, B, i, k) > 0.0) ? 1.0 : -1.0;
+                        DSMatrixElement(normalized, i, k) = sign*dsCaseScreenCoefficient(A, B, i, k);
+                }
+        }
+        firstRows = DSMatrixFirstOccurrenceOfRows(normalized);
+        if (firstRows == NULL)
+                goto bail;
+        for (i = 0; i < numberOfRows; i++) {
+                if (isZero[i] == true)
+                        continue;
+                for (k = 0; k < numberOfColumns; k++)
+                        if (dsCaseScreenCoefficient(A, B, i, k) != 0.0)
+                                break;
+                if (dsCaseScreenCoefficient(A, B, i, k) > 0.0)
+                        minimumPositive[firstRows[i]] = fmin(minimumPositive[firstRows[i]], DSMatrixDoubleValue(c, i, 0));
+                else
+                        minimumNegative[firstRows[i]] = fmin(minimumNegative[firstRows[i]], DSMatrixDoubleValue(c, i, 0));
+        }
+        for (i = 0; i < numberOfRows && found == false; i++) {
+                if (isinf(minimumPositive[i]) || isinf(minimumNegative[i]))
+                        continue;
+                found = ((minimumPositive[i]+minimumNegative[i])/2.0 < threshold);
+        }
+bail:
+        if (normalized != NULL)
+                DSMatrixFree(normalized);
+        if (firstRows != NULL)
+                DSSecureFree(firstRows);
+        if (minimumPositive != NULL)
+                DSSecureFree(minimumPositive);
+        return found;
+}
+
+/**
+ * \brief Rejects conditions of the form [A B]*x + c > 0 that cannot be
+ * satisfied, without solving a linear problem.
+ *
+ * \details Two tests are performed.  A condition with no variables must have
+ * a positive constant, and the sum of two conditions with exactly opposite
+ * coefficients must have a positive constant.  Both tests use the margin of
+ * the linear problem, so they never reject a case that the linear problem
+ * accepts.  Coefficients are compared exactly: conditions that are only
+ * nearly opposite may still be satisfied far from the origin.  Opposing
+ * conditions are found by comparing every pair of conditions if there are
+ * few of them, and by hashing otherwise.
+ *
+ * \param A The DSMatrix with the first block of coefficients. May be NULL if
+ *        the conditions have no variables.
+ * \param B The DSMatrix with the second block of coefficients, or NULL.
+ * \param c The DSMatrix with the constants of the conditions.
+ * \param strict A boolean value indicating if the conditions must be strictly
+ *        satisfied.
+ *
+ * \return DS_CASE_SCREEN_INVALID if the conditions cannot be satisfied,
+ *         DS_CASE_SCREEN_UNDECIDED otherwise.
+ */
+static DSUInteger dsCaseScreenConditions(const DSMatrix * A, const DSMatrix * B, const DSMatrix * c, const bool strict)
+{
+        DSUInteger result = DS_CASE_SCREEN_UNDECIDED;
+        DSUInteger i, j, k, numberOfRows, numberOfColumns = 0;
+        char * isZero = NULL;
+        double threshold = dsCaseScreenThreshold(strict);
+        if (c == NULL)
+                goto bail;
+        numberOfRows = DSMatrixRows(c);
+        if (A != NULL)
+                numberOfColumns += DSMatrixColumns(A);
+        if (B != NULL)
+                numberOfColumns += DSMatrixColumns(B);
+        if (A == NULL && B != NULL) {
+                A = B;
+                B = NULL;
+        }
+        isZero = DSSecureMalloc(sizeof(char)*numberOfRows);
+        for (i = 0; i < numberOfRows; i++) {
+                for (k = 0; k < numberOfColumns; k++) {
+                        if (dsCaseScreenCoefficient(A, B, i, k) != 0.0)
+                                break;
+                }
+                isZero[i] = (k == numberOfColumns);
+                if (isZero[i] == true && DSMatrixDoubleValue(c, i, 0) < threshold) {
+                        __sync_fetch_and_add(&dsScreeningCounters.zeroRows, 1);
+                        result = DS_CASE_SCREEN_INVALID;
+                        goto bail;
+                }
+        }
+        if (numberOfRows > DS_CASE_SCREEN_HASH_ROWS) {
+                if (dsCaseScreenHasOpposingRowsHashed(A, B, c, isZero, threshold) == true) {
+                        __sync_fetch_and_add(&dsScreeningCounters.opposingRows, 1);
+                        result = DS_CASE_SCREEN_INVALID;
+                }
+                goto bail;
+        }
+        for (i = 0; i < numberOfRows; i++) {
+                if (isZero[i] == true)
+                        continue;
+                for (j = i+1; j < numberOfRows; j++) {
+                        if (isZero[j] == true)
+                                continue;
+                        if ((DSMatrixDoubleValue(c, i, 0)+DSMatrixDoubleValue(c, j, 0))/2.0 >= threshold)
+                                continue;
+                        for (k = 0; k < numberOfColumns; k++) {
+                                if (dsCaseScreenCoefficient(A, B, i, k) != -dsCaseScreenCoefficient(A, B, j, k))
+                                        break;
+                        }
+                        if (k == numberOfColumns) {
+                                __sync_fetch_and_add(&dsScreeningCounters.opposingRows, 1);
+                                result = DS_CASE_SCREEN_INVALID;
+                                goto bail;
+                        }
+                }
+        }
+bail:
+        if (isZero != NULL)
+                DSSecureFree(isZero);
+        return result;
+}
+
+/**
+ * \brief Accepts the boundaries U*x + zeta > 0 of a case if they are
+ * satisfied at the point of the last valid case found by the thread.
+ *
+ * \details The point is the solution of the linear problem of the last valid
+ * case tested in the linear programming context of the thread.  Neighboring
+ * cases often share most of their boundaries, so the point frequently
+ * satisfies all of them.  The point is only a certificate; a case that does
+ * not contain it is left undecided.
+ */
+static DSUInteger dsCaseScreenKnownPoint(const DSMatrix * U, const DSMatrix * zeta, const bool strict)
+{
+        DSUInteger result = DS_CASE_SCREEN_UNDECIDED;
+        DSUInteger i, k;
+        double value, threshold = dsCaseScreenThreshold(strict);
+        ds_lpcontext_t * context;
+        if (U == NULL || zeta == NULL)
+                goto bail;
+        pthread_once(&dsLinearProgrammingContextOnce, dsCaseLinearProgrammingContextCreateKey);
+        context = pthread_getspecific(dsLinearProgrammingContextKey);
+        if (context == NULL || context->knownPoint == NULL)
+                goto bail;
+        if (context->knownPointSize != DSMatrixColumns(U))
+                goto bail;
+        for (i = 0; i < DSMatrixRows(U); i++) {
+                value = DSMatrixElement(zeta, i, 0);
+                for (k = 0; k < DSMatrixColumns(U); k++)
+                        value += DSMatrixElement(U, i, k)*context->knownPoint[k];
+                if (value < threshold)
+                        goto bail;
+        }
+        __sync_fetch_and_add(&dsScreeningCounters.knownPoint, 1);
+        result = DS_CASE_SCREEN_VALID;
+bail:
+        return result;
+}
+
+/**
+ * \brief Returns the known point of the linear programming context of the
+ * thread, resized to a number of independent variables.
+ *
+ * \return The array with the known point, or NULL if the thread has no
+ *         linear programming context.
+ */
+static double * dsCaseScreenKnownPointWithSize(const DSUInteger numberOfXi)
+{
+        double * knownPoint = NULL;
+        ds_lpcontext_t * context;
+        if (numberOfXi == 0)
+                goto bail;
+        pthread_once(&dsLinearProgrammingContextOnce, dsCaseLinearProgrammingContextCreateKey);
+        context = pthread_getspecific(dsLinearProgrammingContextKey);
+        if (context == NULL)
+                goto bail;
+        if (context->knownPoint == NULL)
+                context->knownPoint = DSSecureMalloc(sizeof(double)*numberOfXi);
+        else if (context->knownPointSize != numberOfXi)
+                context->knownPoint = DSSecureRealloc(context->knownPoint, sizeof(double)*numberOfXi);
+        context->knownPointSize = numberOfXi;
+        knownPoint = context->knownPoint;
+bail:
+        return knownPoint;
+}
+
+/**
+ * \brief Stores the independent variables of the solution of a linear
+ * problem as the known point of the linear programming context of the thread.
+ */
+static void dsCaseScreenSetKnownPoint(const DSLinearProblem * problem, const DSUInteger numberOfXi)
+{
+        DSUInteger i;
+        double * knownPoint;
+        if (problem == NULL)
+                goto bail;
+        knownPoint = dsCaseScreenKnownPointWithSize(numberOfXi);
+        if (knownPoint == NULL)
+                goto bail;
+        for (i = 0; i < numberOfXi; i++)
+                knownPoint[i] = DSLinearProblemColumnValue(problem, i);
+bail:
+        return;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark Linear programming functions
+#endif
+
+/**
+ * \brief Creates a problem for the coefficients A*x <= B in the DSLinearProblem
+ * of the linear programming context of the thread.
+ *
+ * \details The problem has numberOfActiveRows additional rows after the rows
+ * of A, which are the trivial constraint 0 <= 0 until they are set by
+ * dsCaseLinearProblemSetActiveRows.  All variables are free and the
+ * objective is zero.
+ */
+static DSLinearProblem * dsCaseLinearProblemForMatrices(const DSMatrix *A, const DSMatrix *B, const DSUInteger numberOfActiveRows)
+{
+        DSLinearProblem * problem = NULL;
+        DSUInteger i, j, numberOfXi, numberOfBoundaries;
+        if (A == NULL || B == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
                 goto bail;
         }
         numberOfXi = DSMatrixColumns(A);
         numberOfBoundaries = DSMatrixRows(A);
-        
-        ia = DSMatrixRowsForGLPK(A);
-        ja = DSMatrixColumnsForGLPK(A);
-        ar = DSMatrixDataForGLPK(A);
-        
-        glp_add_rows(linearProblem, numberOfBoundaries);
-        glp_add_cols(linearProblem, numberOfXi);
-        
-        glp_set_obj_dir(linearProblem, GLP_MIN);
-        glp_load_matrix(linearProblem, numberOfBoundaries*numberOfXi,
-                        ia, ja, ar);
+        problem = dsCaseProblemAcquire(numberOfBoundaries+numberOfActiveRows, numberOfXi);
         for (i = 0; i < numberOfBoundaries; i++) {
-                glp_set_row_bnds(linearProblem, i+1, GLP_UP, 0.0,
-                                 DSMatrixDoubleValue(B, i, 0));
+                for (j = 0; j < numberOfXi; j++)
+                        DSLinearProblemSetCoefficient(problem, i, j, DSMatrixDoubleValue(A, i, j));
+                DSLinearProblemSetConstant(problem, i, DSMatrixDoubleValue(B, i, 0));
         }
-        for (i = 0; i < numberOfXi; i++)
-                glp_set_col_bnds(linearProblem, i+1, GLP_FR, 0., 0.);
-        
-        if (ia != NULL)
-                DSSecureFree(ia);
-        if (ja != NULL)
-                DSSecureFree(ja);
-        if (ar != NULL)
-                DSSecureFree(ar);
 bail:
-        return linearProblem;
+        return problem;
 }
 
-static glp_prob * dsCaseLinearProblemForCaseValidity(const DSMatrix * U, const DSMatrix *zeta)
+/**
+ * \brief Makes a set of rows of a problem created by
+ * dsCaseLinearProblemForMatrices hold as equalities.
+ *
+ * \details A DSLinearProblem only has constraints of the form a*x <= b, so
+ * the row a*x <= b of A*x <= B with index rows[i] is made an equality by
+ * setting additional row i of the problem to -a*x <= -b.  The additional rows must be set again for each
+ * set of active rows.
+ */
+static void dsCaseLinearProblemSetActiveRows(DSLinearProblem * problem, const DSMatrix *A, const DSMatrix *B, const DSUInteger numberOfActiveRows, const DSUInteger * rows)
 {
-        glp_prob *linearProblem = NULL;
-        DSMatrix *slacks = NULL, * coefficients;
-        DSUInteger numberOfXi, numberOfBoundaries;
-        
+        DSUInteger i, j, row, numberOfXi, numberOfBoundaries;
+        numberOfXi = DSMatrixColumns(A);
+        numberOfBoundaries = DSMatrixRows(A);
+        for (i = 0; i < numberOfActiveRows; i++) {
+                row = numberOfBoundaries+i;
+                for (j = 0; j < numberOfXi; j++)
+                        DSLinearProblemSetCoefficient(problem, row, j, -DSMatrixDoubleValue(A, rows[i], j));
+                DSLinearProblemSetConstant(problem, row, -DSMatrixDoubleValue(B, rows[i], 0));
+        }
+}
+
+/**
+ * \brief Creates the problem testing if the conditions U*x + zeta > 0 can be
+ * satisfied.
+ *
+ * \details The problem minimizes a slack variable s bounded below by -1,
+ * subject to -U*x - s <= zeta, so the conditions are strictly satisfied if the
+ * objective is negative.  The problem is built directly in the DSLinearProblem
+ * of the thread context, without intermediate matrices.
+ */
+static DSLinearProblem * dsCaseLinearProblemForCaseValidity(const DSMatrix * U, const DSMatrix *zeta)
+{
+        DSLinearProblem * problem = NULL;
+        DSUInteger i, j, numberOfXi, numberOfBoundaries;
         if (zeta == NULL) {
                 DSError(M_DS_MAT_NULL, A_DS_ERROR);
                 goto bail;
@@ -111,84 +590,407 @@ static glp_prob * dsCaseLinearProblemForCaseValidity(const DSMatrix * U, const D
                 numberOfXi = 0;
         else 
                 numberOfXi = DSMatrixColumns(U);
-        
         numberOfBoundaries = DSMatrixRows(zeta);
-        if (numberOfXi > 0) {
-                slacks = DSMatrixAlloc(numberOfBoundaries, 1);
-                DSMatrixSetDoubleValueAll(slacks, 1.0);
-                coefficients = DSMatrixAppendMatrices(U, slacks, true);
-                DSMatrixMultiplyByScalar(coefficients, -1.0);
-        } else {
-                coefficients = DSMatrixAlloc(numberOfBoundaries, 1);
-                DSMatrixSetDoubleValueAll(coefficients, -1.0);
-                
+        problem = dsCaseProblemAcquire(numberOfBoundaries, numberOfXi+1);
+        for (i = 0; i < numberOfBoundaries; i++) {
+                for (j = 0; j < numberOfXi; j++)
+                        DSLinearProblemSetCoefficient(problem, i, j, -DSMatrixDoubleValue(U, i, j));
+                DSLinearProblemSetCoefficient(problem, i, numberOfXi, -1.0);
+                DSLinearProblemSetConstant(problem, i, DSMatrixDoubleValue(zeta, i, 0));
         }
-        
-        linearProblem = dsCaseLinearProblemForMatrices(coefficients, zeta);
-        glp_set_col_bnds(linearProblem, glp_get_num_cols(linearProblem), GLP_LO, -1.0, 0.0);
-        glp_set_obj_coef(linearProblem, glp_get_num_cols(linearProblem), 1.0);
-        
-        
-        DSMatrixFree(coefficients);
-        if (slacks != NULL)
-                DSMatrixFree(slacks);
+        DSLinearProblemSetColumnBounds(problem, numberOfXi, -1.0, INFINITY);
+        DSLinearProblemSetObjectiveCoefficient(problem, numberOfXi, 1.0);
 bail:
-        return linearProblem;
+        return problem;
 }
 
-extern const bool DSCaseConditionsAreValid(const DSCase *aCase)
+/**
+ * \brief Determines if a set of dominance conditions can be strictly satisfied.
+ *
+ * \details The conditions are of the form Cd*yd + Ci*yi + delta > 0, where yd
+ * and yi are the logarithms of the dependent and independent variables.  The
+ * matrices need not come from a complete case; the conditions of a partial
+ * dominance signature are a subset of the conditions of every case that
+ * completes it, so if they cannot be satisfied none of those cases is valid.
+ *
+ * \param Cd The DSMatrix with the coefficients of the dependent variables.
+ * \param Ci The DSMatrix with the coefficients of the independent variables.
+ *        May be NULL if there are no independent variables.
+ * \param delta The DSMatrix with the constant terms of the conditions.
+ *
+ * \return A boolean value indicating if the conditions define a region with
+ *         non-empty interior.
+ */
+extern const bool DSCaseConditionMatricesAreValid(const DSMatrix * Cd, const DSMatrix * Ci, const DSMatrix * delta)
 {
         bool isValid = false;
-        glp_prob *linearProblem = NULL;
-        DSMatrix * U, * Zeta;
-        if (aCase == NULL) {
-                DSError(M_DS_CASE_NULL, A_DS_ERROR);
+        DSLinearProblem *linearProblem = NULL;
+        DSMatrix * C;
+        if (Cd == NULL || delta == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
                 goto bail;
         }
-        U = DSMatrixAppendMatrices(DSCaseCd(aCase), DSCaseCi(aCase), true);
-        Zeta = DSCaseDelta(aCase);
-        linearProblem = dsCaseLinearProblemForCaseValidity(U, Zeta);
-        DSMatrixFree(U);
+        if (dsCaseScreenConditions(Cd, Ci, delta, true) == DS_CASE_SCREEN_INVALID)
+                goto bail;
+        __sync_fetch_and_add(&dsScreeningCounters.linearProblems, 1);
+        if (Ci != NULL)
+                C = DSMatrixAppendMatrices(Cd, Ci, true);
+        else
+                C = DSMatrixCopy(Cd);
+        linearProblem = dsCaseLinearProblemForCaseValidity(C, delta);
+        DSMatrixFree(C);
         if (linearProblem != NULL) {
-                glp_simplex(linearProblem, NULL);
-                if (glp_get_obj_val(linearProblem) <= -1E-14 && glp_get_prim_stat(linearProblem) == GLP_FEAS) {
+                DSLinearProblemSolve(linearProblem);
+                if (DSLinearProblemObjectiveValue(linearProblem) <= -1E-14 && DSLinearProblemIsFeasible(linearProblem) == true) {
                         isValid = true;
                 }
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
         }
 bail:
         return isValid;
 }
 
+/**
+ * \brief The amount by which a boundary must be exceeded at every point
+ * satisfying the other boundaries for it to be considered redundant.
+ */
+#define DS_CASE_REDUNDANCY_TOLERANCE    1E-9
+
+/**
+ * \brief Data of one task testing if a boundary is redundant.
+ */
+typedef struct {
+        const DSMatrix * U;
+        const DSMatrix * zeta;
+        DSUInteger row;
+        bool * isRedundant;
+} ds_redundancy_task_t;
+
+/**
+ * \brief Tests if one boundary U_i*x + zeta_i > 0 is strictly implied by the
+ * other boundaries.
+ *
+ * \details The problem minimizes U_i*x subject to the other boundaries, with
+ * the boundary itself relaxed to U_i*x + zeta_i >= -1 so the problem is
+ * bounded.  The boundary is redundant if the minimum of U_i*x + zeta_i is
+ * positive; if the other boundaries cannot be satisfied, the boundary is kept.
+ */
+static void * dsCaseRedundantBoundaryTask(void * argument)
+{
+        ds_redundancy_task_t * task = argument;
+        DSLinearProblem * problem;
+        DSUInteger i, j, numberOfBoundaries, numberOfXi;
+        double zeta;
+        numberOfBoundaries = DSMatrixRows(task->U);
+        numberOfXi = DSMatrixColumns(task->U);
+        DSCaseLinearProgrammingContextBegin();
+        problem = dsCaseProblemAcquire(numberOfBoundaries, numberOfXi);
+        for (i = 0; i < numberOfBoundaries; i++) {
+                for (j = 0; j < numberOfXi; j++)
+                        DSLinearProblemSetCoefficient(problem, i, j, -DSMatrixElement(task->U, i, j));
+                DSLinearProblemSetConstant(problem, i, DSMatrixElement(task->zeta, i, 0));
+        }
+        zeta = DSMatrixElement(task->zeta, task->row, 0);
+        DSLinearProblemSetConstant(problem, task->row, zeta+1.0);
+        for (j = 0; j < numberOfXi; j++)
+                DSLinearProblemSetObjectiveCoefficient(problem, j, DSMatrixElement(task->U, task->row, j));
+        if (DSLinearProblemSolve(problem) == DS_LINEAR_PROBLEM_OPTIMAL)
+                *task->isRedundant = (DSLinearProblemObjectiveValue(problem) + zeta > DS_CASE_REDUNDANCY_TOLERANCE);
+        dsCaseProblemRelease(problem);
+        DSCaseLinearProgrammingContextEnd();
+        return NULL;
+}
+
+/**
+ * \brief Determines which boundaries U*x + zeta > 0 are implied by the others.
+ *
+ * \details Each boundary is tested with its own linear problem, and the
+ * problems are distributed over the thread pool.  Only boundaries that are
+ * strictly exceeded wherever the others hold are marked, so removing all the
+ * marked boundaries at once leaves the region unchanged; duplicated boundaries
+ * are not strictly implied by each other and must be removed beforehand.  The
+ * rows should be scaled to comparable magnitudes, as the tolerance of the test
+ * is absolute.
+ *
+ * \param U The DSMatrix with the coefficients of the independent variables.
+ * \param zeta The DSMatrix with the constant terms of the boundaries.
+ *
+ * \return An array with one element per boundary, indicating if the boundary
+ *         is redundant.  The caller is responsible for freeing the array.
+ */
+extern bool * DSCaseRedundantBoundaryRows(const DSMatrix * U, const DSMatrix * zeta)
+{
+        bool * isRedundant = NULL;
+        ds_redundancy_task_t * tasks = NULL;
+        DSUInteger i, numberOfBoundaries;
+        if (U == NULL || zeta == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (DSMatrixRows(U) != DSMatrixRows(zeta)) {
+                DSError(M_DS_WRONG ": Number of boundaries does not match", A_DS_ERROR);
+                goto bail;
+        }
+        numberOfBoundaries = DSMatrixRows(U);
+        isRedundant = DSSecureCalloc(sizeof(bool), numberOfBoundaries);
+        if (numberOfBoundaries < 2)
+                goto bail;
+        tasks = DSSecureCalloc(sizeof(ds_redundancy_task_t), numberOfBoundaries);
+        for (i = 0; i < numberOfBoundaries; i++) {
+                tasks[i].U = U;
+                tasks[i].zeta = zeta;
+                tasks[i].row = i;
+                tasks[i].isRedundant = isRedundant+i;
+        }
+        DSThreadPoolRun(dsCaseRedundantBoundaryTask, tasks, sizeof(ds_redundancy_task_t), numberOfBoundaries);
+        DSSecureFree(tasks);
+bail:
+        return isRedundant;
+}
+
+/**
+ * \brief Creates the steady-state equations of a case as the rows of a matrix.
+ *
+ * \details Each row is [Ad Ai B] for one equation, such that the steady state
+ * satisfies Ad*yd + Ai*yi = B.  The rows are taken from the GMA system of lazy
+ * cases and from the S-System of complete cases, so the inverse of Ad is
+ * never needed.
+ */
+static DSMatrix * dsCaseSteadyStateEquations(const DSCase * aCase)
+{
+        DSMatrix * equations = NULL;
+        const DSGMASystem * gma = aCase->pendingGMA;
+        const DSSSystem * ssys = aCase->ssys;
+        DSUInteger i, k, t1, t2, numberOfXd, numberOfXi;
+        double value, *row;
+        numberOfXd = DSVariablePoolNumberOfVariables(aCase->Xd);
+        numberOfXi = DSVariablePoolNumberOfVariables(aCase->Xi);
+        if (gma == NULL && ssys == NULL)
+                goto bail;
+        equations = DSMatrixCalloc(numberOfXd, numberOfXd+numberOfXi+1);
+        for (i = 0; i < numberOfXd; i++) {
+                t1 = DSCaseSig(aCase)[2*i]-1;
+                t2 = DSCaseSig(aCase)[2*i+1]-1;
+                if (gma != NULL) {
+                        row = &DSMatrixElement(equations, i, 0);
+                        DSGMASystemAddTermExponents(gma, 2*i, t1, 1.0, row, row+numberOfXd);
+                        DSGMASystemAddTermExponents(gma, 2*i+1, t2, -1.0, row, row+numberOfXd);
+                } else {
+                        for (k = 0; k < numberOfXd; k++) {
+                                value = DSMatrixDoubleValue(DSSSystemGd(ssys), i, k);
+                                value -= DSMatrixDoubleValue(DSSSystemHd(ssys), i, k);
+                                DSMatrixSetDoubleValue(equations, i, k, value);
+                        }
+                        for (k = 0; k < numberOfXi; k++) {
+                                value = DSMatrixDoubleValue(DSSSystemGi(ssys), i, k);
+                                value -= DSMatrixDoubleValue(DSSSystemHi(ssys), i, k);
+                                DSMatrixSetDoubleValue(equations, i, numberOfXd+k, value);
+                        }
+                }
+                if (gma != NULL)
+                        value = log10(DSMatrixDoubleValue(DSGMASystemBeta(gma), i, t2)/DSMatrixDoubleValue(DSGMASystemAlpha(gma), i, t1));
+                else
+                        value = log10(DSMatrixDoubleValue(DSSSystemBeta(ssys), i, 0)/DSMatrixDoubleValue(DSSSystemAlpha(ssys), i, 0));
+                DSMatrixSetDoubleValue(equations, i, numberOfXd+numberOfXi, value);
+        }
+bail:
+        return equations;
+}
+
+/**
+ * \brief Determines if the dominance conditions of a case can be satisfied at
+ * a steady state, without solving the S-System of the case.
+ *
+ * \details The linear problem has the logarithms of both the dependent and
+ * independent variables as unknowns, with the conditions of the case as
+ * inequalities and the steady-state equations as equalities.  When the
+ * S-System of the case has a solution, this problem is equivalent to the one
+ * solved by DSCaseIsValid, so a case for which this function returns false is
+ * never valid.  Lazy cases are not completed by this function.
+ *
+ * \param aCase The DSCase being tested.
+ * \param strict A boolean value indicating if the conditions must be strictly
+ *        satisfied.
+ *
+ * \return A boolean value that is false if the case cannot be valid.
+ */
+extern const bool DSCaseSteadyStateConditionsAreValid(const DSCase *aCase, const bool strict)
+{
+        bool isValid = false;
+        DSLinearProblem *linearProblem = NULL;
+        DSMatrix * equations = NULL, * coefficients = NULL, * bounds = NULL;
+        DSUInteger i, k, numberOfXd, numberOfXi, numberOfConditions, * rows = NULL;
+        double * knownPoint;
+        if (aCase == NULL) {
+                DSError(M_DS_CASE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (DSCaseCd(aCase) == NULL) {
+                isValid = true;
+                goto bail;
+        }
+        if (dsCaseScreenConditions(DSCaseCd(aCase), DSCaseCi(aCase), DSCaseDelta(aCase), strict) == DS_CASE_SCREEN_INVALID)
+                goto bail;
+        __sync_fetch_and_add(&dsScreeningCounters.linearProblems, 1);
+        equations = dsCaseSteadyStateEquations(aCase);
+        if (equations == NULL)
+                goto bail;
+        numberOfXd = DSMatrixColumns(DSCaseCd(aCase));
+        numberOfXi = DSMatrixColumns(equations)-numberOfXd-1;
+        numberOfConditions = DSMatrixRows(DSCaseCd(aCase));
+        coefficients = DSMatrixCalloc(numberOfConditions+numberOfXd, numberOfXd+numberOfXi+1);
+        bounds = DSMatrixCalloc(numberOfConditions+numberOfXd, 1);
+        for (i = 0; i < numberOfConditions; i++) {
+                for (k = 0; k < numberOfXd; k++)
+                        DSMatrixSetDoubleValue(coefficients, i, k, -DSMatrixDoubleValue(DSCaseCd(aCase), i, k));
+                for (k = 0; k < numberOfXi && DSCaseCi(aCase) != NULL; k++)
+                        DSMatrixSetDoubleValue(coefficients, i, numberOfXd+k, -DSMatrixDoubleValue(DSCaseCi(aCase), i, k));
+                DSMatrixSetDoubleValue(coefficients, i, numberOfXd+numberOfXi, -1.0);
+                DSMatrixSetDoubleValue(bounds, i, 0, DSMatrixDoubleValue(DSCaseDelta(aCase), i, 0));
+        }
+        for (i = 0; i < numberOfXd; i++) {
+                for (k = 0; k < numberOfXd+numberOfXi; k++)
+                        DSMatrixSetDoubleValue(coefficients, numberOfConditions+i, k, DSMatrixDoubleValue(equations, i, k));
+                DSMatrixSetDoubleValue(bounds, numberOfConditions+i, 0, DSMatrixDoubleValue(equations, i, numberOfXd+numberOfXi));
+        }
+        linearProblem = dsCaseLinearProblemForMatrices(coefficients, bounds, numberOfXd);
+        if (linearProblem == NULL)
+                goto bail;
+        rows = DSSecureMalloc(sizeof(DSUInteger)*(numberOfXd+1));
+        for (i = 0; i < numberOfXd; i++)
+                rows[i] = numberOfConditions+i;
+        dsCaseLinearProblemSetActiveRows(linearProblem, coefficients, bounds, numberOfXd, rows);
+        DSLinearProblemSetColumnBounds(linearProblem, numberOfXd+numberOfXi, -1.0, INFINITY);
+        DSLinearProblemSetObjectiveCoefficient(linearProblem, numberOfXd+numberOfXi, 1.0);
+        DSLinearProblemSolve(linearProblem);
+        if (DSLinearProblemIsFeasible(linearProblem) == true) {
+                if (strict == true)
+                        isValid = (DSLinearProblemObjectiveValue(linearProblem) <= -1E-14);
+                else
+                        isValid = (DSLinearProblemObjectiveValue(linearProblem) <= 0.0f);
+        }
+        /** The independent variables of the solution are a known point of the case **/
+        if (isValid == true && (knownPoint = dsCaseScreenKnownPointWithSize(numberOfXi)) != NULL) {
+                for (i = 0; i < numberOfXi; i++)
+                        knownPoint[i] = DSLinearProblemColumnValue(linearProblem, numberOfXd+i);
+        }
+        dsCaseProblemRelease(linearProblem);
+bail:
+        if (rows != NULL)
+                DSSecureFree(rows);
+        if (equations != NULL)
+                DSMatrixFree(equations);
+        if (coefficients != NULL)
+                DSMatrixFree(coefficients);
+        if (bounds != NULL)
+                DSMatrixFree(bounds);
+        return isValid;
+}
+
+extern const bool DSCaseConditionsAreValid(const DSCase *aCase)
+{
+        bool isValid = false;
+        if (aCase == NULL) {
+                DSError(M_DS_CASE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        isValid = DSCaseConditionMatricesAreValid(DSCaseCd(aCase), DSCaseCi(aCase), DSCaseDelta(aCase));
+bail:
+        return isValid;
+}
+
+/**
+ * \brief Determines if a complete case is valid.
+ *
+ * \details Lazy cases have no boundary matrices, and must be completed (see
+ * DSCaseCompleteConstruction) or tested with DSCaseIsValidWithNeighbor.
+ *
+ * \param aCase The DSCase being tested.
+ * \param strict A boolean value indicating if the conditions must be strictly
+ *        satisfied.
+ *
+ * \return A boolean value indicating if the case is valid.
+ */
 extern const bool DSCaseIsValid(const DSCase *aCase, const bool strict)
 {
         bool isValid = false;
-        glp_prob *linearProblem = NULL;
+        DSLinearProblem *linearProblem = NULL;
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
                 goto bail;
         }
+        if (aCase->pendingGMA != NULL) {
+                DSError(M_DS_WRONG ": Lazy case has not been completed", A_DS_ERROR);
+                goto bail;
+        }
         if (DSCaseHasSolution(aCase) == false) {
                 goto bail;
         }
+        if (dsCaseScreenConditions(DSCaseU(aCase), NULL, DSCaseZeta(aCase), strict) == DS_CASE_SCREEN_INVALID)
+                goto bail;
+        if (dsCaseScreenKnownPoint(DSCaseU(aCase), DSCaseZeta(aCase), strict) == DS_CASE_SCREEN_VALID) {
+                isValid = true;
+                goto bail;
+        }
+        __sync_fetch_and_add(&dsScreeningCounters.linearProblems, 1);
         linearProblem = dsCaseLinearProblemForCaseValidity(DSCaseU(aCase), DSCaseZeta(aCase));
         if (linearProblem != NULL) {
-                glp_simplex(linearProblem, NULL);
+                DSLinearProblemSolve(linearProblem);
                 if (strict == true) {
-                        if (glp_get_obj_val(linearProblem) <= -1E-14 && glp_get_prim_stat(linearProblem) == GLP_FEAS) {
+                        if (DSLinearProblemObjectiveValue(linearProblem) <= -1E-14 && DSLinearProblemIsFeasible(linearProblem) == true) {
                                 isValid = true;
                         }
                 } else {
-                        if (glp_get_obj_val(linearProblem) <= 0.0f && glp_get_prim_stat(linearProblem) == GLP_FEAS) {
+                        if (DSLinearProblemObjectiveValue(linearProblem) <= 0.0f && DSLinearProblemIsFeasible(linearProblem) == true) {
                                 isValid = true;
                         }
                 }
-                glp_delete_prob(linearProblem);
+                if (isValid == true && DSCaseU(aCase) != NULL)
+                        dsCaseScreenSetKnownPoint(linearProblem, DSMatrixColumns(DSCaseU(aCase)));
+                dsCaseProblemRelease(linearProblem);
         }
 bail:
         return isValid;
 }
 
+/**
+ * \brief Determines if a case is valid, completing lazy cases only if they may
+ * be valid.
+ *
+ * \details Lazy cases are first tested with
+ * DSCaseSteadyStateConditionsAreValid, and are completed using the neighbor
+ * (see DSCaseCompleteConstruction) only if this test does not rule them out.
+ * Invalid lazy cases therefore never solve their S-System.  When the
+ * S-System of a completed case has a solution, the steady-state test is
+ * equivalent to the test of its boundaries, which is therefore not repeated.
+ *
+ * \param aCase The DSCase being tested, which is completed if it is lazy and
+ *        may be valid.
+ * \param strict A boolean value indicating if the conditions must be strictly
+ *        satisfied.
+ * \param neighbor A complete case of the same design space, or NULL.
+ *
+ * \return A boolean value indicating if the case is valid.
+ */
+extern const bool DSCaseIsValidWithNeighbor(DSCase *aCase, const bool strict, const DSCase * neighbor)
+{
+        bool isValid = false;
+        if (aCase == NULL) {
+                DSError(M_DS_CASE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (aCase->pendingGMA == NULL) {
+                isValid = DSCaseIsValid(aCase, strict);
+                goto bail;
+        }
+        if (DSCaseSteadyStateConditionsAreValid(aCase, strict) == false)
+                goto bail;
+        DSCaseCompleteConstruction(aCase, neighbor);
+        isValid = DSCaseHasSolution(aCase);
+bail:
+        return isValid;
+}
+
 __deprecated extern const bool DSCaseIsValidInStateSpace(const DSCase *aCase) {
         return DSCaseIsConsistent(aCase);
 }
@@ -196,7 +998,7 @@ __deprecated extern const bool DSCaseIsValidInStateSpace(const DSCase *aCase) {
 extern const bool DSCaseIsConsistent(const DSCase *aCase)
 {
         bool isValid = false;
-        glp_prob *linearProblem = NULL;
+        DSLinearProblem *linearProblem = NULL;
         DSMatrix * C;
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
@@ -205,11 +1007,11 @@ extern const bool DSCaseIsConsistent(const DSCase *aCase)
         C  = DSMatrixAppendMatrices(DSCaseCd(aCase), DSCaseCi(aCase), true);
         linearProblem = dsCaseLinearProblemForCaseValidity(C, DSCaseDelta(aCase));
         if (linearProblem != NULL) {
-                glp_simplex(linearProblem, NULL);
-                if (glp_get_obj_val(linearProblem) <= -1E-14 && glp_get_prim_stat(linearProblem) == GLP_FEAS) {
+                DSLinearProblemSolve(linearProblem);
+                if (DSLinearProblemObjectiveValue(linearProblem) <= -1E-14 && DSLinearProblemIsFeasible(linearProblem) == true) {
                         isValid = true;
                 }
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
         }
 bail:
         return isValid;
@@ -367,7 +1169,7 @@ bail:
 extern DSVariablePool * DSCaseConsistentParameterAndStateSet(const DSCase *aCase)
 {
         DSVariablePool * Xi = NULL;
-        glp_prob *linearProblem = NULL;
+        DSLinearProblem *linearProblem = NULL;
         DSUInteger i;
         DSMatrix * C;
         char * name;
@@ -379,23 +1181,23 @@ extern DSVariablePool * DSCaseConsistentParameterAndStateSet(const DSCase *aCase
         linearProblem = dsCaseLinearProblemForCaseValidity(C, DSCaseDelta(aCase));
         DSMatrixFree(C);
         if (linearProblem != NULL) {
-                glp_simplex(linearProblem, NULL);
-                if (glp_get_obj_val(linearProblem) <= -1E-14 && glp_get_prim_stat(linearProblem) == GLP_FEAS) {
+                DSLinearProblemSolve(linearProblem);
+                if (DSLinearProblemObjectiveValue(linearProblem) <= -1E-14 && DSLinearProblemIsFeasible(linearProblem) == true) {
                         Xi = DSVariablePoolAlloc();
                         for (i = 0; i < DSVariablePoolNumberOfVariables(DSCaseXd(aCase)); i++) {
                                 name = DSVariableName(DSVariablePoolVariableAtIndex(DSCaseXd(aCase), i));
                                 DSVariablePoolAddVariableWithName(Xi, name);
-                                DSVariablePoolSetValueForVariableWithName(Xi, name, pow(10, glp_get_col_prim(linearProblem, i+1)));
+                                DSVariablePoolSetValueForVariableWithName(Xi, name, pow(10, DSLinearProblemColumnValue(linearProblem, i)));
                         }
                         for (i = 0; i < DSVariablePoolNumberOfVariables(DSCaseXi(aCase)); i++) {
                                 name = DSVariableName(DSVariablePoolVariableAtIndex(DSCaseXi(aCase), i));
                                 DSVariablePoolAddVariableWithName(Xi, name);
-                                DSVariablePoolSetValueForVariableWithName(Xi, name, pow(10, glp_get_col_prim(linearProblem, DSVariablePoolNumberOfVariables(DSCaseXd(aCase))+i+1)));
+                                DSVariablePoolSetValueForVariableWithName(Xi, name, pow(10, DSLinearProblemColumnValue(linearProblem, DSVariablePoolNumberOfVariables(DSCaseXd(aCase))+i)));
                         }
                 } else {
                         printf("invalid.\n");
                 }
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
         }
 bail:
         return Xi;
@@ -404,7 +1206,7 @@ bail:
 extern DSVariablePool * DSCaseValidParameterAndStateSet(const DSCase *aCase)
 {
         DSVariablePool * Xi = NULL;
-        glp_prob *linearProblem = NULL;
+        DSLinearProblem *linearProblem = NULL;
         DSUInteger i;
         DSMatrix * C, *temp1, *temp2;
         char * name;
@@ -425,23 +1227,23 @@ extern DSVariablePool * DSCaseValidParameterAndStateSet(const DSCase *aCase)
         DSMatrixFree(C);
         DSMatrixFree(temp1);
         if (linearProblem != NULL) {
-                glp_simplex(linearProblem, NULL);
-                if (glp_get_obj_val(linearProblem) <= -1E-14 && glp_get_prim_stat(linearProblem) == GLP_FEAS) {
+                DSLinearProblemSolve(linearProblem);
+                if (DSLinearProblemObjectiveValue(linearProblem) <= -1E-14 && DSLinearProblemIsFeasible(linearProblem) == true) {
                         Xi = DSVariablePoolAlloc();
                         for (i = 0; i < DSVariablePoolNumberOfVariables(DSCaseXd(aCase)); i++) {
                                 name = DSVariableName(DSVariablePoolVariableAtIndex(DSCaseXd(aCase), i));
                                 DSVariablePoolAddVariableWithName(Xi, name);
-                                DSVariablePoolSetValueForVariableWithName(Xi, name, pow(10, glp_get_col_prim(linearProblem, i+1)));
+                                DSVariablePoolSetValueForVariableWithName(Xi, name, pow(10, DSLinearProblemColumnValue(linearProblem, i)));
                         }
                         for (i = 0; i < DSVariablePoolNumberOfVariables(DSCaseXi(aCase)); i++) {
                                 name = DSVariableName(DSVariablePoolVariableAtIndex(DSCaseXi(aCase), i));
                                 DSVariablePoolAddVariableWithName(Xi, name);
-                                DSVariablePoolSetValueForVariableWithName(Xi, name, pow(10, glp_get_col_prim(linearProblem, DSVariablePoolNumberOfVariables(DSCaseXd(aCase))+i+1)));
+                                DSVariablePoolSetValueForVariableWithName(Xi, name, pow(10, DSLinearProblemColumnValue(linearProblem, DSVariablePoolNumberOfVariables(DSCaseXd(aCase))+i)));
                         }
                 } else {
                         printf("invalid.\n");
                 }
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
         }
 bail:
         return Xi;
@@ -450,7 +1252,7 @@ bail:
 extern DSVariablePool * DSCaseValidParameterSet(const DSCase *aCase)
 {
         DSVariablePool * Xi = NULL;
-        glp_prob *linearProblem = NULL;
+        DSLinearProblem *linearProblem = NULL;
         DSUInteger i;
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
@@ -460,82 +1262,110 @@ extern DSVariablePool * DSCaseValidParameterSet(const DSCase *aCase)
                 goto bail;
         linearProblem = dsCaseLinearProblemForCaseValidity(DSCaseU(aCase), DSCaseZeta(aCase));
         if (linearProblem != NULL) {
-                glp_simplex(linearProblem, NULL);
-                if (glp_get_obj_val(linearProblem) <= -1E-14 && glp_get_prim_stat(linearProblem) == GLP_FEAS) {
+                DSLinearProblemSolve(linearProblem);
+                if (DSLinearProblemObjectiveValue(linearProblem) <= -1E-14 && DSLinearProblemIsFeasible(linearProblem) == true) {
                         Xi = DSVariablePoolCopy(DSCaseXi(aCase));
                         DSVariablePoolSetReadWriteAdd(Xi);
                         for (i = 0; i < DSVariablePoolNumberOfVariables(Xi); i++) {
-                                DSVariableSetValue(DSVariablePoolAllVariables(Xi)[i], pow(10, glp_get_col_prim(linearProblem, i+1)));
+                                DSVariableSetValue(DSVariablePoolAllVariables(Xi)[i], pow(10, DSLinearProblemColumnValue(linearProblem, i)));
                         }
                 }
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
         }
 bail:
         return Xi;
 }
 
-extern DSVariablePool * DSCaseValidParameterSetByOptimizingFunction(const DSCase *aCase, const char * function, const bool minimize)
+/**
+ * \brief Finds the parameter set of a valid case that optimizes a parsed
+ * optimization function.
+ *
+ * \details The log10 values of the independent variables are bounded between
+ * -20 and 20.  Within a linear programming context, the problem object of the
+ * thread is reused and warm started, so the same function can be optimized
+ * for many cases without parsing it or creating a linear problem for each.
+ *
+ * \param aCase The DSCase whose region of validity is searched.
+ * \param function The DSOptimizationFunction being optimized, parsed with the
+ *        variables of the design space of the case.
+ * \param minimize A boolean value indicating if the function is minimized or
+ *        maximized.
+ *
+ * \return A DSVariablePool with the values of the independent variables at
+ *         the optimum, or NULL if the case is not valid or the problem has no
+ *         optimal solution.
+ *
+ * \see DSOptimizationFunctionByParsingString
+ */
+extern DSVariablePool * DSCaseValidParameterSetWithOptimizationFunction(const DSCase *aCase, const DSOptimizationFunction * function, const bool minimize)
 {
         DSVariablePool * Xi = NULL;
-        glp_prob *linearProblem = NULL;
+        DSLinearProblem *linearProblem = NULL;
         DSUInteger i;
-        DSMatrixArray * objective;
-        DSMatrix * Od, *U, *Zeta;
+        DSMatrixArray * objective = NULL;
+        DSMatrix * Oi, *U;
         DSMatrix * delta;
-        DSExpression * expression;
-        char * processedFunction;
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
                 goto bail;
         }
-        if (DSCaseIsValid(aCase, false) == false)
-                goto bail;
-        expression = DSExpressionByParsingString(function);
-        if (expression == NULL) {
-                DSError(M_DS_NULL ": Could not parse function string", A_DS_ERROR);
+        if (function == NULL) {
+                DSError(M_DS_NULL ": Optimization function is NULL", A_DS_ERROR);
                 goto bail;
         }
-        processedFunction = DSExpressionAsString(expression);
-        DSExpressionFree(expression);
-        objective = DSCaseParseOptimizationFunction(aCase, processedFunction);
-        DSSecureFree(processedFunction);
+        if (DSCaseIsValid(aCase, false) == false)
+                goto bail;
+        objective = DSOptimizationFunctionMatricesForCase(function, aCase);
         if (objective == NULL) {
                 goto bail;
         }
         U = DSMatrixCopy(DSCaseU(aCase));
-        Zeta = DSMatrixCopy(DSCaseZeta(aCase));
-        Od = DSMatrixArrayMatrix(objective, 0);
+        Oi = DSMatrixArrayMatrix(objective, 0);
         delta = DSMatrixArrayMatrix(objective, 1);
         DSMatrixMultiplyByScalar(U, -1.0);
-        linearProblem = dsCaseLinearProblemForMatrices(U, Zeta);
+        linearProblem = dsCaseLinearProblemForMatrices(U, DSCaseZeta(aCase), 0);
         DSMatrixFree(U);
-        DSMatrixFree(Zeta);
         if (linearProblem == NULL) {
-                DSMatrixArrayFree(objective);
                 goto bail;
         }
-        if (minimize == false) {
-                glp_set_obj_dir(linearProblem, GLP_MAX);
-        }
-        for (i = 0; i < DSMatrixColumns(Od); i++) {
-                glp_set_obj_coef(linearProblem, i+1, DSMatrixDoubleValue(Od, 0, i));
+        DSLinearProblemSetMaximize(linearProblem, (minimize == false));
+        for (i = 0; i < DSMatrixColumns(Oi); i++) {
+                DSLinearProblemSetObjectiveCoefficient(linearProblem, i, DSMatrixDoubleValue(Oi, 0, i));
                 // Limits on optimization bounded between 1e-20 and 1e20
-                glp_set_col_bnds(linearProblem, i+1, GLP_DB, -20, 20);
+                DSLinearProblemSetColumnBounds(linearProblem, i, -20, 20);
         }
-        glp_set_obj_coef(linearProblem, 0, DSMatrixDoubleValue(delta, 0, 0));
-        glp_simplex(linearProblem, NULL);
-        if (glp_get_status(linearProblem) != GLP_OPT) {
-                glp_delete_prob(linearProblem);
-                DSMatrixArrayFree(objective);
+        DSLinearProblemSetObjectiveConstant(linearProblem, DSMatrixDoubleValue(delta, 0, 0));
+        if (DSLinearProblemSolve(linearProblem) != DS_LINEAR_PROBLEM_OPTIMAL) {
                 goto bail;
         }
         Xi = DSVariablePoolCopy(DSCaseXi(aCase));
         DSVariablePoolSetReadWriteAdd(Xi);
         for (i = 0; i < DSVariablePoolNumberOfVariables(Xi); i++) {
-                DSVariableSetValue(DSVariablePoolAllVariables(Xi)[i], pow(10, glp_get_col_prim(linearProblem, i+1)));
+                DSVariableSetValue(DSVariablePoolAllVariables(Xi)[i], pow(10, DSLinearProblemColumnValue(linearProblem, i)));
+        }
+bail:
+        if (linearProblem != NULL)
+                dsCaseProblemRelease(linearProblem);
+        if (objective != NULL)
+                DSMatrixArrayFree(objective);
+        return Xi;
+}
+
+extern DSVariablePool * DSCaseValidParameterSetByOptimizingFunction(const DSCase *aCase, const char * function, const bool minimize)
+{
+        DSVariablePool * Xi = NULL;
+        DSOptimizationFunction * objective = NULL;
+        if (aCase == NULL) {
+                DSError(M_DS_CASE_NULL, A_DS_ERROR);
+                goto bail;
         }
-        glp_delete_prob(linearProblem);
-        DSMatrixArrayFree(objective);
+        /** Validity is tested by DSCaseValidParameterSetWithOptimizationFunction **/
+        objective = DSOptimizationFunctionByParsingString(DSCaseXd(aCase), DSCaseXi(aCase), function);
+        if (objective == NULL) {
+                goto bail;
+        }
+        Xi = DSCaseValidParameterSetWithOptimizationFunction(aCase, objective, minimize);
+        DSOptimizationFunctionFree(objective);
 bail:
         return Xi;
 }
@@ -640,7 +1470,7 @@ bail:
         return freeVariables;
 }
 
-static DSUInteger dsCaseSetDependentAndIndependentVariableBoundsLinearProblem(const DSCase *aCase, glp_prob *linearProblem,  const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds)
+static DSUInteger dsCaseSetDependentAndIndependentVariableBoundsProblem(const DSCase *aCase, DSLinearProblem *problem,  const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds)
 {
         DSUInteger i, variableIndex, freeVariables = 0;
         const DSVariable * lowVariable, *highVariable;
@@ -657,12 +1487,12 @@ static DSUInteger dsCaseSetDependentAndIndependentVariableBoundsLinearProblem(co
                 DSError(M_DS_WRONG ": Number of variables to bound must match", A_DS_ERROR);
                 goto bail;
         }
-        if (linearProblem == NULL) {
-                DSError(M_DS_NULL ": Linear problem is NULL", A_DS_WARN);
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_WARN);
                 goto bail;
         }
-        for (i = 0; i < glp_get_num_cols(linearProblem); i++) {
-                glp_set_col_bnds(linearProblem, i+1, GLP_FR, 0.0, 0.0);
+        for (i = 0; i < DSLinearProblemNumberOfColumns(problem); i++) {
+                DSLinearProblemSetColumnBounds(problem, i, -INFINITY, INFINITY);
         }
         for (i = 0; i < DSVariablePoolNumberOfVariables(lowerBounds); i++) {
                 
@@ -694,17 +1524,10 @@ static DSUInteger dsCaseSetDependentAndIndependentVariableBoundsLinearProblem(co
                         freeVariables = 0;
                         break;
                 }
-                if (low == -INFINITY && high == INFINITY)
-                        glp_set_col_bnds(linearProblem, variableIndex+1, GLP_FR, 0.0, 0.0);
-                else if (low == -INFINITY)
-                        glp_set_col_bnds(linearProblem, variableIndex+1, GLP_UP, 0.0, log10(high));
-                else if (high == INFINITY)
-                        glp_set_col_bnds(linearProblem, variableIndex+1, GLP_LO, log10(low), 0.0);
-                else if (low == high)
-                        glp_set_col_bnds(linearProblem, variableIndex+1, GLP_FX, log10(low), 0.0);
-                else
-                        glp_set_col_bnds(linearProblem, variableIndex+1, GLP_DB, log10(low), log10(high));
-                if (glp_get_col_type(linearProblem, variableIndex+1) != GLP_FX)
+                DSLinearProblemSetColumnBounds(problem, variableIndex,
+                                               (low == -INFINITY) ? -INFINITY : log10(low),
+                                               log10(high));
+                if (DSLinearProblemColumnIsFixed(problem, variableIndex) == false)
                         freeVariables++;
                 
         }
@@ -712,7 +1535,16 @@ bail:
         return freeVariables;
 }
 
-static DSUInteger dsCaseSetVariableBoundsLinearProblem(const DSCase *aCase, glp_prob *linearProblem,  const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds)
+/**
+ * \brief Bounds the independent variables of a DSLinearProblem by the log10
+ * of the values in two variable pools.
+ *
+ * \details All other variables, including the slack variable of a validity
+ * problem, are made free.
+ *
+ * \return The number of bounded variables that are not fixed.
+ */
+static DSUInteger dsCaseSetVariableBoundsProblem(const DSCase *aCase, DSLinearProblem *problem,  const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds)
 {
         DSUInteger i, variableIndex, freeVariables = 0;
         const DSVariable * lowVariable, *highVariable;
@@ -729,12 +1561,12 @@ static DSUInteger dsCaseSetVariableBoundsLinearProblem(const DSCase *aCase, glp_
                 DSError(M_DS_WRONG ": Number of variables to bound must match", A_DS_ERROR);
                 goto bail;
         }
-        if (linearProblem == NULL) {
-                DSError(M_DS_NULL ": Linear problem is NULL", A_DS_WARN);
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_WARN);
                 goto bail;
         }
-        for (i = 0; i < glp_get_num_cols(linearProblem); i++) {
-                glp_set_col_bnds(linearProblem, i+1, GLP_FR, 0.0, 0.0);
+        for (i = 0; i < DSLinearProblemNumberOfColumns(problem); i++) {
+                DSLinearProblemSetColumnBounds(problem, i, -INFINITY, INFINITY);
         }
         for (i = 0; i < DSVariablePoolNumberOfVariables(lowerBounds); i++) {
                 
@@ -762,17 +1594,10 @@ static DSUInteger dsCaseSetVariableBoundsLinearProblem(const DSCase *aCase, glp_
                         freeVariables = 0;
                         break;
                 }
-                if (low == -INFINITY && high == INFINITY)
-                        glp_set_col_bnds(linearProblem, variableIndex+1, GLP_FR, 0.0, 0.0);
-                else if (low == -INFINITY)
-                        glp_set_col_bnds(linearProblem, variableIndex+1, GLP_UP, 0.0, log10(high));
-                else if (high == INFINITY)
-                        glp_set_col_bnds(linearProblem, variableIndex+1, GLP_LO, log10(low), 0.0);
-                else if (low == high)
-                        glp_set_col_bnds(linearProblem, variableIndex+1, GLP_FX, log10(low), 0.0);
-                else
-                        glp_set_col_bnds(linearProblem, variableIndex+1, GLP_DB, log10(low), log10(high));
-                if (glp_get_col_type(linearProblem, variableIndex+1) != GLP_FX)
+                DSLinearProblemSetColumnBounds(problem, variableIndex,
+                                               (low == -INFINITY) ? -INFINITY : log10(low),
+                                               log10(high));
+                if (DSLinearProblemColumnIsFixed(problem, variableIndex) == false)
                         freeVariables++;
                 
         }
@@ -783,7 +1608,7 @@ bail:
 extern DSVariablePool * DSCaseValidParameterSetAtSlice(const DSCase *aCase, const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds)
 {
         bool isValid = false;
-        glp_prob *linearProblem = NULL;
+        DSLinearProblem *linearProblem = NULL;
         DSVariablePool * Xi = NULL;
         DSUInteger i;
         if (aCase == NULL) {
@@ -806,9 +1631,9 @@ extern DSVariablePool * DSCaseValidParameterSetAtSlice(const DSCase *aCase, cons
                 DSError(M_DS_NULL ": Linear problem was not created", A_DS_WARN);
                 goto bail;
         }
-        if (dsCaseSetVariableBoundsLinearProblem(aCase, linearProblem, lowerBounds, upperBounds) <= DSVariablePoolNumberOfVariables(DSCaseXi(aCase))) {
-                glp_simplex(linearProblem, NULL);
-                if (glp_get_obj_val(linearProblem) <= -1E-14 && glp_get_prim_stat(linearProblem) == GLP_FEAS)
+        if (dsCaseSetVariableBoundsProblem(aCase, linearProblem, lowerBounds, upperBounds) <= DSVariablePoolNumberOfVariables(DSCaseXi(aCase))) {
+                DSLinearProblemSolve(linearProblem);
+                if (DSLinearProblemObjectiveValue(linearProblem) <= -1E-14 && DSLinearProblemIsFeasible(linearProblem) == true)
                         isValid = true;
         }
         if (isValid == true) {
@@ -816,29 +1641,41 @@ extern DSVariablePool * DSCaseValidParameterSetAtSlice(const DSCase *aCase, cons
                 DSVariablePoolSetReadWrite(Xi);
                 for (i = 0; i < DSVariablePoolNumberOfVariables(Xi); i++) {
                         DSVariableSetValue(DSVariablePoolAllVariables(Xi)[i],
-                                           pow(10, glp_get_col_prim(linearProblem, i+1)));
+                                           pow(10, DSLinearProblemColumnValue(linearProblem, i)));
                 }
         }
-        glp_delete_prob(linearProblem);
+        dsCaseProblemRelease(linearProblem);
 bail:
         return Xi;
 }
 
-extern DSVariablePool * DSCaseValidParameterSetAtSliceByOptimizingFunction(const DSCase *aCase,
-                                                                           const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds,
-                                                                           const char * function, const bool minimize)
+/**
+ * \brief Finds the parameter set of a case within a slice that optimizes a
+ * parsed optimization function.
+ *
+ * \details The problem is solved as in
+ * DSCaseValidParameterSetWithOptimizationFunction, with the independent
+ * variables bounded by the slice instead.
+ *
+ * \see DSCaseValidParameterSetWithOptimizationFunction
+ */
+extern DSVariablePool * DSCaseValidParameterSetAtSliceWithOptimizationFunction(const DSCase *aCase,
+                                                                               const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds,
+                                                                               const DSOptimizationFunction * function, const bool minimize)
 {
-        glp_prob *linearProblem = NULL;
+        DSLinearProblem *linearProblem = NULL;
         DSVariablePool * Xi = NULL;
         DSUInteger i;
-        DSMatrixArray * objective;
-        DSMatrix * Oi, *delta, *U, *Zeta;
-        DSExpression * expression;
-        char * processedFunction;
+        DSMatrixArray * objective = NULL;
+        DSMatrix * Oi, *delta, *U;
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
                 goto bail;
         }
+        if (function == NULL) {
+                DSError(M_DS_NULL ": Optimization function is NULL", A_DS_ERROR);
+                goto bail;
+        }
         if (DSCaseHasSolution(aCase) == false) {
                 goto bail;
         }
@@ -850,63 +1687,64 @@ extern DSVariablePool * DSCaseValidParameterSetAtSliceByOptimizingFunction(const
                 DSError(M_DS_WRONG ": Number of variables to bound must match", A_DS_ERROR);
                 goto bail;
         }
-        expression = DSExpressionByParsingString(function);
-        if (expression == NULL) {
-                DSError(M_DS_NULL ": Could not parse function string", A_DS_ERROR);
-                goto bail;
-        }
-        processedFunction = DSExpressionAsString(expression);
-        DSExpressionFree(expression);
-        objective = DSCaseParseOptimizationFunction(aCase, processedFunction);
-        DSSecureFree(processedFunction);
+        objective = DSOptimizationFunctionMatricesForCase(function, aCase);
         if (objective == NULL) {
                 goto bail;
         }
         Oi = DSMatrixArrayMatrix(objective, 0);
         delta = DSMatrixArrayMatrix(objective, 1);
         U = DSMatrixCopy(DSCaseU(aCase));
-        Zeta = DSMatrixCopy(DSCaseZeta(aCase));
         DSMatrixMultiplyByScalar(U, -1.0);
-        linearProblem = dsCaseLinearProblemForMatrices(U, Zeta);
+        linearProblem = dsCaseLinearProblemForMatrices(U, DSCaseZeta(aCase), 0);
         DSMatrixFree(U);
-        DSMatrixFree(Zeta);        if (linearProblem == NULL) {
+        if (linearProblem == NULL) {
                 DSError(M_DS_NULL ": Linear problem is null", A_DS_WARN);
-                DSMatrixArrayFree(objective);
                 goto bail;
         }
-        if (dsCaseSetVariableBoundsLinearProblem(aCase, linearProblem, lowerBounds, upperBounds) > DSVariablePoolNumberOfVariables(DSCaseXi(aCase))) {
-                glp_delete_prob(linearProblem);
-                DSMatrixArrayFree(objective);
+        if (dsCaseSetVariableBoundsProblem(aCase, linearProblem, lowerBounds, upperBounds) > DSVariablePoolNumberOfVariables(DSCaseXi(aCase))) {
+                goto bail;
+        }
+        for (i = 0; i < DSMatrixColumns(Oi); i++) {
+                DSLinearProblemSetObjectiveCoefficient(linearProblem, i, DSMatrixDoubleValue(Oi, 0, i));
+        }
+        DSLinearProblemSetMaximize(linearProblem, (minimize == false));
+        DSLinearProblemSetObjectiveConstant(linearProblem, DSMatrixDoubleValue(delta, 0, 0));
+        if (DSLinearProblemSolve(linearProblem) != DS_LINEAR_PROBLEM_OPTIMAL) {
                 goto bail;
         }
-        for (i = 0; i < DSMatrixColumns(Oi); i++) {
-                glp_set_obj_coef(linearProblem, i+1, DSMatrixDoubleValue(Oi, 0, i));
-        }
-        if (minimize == false) {
-                glp_set_obj_dir(linearProblem, GLP_MAX);
-        }
-        glp_set_obj_coef(linearProblem, 0, DSMatrixDoubleValue(delta, 0, 0));
-        if (linearProblem != NULL) {
-                glp_simplex(linearProblem, NULL);
-                if (glp_get_status(linearProblem) != GLP_OPT) {
-                        glp_delete_prob(linearProblem);
-                        DSMatrixArrayFree(objective);
-                        goto bail;
-                }
-                Xi = DSVariablePoolCopy(DSCaseXi(aCase));
-                DSVariablePoolSetReadWriteAdd(Xi);
-                for (i = 0; i < DSVariablePoolNumberOfVariables(Xi); i++) {
-                        DSVariableSetValue(DSVariablePoolAllVariables(Xi)[i], pow(10, glp_get_col_prim(linearProblem, i+1)));
-                }
-        }
         Xi = DSVariablePoolCopy(DSCaseXi(aCase));
         DSVariablePoolSetReadWrite(Xi);
         for (i = 0; i < DSVariablePoolNumberOfVariables(Xi); i++) {
                 DSVariableSetValue(DSVariablePoolAllVariables(Xi)[i],
-                                   pow(10, glp_get_col_prim(linearProblem, i+1)));
+                                   pow(10, DSLinearProblemColumnValue(linearProblem, i)));
+        }
+bail:
+        if (linearProblem != NULL)
+                dsCaseProblemRelease(linearProblem);
+        if (objective != NULL)
+                DSMatrixArrayFree(objective);
+        return Xi;
+}
+
+extern DSVariablePool * DSCaseValidParameterSetAtSliceByOptimizingFunction(const DSCase *aCase,
+                                                                           const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds,
+                                                                           const char * function, const bool minimize)
+{
+        DSVariablePool * Xi = NULL;
+        DSOptimizationFunction * objective = NULL;
+        if (aCase == NULL) {
+                DSError(M_DS_CASE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (DSCaseHasSolution(aCase) == false) {
+                goto bail;
+        }
+        objective = DSOptimizationFunctionByParsingString(DSCaseXd(aCase), DSCaseXi(aCase), function);
+        if (objective == NULL) {
+                goto bail;
         }
-        DSMatrixArrayFree(objective);
-        glp_delete_prob(linearProblem);
+        Xi = DSCaseValidParameterSetAtSliceWithOptimizationFunction(aCase, lowerBounds, upperBounds, objective, minimize);
+        DSOptimizationFunctionFree(objective);
 bail:
         return Xi;
 }
@@ -914,7 +1752,7 @@ bail:
 extern const bool DSCaseIsValidAtSlice(const DSCase *aCase, const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds, const bool strict)
 {
         bool isValid = false;
-        glp_prob *linearProblem = NULL;
+        DSLinearProblem *linearProblem = NULL;
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
                 goto bail;
@@ -943,21 +1781,21 @@ extern const bool DSCaseIsValidAtSlice(const DSCase *aCase, const DSVariablePool
                 DSError(M_DS_NULL ": Linear problem was not created", A_DS_WARN);
                 goto bail;
         }
-        if (dsCaseSetVariableBoundsLinearProblem(aCase, linearProblem, lowerBounds, upperBounds) <= DSVariablePoolNumberOfVariables(DSCaseXi(aCase))) {
-                glp_simplex(linearProblem, NULL);
+        if (dsCaseSetVariableBoundsProblem(aCase, linearProblem, lowerBounds, upperBounds) <= DSVariablePoolNumberOfVariables(DSCaseXi(aCase))) {
+                DSLinearProblemSolve(linearProblem);
 //                if (DSCaseNumber(aCase) == 7) {
-//                        printf("Case 4: %.15f %i [%i]", glp_get_obj_val(linearProblem), glp_get_prim_stat(linearProblem), DSCaseIsValidAtPoint(aCase, lowerBounds));
+//                        printf("Case 4: %.15f %i [%i]", DSLinearProblemObjectiveValue(linearProblem), DSLinearProblemStatus(linearProblem), DSCaseIsValidAtPoint(aCase, lowerBounds));
 //                }
                 if (strict == true) {
-                        if (glp_get_obj_val(linearProblem) <= -1E-14 && glp_get_prim_stat(linearProblem) == GLP_FEAS)
+                        if (DSLinearProblemObjectiveValue(linearProblem) <= -1E-14 && DSLinearProblemIsFeasible(linearProblem) == true)
                                 isValid = true;
                 } else {
-                        if (glp_get_obj_val(linearProblem) <= 0.0f && glp_get_prim_stat(linearProblem) == GLP_FEAS)
+                        if (DSLinearProblemObjectiveValue(linearProblem) <= 0.0f && DSLinearProblemIsFeasible(linearProblem) == true)
                                 isValid = true;
                 }
         }
         
-        glp_delete_prob(linearProblem);
+        dsCaseProblemRelease(linearProblem);
 bail:
         return isValid;
 }
@@ -965,7 +1803,7 @@ bail:
 extern const bool DSCaseIsConsistentAtSlice(const DSCase *aCase, const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds, const bool strict)
 {
         bool isValid = false;
-        glp_prob *linearProblem = NULL;
+        DSLinearProblem *linearProblem = NULL;
         
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
@@ -996,18 +1834,18 @@ extern const bool DSCaseIsConsistentAtSlice(const DSCase *aCase, const DSVariabl
                 DSError(M_DS_NULL ": Linear problem was not created", A_DS_WARN);
                 goto bail;
         }
-        if (dsCaseSetDependentAndIndependentVariableBoundsLinearProblem(aCase, linearProblem, lowerBounds, upperBounds) <= DSVariablePoolNumberOfVariables(DSCaseXi(aCase)) + DSVariablePoolNumberOfVariables(DSCaseXd(aCase))) {
-                glp_simplex(linearProblem, NULL);
+        if (dsCaseSetDependentAndIndependentVariableBoundsProblem(aCase, linearProblem, lowerBounds, upperBounds) <= DSVariablePoolNumberOfVariables(DSCaseXi(aCase)) + DSVariablePoolNumberOfVariables(DSCaseXd(aCase))) {
+                DSLinearProblemSolve(linearProblem);
                 if (strict == true) {
-                        if (glp_get_obj_val(linearProblem) <= -1E-14 && glp_get_prim_stat(linearProblem) == GLP_FEAS)
+                        if (DSLinearProblemObjectiveValue(linearProblem) <= -1E-14 && DSLinearProblemIsFeasible(linearProblem) == true)
                                 isValid = true;
                 } else {
-                        if (glp_get_obj_val(linearProblem) <= 0.0f && glp_get_prim_stat(linearProblem) == GLP_FEAS)
+                        if (DSLinearProblemObjectiveValue(linearProblem) <= 0.0f && DSLinearProblemIsFeasible(linearProblem) == true)
                                 isValid = true;
                 }
         }
         
-        glp_delete_prob(linearProblem);
+        dsCaseProblemRelease(linearProblem);
 bail:
         return isValid;
 }
@@ -1031,22 +1869,22 @@ bail:
         return value;
 }
 
-static DSVertices * dsCaseCalculateBoundingRange(const DSCase * aCase, glp_prob * linearProblem, const DSUInteger index)
+static DSVertices * dsCaseCalculateBoundingRange(const DSCase * aCase, DSLinearProblem * linearProblem, const DSUInteger index)
 {
         DSVertices *vertices = NULL;
         double minVal, maxVal, val[1] = {INFINITY};
         vertices = DSVerticesAlloc(1);
-        glp_set_obj_coef(linearProblem, index+1, 1.0);
-        glp_simplex(linearProblem, NULL);
-        maxVal = glp_get_obj_val(linearProblem);
-        if (glp_get_prim_stat(linearProblem) == GLP_FEAS) {
+        DSLinearProblemSetObjectiveCoefficient(linearProblem, index, 1.0);
+        DSLinearProblemSolve(linearProblem);
+        maxVal = DSLinearProblemObjectiveValue(linearProblem);
+        if (DSLinearProblemIsFeasible(linearProblem) == true) {
                 val[0] = maxVal;
                 DSVerticesAddVertex(vertices, val);
         }
-        glp_set_obj_coef(linearProblem, index+1, -1.0);
-        glp_simplex(linearProblem, NULL);
-        if (glp_get_prim_stat(linearProblem) == GLP_FEAS) {
-                minVal = -glp_get_obj_val(linearProblem);
+        DSLinearProblemSetObjectiveCoefficient(linearProblem, index, -1.0);
+        DSLinearProblemSolve(linearProblem);
+        if (DSLinearProblemIsFeasible(linearProblem) == true) {
+                minVal = -DSLinearProblemObjectiveValue(linearProblem);
                 if (minVal != maxVal) {
                         val[0] = minVal;
                         DSVerticesAddVertex(vertices, val);
@@ -1061,7 +1899,7 @@ extern DSVertices * DSCaseBoundingRangeForVariableWithConstraints(const DSCase *
         DSVertices *vertices = NULL;
         DSUInteger index;
         DSMatrix *A = NULL, *Zeta = NULL, *temp;
-        glp_prob * linearProblem = NULL;
+        DSLinearProblem * linearProblem = NULL;
         
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
@@ -1086,27 +1924,27 @@ extern DSVertices * DSCaseBoundingRangeForVariableWithConstraints(const DSCase *
         Zeta = DSMatrixAppendMatrices(DSCaseZeta(aCase), temp, false);
         DSMatrixFree(temp);
         DSMatrixMultiplyByScalar(A, -1.0);
-        linearProblem = dsCaseLinearProblemForMatrices(A, Zeta);
+        linearProblem = dsCaseLinearProblemForMatrices(A, Zeta, 0);
         
         if (linearProblem == NULL) {
                 DSError(M_DS_NULL ": Linear problem is NULL", A_DS_ERROR);
                 goto bail;
         }
         
-        if (dsCaseSetVariableBoundsLinearProblem(aCase, linearProblem, lowerBounds, upperBounds) == 0) {
+        if (dsCaseSetVariableBoundsProblem(aCase, linearProblem, lowerBounds, upperBounds) == 0) {
                 DSError(M_DS_WRONG ": Needs at least one free variables", A_DS_ERROR);
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
                 goto bail;
         }
         
-        if (glp_get_col_type(linearProblem, DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), variable)+1) == GLP_FX) {
+        if (DSLinearProblemColumnIsFixed(linearProblem, index) == true) {
                 DSError(M_DS_WRONG ": variable is fixed", A_DS_ERROR);
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
                 goto bail;
         }
         
         vertices = dsCaseCalculateBoundingRange(aCase, linearProblem, index);
-        glp_delete_prob(linearProblem);
+        dsCaseProblemRelease(linearProblem);
 bail:
         if (A != NULL)
                 DSMatrixFree(A);
@@ -1118,9 +1956,9 @@ bail:
 extern DSVertices * DSCaseBoundingRangeForVariable(const DSCase *aCase, const char * variable)
 {
         DSVertices *vertices = NULL;
-        DSUInteger i, index;
+        DSUInteger index;
         DSMatrix *A = NULL, *Zeta = NULL, *temp;
-        glp_prob * linearProblem = NULL;
+        DSLinearProblem * linearProblem = NULL;
         
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
@@ -1145,18 +1983,15 @@ extern DSVertices * DSCaseBoundingRangeForVariable(const DSCase *aCase, const ch
         Zeta = DSMatrixAppendMatrices(DSCaseZeta(aCase), temp, false);
         DSMatrixFree(temp);
         DSMatrixMultiplyByScalar(A, -1.0);
-        linearProblem = dsCaseLinearProblemForMatrices(A, Zeta);
+        linearProblem = dsCaseLinearProblemForMatrices(A, Zeta, 0);
         
         if (linearProblem == NULL) {
                 DSError(M_DS_NULL ": Linear problem is NULL", A_DS_ERROR);
                 goto bail;
         }
         
-        for (i = 0; i < DSVariablePoolNumberOfVariables(DSCaseXd(aCase)); i++)
-                glp_set_col_bnds(linearProblem, i+1, GLP_FR, 0.0, 0.0);
-        
         vertices = dsCaseCalculateBoundingRange(aCase, linearProblem, index);
-        glp_delete_prob(linearProblem);
+        dsCaseProblemRelease(linearProblem);
 bail:
         if (A != NULL)
                 DSMatrixFree(A);
@@ -1165,22 +2000,228 @@ bail:
         return vertices;
 }
 
-static DSVertices * dsCaseCalculate1DVertices(const DSCase * aCase, glp_prob * linearProblem, const DSMatrix * A, const DSMatrix *Zeta, const DSUInteger xIndex, const DSVariablePool * lower, const DSVariablePool * upper)
+/**
+ * \brief The log10 bound of the range of each variable in a bounding box.
+ */
+#define DS_CASE_BOUNDING_BOX_BOUND      15.0
+
+/**
+ * \brief Data of one task calculating the bounding box of a case.
+ */
+typedef struct {
+        const DSCase * aCase;
+        const DSVariablePool * lowerBounds;
+        const DSVariablePool * upperBounds;
+        DSMatrix ** box;
+} ds_boundingbox_task_t;
+
+/**
+ * \brief Calculates the minimum and maximum of each variable of a linear
+ * problem.
+ *
+ * \details The same problem is solved twice for each variable, only changing
+ * its objective and the bounds of the variable being optimized, so it is
+ * solved in the workspace kept by the problem and, if it is solved by GLPK,
+ * every solution after the first starts from the optimal basis of the
+ * previous one.  As in DSCaseBoundingRangeForVariable, only the variable
+ * being optimized is limited to [-DS_CASE_BOUNDING_BOX_BOUND,
+ * DS_CASE_BOUNDING_BOX_BOUND], in addition to the bounds already set in the
+ * problem.
+ *
+ * \return A DSMatrix with one row per variable, with the minimum and maximum
+ *         of the variable, or NULL if a range is empty.
+ */
+static DSMatrix * dsCaseCalculateBoundingBox(DSLinearProblem * linearProblem)
+{
+        DSMatrix * box = NULL;
+        DSUInteger i, numberOfXi = DSLinearProblemNumberOfColumns(linearProblem);
+        double * lower, * upper, low, high, minVal, maxVal;
+        lower = DSSecureMalloc(sizeof(double)*2*(numberOfXi+1));
+        upper = lower+numberOfXi+1;
+        for (i = 0; i < numberOfXi; i++) {
+                lower[i] = DSLinearProblemColumnLowerBound(linearProblem, i);
+                upper[i] = DSLinearProblemColumnUpperBound(linearProblem, i);
+        }
+        box = DSMatrixAlloc(numberOfXi, 2);
+        for (i = 0; i < numberOfXi; i++) {
+                if (i > 0) {
+                        DSLinearProblemSetObjectiveCoefficient(linearProblem, i-1, 0.0);
+                        DSLinearProblemSetColumnBounds(linearProblem, i-1, lower[i-1], upper[i-1]);
+                }
+                low = (lower[i] > -DS_CASE_BOUNDING_BOX_BOUND) ? lower[i] : -DS_CASE_BOUNDING_BOX_BOUND;
+                high = (upper[i] < DS_CASE_BOUNDING_BOX_BOUND) ? upper[i] : DS_CASE_BOUNDING_BOX_BOUND;
+                if (low > high)
+                        break;
+                DSLinearProblemSetColumnBounds(linearProblem, i, low, high);
+                DSLinearProblemSetObjectiveCoefficient(linearProblem, i, 1.0);
+                DSLinearProblemSolve(linearProblem);
+                if (DSLinearProblemIsFeasible(linearProblem) == false)
+                        break;
+                minVal = DSLinearProblemObjectiveValue(linearProblem);
+                DSLinearProblemSetObjectiveCoefficient(linearProblem, i, -1.0);
+                DSLinearProblemSolve(linearProblem);
+                if (DSLinearProblemIsFeasible(linearProblem) == false)
+                        break;
+                maxVal = -DSLinearProblemObjectiveValue(linearProblem);
+                DSMatrixSetDoubleValue(box, i, 0, minVal);
+                DSMatrixSetDoubleValue(box, i, 1, maxVal);
+        }
+        if (i < numberOfXi) {
+                DSMatrixFree(box);
+                box = NULL;
+        }
+        DSSecureFree(lower);
+        return box;
+}
+
+/**
+ * \brief Calculates the bounding box of the region of validity of a case
+ * within a slice.
+ *
+ * \details The minimum and maximum of all the independent variables are
+ * calculated with a single linear problem, which is solved 2*|Xi| times
+ * instead of being created 2*|Xi| times, as with
+ * DSCaseBoundingRangeForVariableWithConstraints.  Within a linear programming
+ * context, the DSLinearProblem of the thread is reused.
+ *
+ * \param aCase The DSCase whose bounding box is calculated.
+ * \param lowerBounds A DSVariablePool with the lower bounds of the slice, or
+ *        NULL if the bounding box is not limited to a slice.
+ * \param upperBounds A DSVariablePool with the upper bounds of the slice, or
+ *        NULL if the bounding box is not limited to a slice.
+ *
+ * \return A DSMatrix with one row for each independent variable, in the order
+ *         of Xi, with the log10 minimum and maximum of the variable.  If the
+ *         case is not valid within the bounds, NULL is returned.
+ *
+ * \see DSCaseBoundingBox
+ */
+extern DSMatrix * DSCaseBoundingBoxWithConstraints(const DSCase *aCase, const DSVariablePool * lowerBounds, const DSVariablePool * upperBounds)
+{
+        DSMatrix * box = NULL, *A = NULL;
+        DSLinearProblem * linearProblem = NULL;
+        if (aCase == NULL) {
+                DSError(M_DS_CASE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (DSCaseHasSolution(aCase) == false)
+                goto bail;
+        if ((lowerBounds == NULL) != (upperBounds == NULL)) {
+                DSError(M_DS_VAR_NULL ": Variable pool with bounds of the slice is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        A = DSMatrixCopy(DSCaseU(aCase));
+        DSMatrixMultiplyByScalar(A, -1.0);
+        linearProblem = dsCaseLinearProblemForMatrices(A, DSCaseZeta(aCase), 0);
+        if (linearProblem == NULL) {
+                DSError(M_DS_NULL ": Linear problem is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (lowerBounds != NULL && dsCaseSetVariableBoundsProblem(aCase, linearProblem, lowerBounds, upperBounds) == 0) {
+                DSError(M_DS_WRONG ": Needs at least one free variables", A_DS_ERROR);
+                goto bail;
+        }
+        box = dsCaseCalculateBoundingBox(linearProblem);
+bail:
+        if (linearProblem != NULL)
+                dsCaseProblemRelease(linearProblem);
+        if (A != NULL)
+                DSMatrixFree(A);
+        return box;
+}
+
+/**
+ * \brief Calculates the bounding box of the region of validity of a case.
+ *
+ * \details Equivalent to calling DSCaseBoundingRangeForVariable for every
+ * independent variable, but with a single linear problem.
+ *
+ * \param aCase The DSCase whose bounding box is calculated.
+ *
+ * \return A DSMatrix with the log10 minimum and maximum of each independent
+ *         variable, or NULL if the case is not valid.
+ *
+ * \see DSCaseBoundingBoxWithConstraints
+ */
+extern DSMatrix * DSCaseBoundingBox(const DSCase *aCase)
+{
+        return DSCaseBoundingBoxWithConstraints(aCase, NULL, NULL);
+}
+
+static void * dsCaseBoundingBoxTask(void * argument)
+{
+        ds_boundingbox_task_t * task = argument;
+        DSCaseLinearProgrammingContextBegin();
+        *task->box = DSCaseBoundingBoxWithConstraints(task->aCase, task->lowerBounds, task->upperBounds);
+        DSCaseLinearProgrammingContextEnd();
+        return NULL;
+}
+
+/**
+ * \brief Calculates the bounding boxes of a set of cases in parallel.
+ *
+ * \details The cases are distributed over the thread pool, and each case is
+ * processed with DSCaseBoundingBoxWithConstraints.
+ *
+ * \param numberOfCases The number of cases in the array of cases.
+ * \param cases The array of cases.
+ * \param lowerBounds A DSVariablePool with the lower bounds of the slice, or
+ *        NULL.
+ * \param upperBounds A DSVariablePool with the upper bounds of the slice, or
+ *        NULL.
+ *
+ * \return A DSMatrixArray where matrix i is the bounding box of case i, or
+ *         NULL if that case is not valid within the bounds.  The caller is
+ *         responsible for freeing the array.
+ */
+extern DSMatrixArray * DSCaseBoundingBoxesForCases(const DSUInteger numberOfCases, const DSCase ** cases, const DSVariablePool * lowerBounds, const DSVariablePool * upperBounds)
+{
+        DSMatrixArray * boxes = NULL;
+        DSMatrix ** matrices = NULL;
+        ds_boundingbox_task_t * tasks = NULL;
+        DSUInteger i;
+        if (numberOfCases == 0) {
+                DSError(M_DS_WRONG ": Number of cases must be at least one", A_DS_ERROR);
+                goto bail;
+        }
+        if (cases == NULL) {
+                DSError(M_DS_NULL ": Array of cases is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        matrices = DSSecureCalloc(sizeof(DSMatrix *), numberOfCases);
+        tasks = DSSecureCalloc(sizeof(ds_boundingbox_task_t), numberOfCases);
+        for (i = 0; i < numberOfCases; i++) {
+                tasks[i].aCase = cases[i];
+                tasks[i].lowerBounds = lowerBounds;
+                tasks[i].upperBounds = upperBounds;
+                tasks[i].box = matrices+i;
+        }
+        DSThreadPoolRun(dsCaseBoundingBoxTask, tasks, sizeof(ds_boundingbox_task_t), numberOfCases);
+        DSSecureFree(tasks);
+        boxes = DSMatrixArrayAlloc();
+        for (i = 0; i < numberOfCases; i++)
+                DSMatrixArrayAddMatrix(boxes, matrices[i]);
+        DSSecureFree(matrices);
+bail:
+        return boxes;
+}
+
+static DSVertices * dsCaseCalculate1DVertices(const DSCase * aCase, DSLinearProblem * linearProblem, const DSMatrix * A, const DSMatrix *Zeta, const DSUInteger xIndex, const DSVariablePool * lower, const DSVariablePool * upper)
 {
         DSVertices *vertices = NULL;
         double minVal = 0, maxVal = 0, val[1] = {INFINITY};
         vertices = DSVerticesAlloc(1);
-        glp_set_obj_coef(linearProblem, xIndex+1, 1.0);
-        glp_simplex(linearProblem, NULL);
-        if (glp_get_prim_stat(linearProblem) == GLP_FEAS) {
-                maxVal = glp_get_obj_val(linearProblem);
+        DSLinearProblemSetObjectiveCoefficient(linearProblem, xIndex, 1.0);
+        DSLinearProblemSolve(linearProblem);
+        if (DSLinearProblemIsFeasible(linearProblem) == true) {
+                maxVal = DSLinearProblemObjectiveValue(linearProblem);
                 val[0] = maxVal;
                 DSVerticesAddVertex(vertices, val);
         }
-        glp_set_obj_coef(linearProblem, xIndex+1, -1.0);
-        glp_simplex(linearProblem, NULL);
-        if (glp_get_prim_stat(linearProblem) == GLP_FEAS) {
-                minVal = -glp_get_obj_val(linearProblem);
+        DSLinearProblemSetObjectiveCoefficient(linearProblem, xIndex, -1.0);
+        DSLinearProblemSolve(linearProblem);
+        if (DSLinearProblemIsFeasible(linearProblem) == true) {
+                minVal = -DSLinearProblemObjectiveValue(linearProblem);
                 if (minVal != maxVal) {
                         val[0] = minVal;
                         DSVerticesAddVertex(vertices, val);
@@ -1196,7 +2237,7 @@ extern DSVertices * DSCaseVerticesFor1DSlice(const DSCase *aCase, const DSVariab
         DSVertices *vertices = NULL;
         DSUInteger xIndex;
         DSMatrix *A, *Zeta, *temp;
-        glp_prob * linearProblem = NULL;
+        DSLinearProblem * linearProblem = NULL;
         
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
@@ -1226,7 +2267,7 @@ extern DSVertices * DSCaseVerticesFor1DSlice(const DSCase *aCase, const DSVariab
         Zeta = DSMatrixAppendMatrices(DSCaseZeta(aCase), temp, false);
         DSMatrixFree(temp);
         DSMatrixMultiplyByScalar(A, -1.0);
-        linearProblem = dsCaseLinearProblemForMatrices(A, Zeta);
+        linearProblem = dsCaseLinearProblemForMatrices(A, Zeta, 0);
         
         if (linearProblem == NULL) {
                 DSError(M_DS_NULL ": Linear problem is NULL", A_DS_ERROR);
@@ -1235,37 +2276,46 @@ extern DSVertices * DSCaseVerticesFor1DSlice(const DSCase *aCase, const DSVariab
                 goto bail;
         }
         
-        if (dsCaseSetVariableBoundsLinearProblem(aCase, linearProblem, lowerBounds, upperBounds) != 1) {
+        if (dsCaseSetVariableBoundsProblem(aCase, linearProblem, lowerBounds, upperBounds) != 1) {
                 DSError(M_DS_WRONG ": Need one free variables", A_DS_ERROR);
                 DSMatrixFree(A);
                 DSMatrixFree(Zeta);
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
                 goto bail;
         }
         
-        if (glp_get_col_type(linearProblem, DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), xVariable)+1) != GLP_DB) {
+        if (DSLinearProblemColumnLowerBound(linearProblem, xIndex) == -INFINITY
+            || DSLinearProblemColumnUpperBound(linearProblem, xIndex) == INFINITY
+            || DSLinearProblemColumnIsFixed(linearProblem, xIndex) == true) {
                 DSError(M_DS_WRONG ": X Variable is not double bound", A_DS_ERROR);
                 DSMatrixFree(A);
                 DSMatrixFree(Zeta);
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
                 goto bail;
         }
         
         vertices = dsCaseCalculate1DVertices(aCase, linearProblem, A, Zeta, xIndex, lowerBounds, upperBounds);
         DSMatrixFree(A);
         DSMatrixFree(Zeta);
-        glp_delete_prob(linearProblem);
+        dsCaseProblemRelease(linearProblem);
 bail:
         return vertices;
 }
 
 
-static DSVertices * dsCaseCalculate3DVertices(const DSCase * aCase, glp_prob * linearProblem, const DSMatrix * A, const DSMatrix *Zeta, const DSUInteger xIndex, const DSUInteger yIndex, const DSUInteger zIndex)
+/**
+ * \brief Calculates the vertices of a 3D slice by making every set of three
+ * boundaries active.
+ *
+ * \details The problem must have been created by dsCaseLinearProblemForMatrices
+ * for A and Zeta with three additional rows for the active boundaries.
+ */
+static DSVertices * dsCaseCalculate3DVertices(const DSCase * aCase, DSLinearProblem * linearProblem, const DSMatrix * A, const DSMatrix *Zeta, const DSUInteger xIndex, const DSUInteger yIndex, const DSUInteger zIndex)
 {
         DSVertices *vertices = NULL;
         DSUInteger numberOfCombinations, i, firstIndex, secondIndex, thirdIndex;
-        DSUInteger numberOfBoundaries;
-        double bnd, xVal, yVal, zVal, vals[3];
+        DSUInteger numberOfBoundaries, rows[3];
+        double xVal, yVal, zVal, vals[3];
         
         numberOfBoundaries = DSMatrixRows(A);
         numberOfCombinations = 0;
@@ -1275,35 +2325,29 @@ static DSVertices * dsCaseCalculate3DVertices(const DSCase * aCase, glp_prob * l
                 for (secondIndex = firstIndex+1; secondIndex < numberOfBoundaries; secondIndex++) {
                         for (thirdIndex = secondIndex+1; thirdIndex < numberOfBoundaries; thirdIndex++) {
 
-                                for (i = 0; i < numberOfBoundaries; i++) {
-                                        bnd = glp_get_row_ub(linearProblem, i+1);
-                                        glp_set_row_bnds(linearProblem, i+1, GLP_UP, 0.0, bnd);
-                                }
-                                bnd = glp_get_row_ub(linearProblem, firstIndex+1);
-                                glp_set_row_bnds(linearProblem, firstIndex+1, GLP_FX, bnd, bnd);
-                                bnd = glp_get_row_ub(linearProblem, secondIndex+1);
-                                glp_set_row_bnds(linearProblem, secondIndex+1, GLP_FX, bnd, bnd);
-                                bnd = glp_get_row_ub(linearProblem, thirdIndex+1);
-                                glp_set_row_bnds(linearProblem, thirdIndex+1, GLP_FX, bnd, bnd);
+                                rows[0] = firstIndex;
+                                rows[1] = secondIndex;
+                                rows[2] = thirdIndex;
+                                dsCaseLinearProblemSetActiveRows(linearProblem, A, Zeta, 3, rows);
                                 for (i = 0; i < DSVariablePoolNumberOfVariables(DSCaseXi(aCase)); i++)
-                                        glp_set_obj_coef(linearProblem, i+1, 0.0);
-                                glp_set_obj_coef(linearProblem, xIndex+1, 1.0);
-                                glp_simplex(linearProblem, NULL);
-                                if (glp_get_prim_stat(linearProblem) != GLP_FEAS)
+                                        DSLinearProblemSetObjectiveCoefficient(linearProblem, i, 0.0);
+                                DSLinearProblemSetObjectiveCoefficient(linearProblem, xIndex, 1.0);
+                                DSLinearProblemSolve(linearProblem);
+                                if (DSLinearProblemIsFeasible(linearProblem) == false)
                                         continue;
-                                xVal = glp_get_obj_val(linearProblem);
-                                glp_set_obj_coef(linearProblem, xIndex+1, 0.0);
-                                glp_set_obj_coef(linearProblem, yIndex+1, 1.0);
-                                glp_simplex(linearProblem, NULL);
-                                if (glp_get_prim_stat(linearProblem) != GLP_FEAS)
+                                xVal = DSLinearProblemObjectiveValue(linearProblem);
+                                DSLinearProblemSetObjectiveCoefficient(linearProblem, xIndex, 0.0);
+                                DSLinearProblemSetObjectiveCoefficient(linearProblem, yIndex, 1.0);
+                                DSLinearProblemSolve(linearProblem);
+                                if (DSLinearProblemIsFeasible(linearProblem) == false)
                                         continue;
-                                yVal = glp_get_obj_val(linearProblem);
-                                glp_set_obj_coef(linearProblem, yIndex+1, 0.0);
-                                glp_set_obj_coef(linearProblem, zIndex+1, 1.0);
-                                glp_simplex(linearProblem, NULL);
-                                if (glp_get_prim_stat(linearProblem) != GLP_FEAS)
+                                yVal = DSLinearProblemObjectiveValue(linearProblem);
+                                DSLinearProblemSetObjectiveCoefficient(linearProblem, yIndex, 0.0);
+                                DSLinearProblemSetObjectiveCoefficient(linearProblem, zIndex, 1.0);
+                                DSLinearProblemSolve(linearProblem);
+                                if (DSLinearProblemIsFeasible(linearProblem) == false)
                                         continue;
-                                zVal = glp_get_obj_val(linearProblem);
+                                zVal = DSLinearProblemObjectiveValue(linearProblem);
                                 vals[0] = xVal;
                                 vals[1] = yVal;
                                 vals[2] = zVal;
@@ -1316,12 +2360,19 @@ static DSVertices * dsCaseCalculate3DVertices(const DSCase * aCase, glp_prob * l
 }
 
 
-static DSVertices * dsCaseCalculate2DVertices(const DSCase * aCase, glp_prob * linearProblem, const DSMatrix * A, const DSMatrix *Zeta, const DSUInteger xIndex, const DSUInteger yIndex)
+/**
+ * \brief Calculates the vertices of a 2D slice by making every pair of
+ * boundaries active.
+ *
+ * \details The problem must have been created by dsCaseLinearProblemForMatrices
+ * for A and Zeta with two additional rows for the active boundaries.
+ */
+static DSVertices * dsCaseCalculate2DVertices(const DSCase * aCase, DSLinearProblem * linearProblem, const DSMatrix * A, const DSMatrix *Zeta, const DSUInteger xIndex, const DSUInteger yIndex)
 {
         DSVertices *vertices = NULL;
         DSUInteger numberOfCombinations, i, j, firstIndex, secondIndex;
-        DSUInteger numberOfBoundaries, activeIndex;
-        double bnd, xVal, yVal, vals[2];
+        DSUInteger numberOfBoundaries, activeIndex, rows[2];
+        double xVal, yVal, vals[2];
         
         numberOfBoundaries = DSMatrixRows(A);
         numberOfCombinations = nchoosek(numberOfBoundaries, 2);
@@ -1329,11 +2380,6 @@ static DSVertices * dsCaseCalculate2DVertices(const DSCase * aCase, glp_prob * l
         vertices = DSVerticesAlloc(2);
         for (i = 0; i < numberOfCombinations; i++) {
                 
-                for (j = 0; j < numberOfBoundaries; j++) {
-                        bnd = glp_get_row_ub(linearProblem, j+1);
-                        glp_set_row_bnds(linearProblem, j+1, GLP_UP, 0.0, bnd);
-                }
-                
                 secondIndex = 0;
                 for (j = 0, firstIndex = 1; j <= i; j += numberOfBoundaries-firstIndex, firstIndex++)
                         secondIndex += numberOfBoundaries-firstIndex;
@@ -1341,15 +2387,14 @@ static DSVertices * dsCaseCalculate2DVertices(const DSCase * aCase, glp_prob * l
                 secondIndex = numberOfBoundaries-secondIndex;
                 firstIndex -= 2;
                 
-                bnd = glp_get_row_ub(linearProblem, firstIndex+1);
-                glp_set_row_bnds(linearProblem, firstIndex+1, GLP_FX, bnd, bnd);
-                bnd = glp_get_row_ub(linearProblem, secondIndex+1);
-                glp_set_row_bnds(linearProblem, secondIndex+1, GLP_FX, bnd, bnd);
+                rows[0] = firstIndex;
+                rows[1] = secondIndex;
+                dsCaseLinearProblemSetActiveRows(linearProblem, A, Zeta, 2, rows);
                 
                 for (j = 0; j < DSVariablePoolNumberOfVariables(DSCaseXi(aCase)); j++)
-                        glp_set_obj_coef(linearProblem, j+1, 0.0);
+                        DSLinearProblemSetObjectiveCoefficient(linearProblem, j, 0.0);
                 
-                glp_set_obj_coef(linearProblem, xIndex+1, 1.0);
+                DSLinearProblemSetObjectiveCoefficient(linearProblem, xIndex, 1.0);
                 
                 if (fabs(DSMatrixDoubleValue(A, firstIndex, yIndex)) >= 1E-14)
                         activeIndex = firstIndex;
@@ -1358,10 +2403,10 @@ static DSVertices * dsCaseCalculate2DVertices(const DSCase * aCase, glp_prob * l
                 else
                         continue;
                 
-                glp_simplex(linearProblem, NULL);
-                if (glp_get_prim_stat(linearProblem) != GLP_FEAS)
+                DSLinearProblemSolve(linearProblem);
+                if (DSLinearProblemIsFeasible(linearProblem) == false)
                         continue;
-                xVal = glp_get_obj_val(linearProblem);
+                xVal = DSLinearProblemObjectiveValue(linearProblem);
                 yVal = -DSMatrixDoubleValue(Zeta, activeIndex, 0);
                 for (j = 0; j < DSVariablePoolNumberOfVariables(DSCaseXi(aCase)); j++) {
                         if (j == yIndex)
@@ -1369,7 +2414,7 @@ static DSVertices * dsCaseCalculate2DVertices(const DSCase * aCase, glp_prob * l
                         if (j == xIndex) {
                                 yVal += DSMatrixDoubleValue(A, activeIndex, j) * xVal;
                         } else {
-                                yVal += DSMatrixDoubleValue(A, activeIndex, j) * glp_get_col_ub(linearProblem, j+1);
+                                yVal += DSMatrixDoubleValue(A, activeIndex, j) * DSLinearProblemColumnUpperBound(linearProblem, j);
                         }
                 }
                 yVal /= -DSMatrixDoubleValue(A, activeIndex, yIndex);
@@ -1381,11 +2426,168 @@ static DSVertices * dsCaseCalculate2DVertices(const DSCase * aCase, glp_prob * l
         return vertices;
 }
 
+/**
+ * \brief Creates the half-spaces of a slice of a case in the free variables
+ * of the slice.
+ *
+ * \details The fixed independent variables are substituted in the
+ * boundaries U*x + zeta > 0, leaving one half-space a*x + c >= 0 in the free
+ * variables per boundary.  The bounds of the free variables are returned
+ * separately, in logarithmic coordinates.
+ *
+ * \param indices The indices of the free variables, which become the
+ *        coordinates of the half-spaces in the same order.
+ *
+ * \return A boolean value that is false if the bounds of a free variable are
+ *         not finite and positive, or if an independent variable that is not
+ *         free is not fixed; the slice must then be calculated with linear
+ *         programming.
+ */
+static bool dsCaseSliceHalfSpaces(const DSCase * aCase, const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds, const DSUInteger numberOfIndices, const DSUInteger * indices, DSMatrix ** coefficients, DSMatrix ** constants, double * lower, double * upper)
+{
+        bool isSlice = false;
+        DSUInteger i, j, k, numberOfXi;
+        const DSVariable * lowVariable, * highVariable;
+        const char * name;
+        double * values = NULL, value;
+        *coefficients = NULL;
+        *constants = NULL;
+        if (DSCaseU(aCase) == NULL || DSCaseZeta(aCase) == NULL)
+                goto bail;
+        if (lowerBounds == NULL || upperBounds == NULL)
+                goto bail;
+        numberOfXi = DSVariablePoolNumberOfVariables(DSCaseXi(aCase));
+        values = DSSecureMalloc(sizeof(double)*numberOfXi);
+        for (j = 0; j < numberOfXi; j++) {
+                name = DSVariableName(DSVariablePoolAllVariables(DSCaseXi(aCase))[j]);
+                if (DSVariablePoolHasVariableWithName(lowerBounds, name) == false || DSVariablePoolHasVariableWithName(upperBounds, name) == false)
+                        goto bail;
+                lowVariable = DSVariablePoolVariableWithName(lowerBounds, name);
+                highVariable = DSVariablePoolVariableWithName(upperBounds, name);
+                if (DSVariableValue(lowVariable) <= 0 || DSVariableValue(highVariable) == INFINITY)
+                        goto bail;
+                for (k = 0; k < numberOfIndices; k++) {
+                        if (indices[k] == j)
+                                break;
+                }
+                if (k < numberOfIndices) {
+                        lower[k] = log10(DSVariableValue(lowVariable));
+                        upper[k] = log10(DSVariableValue(highVariable));
+                        values[j] = NAN;
+                        continue;
+                }
+                if (DSVariableValue(lowVariable) != DSVariableValue(highVariable))
+                        goto bail;
+                values[j] = log10(DSVariableValue(lowVariable));
+        }
+        *coefficients = DSMatrixAlloc(DSMatrixRows(DSCaseU(aCase)), numberOfIndices);
+        *constants = DSMatrixAlloc(DSMatrixRows(DSCaseU(aCase)), 1);
+        for (i = 0; i < DSMatrixRows(DSCaseU(aCase)); i++) {
+                value = DSMatrixDoubleValue(DSCaseZeta(aCase), i, 0);
+                for (j = 0; j < numberOfXi; j++) {
+                        if (isnan(values[j]))
+                                continue;
+                        value += DSMatrixDoubleValue(DSCaseU(aCase), i, j)*values[j];
+                }
+                for (k = 0; k < numberOfIndices; k++)
+                        DSMatrixSetDoubleValue(*coefficients, i, k, DSMatrixDoubleValue(DSCaseU(aCase), i, indices[k]));
+                DSMatrixSetDoubleValue(*constants, i, 0, value);
+        }
+        isSlice = true;
+bail:
+        if (values != NULL)
+                DSSecureFree(values);
+        return isSlice;
+}
+
+/**
+ * \brief Calculates the vertices of a 2D slice of a case by clipping the
+ * slice rectangle with the boundaries of the case.
+ *
+ * \details The vertices are returned in counter-clockwise order and no
+ * linear problem is solved.
+ *
+ * \return A new DSVertices object, or NULL if the slice cannot be written as
+ *         half-planes (see dsCaseSliceHalfSpaces), in which case the vertices
+ *         must be calculated with linear programming.
+ */
+static DSVertices * dsCaseCalculate2DVerticesByClipping(const DSCase * aCase, const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds, const DSUInteger xIndex, const DSUInteger yIndex)
+{
+        DSVertices * vertices = NULL;
+        DSMatrix * coefficients = NULL, * constants = NULL;
+        DSUInteger indices[2] = {xIndex, yIndex};
+        double lower[2], upper[2];
+        if (xIndex == yIndex)
+                goto bail;
+        if (dsCaseSliceHalfSpaces(aCase, lowerBounds, upperBounds, 2, indices, &coefficients, &constants, lower, upper) == false)
+                goto bail;
+        vertices = DSVertices2DFromHalfPlanes(coefficients, constants, lower, upper);
+bail:
+        if (coefficients != NULL)
+                DSMatrixFree(coefficients);
+        if (constants != NULL)
+                DSMatrixFree(constants);
+        return vertices;
+}
+
+/**
+ * \brief Calculates the polytope of a 3D slice of a case.
+ *
+ * \details The polytope is calculated with DSPolytopeFromHalfSpaces, which
+ * gives the vertices, faces and connectivity of the slice without solving
+ * linear problems.  Its coordinates are the x, y and z variables, in that
+ * order.
+ *
+ * \return A new DSPolytope, or NULL if the variables are not three distinct
+ *         independent variables of the case or if the slice cannot be
+ *         written as half-spaces (see dsCaseSliceHalfSpaces).
+ */
+static DSPolytope * dsCasePolytopeFor3DSlice(const DSCase *aCase, const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds, const char * xVariable, const char *yVariable, const char *zVariable)
+{
+        DSPolytope * polytope = NULL;
+        DSMatrix * coefficients = NULL, * constants = NULL;
+        DSUInteger i, indices[3];
+        double lower[3], upper[3];
+        if (aCase == NULL || xVariable == NULL || yVariable == NULL || zVariable == NULL)
+                goto bail;
+        if (DSCaseHasSolution(aCase) == false)
+                goto bail;
+        indices[0] = DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), xVariable);
+        indices[1] = DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), yVariable);
+        indices[2] = DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), zVariable);
+        for (i = 0; i < 3; i++) {
+                if (indices[i] >= DSVariablePoolNumberOfVariables(DSCaseXi(aCase)))
+                        goto bail;
+        }
+        if (indices[0] == indices[1] || indices[0] == indices[2] || indices[1] == indices[2])
+                goto bail;
+        if (dsCaseSliceHalfSpaces(aCase, lowerBounds, upperBounds, 3, indices, &coefficients, &constants, lower, upper) == false)
+                goto bail;
+        for (i = 0; i < 3; i++) {
+                if (lower[i] == upper[i])
+                        goto bail;
+        }
+        polytope = DSPolytopeFromHalfSpaces(coefficients, constants, lower, upper);
+bail:
+        if (coefficients != NULL)
+                DSMatrixFree(coefficients);
+        if (constants != NULL)
+                DSMatrixFree(constants);
+        return polytope;
+}
+
 extern DSMatrixArray * DSCaseFacesFor3DSliceAndConnectivity(const DSCase *aCase, const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds, const char * xVariable, const char *yVariable, const char *zVariable)
 {
         DSMatrixArray * faces = NULL;
         DSVertices * vertices;
+        DSPolytope * polytope;
         DSUInteger xIndex, yIndex, zIndex;
+        polytope = dsCasePolytopeFor3DSlice(aCase, lowerBounds, upperBounds, xVariable, yVariable, zVariable);
+        if (polytope != NULL) {
+                faces = DSPolytope3DFaces(polytope);
+                DSPolytopeFree(polytope);
+                goto exit;
+        }
         vertices = DSCaseVerticesFor3DSlice(aCase, lowerBounds, upperBounds, xVariable, yVariable, zVariable);
         if (vertices == NULL) {
                 goto exit;
@@ -1405,7 +2607,19 @@ extern DSMatrixArray * DSCaseVerticesFor3DSliceAndConnectivity(const DSCase *aCa
         DSMatrixArray * verticesAndConnectivity = NULL;
         DSVertices * vertices;
         DSMatrix * connectivity;
+        DSPolytope * polytope;
         DSUInteger xIndex, yIndex, zIndex;
+        polytope = dsCasePolytopeFor3DSlice(aCase, lowerBounds, upperBounds, xVariable, yVariable, zVariable);
+        if (polytope != NULL) {
+                if (DSPolytopeNumberOfVertices(polytope) > 0) {
+                        vertices = DSPolytopeVertices(polytope);
+                        verticesAndConnectivity = DSMatrixArrayAlloc();
+                        DSMatrixArrayAddMatrix(verticesAndConnectivity, DSVerticesFreeToMatrix(vertices));
+                        DSMatrixArrayAddMatrix(verticesAndConnectivity, DSPolytopeConnectivityMatrix(polytope));
+                }
+                DSPolytopeFree(polytope);
+                goto exit;
+        }
         vertices = DSCaseVerticesFor3DSlice(aCase, lowerBounds, upperBounds, xVariable, yVariable, zVariable);
         if (vertices == NULL) {
                 goto exit;
@@ -1415,9 +2629,8 @@ extern DSMatrixArray * DSCaseVerticesFor3DSliceAndConnectivity(const DSCase *aCa
         zIndex = DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), zVariable);
         connectivity = DSVertices3DConnectivityMatrix(vertices, aCase, lowerBounds, upperBounds, xIndex, yIndex, zIndex);
         verticesAndConnectivity = DSMatrixArrayAlloc();
-        DSMatrixArrayAddMatrix(verticesAndConnectivity, DSVerticesToMatrix(vertices));
+        DSMatrixArrayAddMatrix(verticesAndConnectivity, DSVerticesFreeToMatrix(vertices));
         DSMatrixArrayAddMatrix(verticesAndConnectivity, connectivity);
-        DSVerticesFree(vertices);
 exit:
         return verticesAndConnectivity;
 }
@@ -1426,7 +2639,8 @@ extern DSVertices * DSCaseVerticesFor3DSlice(const DSCase *aCase, const DSVariab
         DSVertices *vertices = NULL;
         DSUInteger yIndex, xIndex, zIndex;
         DSMatrix *A, *Zeta, *temp;
-        glp_prob * linearProblem = NULL;
+        DSLinearProblem * linearProblem = NULL;
+        DSPolytope * polytope;
         
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
@@ -1454,6 +2668,12 @@ extern DSVertices * DSCaseVerticesFor3DSlice(const DSCase *aCase, const DSVariab
                 DSError(M_DS_WRONG ": Case does not have Z variable", A_DS_ERROR);
                 goto bail;
         }
+        polytope = dsCasePolytopeFor3DSlice(aCase, lowerBounds, upperBounds, xVariable, yVariable, zVariable);
+        if (polytope != NULL) {
+                vertices = DSPolytopeVertices(polytope);
+                DSPolytopeFree(polytope);
+                goto bail;
+        }
         temp = DSMatrixCalloc(6, DSVariablePoolNumberOfVariables(DSCaseXi(aCase)));
         DSMatrixSetDoubleValue(temp, 0, xIndex, 1.0);
         DSMatrixSetDoubleValue(temp, 1, xIndex, -1.0);
@@ -1474,7 +2694,7 @@ extern DSVertices * DSCaseVerticesFor3DSlice(const DSCase *aCase, const DSVariab
         Zeta = DSMatrixAppendMatrices(DSCaseZeta(aCase), temp, false);
         DSMatrixFree(temp);
         DSMatrixMultiplyByScalar(A, -1.0);
-        linearProblem = dsCaseLinearProblemForMatrices(A, Zeta);
+        linearProblem = dsCaseLinearProblemForMatrices(A, Zeta, 3);
         
         if (linearProblem == NULL) {
                 DSError(M_DS_NULL ": Linear problem is NULL", A_DS_ERROR);
@@ -1483,39 +2703,39 @@ extern DSVertices * DSCaseVerticesFor3DSlice(const DSCase *aCase, const DSVariab
                 goto bail;
         }
         
-        if (dsCaseSetVariableBoundsLinearProblem(aCase, linearProblem, lowerBounds, upperBounds) != 3) {
+        if (dsCaseSetVariableBoundsProblem(aCase, linearProblem, lowerBounds, upperBounds) != 3) {
                 DSError(M_DS_WRONG ": Need three free variables", A_DS_ERROR);
                 DSMatrixFree(A);
                 DSMatrixFree(Zeta);
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
                 goto bail;
         }
         
-        if (glp_get_col_type(linearProblem, DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), xVariable)+1) == GLP_FX) {
+        if (DSLinearProblemColumnIsFixed(linearProblem, xIndex) == true) {
                 DSError(M_DS_WRONG ": X Variable is fixed", A_DS_ERROR);
                 DSMatrixFree(A);
                 DSMatrixFree(Zeta);
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
                 goto bail;
         }
-        if (glp_get_col_type(linearProblem, DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), yVariable)+1) == GLP_FX) {
+        if (DSLinearProblemColumnIsFixed(linearProblem, yIndex) == true) {
                 DSError(M_DS_WRONG ": Y Variable is fixed", A_DS_ERROR);
                 DSMatrixFree(A);
                 DSMatrixFree(Zeta);
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
                 goto bail;
         }
-        if (glp_get_col_type(linearProblem, DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), zVariable)+1) == GLP_FX) {
+        if (DSLinearProblemColumnIsFixed(linearProblem, zIndex) == true) {
                 DSError(M_DS_WRONG ": Z Variable is fixed", A_DS_ERROR);
                 DSMatrixFree(A);
                 DSMatrixFree(Zeta);
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
                 goto bail;
         }
         vertices = dsCaseCalculate3DVertices(aCase, linearProblem, A, Zeta, xIndex, yIndex, zIndex);
         DSMatrixFree(A);
         DSMatrixFree(Zeta);
-        glp_delete_prob(linearProblem);
+        dsCaseProblemRelease(linearProblem);
 bail:
         return vertices;
 }
@@ -1525,7 +2745,7 @@ extern DSVertices * DSCaseVerticesFor2DSlice(const DSCase *aCase, const DSVariab
         DSVertices *vertices = NULL;
         DSUInteger yIndex, xIndex;
         DSMatrix *A, *Zeta, *temp;
-        glp_prob * linearProblem = NULL;
+        DSLinearProblem * linearProblem = NULL;
         
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
@@ -1548,6 +2768,9 @@ extern DSVertices * DSCaseVerticesFor2DSlice(const DSCase *aCase, const DSVariab
                 DSError(M_DS_WRONG ": Case does not have Y variable", A_DS_ERROR);
                 goto bail;
         }
+        vertices = dsCaseCalculate2DVerticesByClipping(aCase, lowerBounds, upperBounds, xIndex, yIndex);
+        if (vertices != NULL)
+                goto bail;
         
         temp = DSMatrixCalloc(4, DSVariablePoolNumberOfVariables(DSCaseXi(aCase)));
         DSMatrixSetDoubleValue(temp, 0, xIndex, 1.0);
@@ -1564,7 +2787,7 @@ extern DSVertices * DSCaseVerticesFor2DSlice(const DSCase *aCase, const DSVariab
         Zeta = DSMatrixAppendMatrices(DSCaseZeta(aCase), temp, false);
         DSMatrixFree(temp);
         DSMatrixMultiplyByScalar(A, -1.0);
-        linearProblem = dsCaseLinearProblemForMatrices(A, Zeta);
+        linearProblem = dsCaseLinearProblemForMatrices(A, Zeta, 2);
         
         if (linearProblem == NULL) {
                 DSError(M_DS_NULL ": Linear problem is NULL", A_DS_ERROR);
@@ -1573,33 +2796,33 @@ extern DSVertices * DSCaseVerticesFor2DSlice(const DSCase *aCase, const DSVariab
                 goto bail;
         }
         
-        if (dsCaseSetVariableBoundsLinearProblem(aCase, linearProblem, lowerBounds, upperBounds) != 2) {
+        if (dsCaseSetVariableBoundsProblem(aCase, linearProblem, lowerBounds, upperBounds) != 2) {
                 DSError(M_DS_WRONG ": Need two free variables", A_DS_ERROR);
                 DSMatrixFree(A);
                 DSMatrixFree(Zeta);
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
                 goto bail;
         }
         
-        if (glp_get_col_type(linearProblem, DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), xVariable)+1) == GLP_FX) {
+        if (DSLinearProblemColumnIsFixed(linearProblem, xIndex) == true) {
                 DSError(M_DS_WRONG ": X Variable is fixed", A_DS_ERROR);
                 DSMatrixFree(A);
                 DSMatrixFree(Zeta);
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
                 goto bail;
         }
-        if (glp_get_col_type(linearProblem, DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), yVariable)+1) == GLP_FX) {
+        if (DSLinearProblemColumnIsFixed(linearProblem, yIndex) == true) {
                 DSError(M_DS_WRONG ": Y Variable is fixed", A_DS_ERROR);
                 DSMatrixFree(A);
                 DSMatrixFree(Zeta);
-                glp_delete_prob(linearProblem);
+                dsCaseProblemRelease(linearProblem);
                 goto bail;
         }
         
         vertices = dsCaseCalculate2DVertices(aCase, linearProblem, A, Zeta, xIndex, yIndex);
         DSMatrixFree(A);
         DSMatrixFree(Zeta);
-        glp_delete_prob(linearProblem);
+        dsCaseProblemRelease(linearProblem);
 bail:
         return vertices;
 }
@@ -1782,8 +3005,11 @@ bail:
 //}
 //
 
-static void dsCaseOptimizationFunctionProcessExponentBasePairs(const DSCase *aCase, gma_parseraux_t *aux,
-                                                               DSMatrix * Od, DSMatrix * Oi, DSMatrix *delta)
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark Optimization functions
+#endif
+
+static void dsOptimizationFunctionProcessExponentBasePairs(DSOptimizationFunction * function, const DSVariablePool * Xd, const DSVariablePool * Xi, gma_parseraux_t *aux)
 {
         DSUInteger j, varIndex;
         const char *varName;
@@ -1793,81 +3019,167 @@ static void dsCaseOptimizationFunctionProcessExponentBasePairs(const DSCase *aCa
         }
         for (j = 0; j < DSGMAParserAuxNumberOfBases(aux); j++) {
                 if (DSGMAParserAuxBaseAtIndexIsVariable(aux, j) == false) {
-                        currentValue = DSMatrixDoubleValue(delta, index, 0);
-                        currentValue += log10(DSGMAParseAuxsConstantBaseAtIndex(aux, j));
-                        DSMatrixSetDoubleValue(delta,
-                                               index, 0,
-                                               currentValue);
+                        function->delta += log10(DSGMAParseAuxsConstantBaseAtIndex(aux, j));
                         continue;
                 }
                 varName = DSGMAParserAuxVariableAtIndex(aux, j);
-                if (DSVariablePoolHasVariableWithName(DSCaseXd(aCase), varName) == true) {
-                        varIndex = DSVariablePoolIndexOfVariableWithName(DSCaseXd(aCase), varName);
-                        currentValue = DSMatrixDoubleValue(Od, 0, varIndex);
+                if (DSVariablePoolHasVariableWithName(Xd, varName) == true) {
+                        varIndex = DSVariablePoolIndexOfVariableWithName(Xd, varName);
+                        currentValue = DSMatrixDoubleValue(function->Od, 0, varIndex);
                         currentValue += DSGMAParserAuxExponentAtIndex(aux, j);
-                        DSMatrixSetDoubleValue(Od, 0, varIndex, currentValue);
-                } else if (DSVariablePoolHasVariableWithName(DSCaseXi(aCase), varName) == true) {
-                        varIndex = DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), varName);
-                        currentValue = DSMatrixDoubleValue(Oi, 0, varIndex);
+                        DSMatrixSetDoubleValue(function->Od, 0, varIndex, currentValue);
+                } else if (DSVariablePoolHasVariableWithName(Xi, varName) == true) {
+                        varIndex = DSVariablePoolIndexOfVariableWithName(Xi, varName);
+                        currentValue = DSMatrixDoubleValue(function->Oi, 0, varIndex);
                         currentValue += DSGMAParserAuxExponentAtIndex(aux, j);
-                        DSMatrixSetDoubleValue(Oi, 0, varIndex, currentValue);
+                        DSMatrixSetDoubleValue(function->Oi, 0, varIndex, currentValue);
+                }
+        }
+bail:
+        return;
+}
+
+/**
+ * \brief Parses an optimization function that has already been processed as
+ * a DSExpression.
+ */
+static DSOptimizationFunction * dsOptimizationFunctionByParsingProcessedString(const DSVariablePool * Xd, const DSVariablePool * Xi, const char * string)
+{
+        DSOptimizationFunction * function = NULL;
+        gma_parseraux_t *aux = NULL;
+        DSVariablePool * eqVars = NULL;
+        DSExpression * expr;
+        DSUInteger i;
+        if (Xd == NULL || Xi == NULL) {
+                DSError(M_DS_WRONG ": Need Xi and Xd", A_DS_ERROR);
+                goto bail;
+        }
+        aux = dsCaseParseStringToTermList(string);
+        if (aux == NULL) {
+                goto bail;
+        }
+        function = DSSecureCalloc(sizeof(DSOptimizationFunction), 1);
+        function->Od = DSMatrixCalloc(1, DSVariablePoolNumberOfVariables(Xd));
+        function->Oi = DSMatrixCalloc(1, DSVariablePoolNumberOfVariables(Xi));
+        dsOptimizationFunctionProcessExponentBasePairs(function, Xd, Xi, aux);
+        DSGMAParserAuxFree(aux);
+        expr = DSExpressionByParsingString(string);
+        eqVars = DSExpressionVariablesInExpression(expr);
+        for (i = 0; i < DSVariablePoolNumberOfVariables(eqVars); i++) {
+                if (DSVariablePoolHasVariableWithName(Xd, DSVariableName(DSVariablePoolVariableAtIndex(eqVars, i)))) {
+                        function->hasXd = true;
+                        break;
                 }
         }
+        DSExpressionFree(expr);
+        DSVariablePoolFree(eqVars);
+bail:
+        return function;
+}
+
+/**
+ * \brief Parses an optimization function once, so that it can be applied to
+ * many cases.
+ *
+ * \details The function must be a power law of the dependent and independent
+ * variables.  Its string is processed and parsed once, and the exponents are
+ * stored in the order of the variable pools, so applying the function to a
+ * case does not parse any string.  The pools are usually those of the GMA
+ * system of the design space, or of any of its cases.
+ *
+ * \param Xd The variable pool with the dependent variables.
+ * \param Xi The variable pool with the independent variables.
+ * \param string The string with the optimization function.
+ *
+ * \return A new DSOptimizationFunction, which must be freed with
+ *         DSOptimizationFunctionFree, or NULL if the string could not be
+ *         parsed.
+ */
+extern DSOptimizationFunction * DSOptimizationFunctionByParsingString(const DSVariablePool * Xd, const DSVariablePool * Xi, const char * string)
+{
+        DSOptimizationFunction * function = NULL;
+        DSExpression * expression;
+        char * processedFunction;
+        expression = DSExpressionByParsingString(string);
+        if (expression == NULL) {
+                DSError(M_DS_NULL ": Could not parse function string", A_DS_ERROR);
+                goto bail;
+        }
+        processedFunction = DSExpressionAsString(expression);
+        DSExpressionFree(expression);
+        function = dsOptimizationFunctionByParsingProcessedString(Xd, Xi, processedFunction);
+        DSSecureFree(processedFunction);
+bail:
+        return function;
+}
+
+extern void DSOptimizationFunctionFree(DSOptimizationFunction * function)
+{
+        if (function == NULL) {
+                DSError(M_DS_NULL ": Optimization function is NULL", A_DS_WARN);
+                goto bail;
+        }
+        DSMatrixFree(function->Od);
+        DSMatrixFree(function->Oi);
+        DSSecureFree(function);
 bail:
         return;
 }
 
-static DSMatrixArray * dsCaseOptimiztionFunctionCreateMatrix(const DSCase *aCase, gma_parseraux_t *aux, bool hasXd)
+/**
+ * \brief Calculates the coefficients of an optimization function in terms of
+ * the independent variables of a case.
+ *
+ * \details If the function has dependent variables, they are replaced by
+ * their solution in the S-system of the case, log(Xd) = M*(B-Ai*log(Xi)).
+ *
+ * \return A DSMatrixArray with the 1 by |Xi| matrix of coefficients of the
+ *         independent variables, and the 1 by 1 matrix with the constant, or
+ *         NULL if the function cannot be applied to the case.
+ */
+extern DSMatrixArray * DSOptimizationFunctionMatricesForCase(const DSOptimizationFunction * function, const DSCase * aCase)
 {
         DSMatrixArray * optimizationMatrices = NULL;
-        DSMatrix * Od, *Oi, *delta;
+        DSMatrix * Oi, *delta;
         const DSSSystem * ssystem;
-        const DSVariablePool * Xd, *Xi;
-        DSMatrix * Ai, * B, * MAi, * Mb;
+        DSMatrix * Ai, * B, * OdM, * OdMAi, * OdMb;
+        if (function == NULL) {
+                DSError(M_DS_NULL ": Optimization function is NULL", A_DS_ERROR);
+                goto bail;
+        }
         if (aCase == NULL) {
                 DSError(M_DS_CASE_NULL, A_DS_ERROR);
                 goto bail;
         }
-        if (aux == NULL) {
-                DSError(M_DS_NULL ": Parser auxiliary data is NULL", A_DS_ERROR);
+        if (DSCaseXd(aCase) == NULL || DSCaseXi(aCase) == NULL) {
+                DSError(M_DS_WRONG ": Need Xi and Xd", A_DS_ERROR);
                 goto bail;
         }
-        Xd = DSCaseXd(aCase);
-        Xi = DSCaseXi(aCase);
-        if (Xd == NULL || Xi == NULL) {
-                DSError(M_DS_WRONG ": Need Xi and Xd", A_DS_ERROR);
+        if (DSMatrixColumns(function->Od) != DSVariablePoolNumberOfVariables(DSCaseXd(aCase))
+            || DSMatrixColumns(function->Oi) != DSVariablePoolNumberOfVariables(DSCaseXi(aCase))) {
+                DSError(M_DS_WRONG ": Optimization function and case have different variables", A_DS_ERROR);
                 goto bail;
         }
         ssystem = DSCaseSSystem(aCase);
-        Od = DSMatrixCalloc(1, DSVariablePoolNumberOfVariables(Xd));
-        Oi = DSMatrixCalloc(1, DSVariablePoolNumberOfVariables(Xi));
+        if (function->hasXd == true && DSSSystemHasSolution(ssystem) == false)
+                goto bail;
+        Oi = DSMatrixCopy(function->Oi);
         delta = DSMatrixCalloc(1, 1);
-        dsCaseOptimizationFunctionProcessExponentBasePairs(aCase, aux, Od, Oi, delta);
-        if (hasXd == true) {
-                if (DSSSystemHasSolution(ssystem) == false) {
-                        DSMatrixFree(Od);
-                        DSMatrixFree(Oi);
-                        DSMatrixFree(delta);
-                        goto bail;
-                }
+        DSMatrixSetDoubleValue(delta, 0, 0, function->delta);
+        if (function->hasXd == true) {
                 Ai = DSSSystemAi(ssystem);
                 B = DSSSystemB(ssystem);
-                MAi = DSMatrixByMultiplyingMatrix(DSSSystemM(ssystem), Ai);
-                Mb = DSMatrixByMultiplyingMatrix(DSSSystemM(ssystem), B);
-                DSMatrixFree(Ai);
-                DSMatrixFree(B);
-                Ai = MAi;
-                MAi = DSMatrixByMultiplyingMatrix(Od, MAi);
+                OdM = DSMatrixByMultiplyingMatrix(function->Od, DSSSystemM(ssystem));
+                OdMAi = DSMatrixByMultiplyingMatrix(OdM, Ai);
+                OdMb = DSMatrixByMultiplyingMatrix(OdM, B);
+                DSMatrixSubstractByMatrix(Oi, OdMAi);
+                DSMatrixAddByMatrix(delta, OdMb);
                 DSMatrixFree(Ai);
-                B = Mb;
-                Mb = DSMatrixByMultiplyingMatrix(Od, Mb);
                 DSMatrixFree(B);
-                DSMatrixSubstractByMatrix(Oi, MAi);
-                DSMatrixAddByMatrix(delta, Mb);
-                DSMatrixFree(MAi);
-                DSMatrixFree(Mb);
+                DSMatrixFree(OdM);
+                DSMatrixFree(OdMAi);
+                DSMatrixFree(OdMb);
         }
-        DSMatrixFree(Od);
         optimizationMatrices = DSMatrixArrayAlloc();
         DSMatrixArrayAddMatrix(optimizationMatrices, Oi);
         DSMatrixArrayAddMatrix(optimizationMatrices, delta);
@@ -1878,34 +3190,17 @@ bail:
 extern DSMatrixArray * DSCaseParseOptimizationFunction(const DSCase * aCase, const char * string)
 {
         DSMatrixArray * O = NULL;
-        DSVariablePool * eqVars = NULL;
-        DSExpression * expr;
-        bool hasXd = false;
-        DSUInteger i;
-        char * name;
+        DSOptimizationFunction * function = NULL;
         if (aCase == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
                 goto bail;
         }
-        gma_parseraux_t *aux = NULL;
-        aux = dsCaseParseStringToTermList(string);
-        if (aux == NULL) {
+        function = dsOptimizationFunctionByParsingProcessedString(DSCaseXd(aCase), DSCaseXi(aCase), string);
+        if (function == NULL) {
                 goto bail;
         }
-        expr = DSExpressionByParsingString(string);
-        eqVars = DSExpressionVariablesInExpression(expr);
-        for (i = 0; i < DSVariablePoolNumberOfVariables(eqVars); i++) {
-                name = DSVariableName(DSVariablePoolVariableAtIndex(eqVars, i));
-                if (DSVariablePoolHasVariableWithName(DSCaseXd(aCase), name)) {
-                        hasXd = true;
-                        break;
-                }
-        }
-        DSExpressionFree(expr);
-        DSVariablePoolFree(eqVars);
-        O = dsCaseOptimiztionFunctionCreateMatrix(aCase, aux, hasXd);
-        DSGMAParserAuxFree(aux);
-
+        O = DSOptimizationFunctionMatricesForCase(function, aCase);
+        DSOptimizationFunctionFree(function);
 bail:
         return O;
 }
@@ -2252,7 +3547,7 @@ extern DSPseudoCase * DSPseudoCaseFromIntersectionOfCasesExcludingSlice(const DS
         delta = NULL;
         DSSecureFree(indices_i);
         DSSecureFree(indices_d);
-        DSCaseRemoveRedundantBoundaries(caseIntersection);
+        DSCaseRemoveDuplicateBoundaries(caseIntersection);
 bail:
         if (Cd != NULL)
                 DSMatrixFree(Cd);
@@ -0,0 +1,332 @@
+/**
+ * \file DSCaseSet.c
+ * \brief Implementation file with functions for dealing with sets of case
+ * numbers.
+ *
+ * \details
+ *
+ * Copyright (C) 2011-2014 Jason Lomnitz.\n\n
+ *
+ * This file is part of the Design Space Toolbox V2 (C Library).
+ *
+ * The Design Space Toolbox V2 is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Design Space Toolbox V2 is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Design Space Toolbox. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * \author Jason Lomnitz.
+ * \date 2014
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "DSMemoryManager.h"
+#include "DSCaseSet.h"
+
+/**
+ * \brief The number of case numbers stored in each word of a case set.
+ */
+#define DS_CASE_SET_WORD_BITS           (sizeof(unsigned long)*8)
+
+/**
+ * \brief Index of the word containing the bit of a case number.
+ */
+#define dsCaseSetWord(x)                (((x)-1)/DS_CASE_SET_WORD_BITS)
+
+/**
+ * \brief Mask selecting the bit of a case number within its word.
+ */
+#define dsCaseSetMask(x)                (1UL << (((x)-1)%DS_CASE_SET_WORD_BITS))
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Allocation, deallocation and initialization
+#endif
+
+/**
+ * \brief Creates an empty case set.
+ *
+ * \param maximumCaseNumber The largest case number that can be stored in the
+ *        set; normally the number of cases of the design space.
+ *
+ * \return A pointer to the new DSCaseSet.
+ */
+extern DSCaseSet * DSCaseSetAlloc(const DSUInteger maximumCaseNumber)
+{
+        DSCaseSet * set = NULL;
+        set = DSSecureCalloc(sizeof(DSCaseSet), 1);
+        set->maximumCaseNumber = maximumCaseNumber;
+        /** Rounding up without adding to maximumCaseNumber, which may be close to overflow **/
+        set->numberOfWords = maximumCaseNumber/DS_CASE_SET_WORD_BITS + (maximumCaseNumber % DS_CASE_SET_WORD_BITS != 0);
+        if (set->numberOfWords > 0)
+                set->words = DSSecureCalloc(sizeof(unsigned long), set->numberOfWords);
+        set->count = 0;
+        return set;
+}
+
+extern DSCaseSet * DSCaseSetCopy(const DSCaseSet * set)
+{
+        DSCaseSet * copy = NULL;
+        if (set == NULL) {
+                DSError(M_DS_CASE_SET_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        copy = DSCaseSetAlloc(set->maximumCaseNumber);
+        if (set->numberOfWords > 0)
+                memcpy(copy->words, set->words, sizeof(unsigned long)*set->numberOfWords);
+        copy->count = set->count;
+bail:
+        return copy;
+}
+
+extern void DSCaseSetFree(DSCaseSet * set)
+{
+        if (set == NULL) {
+                DSError(M_DS_CASE_SET_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (set->words != NULL)
+                DSSecureFree(set->words);
+        DSSecureFree(set);
+bail:
+        return;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Insertion and membership
+#endif
+
+/**
+ * \brief Adds a case number to a case set.
+ *
+ * \details The bit of the case number is set with an atomic or operation, and
+ * the count is only incremented by the thread that actually set the bit. This
+ * function can therefore be called concurrently on the same set without
+ * additional locking.
+ *
+ * \param set The DSCaseSet where the case number is added.
+ * \param caseNumber The case number being added.
+ *
+ * \return A boolean value indicating if the case number was not already in the
+ *         set.
+ */
+extern bool DSCaseSetAddCaseNumber(DSCaseSet * set, const DSUInteger caseNumber)
+{
+        bool added = false;
+        unsigned long previous, mask;
+        if (set == NULL) {
+                DSError(M_DS_CASE_SET_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (caseNumber == 0 || caseNumber > set->maximumCaseNumber) {
+                DSError(M_DS_WRONG ": Case number out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        mask = dsCaseSetMask(caseNumber);
+        previous = __sync_fetch_and_or(&set->words[dsCaseSetWord(caseNumber)], mask);
+        if ((previous & mask) == 0) {
+                __sync_fetch_and_add(&set->count, 1);
+                added = true;
+        }
+bail:
+        return added;
+}
+
+extern bool DSCaseSetContainsCaseNumber(const DSCaseSet * set, const DSUInteger caseNumber)
+{
+        bool contains = false;
+        if (set == NULL) {
+                DSError(M_DS_CASE_SET_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (caseNumber == 0 || caseNumber > set->maximumCaseNumber)
+                goto bail;
+        contains = ((set->words[dsCaseSetWord(caseNumber)] & dsCaseSetMask(caseNumber)) != 0);
+bail:
+        return contains;
+}
+
+extern DSUInteger DSCaseSetCount(const DSCaseSet * set)
+{
+        DSUInteger count = 0;
+        if (set == NULL) {
+                DSError(M_DS_CASE_SET_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        count = set->count;
+bail:
+        return count;
+}
+
+extern DSUInteger DSCaseSetMaximumCaseNumber(const DSCaseSet * set)
+{
+        DSUInteger maximumCaseNumber = 0;
+        if (set == NULL) {
+                DSError(M_DS_CASE_SET_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        maximumCaseNumber = set->maximumCaseNumber;
+bail:
+        return maximumCaseNumber;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Ordered iteration
+#endif
+
+/**
+ * \brief Returns the smallest case number in a set that is greater than a
+ * given case number.
+ *
+ * \details Starting with a case number of 0 and passing the previously returned
+ * case number iterates over the set in increasing order. Empty words are
+ * skipped as a whole, so iterating over a sparse set is proportional to the
+ * number of words rather than the number of cases.
+ *
+ * \param set The DSCaseSet being iterated.
+ * \param caseNumber The case number after which the search starts.
+ *
+ * \return The next case number in the set, or 0 if there are no more case
+ *         numbers.
+ */
+extern DSUInteger DSCaseSetNextCaseNumber(const DSCaseSet * set, const DSUInteger caseNumber)
+{
+        DSUInteger next = 0, word, bit;
+        unsigned long bits;
+        if (set == NULL) {
+                DSError(M_DS_CASE_SET_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (caseNumber >= set->maximumCaseNumber)
+                goto bail;
+        /** The bit of caseNumber+1 is bit caseNumber **/
+        word = caseNumber / DS_CASE_SET_WORD_BITS;
+        bit = caseNumber % DS_CASE_SET_WORD_BITS;
+        bits = set->words[word] & (~0UL << bit);
+        while (bits == 0) {
+                if (++word >= set->numberOfWords)
+                        goto bail;
+                bits = set->words[word];
+        }
+        next = word*DS_CASE_SET_WORD_BITS + __builtin_ctzl(bits) + 1;
+bail:
+        return next;
+}
+
+/**
+ * \brief Returns an ordered array with the case numbers in a set.
+ *
+ * \param set The DSCaseSet being queried.
+ * \param numberOfCases A pointer to a DSUInteger where the number of case
+ *        numbers in the array is stored. May be NULL.
+ *
+ * \return A newly allocated array with the case numbers in increasing order,
+ *         or NULL if the set is empty. The caller is responsible for freeing
+ *         the array.
+ */
+extern DSUInteger * DSCaseSetCaseNumbers(const DSCaseSet * set, DSUInteger * numberOfCases)
+{
+        DSUInteger * caseNumbers = NULL;
+        DSUInteger i, count, caseNumber = 0;
+        if (numberOfCases != NULL)
+                *numberOfCases = 0;
+        if (set == NULL) {
+                DSError(M_DS_CASE_SET_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        count = set->count;
+        if (count == 0)
+                goto bail;
+        caseNumbers = DSSecureMalloc(sizeof(DSUInteger)*count);
+        for (i = 0; i < count; i++) {
+                caseNumber = DSCaseSetNextCaseNumber(set, caseNumber);
+                if (caseNumber == 0)
+                        break;
+                caseNumbers[i] = caseNumber;
+        }
+        if (numberOfCases != NULL)
+                *numberOfCases = i;
+bail:
+        return caseNumbers;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Set operations
+#endif
+
+/**
+ * \brief Recalculates the number of case numbers in a set from its bits.
+ */
+static void dsCaseSetRecount(DSCaseSet * set)
+{
+        DSUInteger i;
+        set->count = 0;
+        for (i = 0; i < set->numberOfWords; i++)
+                set->count += __builtin_popcountl(set->words[i]);
+}
+
+/**
+ * \brief Creates a case set with the case numbers in either of two sets.
+ *
+ * \details The union is calculated one word at a time. The new set can store
+ * case numbers up to the largest maximum case number of the two sets.
+ *
+ * \return A new DSCaseSet with the union of both sets.
+ */
+extern DSCaseSet * DSCaseSetUnion(const DSCaseSet * set1, const DSCaseSet * set2)
+{
+        DSCaseSet * set = NULL;
+        DSUInteger i;
+        if (set1 == NULL || set2 == NULL) {
+                DSError(M_DS_CASE_SET_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (set1->maximumCaseNumber < set2->maximumCaseNumber) {
+                set = DSCaseSetCopy(set2);
+                set2 = set1;
+        } else {
+                set = DSCaseSetCopy(set1);
+        }
+        for (i = 0; i < set2->numberOfWords; i++)
+                set->words[i] |= set2->words[i];
+        dsCaseSetRecount(set);
+bail:
+        return set;
+}
+
+/**
+ * \brief Creates a case set with the case numbers in both of two sets.
+ *
+ * \details The intersection is calculated one word at a time. The new set can
+ * store case numbers up to the smallest maximum case number of the two sets.
+ *
+ * \return A new DSCaseSet with the intersection of both sets.
+ */
+extern DSCaseSet * DSCaseSetIntersection(const DSCaseSet * set1, const DSCaseSet * set2)
+{
+        DSCaseSet * set = NULL;
+        DSUInteger i;
+        if (set1 == NULL || set2 == NULL) {
+                DSError(M_DS_CASE_SET_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (set1->maximumCaseNumber > set2->maximumCaseNumber) {
+                set = DSCaseSetCopy(set2);
+                set2 = set1;
+        } else {
+                set = DSCaseSetCopy(set1);
+        }
+        for (i = 0; i < set->numberOfWords; i++)
+                set->words[i] &= set2->words[i];
+        dsCaseSetRecount(set);
+bail:
+        return set;
+}
@@ -0,0 +1,82 @@
+/**
+ * \file DSCaseSet.h
+ * \brief Header file with functions for dealing with sets of case numbers.
+ *
+ * \details A case set stores case numbers as bits in an array of words.
+ * Adding a case number is a single atomic operation, so multiple threads can
+ * insert case numbers into the same set without locks. Membership tests and
+ * counts do not allocate memory, and case numbers are always iterated in
+ * increasing order.
+ *
+ * Copyright (C) 2011-2014 Jason Lomnitz.\n\n
+ *
+ * This file is part of the Design Space Toolbox V2 (C Library).
+ *
+ * The Design Space Toolbox V2 is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Design Space Toolbox V2 is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Design Space Toolbox. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * \author Jason Lomnitz.
+ * \date 2014
+ */
+
+#include <stdbool.h>
+#include "DSTypes.h"
+#include "DSErrors.h"
+
+#ifndef __DS_CASE_SET__
+#define __DS_CASE_SET__
+
+#define M_DS_CASE_SET_NULL              M_DS_NULL ": Case set is NULL"
+
+#ifdef __cplusplus
+__BEGIN_DECLS
+#endif
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Allocation, deallocation and initialization
+#endif
+
+extern DSCaseSet * DSCaseSetAlloc(const DSUInteger maximumCaseNumber);
+extern DSCaseSet * DSCaseSetCopy(const DSCaseSet * set);
+extern void DSCaseSetFree(DSCaseSet * set);
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Insertion and membership
+#endif
+
+extern bool DSCaseSetAddCaseNumber(DSCaseSet * set, const DSUInteger caseNumber);
+extern bool DSCaseSetContainsCaseNumber(const DSCaseSet * set, const DSUInteger caseNumber);
+
+extern DSUInteger DSCaseSetCount(const DSCaseSet * set);
+extern DSUInteger DSCaseSetMaximumCaseNumber(const DSCaseSet * set);
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Ordered iteration
+#endif
+
+extern DSUInteger DSCaseSetNextCaseNumber(const DSCaseSet * set, const DSUInteger caseNumber);
+extern DSUInteger * DSCaseSetCaseNumbers(const DSCaseSet * set, DSUInteger * numberOfCases);
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Set operations
+#endif
+
+extern DSCaseSet * DSCaseSetUnion(const DSCaseSet * set1, const DSCaseSet * set2);
+extern DSCaseSet * DSCaseSetIntersection(const DSCaseSet * set1, const DSCaseSet * set2);
+
+#ifdef __cplusplus
+__END_DECLS
+#endif
+
+#endif
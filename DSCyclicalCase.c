@@ -32,6 +32,7 @@
 #include <string.h>
 #include <stdio.h>
 #include "DSCyclicalCase.h"
+#include "DSCaseSet.h"
 
 extern DSDesignSpace * DSCyclicalCaseInternalForUnderdeterminedCase(const DSCase * aCase, const DSDesignSpace * original);
 extern DSDesignSpace * DSCyclicalCaseDesignSpacesForUnderdeterminedCase(const DSCase * aCase, const DSDesignSpace * original);
@@ -404,7 +405,7 @@ extern DSDictionary * DSCyclicalCaseCalculateAllValidSubcases(const DSCyclicalCa
                 goto bail;
         }
         for (i = 0; i < numberValid; i++) {
-                validCaseNumbers = atoi(ds->validCases->names[i]);
+                validCaseNumbers = DSCaseSetNextCaseNumber(ds->validCases, validCaseNumbers);
                 aCase = DSDesignSpaceCaseWithCaseNumber(ds, validCaseNumbers);
                 DSDictionaryAddValueWithName(caseDictionary, DSCaseIdentifier(aCase), aCase);
         }
@@ -437,7 +438,7 @@ extern DSDictionary * DSCyclicalCaseCalculateAllValidSubcasesForSlice(const DSCy
                 goto bail;
         }
         for (i = 0; i < numberValid; i++) {
-                validCaseNumbers = atoi(ds->validCases->names[i]);
+                validCaseNumbers = DSCaseSetNextCaseNumber(ds->validCases, validCaseNumbers);
                 aCase = DSDesignSpaceCaseWithCaseNumber(ds, validCaseNumbers);
                 if (DSCaseIsValidAtSlice(aCase, lower, upper, true) == true) {
                         DSDictionaryAddValueWithName(caseDictionary, DSCaseIdentifier(aCase), aCase);
@@ -476,7 +477,7 @@ extern DSDictionary * DSCyclicalCaseVerticesForSlice(const DSCyclicalCase *cycli
                 goto bail;
         }
         for (i = 0; i < numberValid; i++) {
-                validCaseNumbers = atoi(ds->validCases->names[i]);
+                validCaseNumbers = DSCaseSetNextCaseNumber(ds->validCases, validCaseNumbers);
                 aCase = DSDesignSpaceCaseWithCaseNumber(ds, validCaseNumbers);
                 if (DSCaseIsValidAtSlice(aCase, lowerBounds, upperBounds, true) == true) {
                         vertices = DSCaseVerticesForSlice(aCase, lowerBounds, upperBounds, numberOfVariables, variables);
@@ -515,7 +516,7 @@ extern DSDictionary * DSCyclicalCaseVerticesFor2DSlice(const DSCyclicalCase *cyc
                 goto bail;
         }
         for (i = 0; i < numberValid; i++) {
-                validCaseNumbers = atoi(ds->validCases->names[i]);
+                validCaseNumbers = DSCaseSetNextCaseNumber(ds->validCases, validCaseNumbers);
                 aCase = DSDesignSpaceCaseWithCaseNumber(ds, validCaseNumbers);
                 if (DSCaseIsValidAtSlice(aCase, lowerBounds, upperBounds, true) == true) {
                         vertices = DSCaseVerticesFor2DSlice(aCase, lowerBounds, upperBounds, xVariable, yVariable);
@@ -39,7 +39,9 @@
 #include "DSSSystem.h"
 #include "DSCase.h"
 #include "DSStack.h"
+#include "DSCaseSet.h"
 #include "DSDesignSpaceParallel.h"
+#include "DSThreadPool.h"
 #include "DSCyclicalCase.h"
 #include "DSGMASystemParsingAux.h"
 #include "DSDesignSpaceConditionGrammar.h"
@@ -68,7 +70,6 @@
 
 extern void DSCaseRemoveZeroBoundaries(DSCase *aCase);
 
-static void dsDesignSpaceCalculatePrunedValidityParallelBSD(DSDesignSpace *ds, const DSUInteger numberOfCases, const DSUInteger * caseNumber);
 
 extern DSDesignSpace * DSDesignSpaceAlloc(void)
 {
@@ -96,7 +97,7 @@ void DSDesignSpaceFree(DSDesignSpace * ds)
         if (DSDSDelta(ds) != NULL)
                 DSMatrixFree(DSDSDelta(ds));
         if (DSDSValidPool(ds) != NULL) 
-                DSDictionaryFree(DSDSValidPool(ds));
+                DSCaseSetFree(DSDSValidPool(ds));
         if (DSDSCasePrefix(ds) != NULL)
                 DSSecureFree(DSDSCasePrefix(ds));
         DSDictionaryFreeWithFunction(DSDSCyclical(ds), DSCyclicalCaseFree);
@@ -243,6 +244,49 @@ bail:
         return;
 }
 
+/**
+ * \brief Sets the order in which all the cases of a design space are
+ * enumerated when calculating their validity.
+ *
+ * \details When enabled, cases are enumerated in Gray code order (see
+ * DSDesignSpaceCaseNumberForGrayCodeIndex), so that each case differs from
+ * the previous one in a single dominant term and its S-System is solved by
+ * updating the solution of the previous case.
+ */
+extern void DSDesignSpaceSetGrayCodeEnumeration(DSDesignSpace *ds, bool grayCode)
+{
+        unsigned char newFlag;
+        if (ds == NULL) {
+                DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        newFlag = ds->modifierFlags & ~DS_DESIGN_SPACE_FLAG_GRAY_CODE;
+        ds->modifierFlags = (grayCode ? DS_DESIGN_SPACE_FLAG_GRAY_CODE : 0) | newFlag;
+bail:
+        return;
+}
+
+/**
+ * \brief Sets if the redundant boundaries of the valid cases of a design space
+ * are removed when the cases are calculated.
+ *
+ * \details When enabled, DSCaseRemoveRedundantBoundaries is applied to the
+ * cases returned by DSDesignSpaceCalculateAllValidCases and to the cases
+ * passed to the visitor of DSDesignSpaceVisitValidCases.
+ */
+extern void DSDesignSpaceSetRemoveRedundantBoundaries(DSDesignSpace *ds, bool removeRedundant)
+{
+        unsigned char newFlag;
+        if (ds == NULL) {
+                DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        newFlag = ds->modifierFlags & ~DS_DESIGN_SPACE_FLAG_REMOVE_REDUNDANT_BOUNDARIES;
+        ds->modifierFlags = (removeRedundant ? DS_DESIGN_SPACE_FLAG_REMOVE_REDUNDANT_BOUNDARIES : 0) | newFlag;
+bail:
+        return;
+}
+
 #if defined (__APPLE__) && defined (__MACH__)
 #pragma mark - Getters -
 #endif
@@ -262,6 +306,16 @@ extern bool DSDesignSpaceResolveCoDominance(const DSDesignSpace *ds)
         return ds->modifierFlags & DS_DESIGN_SPACE_FLAG_RESOLVE_CO_DOMINANCE;
 }
 
+extern bool DSDesignSpaceGrayCodeEnumeration(const DSDesignSpace *ds)
+{
+        return ds->modifierFlags & DS_DESIGN_SPACE_FLAG_GRAY_CODE;
+}
+
+extern bool DSDesignSpaceRemoveRedundantBoundaries(const DSDesignSpace *ds)
+{
+        return ds->modifierFlags & DS_DESIGN_SPACE_FLAG_REMOVE_REDUNDANT_BOUNDARIES;
+}
+
 
 extern const DSVariablePool * DSDesignSpaceXi(const DSDesignSpace *ds)
 {
@@ -324,21 +378,7 @@ extern const DSUInteger DSDesignSpaceNumberOfValidCases(const DSDesignSpace *ds)
         }
         if (DSDSValidPool(ds) == NULL)
                 DSDesignSpaceCalculateValidityOfCases((DSDesignSpace *)ds);
-        numberValdCases = DSDictionaryCount(DSDSValidPool(ds));
-bail:
-        return numberValdCases;
-}
-
-extern const DSUInteger DSDesignSpaceNumberOfValidCasesFromPrunedCases(const DSDesignSpace *ds, DSUInteger numberOfCases, DSUInteger * caseNumbers)
-{
-        DSUInteger numberValdCases = 0;
-        if (ds == NULL) {
-                DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
-                goto bail;
-        }
-        if (DSDSValidPool(ds) == NULL)
-                dsDesignSpaceCalculatePrunedValidityParallelBSD((DSDesignSpace *)ds, numberOfCases, caseNumbers);
-        numberValdCases = DSDictionaryCount(DSDSValidPool(ds));
+        numberValdCases = DSCaseSetCount(DSDSValidPool(ds));
 bail:
         return numberValdCases;
 }
@@ -693,6 +733,17 @@ bail:
 }
 
 extern DSCase * DSDesignSpaceCaseWithCaseNumber(const DSDesignSpace * ds, const DSUInteger caseNumber)
+{
+        return DSDesignSpaceCaseWithCaseNumberAndNeighbor(ds, caseNumber, NULL);
+}
+
+/**
+ * \brief Creates a case of a design space, reusing the S-System solution of a
+ * neighboring case.
+ *
+ * \see DSCaseWithTermsFromDesignSpaceAndNeighbor
+ */
+extern DSCase * DSDesignSpaceCaseWithCaseNumberAndNeighbor(const DSDesignSpace * ds, const DSUInteger caseNumber, const DSCase * neighbor)
 {
         DSCase * aCase = NULL;
         DSCase * processedCase;
@@ -715,7 +766,7 @@ extern DSCase * DSDesignSpaceCaseWithCaseNumber(const DSDesignSpace * ds, const
         }
         terms = DSCaseSignatureForCaseNumber(caseNumber, DSDSGMA(ds));
         if (terms != NULL) {
-                aCase = DSCaseWithTermsFromDesignSpace(ds, terms, DSDesignSpaceCasePrefix(ds));
+                aCase = DSCaseWithTermsFromDesignSpaceAndNeighbor(ds, terms, DSDesignSpaceCasePrefix(ds), neighbor);
                 DSSecureFree(terms);
                 if (DSDesignSpaceResolveCoDominance(ds) == true) {
                         processedCase = dsDesignSpaceCaseByRemovingIdenticalFluxes(ds, aCase);
@@ -729,6 +780,103 @@ bail:
         return aCase;
 }
 
+/**
+ * \brief Creates a lazy case of a design space.
+ *
+ * \details Lazy cases defer solving their S-System until it is needed (see
+ * DSCaseLazyWithTermsFromDesignSpace).  Cases of design spaces that resolve
+ * co-dominance are modified after they are constructed, and are always
+ * complete.
+ */
+extern DSCase * DSDesignSpaceLazyCaseWithCaseNumber(const DSDesignSpace * ds, const DSUInteger caseNumber)
+{
+        DSCase * aCase = NULL;
+        DSUInteger * terms = NULL;
+        if (ds == NULL) {
+                DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (DSDesignSpaceResolveCoDominance(ds) == true) {
+                aCase = DSDesignSpaceCaseWithCaseNumber(ds, caseNumber);
+                goto bail;
+        }
+        if (DSDSGMA(ds) == NULL) {
+                DSError(M_DS_GMA_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (caseNumber == 0) {
+                DSError(M_DS_WRONG ": Case number is 0", A_DS_ERROR);
+                goto bail;
+        }
+        if (caseNumber > DSDSNumCases(ds)) {
+                DSError(M_DS_WRONG ": Case number out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        terms = DSCaseSignatureForCaseNumber(caseNumber, DSDSGMA(ds));
+        if (terms != NULL) {
+                aCase = DSCaseLazyWithTermsFromDesignSpace(ds, terms);
+                DSSecureFree(terms);
+        }
+bail:
+        return aCase;
+}
+
+/**
+ * \brief Returns the case number at a position of the Gray code order of the
+ * cases of a design space.
+ *
+ * \details The Gray code order is the reflected mixed-radix Gray code over
+ * the dominant terms of the signature, with the last position changing
+ * fastest.  The signatures of consecutive indices differ in exactly one
+ * dominant term, and every case appears exactly once.
+ *
+ * \param ds The DSDesignSpace whose cases are enumerated.
+ * \param index The position in the Gray code order, starting at 0.
+ *
+ * \return The case number at the position, or 0 if the index is out of
+ *         bounds.
+ */
+extern DSUInteger DSDesignSpaceCaseNumberForGrayCodeIndex(const DSDesignSpace * ds, const DSUInteger index)
+{
+        DSUInteger caseNumber = 0;
+        DSUInteger i, numberOfPositions, divisor, digit, remainder;
+        const DSUInteger * termList;
+        DSUInteger * signature = NULL;
+        bool reflected = false;
+        if (ds == NULL) {
+                DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (DSDSGMA(ds) == NULL) {
+                DSError(M_DS_GMA_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (index >= DSDSNumCases(ds)) {
+                DSError(M_DS_WRONG ": Gray code index out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        termList = DSGMASystemSignature(DSDSGMA(ds));
+        numberOfPositions = 2*DSGMASystemNumberOfEquations(DSDSGMA(ds));
+        signature = DSSecureMalloc(sizeof(DSUInteger)*numberOfPositions);
+        divisor = DSDSNumCases(ds);
+        remainder = index;
+        for (i = 0; i < numberOfPositions; i++) {
+                divisor /= termList[i];
+                digit = remainder / divisor;
+                remainder %= divisor;
+                /** The sequence of the remaining positions is reversed whenever the digit is odd **/
+                if (reflected == true)
+                        digit = termList[i]-1-digit;
+                signature[i] = digit+1;
+                if (digit % 2 == 1)
+                        reflected = !reflected;
+        }
+        caseNumber = DSCaseNumberForSignature(signature, DSDSGMA(ds));
+        DSSecureFree(signature);
+bail:
+        return caseNumber;
+}
+
 extern DSCase * DSDesignSpaceCaseWithCaseIdentifier(const DSDesignSpace * ds, const char * identifer)
 {
         const DSCyclicalCase * cyclicalCase;
@@ -810,7 +958,6 @@ extern DSCase * DSDesignSpaceCaseWithCaseSignatureList(const DSDesignSpace *ds,
 extern const bool DSDesignSpaceCaseWithCaseNumberIsValid(const DSDesignSpace *ds, const DSUInteger caseNumber)
 {
         bool isValid = false;
-        char * string = NULL;
         if (ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
                 goto bail;
@@ -825,11 +972,8 @@ extern const bool DSDesignSpaceCaseWithCaseNumberIsValid(const DSDesignSpace *ds
         }
         if (DSDSValidPool(ds) == NULL)
                 DSDesignSpaceCalculateValidityOfCases((DSDesignSpace *)ds);
-        string = DSSecureCalloc(sizeof(char), 100);
-        sprintf(string, "%d", caseNumber);
-        isValid = ((DSDictionaryValueForName(DSDSValidPool(ds), string) != NULL) ? true : false);
+        isValid = DSCaseSetContainsCaseNumber(DSDSValidPool(ds), caseNumber);
 //        isValid = DSCaseIsValid(DSDesignSpaceCaseWithCaseNumber(ds, caseNumber));
-        DSSecureFree(string);
 bail:
         return isValid;
 }
@@ -1292,11 +1436,9 @@ bail:
 static void dsDesignSpaceCalculateCyclicalCasesParallelBSD(DSDesignSpace *ds)
 {
         DSUInteger i;
-        DSUInteger numberOfThreads = (DSUInteger)sysconf(_SC_NPROCESSORS_ONLN);
+        DSUInteger numberOfThreads = DSThreadPoolNumberOfThreads();
         DSUInteger numberOfCases;
-        pthread_t * threads = NULL;
-        pthread_attr_t attr;
-        ds_parallelstack_t *stack;
+        ds_parallelrange_t range;
         struct pthread_struct *pdatas;
         if (ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
@@ -1316,30 +1458,15 @@ static void dsDesignSpaceCalculateCyclicalCasesParallelBSD(DSDesignSpace *ds)
                 goto bail;
         }
         DSParallelInitMutexes();
-        pthread_attr_init(&attr);
-        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-        /* Should optimize number of threads to system Optimal ~ 2*number of processors */
-        
-        /* Initializing parallel data stacks and pthreads data structure */
+        /* Initializing the range of cases and thread pool task data structure */
         pdatas = DSSecureCalloc(sizeof(struct pthread_struct),numberOfThreads);
-        stack = DSParallelStackAlloc();
+        DSParallelRangeInit(&range, 1, numberOfCases+1, numberOfThreads);
         for (i = 0; i < numberOfThreads; i++) {
                 pdatas[i].ds = ds;
-                pdatas[i].stack = stack;
+                pdatas[i].range = &range;
         }
-        for (i = 0; i < numberOfCases; i++)
-                DSParallelStackPush(stack, i+1);
-        
-        threads = DSSecureCalloc(sizeof(pthread_t), numberOfThreads);
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_create(&threads[i], &attr, DSParallelWorkerCyclicalCases, (void *)(&pdatas[i]));
-        /* Joining all the N-threads, indicating all cases have been processed */
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_join(threads[i], NULL);
-        DSParallelStackFree(stack);
-        DSSecureFree(threads);
+        DSThreadPoolRun(DSParallelWorkerCyclicalCases, pdatas, sizeof(struct pthread_struct), numberOfThreads);
         DSSecureFree(pdatas);
-        pthread_attr_destroy(&attr);
 bail:
         return;
 }
@@ -1347,9 +1474,9 @@ bail:
 
 static void dsDesignSpaceCalculateValiditySeries(DSDesignSpace *ds)
 {
-        DSUInteger i;
+        DSUInteger i, caseNumber;
         char * string = NULL;
-        DSCase * aCase = NULL;
+        DSCase * aCase = NULL, * neighbor = NULL;
         const DSCyclicalCase * cyclicalCase;
         bool strict = true;
         if (ds == NULL) {
@@ -1369,25 +1496,41 @@ static void dsDesignSpaceCalculateValiditySeries(DSDesignSpace *ds)
                 DSError(M_DS_WRONG ": GMA signature is NULL", A_DS_ERROR);
                 goto bail;
         }
-        DSDSValidPool(ds) = DSDictionaryAlloc();
+        DSDSValidPool(ds) = DSCaseSetAlloc(DSDSNumCases(ds));
         string = DSSecureCalloc(sizeof(char), 100);
 //        if (DSDesignSpaceCyclical(ds) == true)
 //                strict = true;
+        DSCaseLinearProgrammingContextBegin();
         for (i = 0; i < DSDSNumCases(ds); i++) {
-                aCase = DSDesignSpaceCaseWithCaseNumber(ds, i+1);
+                caseNumber = i+1;
+                if (DSDesignSpaceGrayCodeEnumeration(ds) == true)
+                        caseNumber = DSDesignSpaceCaseNumberForGrayCodeIndex(ds, i);
+                if (DSGMASystemCaseNumberHasTermConflicts(DSDSGMA(ds), caseNumber) == true)
+                        continue;
+                aCase = DSDesignSpaceLazyCaseWithCaseNumber(ds, caseNumber);
                 if (aCase == NULL)
                         continue;
-                sprintf(string, "%d", i+1);
-                if (DSCaseIsValid(aCase, strict) == true) {
-                        DSDictionaryAddValueWithName(ds->validCases, string, (void*)1);
+                sprintf(string, "%d", caseNumber);
+                if (DSCaseIsValidWithNeighbor(aCase, strict, neighbor) == true) {
+                        DSCaseSetAddCaseNumber(ds->validCases, caseNumber);
                 } else if (DSDictionaryValueForName(ds->cyclicalCases, string) != NULL) {
-                        cyclicalCase = DSDesignSpaceCyclicalCaseWithCaseNumber(ds, i+1);
+                        cyclicalCase = DSDesignSpaceCyclicalCaseWithCaseNumber(ds, caseNumber);
                         if (DSCyclicalCaseIsValid(cyclicalCase, strict) == true)
-                                DSDictionaryAddValueWithName(ds->validCases, string, (void*)1);
+                                DSCaseSetAddCaseNumber(ds->validCases, caseNumber);
+                }
+                /** Only cases that solved their S-System are useful neighbors **/
+                if (DSCaseIsLazy(aCase) == true) {
+                        DSCaseFree(aCase);
+                        continue;
                 }
-                DSCaseFree(aCase);
+                if (neighbor != NULL)
+                        DSCaseFree(neighbor);
+                neighbor = aCase;
                 
         }
+        DSCaseLinearProgrammingContextEnd();
+        if (neighbor != NULL)
+                DSCaseFree(neighbor);
         DSSecureFree(string);
         
 bail:
@@ -1399,10 +1542,8 @@ static DSDictionary * dsDesignSpaceCalculateValidityOfCaseSetParallelBSD(DSDesig
         DSDictionary * caseDictionary = NULL;
         DSUInteger i, j;
         const char * name;
-        long int numberOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
-        pthread_t * threads = NULL;
-        pthread_attr_t attr;
-        ds_parallelstack_t *stack;
+        DSUInteger numberOfThreads = DSThreadPoolNumberOfThreads();
+        ds_parallelrange_t range;
         struct pthread_struct *pdatas;
         if (ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
@@ -1423,31 +1564,19 @@ static DSDictionary * dsDesignSpaceCalculateValidityOfCaseSetParallelBSD(DSDesig
 //        numberValid = DSDesignSpaceNumberOfValidCases(ds);
 //        if (numberValid == 0)
 //                goto bail;
-        pthread_attr_init(&attr);
-        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-        /* Should optimize number of threads to system */
-        
-        /* Initializing parallel data stacks and pthreads data structure */
-        
-        stack = DSParallelStackAlloc();
-        stack->argument_type = DS_STACK_ARG_CASE;
-        pdatas = DSSecureMalloc(sizeof(struct pthread_struct)*numberOfThreads);
+        /* Initializing the range of cases and thread pool task data structure */
+        DSParallelRangeInit(&range, 0, numberOfCases, numberOfThreads);
+        range.argument_type = DS_STACK_ARG_CASE;
+        range.cases = cases;
+        pdatas = DSSecureCalloc(sizeof(struct pthread_struct), numberOfThreads);
         for (i = 0; i < numberOfThreads; i++) {
                 pdatas[i].ds = ds;
-                pdatas[i].stack = stack;
+                pdatas[i].range = &range;
                 pdatas[i].numberOfArguments = 0;
                 pdatas[i].functionArguments = NULL;//DSSecureMalloc(sizeof(DSVariablePool *)*2);
         }
-        for (i = 0; i < numberOfCases; i++) {
-                DSParallelStackPush(stack, cases[i]);
-        }
-        threads = DSSecureCalloc(sizeof(pthread_t), numberOfThreads);
-        /* Creating the N-threads with their data */
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_create(&threads[i], &attr, DSParallelWorkerValidity, (void *)(&pdatas[i]));
-        /* Joining all the N-threads, indicating all cases have been processed */
+        DSThreadPoolRun(DSParallelWorkerValidity, pdatas, sizeof(struct pthread_struct), numberOfThreads);
         for (i = 0; i < numberOfThreads; i++) {
-                pthread_join(threads[i], NULL);
                 for (j = 0; j < DSDictionaryCount(pdatas[i].returnPointer); j++) {
                         name = DSDictionaryNames((DSDictionary *)pdatas[i].returnPointer)[j];
                         DSDictionaryAddValueWithName(caseDictionary, name, DSDictionaryValueForName(pdatas[i].returnPointer, name));
@@ -1455,10 +1584,7 @@ static DSDictionary * dsDesignSpaceCalculateValidityOfCaseSetParallelBSD(DSDesig
                 DSDictionaryFree((DSDictionary*)pdatas[i].returnPointer);
                 DSSecureFree(pdatas[i].functionArguments);
         }
-        DSParallelStackFree(stack);
-        DSSecureFree(threads);
         DSSecureFree(pdatas);
-        pthread_attr_destroy(&attr);
 bail:
         return caseDictionary;
 }
@@ -1467,10 +1593,8 @@ bail:
 static void  dsDesignSpaceCalculateValidityParallelBSD(DSDesignSpace *ds)
 {
         DSUInteger i;
-        long int numberOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
-        pthread_t * threads = NULL;
-        pthread_attr_t attr;
-        ds_parallelstack_t *stack;
+        DSUInteger numberOfThreads = DSThreadPoolNumberOfThreads();
+        ds_parallelrange_t range;
         struct pthread_struct *pdatas;
         if (ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
@@ -1484,34 +1608,16 @@ static void  dsDesignSpaceCalculateValidityParallelBSD(DSDesignSpace *ds)
                 DSError(M_DS_WRONG ": GMA signature is NULL", A_DS_ERROR);
                 goto bail;
         }
-        DSDSValidPool(ds) = DSDictionaryAlloc();//DSVariablePoolAlloc();
-        pthread_attr_init(&attr);
-        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-        /* Should optimize number of threads to system */
-        
-        /* Initializing parallel data stacks and pthreads data structure */
-        
-        stack = DSParallelStackAlloc();
+        DSDSValidPool(ds) = DSCaseSetAlloc(DSDSNumCases(ds));
+        /* Initializing the range of cases and thread pool task data structure */
+        DSParallelRangeInit(&range, 1, DSDSNumCases(ds)+1, numberOfThreads);
         pdatas = DSSecureMalloc(sizeof(struct pthread_struct)*numberOfThreads);
         for (i = 0; i < numberOfThreads; i++) {
                 pdatas[i].ds = ds;
-                pdatas[i].stack = stack;
+                pdatas[i].range = &range;
         }
-        for (i = 0; i < DSDSNumCases(ds); i++)
-                DSParallelStackPush(stack, i+1);
-        
-        threads = DSSecureCalloc(sizeof(pthread_t), numberOfThreads);
-        /* Creating the N-threads with their data */
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_create(&threads[i], &attr, DSParallelWorkerValidity, (void *)(&pdatas[i]));
-        /* Joining all the N-threads, indicating all cases have been processed */
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_join(threads[i], NULL);
-        DSParallelStackFree(stack);
-        
-        DSSecureFree(threads);
+        DSThreadPoolRun(DSParallelWorkerValidity, pdatas, sizeof(struct pthread_struct), numberOfThreads);
         DSSecureFree(pdatas);
-        pthread_attr_destroy(&attr);
 bail:
         return;
 }
@@ -1537,7 +1643,7 @@ static DSDictionary * dsDesignSpaceCalculateAllValidCasesByResolvingCyclicalCase
         if (numberValid == 0)
                 goto bail;
         for (i = 0; i < numberValid; i++) {
-                validCaseNumbers = atoi(ds->validCases->names[i]);
+                validCaseNumbers = DSCaseSetNextCaseNumber(ds->validCases, validCaseNumbers);
                 aCase = DSDesignSpaceCaseWithCaseNumber(ds, validCaseNumbers);
                 sprintf(nameString, "%d", validCaseNumbers);
                 cyclicalCase = DSDesignSpaceCyclicalCaseWithCaseNumber(ds, validCaseNumbers);
@@ -1568,12 +1674,10 @@ static DSDictionary * dsDesignSpaceCalculateAllValidCasesByResolvingCyclicalCase
 {
         DSDictionary * caseDictionary = NULL;
         DSUInteger i, j, numberValid = 0;
-        DSUInteger validCaseNumbers = 0;
+        DSUInteger * validCaseNumbers = NULL;
         const char * name;
-        long int numberOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
-        pthread_t * threads = NULL;
-        pthread_attr_t attr;
-        ds_parallelstack_t *stack;
+        DSUInteger numberOfThreads = DSThreadPoolNumberOfThreads();
+        ds_parallelrange_t range;
         struct pthread_struct *pdatas;
         if (ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
@@ -1591,39 +1695,25 @@ static DSDictionary * dsDesignSpaceCalculateAllValidCasesByResolvingCyclicalCase
         numberValid = DSDesignSpaceNumberOfValidCases(ds);
         if (numberValid == 0)
                 goto bail;
-        pthread_attr_init(&attr);
-        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-        /* Should optimize number of threads to system */
-        
-        /* Initializing parallel data stacks and pthreads data structure */
-        
-        stack = DSParallelStackAlloc();
+        /* Initializing the range of cases and thread pool task data structure */
+        validCaseNumbers = DSCaseSetCaseNumbers(ds->validCases, &numberValid);
+        DSParallelRangeInit(&range, 0, numberValid, numberOfThreads);
+        range.caseNumbers = validCaseNumbers;
         pdatas = DSSecureMalloc(sizeof(struct pthread_struct)*numberOfThreads);
         for (i = 0; i < numberOfThreads; i++) {
                 pdatas[i].ds = ds;
-                pdatas[i].stack = stack;
+                pdatas[i].range = &range;
         }
-        for (i = 0; i < numberValid; i++) {
-                validCaseNumbers = atoi(ds->validCases->names[i]);
-                DSParallelStackPush(stack, validCaseNumbers);
-        }
-        threads = DSSecureCalloc(sizeof(pthread_t), numberOfThreads);
-        /* Creating the N-threads with their data */
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_create(&threads[i], &attr, DSParallelWorkerValidityResolveCycles, (void *)(&pdatas[i]));
-        /* Joining all the N-threads, indicating all cases have been processed */
+        DSThreadPoolRun(DSParallelWorkerValidityResolveCycles, pdatas, sizeof(struct pthread_struct), numberOfThreads);
         for (i = 0; i < numberOfThreads; i++) {
-                pthread_join(threads[i], NULL);
                 for (j = 0; j < DSDictionaryCount(pdatas[i].returnPointer); j++) {
                         name = DSDictionaryNames((DSDictionary *)pdatas[i].returnPointer)[j];
                         DSDictionaryAddValueWithName(caseDictionary, name, DSDictionaryValueForName(pdatas[i].returnPointer, name));
                 }
                 DSDictionaryFree((DSDictionary*)pdatas[i].returnPointer);
         }
-        DSParallelStackFree(stack);
-        DSSecureFree(threads);
+        DSSecureFree(validCaseNumbers);
         DSSecureFree(pdatas);
-        pthread_attr_destroy(&attr);
 bail:
         return caseDictionary;
 }
@@ -1652,7 +1742,7 @@ static DSDictionary * dsDesignSpaceCalculateAllValidCasesForSliceByResolvingCycl
         if (numberValid == 0)
                 goto bail;
         for (i = 0; i < numberValid; i++) {
-                validCaseNumbers = atoi(ds->validCases->names[i]);
+                validCaseNumbers = DSCaseSetNextCaseNumber(ds->validCases, validCaseNumbers);
                 aCase = DSDesignSpaceCaseWithCaseNumber(ds, validCaseNumbers);
                 sprintf(nameString, "%d", validCaseNumbers);
                 cyclicalCase = DSDesignSpaceCyclicalCaseWithCaseNumber(ds, validCaseNumbers);
@@ -1687,12 +1777,10 @@ static DSDictionary * dsDesignSpaceCalculateAllValidCasesForSliceByResolvingCycl
 {
         DSDictionary * caseDictionary = NULL;
         DSUInteger i, j, numberValid = 0;
-        DSUInteger validCaseNumbers = 0;
+        DSUInteger * validCaseNumbers = NULL;
         const char * name;
-        long int numberOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
-        pthread_t * threads = NULL;
-        pthread_attr_t attr;
-        ds_parallelstack_t *stack;
+        DSUInteger numberOfThreads = DSThreadPoolNumberOfThreads();
+        ds_parallelrange_t range;
         struct pthread_struct *pdatas;
         if (ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
@@ -1714,33 +1802,21 @@ static DSDictionary * dsDesignSpaceCalculateAllValidCasesForSliceByResolvingCycl
         numberValid = DSDesignSpaceNumberOfValidCases(ds);
         if (numberValid == 0)
                 goto bail;
-        pthread_attr_init(&attr);
-        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-        /* Should optimize number of threads to system */
-        
-        /* Initializing parallel data stacks and pthreads data structure */
-        
-        stack = DSParallelStackAlloc();
+        /* Initializing the range of cases and thread pool task data structure */
+        validCaseNumbers = DSCaseSetCaseNumbers(ds->validCases, &numberValid);
+        DSParallelRangeInit(&range, 0, numberValid, numberOfThreads);
+        range.caseNumbers = validCaseNumbers;
         pdatas = DSSecureMalloc(sizeof(struct pthread_struct)*numberOfThreads);
         for (i = 0; i < numberOfThreads; i++) {
                 pdatas[i].ds = ds;
-                pdatas[i].stack = stack;
+                pdatas[i].range = &range;
                 pdatas[i].numberOfArguments = 2;
                 pdatas[i].functionArguments = DSSecureMalloc(sizeof(DSVariablePool *)*2);
                 pdatas[i].functionArguments[0] = (void*)lower;
                 pdatas[i].functionArguments[1] = (void*)upper;
         }
-        for (i = 0; i < numberValid; i++) {
-                validCaseNumbers = atoi(ds->validCases->names[i]);
-                DSParallelStackPush(stack, (void *)(unsigned long int)validCaseNumbers);
-        }
-        threads = DSSecureCalloc(sizeof(pthread_t), numberOfThreads);
-        /* Creating the N-threads with their data */
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_create(&threads[i], &attr, DSParallelWorkerValidityForSliceResolveCycles, (void *)(&pdatas[i]));
-        /* Joining all the N-threads, indicating all cases have been processed */
+        DSThreadPoolRun(DSParallelWorkerValidityForSliceResolveCycles, pdatas, sizeof(struct pthread_struct), numberOfThreads);
         for (i = 0; i < numberOfThreads; i++) {
-                pthread_join(threads[i], NULL);
                 for (j = 0; j < DSDictionaryCount(pdatas[i].returnPointer); j++) {
                         name = DSDictionaryNames((DSDictionary *)pdatas[i].returnPointer)[j];
                         DSDictionaryAddValueWithName(caseDictionary, name, DSDictionaryValueForName(pdatas[i].returnPointer, name));
@@ -1748,10 +1824,8 @@ static DSDictionary * dsDesignSpaceCalculateAllValidCasesForSliceByResolvingCycl
                 DSDictionaryFree((DSDictionary*)pdatas[i].returnPointer);
                 DSSecureFree(pdatas[i].functionArguments);
         }
-        DSParallelStackFree(stack);
-        DSSecureFree(threads);
+        DSSecureFree(validCaseNumbers);
         DSSecureFree(pdatas);
-        pthread_attr_destroy(&attr);
 bail:
         return caseDictionary;
 }
@@ -1773,7 +1847,7 @@ static DSDictionary * dsDesignSpaceCalculateAllValidCasesForSliceSeries(DSDesign
         if (numberValid == 0)
                 goto bail;
         for (i = 0; i < numberValid; i++) {
-                validCaseNumbers = atoi(ds->validCases->names[i]);
+                validCaseNumbers = DSCaseSetNextCaseNumber(ds->validCases, validCaseNumbers);
                 aCase = DSDesignSpaceCaseWithCaseNumber(ds, validCaseNumbers);
                 sprintf(nameString, "%d", validCaseNumbers);
                 cyclicalCase = DSDesignSpaceCyclicalCaseWithCaseNumber(ds, validCaseNumbers);
@@ -1795,12 +1869,10 @@ static DSDictionary * dsDesignSpaceCalculateValidityAtSliceParallelBSD(DSDesignS
 {
         DSDictionary * caseDictionary = NULL;
         DSUInteger i, j, numberValid = 0;
-        DSUInteger validCaseNumbers = 0;
+        DSUInteger * validCaseNumbers = NULL;
         const char * name;
-        long int numberOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
-        pthread_t * threads = NULL;
-        pthread_attr_t attr;
-        ds_parallelstack_t *stack;
+        DSUInteger numberOfThreads = DSThreadPoolNumberOfThreads();
+        ds_parallelrange_t range;
         struct pthread_struct *pdatas;
         if (ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
@@ -1818,34 +1890,22 @@ static DSDictionary * dsDesignSpaceCalculateValidityAtSliceParallelBSD(DSDesignS
         numberValid = DSDesignSpaceNumberOfValidCases(ds);
         if (numberValid == 0)
                 goto bail;
-        pthread_attr_init(&attr);
-        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-        /* Should optimize number of threads to system */
-        
-        /* Initializing parallel data stacks and pthreads data structure */
-        
-        stack = DSParallelStackAlloc();
+        /* Initializing the range of cases and thread pool task data structure */
+        validCaseNumbers = DSCaseSetCaseNumbers(ds->validCases, &numberValid);
+        DSParallelRangeInit(&range, 0, numberValid, numberOfThreads);
+        range.caseNumbers = validCaseNumbers;
         pdatas = DSSecureMalloc(sizeof(struct pthread_struct)*numberOfThreads);
         for (i = 0; i < numberOfThreads; i++) {
                 pdatas[i].ds = ds;
-                pdatas[i].stack = stack;
+                pdatas[i].range = &range;
                 pdatas[i].numberOfArguments = 3;
                 pdatas[i].functionArguments = DSSecureMalloc(sizeof(DSVariablePool *)*3);
                 pdatas[i].functionArguments[0] = (void*)lower;
                 pdatas[i].functionArguments[1] = (void*)upper;
                 pdatas[i].functionArguments[2] = (void*)strict;
         }
-        for (i = 0; i < numberValid; i++) {
-                validCaseNumbers = atoi(ds->validCases->names[i]);
-                DSParallelStackPush(stack, validCaseNumbers);
-        }
-        threads = DSSecureCalloc(sizeof(pthread_t), numberOfThreads);
-        /* Creating the N-threads with their data */
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_create(&threads[i], &attr, DSParallelWorkerValiditySlice, (void *)(&pdatas[i]));
-        /* Joining all the N-threads, indicating all cases have been processed */
+        DSThreadPoolRun(DSParallelWorkerValiditySlice, pdatas, sizeof(struct pthread_struct), numberOfThreads);
         for (i = 0; i < numberOfThreads; i++) {
-                pthread_join(threads[i], NULL);
                 for (j = 0; j < DSDictionaryCount(pdatas[i].returnPointer); j++) {
                         name = DSDictionaryNames((DSDictionary *)pdatas[i].returnPointer)[j];
                         DSDictionaryAddValueWithName(caseDictionary, name, DSDictionaryValueForName(pdatas[i].returnPointer, name));
@@ -1853,10 +1913,8 @@ static DSDictionary * dsDesignSpaceCalculateValidityAtSliceParallelBSD(DSDesignS
                 DSDictionaryFree((DSDictionary*)pdatas[i].returnPointer);
                 DSSecureFree(pdatas[i].functionArguments);
         }
-        DSParallelStackFree(stack);
-        DSSecureFree(threads);
+        DSSecureFree(validCaseNumbers);
         DSSecureFree(pdatas);
-        pthread_attr_destroy(&attr);
 bail:
         return caseDictionary;
 }
@@ -1915,11 +1973,9 @@ bail:
 static DSCase ** dsDesignSpaceCalculateCasesFromPrefixesParallelBSD(DSDesignSpace *ds, DSUInteger * numberOfCases, const DSUInteger numberOfPrefixes, const DSUInteger sizeOfPrefix, DSUInteger ** prefixes)
 {
         DSUInteger i, j, numberInPrefix;
-        DSUInteger numberOfThreads = (DSUInteger)sysconf(_SC_NPROCESSORS_ONLN);
-        DSUInteger *temp;
-        pthread_t * threads = NULL;
-        pthread_attr_t attr;
-        ds_parallelstack_t *stack;
+        DSUInteger numberOfThreads = DSThreadPoolNumberOfThreads();
+        DSUInteger *temp, *caseNumbers = NULL;
+        ds_parallelrange_t range;
         DSCase ** processedCases = NULL;
         struct pthread_struct *pdatas;
         
@@ -1945,38 +2001,33 @@ static DSCase ** dsDesignSpaceCalculateCasesFromPrefixesParallelBSD(DSDesignSpac
         }
 
         DSParallelInitMutexes();
-        pthread_attr_init(&attr);
-        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-        /* Should optimize number of threads to system Optimal ~ 2*number of processors */
-        
-        /* Initializing parallel data stacks and pthreads data structure */
+        /* Initializing the range of cases and thread pool task data structure */
         pdatas = DSSecureMalloc(sizeof(struct pthread_struct)*numberOfThreads);
-        stack = DSParallelStackAlloc();
         for (i = 0; i < numberOfPrefixes; i++) {
                 temp = DSDesignSpaceCaseNumbersWithPrefix(ds, sizeOfPrefix, prefixes[i], &numberInPrefix);
                 *numberOfCases += numberInPrefix;
+                if (caseNumbers == NULL) {
+                        caseNumbers = DSSecureMalloc(sizeof(DSUInteger)**numberOfCases);
+                } else {
+                        caseNumbers = DSSecureRealloc(caseNumbers, sizeof(DSUInteger)**numberOfCases);
+                }
                 for (j = 0; j < numberInPrefix; j++) {
-                        DSParallelStackPush(stack, temp[j]);
+                        caseNumbers[*numberOfCases-numberInPrefix+j] = temp[j];
                 }
                 DSSecureFree(temp);
         }
         processedCases = DSSecureCalloc(sizeof(DSCase *), *numberOfCases);
-        stack->cases = processedCases;
+        DSParallelRangeInit(&range, 0, *numberOfCases, numberOfThreads);
+        range.caseNumbers = caseNumbers;
+        range.cases = processedCases;
         for (i = 0; i < numberOfThreads; i++) {
                 pdatas[i].ds = ds;
-                pdatas[i].stack = stack;
-        }
-        threads = DSSecureCalloc(sizeof(pthread_t), numberOfThreads);
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_create(&threads[i], &attr, DSParallelWorkerCases, (void *)(&pdatas[i]));
-        /* Joining all the N-threads, indicating all cases have been processed */
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_join(threads[i], NULL);
+                pdatas[i].range = &range;
+        }
+        DSThreadPoolRun(DSParallelWorkerCases, pdatas, sizeof(struct pthread_struct), numberOfThreads);
         
-        DSParallelStackFree(stack);
-        DSSecureFree(threads);
+        DSSecureFree(caseNumbers);
         DSSecureFree(pdatas);
-        pthread_attr_destroy(&attr);
 bail:
         return processedCases;
 }
@@ -2012,10 +2063,8 @@ bail:
 static DSCase ** dsDesignSpaceCalculateCasesParallelBSD(DSDesignSpace *ds, const DSUInteger numberOfCases, DSUInteger *cases)
 {
         DSUInteger i;
-        DSUInteger numberOfThreads = (DSUInteger)sysconf(_SC_NPROCESSORS_ONLN);
-        pthread_t * threads = NULL;
-        pthread_attr_t attr;
-        ds_parallelstack_t *stack;
+        DSUInteger numberOfThreads = DSThreadPoolNumberOfThreads();
+        ds_parallelrange_t range;
         DSCase ** processedCases = NULL;
         struct pthread_struct *pdatas;
         
@@ -2041,277 +2090,276 @@ static DSCase ** dsDesignSpaceCalculateCasesParallelBSD(DSDesignSpace *ds, const
         }
         
         DSParallelInitMutexes();
-        pthread_attr_init(&attr);
-        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
         processedCases = DSSecureCalloc(sizeof(DSCase *), numberOfCases);
-        /* Should optimize number of threads to system Optimal ~ 2*number of processors */
-        
-        /* Initializing parallel data stacks and pthreads data structure */
+        /* Initializing the range of cases and thread pool task data structure */
         pdatas = DSSecureMalloc(sizeof(struct pthread_struct)*numberOfThreads);
-        stack = DSParallelStackAlloc();
-        stack->cases = processedCases;
+        DSParallelRangeInit(&range, 0, numberOfCases, numberOfThreads);
+        range.caseNumbers = cases;
+        range.cases = processedCases;
         for (i = 0; i < numberOfThreads; i++) {
                 pdatas[i].ds = ds;
-                pdatas[i].stack = stack;
+                pdatas[i].range = &range;
         }
-        for (i = 0; i < numberOfCases; i++)
-                DSParallelStackPush(stack, cases[i]);
-        
-        threads = DSSecureCalloc(sizeof(pthread_t), numberOfThreads);
-        
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_create(&threads[i], &attr, DSParallelWorkerCases, (void *)(&pdatas[i]));
-        /* Joining all the N-threads, indicating all cases have been processed */
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_join(threads[i], NULL);
+        DSThreadPoolRun(DSParallelWorkerCases, pdatas, sizeof(struct pthread_struct), numberOfThreads);
         
-        DSParallelStackFree(stack);
-        
-        DSSecureFree(threads);
         DSSecureFree(pdatas);
-        pthread_attr_destroy(&attr);
 bail:
         return processedCases;
 }
 
-static DSUInteger * dsDesignSpaceCalculateCasesNumbersWithPrefixSignatures(DSDesignSpace *ds, DSUInteger * numberOfCases, const DSUInteger numberOfPrefixes, const DSUInteger sizeOfPrefix, const DSUInteger **prefixes)
+/**
+ * \brief Writes the conditions for a term of the GMA system to dominate the
+ * other terms of its position of the signature.
+ *
+ * \details The position is an index of the signature of the design space
+ * (positive and negative terms of each equation, in order).  One condition
+ * Cd*log(Xd) + Ci*log(Xi) + delta > 0 is written for each of the other terms
+ * of the position, starting at the given row of the matrices; the other rows
+ * are not modified.  The matrices must have enough rows.
+ *
+ * \param ds The DSDesignSpace containing the GMA system.
+ * \param position The position of the signature.
+ * \param term The dominant term of the position, starting at 1.
+ * \param Cd The matrix of conditions of the dependent variables.
+ * \param Ci The matrix of conditions of the independent variables, or NULL if
+ *        there are no independent variables.
+ * \param delta The column of constant terms of the conditions.
+ * \param firstRow The row where the first condition is written.
+ *
+ * \return The number of conditions written.
+ */
+extern DSUInteger DSDesignSpaceDominanceConditionsInto(const DSDesignSpace * ds, const DSUInteger position, const DSUInteger term, DSMatrix * Cd, DSMatrix * Ci, DSMatrix * delta, const DSUInteger firstRow)
 {
-        DSUInteger i, j, numberInPrefix;
-        DSUInteger * temp, * caseNumbers = NULL;
+        DSUInteger j, l = firstRow;
+        const DSGMASystem * gma;
+        const DSUInteger * termList;
+        const DSMatrix * coefficients;
+        double *xdRow, *xiRow;
         if (ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
                 goto bail;
         }
-        if (numberOfPrefixes == 0) {
-                DSError(M_DS_WRONG ": Number of cases to calculate is 0", A_DS_WARN);
+        if (Cd == NULL || delta == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
                 goto bail;
         }
-        if (prefixes == NULL) {
-                DSError(M_DS_NULL ": Array of cases to calculate is NULL", A_DS_ERROR);
+        gma = DSDSGMA(ds);
+        termList = DSGMASystemSignature(gma);
+        if (position >= 2*DSGMASystemNumberOfEquations(gma)) {
+                DSError(M_DS_WRONG ": Position is outside of the signature", A_DS_ERROR);
                 goto bail;
         }
-        if (sizeOfPrefix == 0) {
-                DSError(M_DS_NULL ": Array of cases to calculate is NULL", A_DS_ERROR);
+        if (term == 0 || term > termList[position]) {
+                DSError(M_DS_WRONG ": Dominant term is out of bounds", A_DS_ERROR);
                 goto bail;
         }
-        if (numberOfCases == NULL) {
-                DSError(M_DS_WRONG ": Number of cases to calculate is 0", A_DS_WARN);
+        if (firstRow+termList[position]-1 > DSMatrixRows(Cd)) {
+                DSError(M_DS_WRONG ": Matrices do not have enough rows", A_DS_ERROR);
                 goto bail;
         }
-        *numberOfCases = 0;
-        for (i = 0; i < numberOfPrefixes; i++) {
-                temp = DSDesignSpaceCaseNumbersWithPrefix(ds, sizeOfPrefix, prefixes[i], &numberInPrefix);
-                *numberOfCases += numberInPrefix;
-                if (caseNumbers == NULL) {
-                        caseNumbers = DSSecureMalloc(sizeof(DSUInteger)**numberOfCases);
-                } else {
-                        caseNumbers = DSSecureRealloc(caseNumbers, sizeof(DSUInteger)**numberOfCases);
-                }
-                for (j = 0; j < numberInPrefix; j++) {
-                        caseNumbers[*numberOfCases-numberInPrefix+j] = temp[j];
-                        printf("Temp:%i %i %i\n", temp[j], DSDesignSpaceNumberOfCases(ds), i);
-                }
-                DSSecureFree(temp);
+        coefficients = (position % 2 == 0) ? DSGMASystemAlpha(gma) : DSGMASystemBeta(gma);
+        for (j = 0; j < termList[position]; j++) {
+                if (j == term-1)
+                        continue;
+                DSMatrixElement(delta, l, 0) = log10(DSMatrixDoubleValue(coefficients, position/2, term-1)
+                                                     /DSMatrixDoubleValue(coefficients, position/2, j));
+                xdRow = &DSMatrixElement(Cd, l, 0);
+                xiRow = (Ci != NULL) ? &DSMatrixElement(Ci, l, 0) : NULL;
+                memset(xdRow, 0, sizeof(double)*DSMatrixColumns(Cd));
+                if (xiRow != NULL)
+                        memset(xiRow, 0, sizeof(double)*DSMatrixColumns(Ci));
+                DSGMASystemAddTermExponents(gma, position, term-1, 1.0, xdRow, xiRow);
+                DSGMASystemAddTermExponents(gma, position, j, -1.0, xdRow, xiRow);
+                l++;
         }
 bail:
-        return caseNumbers;
+        return l-firstRow;
 }
-static DSDesignSpace * dsDesignSpaceSubDesignSpaceByRemovingLastEquation(DSDesignSpace * ds)
+
+/**
+ * \brief Writes the additional conditions of a design space, starting at the
+ * given row of the matrices.
+ *
+ * \return The number of conditions written.
+ */
+extern DSUInteger DSDesignSpaceAdditionalConditionsInto(const DSDesignSpace * ds, DSMatrix * Cd, DSMatrix * Ci, DSMatrix * delta, const DSUInteger firstRow)
 {
-        DSDesignSpace * subds = NULL;
-        DSVariablePool *vars, * Xd_a;
-        DSUInteger i, j, numberOfEquations;
-        DSExpression ** equations, *lhs;
-        const char * name;
-        char ** strings;
+        DSUInteger numberOfConditions = 0;
+        DSMatrixView view;
         if (ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
                 goto bail;
         }
-        numberOfEquations = DSDesignSpaceNumberOfEquations(ds);
-        if (numberOfEquations == 1) {
+        if (DSDSCd(ds) == NULL)
                 goto bail;
-        }
-        numberOfEquations--;
-        equations = DSDesignSpaceEquations(ds);
-        Xd_a = DSVariablePoolAlloc();
-        strings = DSSecureMalloc(sizeof(char *)*numberOfEquations);
-//        numberOfXd = 0;
-        for (i = 0; i < numberOfEquations; i++) {
-                strings[i] = DSExpressionAsString(equations[i]);
-                lhs = DSExpressionEquationLHSExpression(equations[i]);
-                vars = DSExpressionVariablesInExpression(lhs);
-                if (DSVariablePoolNumberOfVariables(vars) == 1) {
-                        DSExpressionFree(lhs);
-                        DSSecureFree(vars);
-                        DSExpressionFree(equations[i]);
-                        continue;
-                }
-                DSExpressionFree(lhs);
-                DSSecureFree(vars);
-                lhs = DSExpressionEquationRHSExpression(equations[i]);
-                vars = DSExpressionVariablesInExpression(lhs);
-                for (j = 0; j < DSVariablePoolNumberOfVariables(vars); j++) {
-                        name = DSVariableName(DSVariablePoolVariableAtIndex(vars, j));
-                        if (DSVariablePoolHasVariableWithName(DSGMASystemXd_a(DSDesignSpaceGMASystem(ds)), name) == false)
-                                continue;
-                        if (DSVariablePoolHasVariableWithName(Xd_a, name) == true)
-                                continue;
-                        DSVariablePoolAddVariableWithName(Xd_a, name);
-                        break;
-                }
-                DSExpressionFree(lhs);
-                DSSecureFree(vars);
-                DSExpressionFree(equations[i]);
-        }
-        DSSecureFree(equations);
-        DSVariablePoolPrint(Xd_a);
-        subds = DSDesignSpaceByParsingStrings(strings, Xd_a, numberOfEquations);
-        for (i = 0; i < numberOfEquations; i++) {
-                DSSecureFree(strings[i]);
-        }
-        DSVariablePoolFree(Xd_a);
-        DSSecureFree(strings);
+        numberOfConditions = DSMatrixRows(DSDSCd(ds));
+        DSMatrixCopyInto(DSMatrixViewOfRows(&view, Cd, firstRow, numberOfConditions), DSDSCd(ds));
+        DSMatrixCopyInto(DSMatrixViewOfRows(&view, delta, firstRow, numberOfConditions), DSDSDelta(ds));
+        if (Ci != NULL && DSDSCi(ds) != NULL)
+                DSMatrixCopyInto(DSMatrixViewOfRows(&view, Ci, firstRow, numberOfConditions), DSDSCi(ds));
+        else if (Ci != NULL)
+                DSMatrixSetDoubleValueAll(DSMatrixViewOfRows(&view, Ci, firstRow, numberOfConditions), 0.0);
 bail:
-        return subds;
+        return numberOfConditions;
 }
 
-static void dsDesignSpaceCalculatePrunedValidityParallelBSD(DSDesignSpace *ds, const DSUInteger numberOfCases, const DSUInteger * caseNumber)
+/**
+ * \brief Determines if the dominance conditions of a partial signature can be
+ * satisfied.
+ *
+ * \details The partial signature fixes the dominant terms of the first
+ * numberOfTerms positions of the signature of the design space (positive and
+ * negative terms of each equation, in order).  The conditions for these terms
+ * to dominate, together with the additional conditions of the design space,
+ * are tested for a solution in the joint space of dependent and independent
+ * variables.  Every case whose signature starts with the partial signature has
+ * these conditions, so if they cannot be satisfied no such case can be valid.
+ *
+ * The branch-and-bound search does not call this function; it keeps the
+ * conditions of the path to each node and only adds those of the last
+ * position (see DSDesignSpaceDominanceConditionsInto).
+ *
+ * \param ds The DSDesignSpace containing the GMA system.
+ * \param signature The array of dominant terms; only the first numberOfTerms
+ *        entries are used.
+ * \param numberOfTerms The number of positions of the signature that are fixed.
+ *
+ * \return A boolean value indicating if the partial signature may lead to
+ *         valid cases.
+ */
+extern const bool DSDesignSpacePartialSignatureIsFeasible(const DSDesignSpace * ds, const DSUInteger * signature, const DSUInteger numberOfTerms)
 {
-        DSUInteger i;
-        long int numberOfThreads = sysconf(_SC_NPROCESSORS_ONLN);
-        pthread_t * threads = NULL;
-        pthread_attr_t attr;
-        ds_parallelstack_t *stack;
-        struct pthread_struct *pdatas;
+        bool isFeasible = false;
+        DSUInteger i, l, numberOfConditions, numberOfXd, numberOfXi;
+        const DSGMASystem * gma;
+        const DSUInteger * termList;
+        DSMatrix * Cd = NULL, * Ci = NULL, * delta = NULL;
         if (ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
                 goto bail;
         }
-        if (DSDSGMA(ds) == NULL) {
+        if (signature == NULL) {
+                DSError(M_DS_NULL ": Array of dominant terms is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        gma = DSDSGMA(ds);
+        if (gma == NULL) {
                 DSError(M_DS_GMA_NULL, A_DS_ERROR);
                 goto bail;
         }
-        if (DSGMASystemSignature(DSDSGMA(ds)) == NULL) {
-                DSError(M_DS_WRONG ": GMA signature is NULL", A_DS_ERROR);
+        termList = DSGMASystemSignature(gma);
+        if (numberOfTerms > 2*DSGMASystemNumberOfEquations(gma)) {
+                DSError(M_DS_WRONG ": Partial signature is longer than the signature", A_DS_ERROR);
                 goto bail;
         }
-        DSDSValidPool(ds) = DSDictionaryAlloc();//DSVariablePoolAlloc();
-        pthread_attr_init(&attr);
-        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-        /* Should optimize number of threads to system */
-        
-        /* Initializing parallel data stacks and pthreads data structure */
-        
-        stack = DSParallelStackAlloc();
-        pdatas = DSSecureMalloc(sizeof(struct pthread_struct)*numberOfThreads);
-        for (i = 0; i < numberOfThreads; i++) {
-                pdatas[i].ds = ds;
-                pdatas[i].stack = stack;
+        numberOfXd = DSVariablePoolNumberOfVariables(DSGMASystemXd(gma));
+        numberOfXi = DSVariablePoolNumberOfVariables(DSGMASystemXi(gma));
+        numberOfConditions = 0;
+        for (i = 0; i < numberOfTerms; i++)
+                numberOfConditions += termList[i]-1;
+        if (DSDSCd(ds) != NULL)
+                numberOfConditions += DSMatrixRows(DSDSCd(ds));
+        if (numberOfConditions == 0) {
+                isFeasible = true;
+                goto bail;
+        }
+        Cd = DSMatrixAlloc(numberOfConditions, numberOfXd);
+        if (numberOfXi > 0)
+                Ci = DSMatrixAlloc(numberOfConditions, numberOfXi);
+        delta = DSMatrixAlloc(numberOfConditions, 1);
+        l = DSDesignSpaceAdditionalConditionsInto(ds, Cd, Ci, delta, 0);
+        for (i = 0; i < numberOfTerms; i++) {
+                if (signature[i] == 0 || signature[i] > termList[i]) {
+                        DSError(M_DS_WRONG ": Dominant term is out of bounds", A_DS_ERROR);
+                        goto bail;
+                }
+                l += DSDesignSpaceDominanceConditionsInto(ds, i, signature[i], Cd, Ci, delta, l);
         }
-        for (i = 0; i < numberOfCases; i++) {
-                DSParallelStackPush(stack, caseNumber[i]);
-                printf("%i\n", caseNumber[i]);
-        }
-        DSDesignSpacePrint(ds);
-        threads = DSSecureCalloc(sizeof(pthread_t), numberOfThreads);
-        /* Creating the N-threads with their data */
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_create(&threads[i], &attr, DSParallelWorkerValidity, (void *)(&pdatas[i]));
-        /* Joining all the N-threads, indicating all cases have been processed */
-        for (i = 0; i < numberOfThreads; i++)
-                pthread_join(threads[i], NULL);
-        DSParallelStackFree(stack);
-        DSSecureFree(threads);
-        DSSecureFree(pdatas);
-        pthread_attr_destroy(&attr);
+        isFeasible = DSCaseConditionMatricesAreValid(Cd, Ci, delta);
 bail:
-        return;
+        if (Cd != NULL)
+                DSMatrixFree(Cd);
+        if (Ci != NULL)
+                DSMatrixFree(Ci);
+        if (delta != NULL)
+                DSMatrixFree(delta);
+        return isFeasible;
 }
 
-static DSUInteger ** dsDesignSpaceCalculateValidCasesByPrunning(DSDesignSpace *ds, DSUInteger * numberValid)
+/**
+ * \brief Calculates the valid cases of a design space by a depth-first
+ * branch-and-bound search over dominance signatures.
+ *
+ * \details The search fixes the dominant term of one position of the
+ * signature at a time, and discards the whole subtree of a partial signature
+ * as soon as its dominance conditions cannot be satisfied (see
+ * DSDesignSpacePartialSignatureIsFeasible).  Only complete signatures that
+ * survive are built as cases and tested for validity.  Subtrees above the
+ * split depth are submitted as thread pool tasks; the split depth is the
+ * shallowest depth with at least DS_PARALLEL_PRUNING_TASK_FACTOR subtrees per
+ * thread.
+ */
+static void dsDesignSpaceCalculateValidityByPrunning(DSDesignSpace *ds)
 {
-        DSUInteger ** validSignatures = NULL;
-        DSUInteger ** validPrefixes, *caseNumbers;
-        DSCase ** validCases;
+        DSUInteger numberOfThreads = DSThreadPoolNumberOfThreads();
+        DSUInteger i, numberOfPositions, numberOfSubtrees, numberOfConditions, numberOfXi;
         const DSUInteger * termList;
-        DSUInteger i, numberOfEquations, numberOfPrefixes, numberOfCases;
-        DSDesignSpace * subds;
+        ds_parallelprunednode_t * root;
+        DSThreadPoolGroup * group = NULL;
         if (ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
                 goto bail;
         }
-        if (DSDesignSpaceNumberOfEquations(ds) == 1) {
-                termList = DSDesignSpaceSignature(ds);
-                if (termList[0] == 1 && termList[1] == 1) {
-                        validSignatures = DSSecureMalloc(sizeof(DSUInteger *));
-                        validSignatures[0] = DSSecureMalloc(sizeof(DSUInteger)*2);
-                        validSignatures[0][0] = 1;
-                        validSignatures[0][1] = 1;
-                } else {
-                        validCases = DSDesignSpaceCalculateAllValidCases(ds);
-                        printf("Valid at root: %i\n", DSDesignSpaceNumberOfValidCases(ds));
-                        for (i = 0; i < DSDesignSpaceNumberOfEquations(ds); i++) {
-                                DSExpressionPrint(DSDesignSpaceEquations(ds)[i]);
-                        }
-                        *numberValid = DSDesignSpaceNumberOfValidCases(ds);
-                        validSignatures = DSSecureMalloc(sizeof(DSUInteger *)**numberValid);
-                        for (i = 0; i < *numberValid; i++) {
-                                validSignatures[i] = DSCaseSignatureForCaseNumber(DSCaseNumber(validCases[i]), DSDesignSpaceGMASystem(ds));
-                                DSCaseFree(validCases[i]);
-                        }
-                        DSSecureFree(validCases);
-                        goto bail;
-                }
-        }
-        subds = dsDesignSpaceSubDesignSpaceByRemovingLastEquation(ds);
-        validPrefixes = dsDesignSpaceCalculateValidCasesByPrunning(subds, &numberOfPrefixes);
-        termList = DSDesignSpaceSignature(subds);
-        numberOfEquations = DSDesignSpaceNumberOfEquations(ds);
-        if (termList[numberOfEquations*2-2] == 1 && termList[numberOfEquations*2-1] == 1) {
-                for (i = 0; i < numberOfPrefixes; i++) {
-                        validPrefixes[i] = DSSecureRealloc(validPrefixes[i],sizeof(DSUInteger)*numberOfEquations*2);
-                        validPrefixes[i][numberOfEquations*2-2] = 1;
-                        validPrefixes[i][numberOfEquations*2-1] = 1;
-                }
-                validSignatures = validPrefixes;
-                *numberValid = numberOfPrefixes;
-                DSSecureFree(subds);
+        if (DSDSGMA(ds) == NULL) {
+                DSError(M_DS_GMA_NULL, A_DS_ERROR);
                 goto bail;
         }
-        caseNumbers = dsDesignSpaceCalculateCasesNumbersWithPrefixSignatures(ds, &numberOfCases, numberOfPrefixes,
-                                                                             DSDesignSpaceNumberOfEquations(subds)*2, (const DSUInteger **)validPrefixes);
-        for (i = 0; i < numberOfPrefixes; i++) {
-                DSSecureFree(validPrefixes[i]);
+        termList = DSGMASystemSignature(DSDSGMA(ds));
+        if (termList == NULL) {
+                DSError(M_DS_WRONG ": GMA signature is NULL", A_DS_ERROR);
+                goto bail;
         }
-        DSSecureFree(validPrefixes);
-        DSDesignSpaceFree(subds);
-        *numberValid = DSDesignSpaceNumberOfValidCasesFromPrunedCases(ds, numberOfCases, caseNumbers);
-        validSignatures = DSSecureMalloc(sizeof(DSUInteger *)**numberValid);
-        validCases = DSDesignSpaceCalculateAllValidCases(ds);
-        for (i = 0; i < *numberValid; i++) {
-                validSignatures[i] = DSCaseSignatureForCaseNumber(DSCaseNumber(validCases[i]), DSDesignSpaceGMASystem(ds));
-                DSCaseFree(validCases[i]);
+        DSDSValidPool(ds) = DSCaseSetAlloc(DSDSNumCases(ds));
+        numberOfPositions = 2*DSGMASystemNumberOfEquations(DSDSGMA(ds));
+        root = DSSecureCalloc(sizeof(ds_parallelprunednode_t), 1);
+        root->ds = ds;
+        root->depth = 0;
+        root->signature = DSSecureCalloc(sizeof(DSUInteger), numberOfPositions);
+        root->splitDepth = 0;
+        /** Room for the additional conditions and those of every position **/
+        numberOfConditions = (DSDSCd(ds) != NULL) ? DSMatrixRows(DSDSCd(ds)) : 0;
+        for (i = 0; i < numberOfPositions; i++)
+                numberOfConditions += termList[i]-1;
+        numberOfXi = DSVariablePoolNumberOfVariables(DSGMASystemXi(DSDSGMA(ds)));
+        root->Cd = DSMatrixAlloc(numberOfConditions+1, DSVariablePoolNumberOfVariables(DSGMASystemXd(DSDSGMA(ds))));
+        root->Ci = (numberOfXi > 0) ? DSMatrixAlloc(numberOfConditions+1, numberOfXi) : NULL;
+        root->delta = DSMatrixAlloc(numberOfConditions+1, 1);
+        root->numberOfConditions = DSDesignSpaceAdditionalConditionsInto(ds, root->Cd, root->Ci, root->delta, 0);
+        if (DSDesignSpaceSerial(ds) == false && numberOfThreads > 1) {
+                numberOfSubtrees = 1;
+                while (root->splitDepth < numberOfPositions && numberOfSubtrees < numberOfThreads*DS_PARALLEL_PRUNING_TASK_FACTOR)
+                        numberOfSubtrees *= termList[root->splitDepth++];
+                group = DSThreadPoolGroupAlloc();
+        }
+        root->group = group;
+        DSParallelWorkerPrunedValidity(root);
+        if (group != NULL) {
+                DSThreadPoolGroupWait(group);
+                DSThreadPoolGroupFree(group);
         }
-        DSSecureFree(validCases);
 bail:
-        return validSignatures;
+        return;
 }
 
 extern DSCase ** DSDesignSpaceCalculateValidCasesByPrunning(DSDesignSpace *ds)
 {
         DSCase ** validCases = NULL;
-        DSUInteger ** validSignatures = NULL;
-        DSUInteger i, numberValid;
         if (ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
                 goto bail;
         }
-        validSignatures = dsDesignSpaceCalculateValidCasesByPrunning(ds, &numberValid);
-        for (i = 0; i < numberValid; i++) {
-                DSSecureFree(validSignatures[i]);
-        }
-        DSSecureFree(validSignatures);
+        if (DSDSValidPool(ds) == NULL)
+                dsDesignSpaceCalculateValidityByPrunning(ds);
         validCases = DSDesignSpaceCalculateAllValidCases(ds);
 bail:
         return validCases;
@@ -2349,16 +2397,179 @@ extern DSCase ** DSDesignSpaceCalculateAllValidCases(DSDesignSpace *ds)
         numberValid = DSDesignSpaceNumberOfValidCases(ds);
         if (numberValid == 0)
                 goto bail;
-        validCaseNumbers = DSSecureMalloc(sizeof(DSUInteger)*numberValid);
-        for (i = 0; i < numberValid; i++) {
-                validCaseNumbers[i] = atoi(ds->validCases->names[i]);
-        }
+        validCaseNumbers = DSCaseSetCaseNumbers(ds->validCases, &numberValid);
         validCases = DSDesignSpaceCalculateCases(ds, numberValid, validCaseNumbers);
         DSSecureFree(validCaseNumbers);
+        if (validCases != NULL && DSDesignSpaceRemoveRedundantBoundaries(ds) == true) {
+                for (i = 0; i < numberValid; i++)
+                        if (validCases[i] != NULL)
+                                DSCaseRemoveRedundantBoundaries(validCases[i]);
+        }
 bail:
         return validCases;
 }
 
+/**
+ * \brief Calculates the bounding boxes of the valid cases of a design space.
+ *
+ * \details The bounding boxes are calculated in parallel with
+ * DSCaseBoundingBoxesForCases, which solves a single linear problem per case.
+ *
+ * \param ds The DSDesignSpace whose valid cases are bounded.
+ * \param lower A DSVariablePool with the lower bounds of the slice, or NULL.
+ * \param upper A DSVariablePool with the upper bounds of the slice, or NULL.
+ *
+ * \return A DSDictionary with the bounding box of each valid case, as
+ *         returned by DSCaseBoundingBox, with the case number as the key.
+ *         Cases that are not valid within the slice are not included.  The
+ *         caller is responsible for freeing the dictionary and its matrices.
+ */
+extern DSDictionary * DSDesignSpaceBoundingBoxesForValidCases(DSDesignSpace *ds, const DSVariablePool * lower, const DSVariablePool * upper)
+{
+        DSDictionary * boxes = NULL;
+        DSMatrixArray * matrices = NULL;
+        DSCase ** validCases = NULL;
+        DSUInteger i, numberValid = 0;
+        char nameString[100];
+        if (ds == NULL) {
+                DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        boxes = DSDictionaryAlloc();
+        validCases = DSDesignSpaceCalculateAllValidCases(ds);
+        if (validCases == NULL)
+                goto bail;
+        numberValid = DSDesignSpaceNumberOfValidCases(ds);
+        matrices = DSCaseBoundingBoxesForCases(numberValid, (const DSCase **)validCases, lower, upper);
+        for (i = 0; i < numberValid; i++) {
+                if (validCases[i] == NULL)
+                        continue;
+                if (matrices != NULL && DSMatrixArrayMatrix(matrices, i) != NULL) {
+                        sprintf(nameString, "%d", DSCaseNumber(validCases[i]));
+                        DSDictionaryAddValueWithName(boxes, nameString, DSMatrixArrayMatrix(matrices, i));
+                }
+                DSCaseFree(validCases[i]);
+        }
+        DSSecureFree(validCases);
+        /** The matrices are now owned by the dictionary **/
+        if (matrices != NULL)
+                DSMatrixArrayFreeWithoutMatrices(matrices);
+bail:
+        return boxes;
+}
+
+/**
+ * \brief Visits the valid cases of a design space without keeping them in
+ * memory.
+ *
+ * \details Cases are built by the thread pool and passed to the visitor as
+ * they are produced, and each case is freed as soon as the visitor returns.
+ * If the valid cases have already been calculated only those cases are built;
+ * otherwise each case is tested for validity by the worker that builds it,
+ * and the set of valid cases of the design space is left unchanged.
+ *
+ * When cases are delivered unordered, the visitor is called from the worker
+ * threads (one call at a time) and at most one case per thread is in memory.
+ * When cases are delivered in order, the workers store their results in a
+ * reorder buffer keyed by position, and the calling thread calls the visitor
+ * in increasing case number as soon as consecutive results are available.
+ * Workers never build a case more than DS_DESIGN_SPACE_VISIT_WINDOW_FACTOR
+ * cases per thread ahead of the next case to be visited.
+ *
+ * \param ds The DSDesignSpace whose valid cases are visited.
+ * \param visitor The function called with each valid case.  Returning false
+ *        stops the enumeration.
+ * \param context A pointer passed to each call of the visitor.
+ * \param ordered A boolean value indicating if cases must be visited in
+ *        increasing case number.
+ *
+ * \return The number of cases passed to the visitor.
+ */
+extern DSUInteger DSDesignSpaceVisitValidCases(DSDesignSpace *ds, DSDesignSpaceCaseVisitor visitor, void * context, const bool ordered)
+{
+        DSUInteger i, start, end, numberOfCases = 0, numberVisited = 0;
+        DSUInteger numberOfThreads = DSThreadPoolNumberOfThreads();
+        DSUInteger * caseNumbers = NULL;
+        DSThreadPoolGroup * group = NULL;
+        ds_parallelrange_t range;
+        ds_parallelvisitor_t visit;
+        void * functionArguments[1];
+        struct pthread_struct *pdatas = NULL;
+        if (ds == NULL) {
+                DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (visitor == NULL) {
+                DSError(M_DS_NULL ": Case visitor is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (DSDSGMA(ds) == NULL) {
+                DSError(M_DS_GMA_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        visit.visitor = visitor;
+        visit.context = context;
+        visit.stop = false;
+        visit.numberVisited = 0;
+        visit.validityKnown = (DSDSValidPool(ds) != NULL);
+        visit.buffer = NULL;
+        visit.isDone = NULL;
+        visit.bufferSize = 0;
+        pthread_mutex_init(&visit.lock, NULL);
+        pthread_cond_init(&visit.changed, NULL);
+        if (visit.validityKnown == true) {
+                caseNumbers = DSCaseSetCaseNumbers(DSDSValidPool(ds), &numberOfCases);
+                start = 0;
+                end = numberOfCases;
+        } else {
+                start = 1;
+                end = DSDSNumCases(ds)+1;
+        }
+        functionArguments[0] = &visit;
+        pdatas = DSSecureCalloc(sizeof(struct pthread_struct), numberOfThreads);
+        for (i = 0; i < numberOfThreads; i++) {
+                pdatas[i].ds = ds;
+                pdatas[i].range = &range;
+                pdatas[i].numberOfArguments = 1;
+                pdatas[i].functionArguments = functionArguments;
+        }
+        if (ordered == false) {
+                DSParallelRangeInit(&range, start, end, numberOfThreads);
+                range.caseNumbers = caseNumbers;
+                DSThreadPoolRun(DSParallelWorkerVisitValidCases, pdatas, sizeof(struct pthread_struct), numberOfThreads);
+        } else {
+                /** The visiting thread delivers the cases while the workers fill the reorder buffer **/
+                DSParallelRangeInit(&range, start, end, numberOfThreads);
+                range.caseNumbers = caseNumbers;
+                visit.bufferSize = numberOfThreads*DS_DESIGN_SPACE_VISIT_WINDOW_FACTOR;
+                visit.buffer = DSSecureCalloc(sizeof(DSCase *), visit.bufferSize);
+                visit.isDone = DSSecureCalloc(sizeof(bool), visit.bufferSize);
+                visit.nextClaimed = start;
+                visit.nextDelivered = start;
+                group = DSThreadPoolGroupAlloc();
+                for (i = 0; i < numberOfThreads; i++)
+                        DSThreadPoolGroupSubmit(group, DSParallelWorkerVisitValidCases, pdatas+i);
+                DSParallelVisitorDeliverInOrder(pdatas);
+                DSThreadPoolGroupWait(group);
+                DSThreadPoolGroupFree(group);
+                /** Cases built ahead of an early stop are never delivered **/
+                for (i = 0; i < visit.bufferSize; i++) {
+                        if (visit.buffer[i] != NULL)
+                                DSCaseFree(visit.buffer[i]);
+                }
+                DSSecureFree(visit.buffer);
+                DSSecureFree(visit.isDone);
+        }
+        numberVisited = visit.numberVisited;
+        pthread_mutex_destroy(&visit.lock);
+        pthread_cond_destroy(&visit.changed);
+        if (caseNumbers != NULL)
+                DSSecureFree(caseNumbers);
+        DSSecureFree(pdatas);
+bail:
+        return numberVisited;
+}
+
 extern DSDictionary * DSDesignSpaceCalculateAllValidCasesForSliceByResolvingCyclicalCases(DSDesignSpace *ds,
                                                                                           const DSVariablePool * lower,
                                                                                           const DSVariablePool * upper)
@@ -2613,8 +2824,10 @@ extern DSDesignSpaceMessage * DSDesignSpaceEncode(const DSDesignSpace * ds)
         message->n_validcases = DSDesignSpaceNumberOfValidCases(ds);
         message->validcases = DSSecureCalloc(sizeof(DSUInteger), message->n_validcases);
         message->numberofcases = ds->numberOfCases;
+        caseNumber = 0;
         for (i = 0; i < message->n_validcases; i++) {
-                message->validcases[i] = atoi(DSDictionaryNames(ds->validCases)[i]);
+                caseNumber = DSCaseSetNextCaseNumber(ds->validCases, caseNumber);
+                message->validcases[i] = caseNumber;
         }
         message->n_cyclicalcasesnumbers = DSDictionaryCount(ds->cyclicalCases);
         message->n_cyclicalcases = message->n_cyclicalcasesnumbers;
@@ -2653,10 +2866,9 @@ extern DSDesignSpace * DSDesignSpaceFromDesignSpaceMessage(const DSDesignSpaceMe
         }
         ds->numberOfCases = message->numberofcases;
         ds->modifierFlags = message->modifierflags;
-        ds->validCases = DSDictionaryAlloc();
+        ds->validCases = DSCaseSetAlloc(ds->numberOfCases);
         for (i = 0; i < message->n_validcases; i++) {
-                sprintf(name, "%i", message->validcases[i]);
-                DSDictionaryAddValueWithName(ds->validCases, name, (void *)1);
+                DSCaseSetAddCaseNumber(ds->validCases, message->validcases[i]);
         }
         ds->Xd = DSGMASystemXd(ds->gma);
         ds->Xd_a = DSGMASystemXd_a(ds->gma);
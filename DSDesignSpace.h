@@ -42,6 +42,25 @@ __BEGIN_DECLS
 #define DS_DESIGN_SPACE_FLAG_SERIAL                      0x01
 #define DS_DESIGN_SPACE_FLAG_CYCLICAL                    0x02
 #define DS_DESIGN_SPACE_FLAG_RESOLVE_CO_DOMINANCE        0x04
+#define DS_DESIGN_SPACE_FLAG_GRAY_CODE                   0x08
+#define DS_DESIGN_SPACE_FLAG_REMOVE_REDUNDANT_BOUNDARIES 0x10
+
+/**
+ * \brief The number of cases per thread that may be built ahead of the next
+ * valid case delivered in order by DSDesignSpaceVisitValidCases.
+ */
+#define DS_DESIGN_SPACE_VISIT_WINDOW_FACTOR              16
+
+/**
+ * \brief Function prototype for visiting the valid cases of a design space.
+ *
+ * \details The visitor receives each valid case and a user supplied context.
+ * The case is freed after the visitor returns, so the visitor must copy any
+ * data it needs to keep.  Returning false stops the enumeration.
+ *
+ * \see DSDesignSpaceVisitValidCases
+ */
+typedef bool (*DSDesignSpaceCaseVisitor)(const DSCase * aCase, void * context);
 
 #if defined (__APPLE__) && defined (__MACH__)
 #pragma mark - Allocation, deallocation and initialization
@@ -67,6 +86,8 @@ extern void DSDesignSpaceAddConditions(DSDesignSpace *ds, const DSMatrix * Cd, c
 extern void DSDesignSpaceSetSerial(DSDesignSpace *ds, bool serial);
 extern void DSDesignSpaceSetCyclical(DSDesignSpace *ds, bool cyclical);
 extern void DSDesignSpaceSetResolveCoDominance(DSDesignSpace *ds, bool Codominance);
+extern void DSDesignSpaceSetGrayCodeEnumeration(DSDesignSpace *ds, bool grayCode);
+extern void DSDesignSpaceSetRemoveRedundantBoundaries(DSDesignSpace *ds, bool removeRedundant);
 
 #if defined (__APPLE__) && defined (__MACH__)
 #pragma mark - Getters -
@@ -75,6 +96,8 @@ extern void DSDesignSpaceSetResolveCoDominance(DSDesignSpace *ds, bool Codominan
 extern bool DSDesignSpaceSerial(const DSDesignSpace *ds);
 extern bool DSDesignSpaceCyclical(const DSDesignSpace *ds);
 extern bool DSDesignSpaceResolveCoDominance(const DSDesignSpace *ds);
+extern bool DSDesignSpaceGrayCodeEnumeration(const DSDesignSpace *ds);
+extern bool DSDesignSpaceRemoveRedundantBoundaries(const DSDesignSpace *ds);
 
 extern const DSVariablePool * DSDesignSpaceXi(const DSDesignSpace *ds);
 
@@ -87,6 +110,9 @@ extern const DSUInteger DSDesignSpaceNumberOfValidCases(const DSDesignSpace *ds)
 extern const DSUInteger DSDesignSpaceNumberOfCases(const DSDesignSpace *ds);
 
 extern DSCase * DSDesignSpaceCaseWithCaseNumber(const DSDesignSpace * ds, const DSUInteger caseNumber);
+extern DSCase * DSDesignSpaceCaseWithCaseNumberAndNeighbor(const DSDesignSpace * ds, const DSUInteger caseNumber, const DSCase * neighbor);
+extern DSCase * DSDesignSpaceLazyCaseWithCaseNumber(const DSDesignSpace * ds, const DSUInteger caseNumber);
+extern DSUInteger DSDesignSpaceCaseNumberForGrayCodeIndex(const DSDesignSpace * ds, const DSUInteger index);
 extern DSCase * DSDesignSpaceCaseWithCaseIdentifier(const DSDesignSpace * ds, const char * identifer);
 extern DSCase * DSDesignSpaceCaseWithCaseSignature(const DSDesignSpace * ds, const DSUInteger * signature);
 //extern DSCase * DSDesignSpaceCaseWithCaseSignatureList(const DSDesignSpace *ds, const DSUInteger firstTerm, ...);
@@ -117,12 +143,18 @@ extern DSUInteger * DSDesignSpaceCaseNumbersWithPrefix(const DSDesignSpace * ds,
 ;
 
 extern DSCase ** DSDesignSpaceCalculateCases(DSDesignSpace *ds, const DSUInteger numberOfCase, DSUInteger *cases);
+extern DSUInteger DSDesignSpaceDominanceConditionsInto(const DSDesignSpace * ds, const DSUInteger position, const DSUInteger term, DSMatrix * Cd, DSMatrix * Ci, DSMatrix * delta, const DSUInteger firstRow);
+extern DSUInteger DSDesignSpaceAdditionalConditionsInto(const DSDesignSpace * ds, DSMatrix * Cd, DSMatrix * Ci, DSMatrix * delta, const DSUInteger firstRow);
+extern const bool DSDesignSpacePartialSignatureIsFeasible(const DSDesignSpace * ds, const DSUInteger * signature, const DSUInteger numberOfTerms);
 extern DSCase ** DSDesignSpaceCalculateValidCasesByPrunning(DSDesignSpace *ds);
 extern DSCase ** DSDesignSpaceCalculateAllValidCases(DSDesignSpace *ds);
 extern DSDictionary * DSDesignSpaceCalculateAllValidCasesForSliceByResolvingCyclicalCases(DSDesignSpace *ds, const DSVariablePool * lower, const DSVariablePool * upper);
 extern DSDictionary * DSDesignSpaceCalculateAllValidCasesByResolvingCyclicalCases(DSDesignSpace *ds);
 extern DSDictionary * DSDesignSpaceCalculateAllValidCasesForSlice(DSDesignSpace *ds, const DSVariablePool *lower, const DSVariablePool *upper);
 extern DSDictionary * DSDesignSpaceCalculateAllValidCasesForSliceNonStrict(DSDesignSpace *ds, const DSVariablePool *lower, const DSVariablePool *upper);
+extern DSDictionary * DSDesignSpaceBoundingBoxesForValidCases(DSDesignSpace *ds, const DSVariablePool * lower, const DSVariablePool * upper);
+
+extern DSUInteger DSDesignSpaceVisitValidCases(DSDesignSpace *ds, DSDesignSpaceCaseVisitor visitor, void * context, const bool ordered);
 
 #if defined (__APPLE__) && defined (__MACH__)
 #pragma mark Cyclical Cases and Cyclical Case validity
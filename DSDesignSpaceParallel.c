@@ -28,6 +28,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <pthread.h>
 #include <glpk.h>
 #include "DSDesignSpaceParallel.h"
@@ -38,6 +39,7 @@
 #include "DSSSystem.h"
 #include "DSCase.h"
 #include "DSCyclicalCase.h"
+#include "DSCaseSet.h"
 #include "DSMatrix.h"
 
 #define PARALLEL_STACK_SIZE_INCREMENT     5000
@@ -156,7 +158,140 @@ bail:
         return;
 }
 
-#include <unistd.h>
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Parallel ranges
+#endif
+
+/**
+ * \brief Initializes a range of indices to be processed by parallel workers.
+ *
+ * \details The range only stores its bounds and the next unclaimed index, and
+ * thus uses the same amount of memory regardless of the number of cases to be
+ * processed.  If caseNumbers is not NULL, the indices in the range are
+ * positions in the caseNumbers array; otherwise, the indices are the case
+ * numbers themselves.
+ *
+ * \param range The ds_parallelrange_t being initialized.
+ * \param begin The first index in the range.
+ * \param end One past the last index in the range.
+ * \param numberOfWorkers The number of workers processing the range, used to
+ *        size the chunks handed to each worker.
+ */
+extern void DSParallelRangeInit(ds_parallelrange_t * range, const DSUInteger begin, const DSUInteger end, const DSUInteger numberOfWorkers)
+{
+        if (range == NULL) {
+                DSError(M_DS_NULL ": Parallel range is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        range->begin = begin;
+        range->end = (end < begin) ? begin : end;
+        range->next = range->begin;
+        range->numberOfWorkers = (numberOfWorkers == 0) ? 1 : numberOfWorkers;
+        range->caseNumbers = NULL;
+        range->cases = NULL;
+        range->argument_type = DS_STACK_ARG_CASENUM;
+bail:
+        return;
+}
+
+/**
+ * \brief Atomically claims the next chunk of a range.
+ *
+ * \details Chunks are claimed with a compare-and-swap on the next unclaimed
+ * index, and their size decreases as the range is consumed: each chunk is
+ * a fraction of the remaining indices divided by the number of workers, but
+ * no smaller than DS_PARALLEL_RANGE_MIN_CHUNK.  Large chunks at the start keep
+ * the number of atomic operations low, and small chunks at the end keep all
+ * workers busy until the range is exhausted.
+ *
+ * \param range The ds_parallelrange_t being processed.
+ * \param first A pointer to a DSUInteger where the first index of the chunk is
+ *        stored.
+ * \param last A pointer to a DSUInteger where one past the last index of the
+ *        chunk is stored.
+ *
+ * \return A boolean value indicating if a non-empty chunk was claimed.
+ */
+extern bool DSParallelRangeNextChunk(ds_parallelrange_t * range, DSUInteger * first, DSUInteger * last)
+{
+        bool claimed = false;
+        DSUInteger current, chunk, remaining;
+        if (range == NULL) {
+                DSError(M_DS_NULL ": Parallel range is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        while (true) {
+                current = range->next;
+                if (current >= range->end)
+                        break;
+                remaining = range->end - current;
+                chunk = remaining / (DS_PARALLEL_RANGE_CHUNK_FACTOR*range->numberOfWorkers);
+                if (chunk < DS_PARALLEL_RANGE_MIN_CHUNK)
+                        chunk = DS_PARALLEL_RANGE_MIN_CHUNK;
+                if (chunk > remaining)
+                        chunk = remaining;
+                if (__sync_bool_compare_and_swap(&range->next, current, current+chunk) == true) {
+                        *first = current;
+                        *last = current+chunk;
+                        claimed = true;
+                        break;
+                }
+        }
+bail:
+        return claimed;
+}
+
+/**
+ * \brief Returns the next index of a range to be processed by a worker.
+ *
+ * \details Each worker keeps a ds_parallelcursor_t, initialized to zero, with
+ * the chunk it is currently processing.  When the chunk is exhausted, a new
+ * chunk is claimed with DSParallelRangeNextChunk.
+ *
+ * \return A boolean value indicating if an index was returned; false
+ *         indicates that the range has been fully claimed.
+ */
+extern bool DSParallelRangeNextIndex(ds_parallelrange_t * range, ds_parallelcursor_t * cursor, DSUInteger * index)
+{
+        bool hasIndex = false;
+        if (cursor == NULL || index == NULL) {
+                DSError(M_DS_NULL ": Parallel cursor is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (cursor->current >= cursor->end) {
+                if (DSParallelRangeNextChunk(range, &cursor->current, &cursor->end) == false)
+                        goto bail;
+        }
+        *index = cursor->current++;
+        hasIndex = true;
+bail:
+        return hasIndex;
+}
+
+/**
+ * \brief Returns the case number corresponding to an index of a range.
+ *
+ * \return The case number at the index, or the index itself if the range does
+ *         not have an array of case numbers.
+ */
+extern DSUInteger DSParallelRangeCaseNumberAtIndex(const ds_parallelrange_t * range, const DSUInteger index)
+{
+        DSUInteger caseNumber = 0;
+        if (range == NULL) {
+                DSError(M_DS_NULL ": Parallel range is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (range->caseNumbers != NULL)
+                caseNumber = range->caseNumbers[index];
+        else
+                caseNumber = index;
+bail:
+        return caseNumber;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Parallel workers
+#endif
 
 extern void * DSParallelWorker(void * pthread_struct)
 {
@@ -167,15 +302,16 @@ extern void * DSParallelWorkerCyclicalCases(void * pthread_struct)
 {
         DSUInteger * termSignature = NULL;
         struct pthread_struct * pdata = NULL;
-        DSUInteger caseNumber;
+        DSUInteger index, caseNumber;
+        ds_parallelcursor_t cursor = {0, 0};
         DSCase *aCase;
         if (pthread_struct == NULL) {
                 DSError(M_DS_NULL ": Parallel worker data is NULL", A_DS_ERROR);
                 goto bail;
         }
         pdata = (struct pthread_struct *)pthread_struct;
-        if (pdata->stack == NULL) {
-                DSError(M_DS_NULL ": Stack in parallel worker is NULL", A_DS_ERROR);
+        if (pdata->range == NULL) {
+                DSError(M_DS_NULL ": Range in parallel worker is NULL", A_DS_ERROR);
                 goto bail;
         }
         if (pdata->ds == NULL) {
@@ -186,8 +322,8 @@ extern void * DSParallelWorkerCyclicalCases(void * pthread_struct)
                 DSError(M_DS_GMA_NULL, A_DS_ERROR);
                 goto bail;
         }
-        while (pdata->stack->count > 0)  {
-                caseNumber = (DSUInteger)DSParallelStackPop(pdata->stack);
+        while (DSParallelRangeNextIndex(pdata->range, &cursor, &index) == true) {
+                caseNumber = DSParallelRangeCaseNumberAtIndex(pdata->range, index);
                 if (caseNumber == 0)
                         continue;
                 if (caseNumber > DSDesignSpaceNumberOfCases(pdata->ds)) {
@@ -205,29 +341,29 @@ extern void * DSParallelWorkerCyclicalCases(void * pthread_struct)
                 }
         }
 bail:
-        pthread_exit(NULL);
+        return NULL;
 }
 
 extern void * DSParallelWorkerCases(void * pthread_struct)
 {
         DSUInteger * termSignature = NULL;
         struct pthread_struct * pdata = NULL;
-        DSUInteger caseNumber;
-        DSCase *aCase; 
+        DSUInteger index, caseNumber;
+        ds_parallelcursor_t cursor = {0, 0};
         if (pthread_struct == NULL) {
                 DSError(M_DS_NULL ": Parallel worker data is NULL", A_DS_ERROR);
                 goto bail;
         }
         pdata = (struct pthread_struct *)pthread_struct;
-        if (pdata->stack == NULL) {
-                DSError(M_DS_NULL ": Stack in parallel worker is NULL", A_DS_ERROR);
+        if (pdata->range == NULL) {
+                DSError(M_DS_NULL ": Range in parallel worker is NULL", A_DS_ERROR);
                 goto bail;
         }
         if (pdata->ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
                 goto bail;
         }
-        if (pdata->stack->cases == NULL) {
+        if (pdata->range->cases == NULL) {
                 DSError(M_DS_NULL ": Case array is NULL", A_DS_ERROR);
                 goto bail;
         }
@@ -235,8 +371,9 @@ extern void * DSParallelWorkerCases(void * pthread_struct)
                 DSError(M_DS_GMA_NULL, A_DS_ERROR);
                 goto bail;
         }
-        while (pdata->stack->count > 0)  {
-                caseNumber = DSParallelStackPop(pdata->stack);
+        /** Each index owns one position of the case array, no locking is needed **/
+        while (DSParallelRangeNextIndex(pdata->range, &cursor, &index) == true) {
+                caseNumber = DSParallelRangeCaseNumberAtIndex(pdata->range, index);
                 if (caseNumber == 0)
                         continue;
                 if (caseNumber > DSDesignSpaceNumberOfCases(pdata->ds)) {
@@ -245,48 +382,59 @@ extern void * DSParallelWorkerCases(void * pthread_struct)
                 }
                 termSignature = DSCaseSignatureForCaseNumber(caseNumber, pdata->ds->gma);
                 if (termSignature != NULL) {
-                        aCase = DSCaseWithTermsFromDesignSpace(pdata->ds, termSignature, DSDesignSpaceCasePrefix(pdata->ds));
-                        DSParallelStackAddCase(pdata->stack, aCase);
+                        pdata->range->cases[index-pdata->range->begin] = DSCaseWithTermsFromDesignSpace(pdata->ds, termSignature, DSDesignSpaceCasePrefix(pdata->ds));
                         DSSecureFree(termSignature);
                 }
         }
 bail:
-        pthread_exit(NULL);
+        return NULL;
 }
 
 extern void * DSParallelWorkerValidity(void * pthread_struct)
 {
         struct pthread_struct * pdata = NULL;
-        DSUInteger caseNumber;
-        DSCase *aCase, *toFree;
+        DSUInteger index, caseNumber;
+        ds_parallelcursor_t cursor = {0, 0};
+        DSCase *aCase, *toFree, *neighbor = NULL;
         const DSCyclicalCase * cyclicalCase;
+        bool isValid, grayCode, hasCyclicalCases;
         char string[100];
         if (pthread_struct == NULL) {
                 DSError(M_DS_NULL ": Parallel worker data is NULL", A_DS_ERROR);
                 goto bail;
         }
         pdata = (struct pthread_struct *)pthread_struct;
-        if (pdata->stack == NULL) {
-                DSError(M_DS_NULL ": Stack in parallel worker is NULL", A_DS_ERROR);
+        if (pdata->range == NULL) {
+                DSError(M_DS_NULL ": Range in parallel worker is NULL", A_DS_ERROR);
                 goto bail;
         }
         if (pdata->ds == NULL) {
                 DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
                 goto bail;
         }
-        if (pdata->ds->validCases == NULL) {
-                DSError(M_DS_NULL ": Dictionary of valid cases is NULL", A_DS_ERROR);
+        if (pdata->range->argument_type == DS_STACK_ARG_CASE) {
+                pdata->returnPointer = DSDictionaryAlloc();
+        } else if (pdata->ds->validCases == NULL) {
+                DSError(M_DS_NULL ": Set of valid cases is NULL", A_DS_ERROR);
                 goto bail;
         }
         if (pdata->ds->gma == NULL) {
                 DSError(M_DS_GMA_NULL, A_DS_ERROR);
                 goto bail;
         }
-        glp_init_env();
-        /** Data in stack MUST be a case number, if not an error will occur **/
-        while (pdata->stack->count > 0)  {
-                if (pdata->stack->argument_type == DS_STACK_ARG_CASENUM) {
-                        caseNumber = (DSUInteger)DSParallelStackPop(pdata->stack);
+        /** Consecutive indices of a chunk are neighbors in Gray code order **/
+        grayCode = (DSDesignSpaceGrayCodeEnumeration(pdata->ds) == true && pdata->range->caseNumbers == NULL);
+        hasCyclicalCases = (pdata->ds->cyclicalCases != NULL && DSDictionaryCount(pdata->ds->cyclicalCases) > 0);
+        DSCaseLinearProgrammingContextBegin();
+        while (DSParallelRangeNextIndex(pdata->range, &cursor, &index) == true) {
+                if (pdata->range->argument_type == DS_STACK_ARG_CASE) {
+                        aCase = pdata->range->cases[index-pdata->range->begin];
+                        toFree = NULL;
+                        if (aCase == NULL)
+                                continue;
+                        caseNumber = aCase->caseNumber;
+                } else {
+                        caseNumber = DSParallelRangeCaseNumberAtIndex(pdata->range, index);
                         if (caseNumber == 0) {
                                 continue;
                         }
@@ -294,31 +442,445 @@ extern void * DSParallelWorkerValidity(void * pthread_struct)
                                 DSError(M_DS_WRONG ": Case number out of bounds", A_DS_ERROR);
                                 continue;
                         }
-                        aCase = DSDesignSpaceCaseWithCaseNumber(pdata->ds, caseNumber);
+                        if (grayCode == true)
+                                caseNumber = DSDesignSpaceCaseNumberForGrayCodeIndex(pdata->ds, caseNumber-1);
+                        if (DSGMASystemCaseNumberHasTermConflicts(pdata->ds->gma, caseNumber) == true)
+                                continue;
+                        aCase = DSDesignSpaceLazyCaseWithCaseNumber(pdata->ds, caseNumber);
                         toFree = aCase;
-                } else if (pdata->stack->argument_type == DS_STACK_ARG_CASE) {
-                        aCase = (DSCase *)DSParallelStackPop(pdata->stack);
-                        toFree = NULL;
+                        if (aCase == NULL)
+                                continue;
+                }
+                isValid = DSCaseIsValidWithNeighbor(aCase, true, neighbor);
+                /** The name of a case is only formatted when it is looked up or stored **/
+                if (isValid == false && hasCyclicalCases == true) {
+                        sprintf(string, "%d", caseNumber);
+                        cyclicalCase = DSDictionaryValueForName(pdata->ds->cyclicalCases, string);
+                        if (cyclicalCase != NULL)
+                                isValid = DSCyclicalCaseIsValid(cyclicalCase, true);
                 }
-                sprintf(string, "%d", aCase->caseNumber);//caseNumber);//aCase->caseNumber);
-                if (DSCaseIsValid(aCase, true) == true) {
-                        DSDictionaryAddValueWithName(pdata->ds->validCases, string, (void*)1);
-                } else if (DSDictionaryValueForName(pdata->ds->cyclicalCases, string) != NULL) {
-                        cyclicalCase = DSDesignSpaceCyclicalCaseWithCaseNumber(pdata->ds, caseNumber);
-                        if (DSCyclicalCaseIsValid(cyclicalCase, true) == true)
-                                DSDictionaryAddValueWithName(pdata->ds->validCases, string, (void*)1);
+                if (isValid == true) {
+                        if (toFree == NULL) {
+                                sprintf(string, "%d", caseNumber);
+                                DSDictionaryAddValueWithName((DSDictionary *)pdata->returnPointer, string, aCase);
+                        } else {
+                                DSCaseSetAddCaseNumber(pdata->ds->validCases, caseNumber);
+                        }
+                }
+                if (toFree == NULL)
+                        continue;
+                /** Only cases that solved their S-System are useful neighbors **/
+                if (DSCaseIsLazy(toFree) == true) {
+                        DSCaseFree(toFree);
+                } else {
+                        if (neighbor != NULL)
+                                DSCaseFree(neighbor);
+                        neighbor = toFree;
                 }
+        }
+        if (neighbor != NULL)
+                DSCaseFree(neighbor);
+        DSCaseLinearProgrammingContextEnd();
+bail:
+        return NULL;
+}
+
+/**
+ * \brief Builds the case at an index of the range of a visitor, returning it
+ * only if it is valid.
+ *
+ * \details If the validity of the case is not yet known it is tested here,
+ * including the validity of its cyclical case.  Valid cases are completed,
+ * and their redundant boundaries removed if the design space requests it.
+ */
+static DSCase * dsParallelVisitorValidCaseAtIndex(struct pthread_struct * pdata, const ds_parallelvisitor_t * visit, const DSUInteger index)
+{
+        DSUInteger caseNumber;
+        DSCase * aCase = NULL;
+        const DSCyclicalCase * cyclicalCase;
+        bool isValid;
+        caseNumber = DSParallelRangeCaseNumberAtIndex(pdata->range, index);
+        if (caseNumber == 0)
+                goto bail;
+        if (caseNumber > DSDesignSpaceNumberOfCases(pdata->ds)) {
+                DSError(M_DS_WRONG ": Case number out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        if (visit->validityKnown == false && DSGMASystemCaseNumberHasTermConflicts(pdata->ds->gma, caseNumber) == true)
+                goto bail;
+        if (visit->validityKnown == true)
+                aCase = DSDesignSpaceCaseWithCaseNumber(pdata->ds, caseNumber);
+        else
+                aCase = DSDesignSpaceLazyCaseWithCaseNumber(pdata->ds, caseNumber);
+        if (aCase == NULL)
+                goto bail;
+        isValid = visit->validityKnown;
+        if (isValid == false) {
+                isValid = DSCaseIsValidWithNeighbor(aCase, true, NULL);
+                cyclicalCase = DSDesignSpaceCyclicalCaseWithCaseNumber(pdata->ds, caseNumber);
+                if (isValid == false && cyclicalCase != NULL)
+                        isValid = DSCyclicalCaseIsValid(cyclicalCase, true);
+        }
+        if (isValid == false) {
                 DSCaseFree(aCase);
+                aCase = NULL;
+                goto bail;
         }
-        glp_free_env();
+        /** Cases are completed before they are shared with the visitor **/
+        DSCaseCompleteConstruction(aCase, NULL);
+        if (DSDesignSpaceRemoveRedundantBoundaries(pdata->ds) == true)
+                DSCaseRemoveRedundantBoundaries(aCase);
+bail:
+        return aCase;
+}
+
+/**
+ * \brief Claims the next index of the range of a visitor with a reorder
+ * buffer.
+ *
+ * \details The lock of the visitor must be held.  No index is claimed if its
+ * slot in the reorder buffer has not been delivered yet.
+ *
+ * \return A boolean value indicating if an index was claimed.
+ */
+static bool dsParallelVisitorClaimIndex(ds_parallelvisitor_t * visit, const ds_parallelrange_t * range, DSUInteger * index)
+{
+        bool claimed = false;
+        if (visit->stop == true || visit->nextClaimed >= range->end)
+                goto bail;
+        if (visit->nextClaimed >= visit->nextDelivered+visit->bufferSize)
+                goto bail;
+        *index = visit->nextClaimed++;
+        claimed = true;
 bail:
-        pthread_exit(NULL);
+        return claimed;
+}
+
+/**
+ * \brief Builds the case at a claimed index and stores it in the reorder
+ * buffer of a visitor.
+ *
+ * \details The lock of the visitor must be held; it is released while the
+ * case is built.
+ */
+static void dsParallelVisitorProcessIndex(struct pthread_struct * pdata, ds_parallelvisitor_t * visit, const DSUInteger index)
+{
+        DSCase * aCase;
+        DSUInteger slot = (index-pdata->range->begin) % visit->bufferSize;
+        pthread_mutex_unlock(&visit->lock);
+        aCase = dsParallelVisitorValidCaseAtIndex(pdata, visit, index);
+        pthread_mutex_lock(&visit->lock);
+        visit->buffer[slot] = aCase;
+        visit->isDone[slot] = true;
+        pthread_cond_broadcast(&visit->changed);
+}
+
+/**
+ * \brief Worker streaming the valid cases of a design space to a visitor.
+ *
+ * \details Each case is built once (see dsParallelVisitorValidCaseAtIndex).
+ * When the visitor has a reorder buffer, valid cases are stored in it for the
+ * visiting thread to deliver in order; otherwise they are passed immediately
+ * to the visitor and freed, so each worker holds at most one case at a time.
+ */
+extern void * DSParallelWorkerVisitValidCases(void * pthread_struct)
+{
+        struct pthread_struct * pdata = NULL;
+        DSUInteger index;
+        ds_parallelcursor_t cursor = {0, 0};
+        DSCase *aCase;
+        ds_parallelvisitor_t * visit;
+        if (pthread_struct == NULL) {
+                DSError(M_DS_NULL ": Parallel worker data is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        pdata = (struct pthread_struct *)pthread_struct;
+        if (pdata->range == NULL) {
+                DSError(M_DS_NULL ": Range in parallel worker is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (pdata->ds == NULL) {
+                DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (pdata->ds->gma == NULL) {
+                DSError(M_DS_GMA_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (pdata->numberOfArguments == 0) {
+                DSError(M_DS_WRONG ": p_data structure needs one argument", A_DS_ERROR);
+                goto bail;
+        }
+        visit = pdata->functionArguments[0];
+        if (visit == NULL) {
+                DSError(M_DS_NULL ": Case visitor is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        DSCaseLinearProgrammingContextBegin();
+        if (visit->buffer != NULL) {
+                pthread_mutex_lock(&visit->lock);
+                while (visit->stop == false && visit->nextClaimed < pdata->range->end) {
+                        if (dsParallelVisitorClaimIndex(visit, pdata->range, &index) == true)
+                                dsParallelVisitorProcessIndex(pdata, visit, index);
+                        else
+                                pthread_cond_wait(&visit->changed, &visit->lock);
+                }
+                pthread_mutex_unlock(&visit->lock);
+        } else {
+                while (visit->stop == false && DSParallelRangeNextIndex(pdata->range, &cursor, &index) == true) {
+                        aCase = dsParallelVisitorValidCaseAtIndex(pdata, visit, index);
+                        if (aCase == NULL)
+                                continue;
+                        pthread_mutex_lock(&visit->lock);
+                        if (visit->stop == false) {
+                                visit->numberVisited++;
+                                if (visit->visitor(aCase, visit->context) == false)
+                                        visit->stop = true;
+                        }
+                        pthread_mutex_unlock(&visit->lock);
+                        DSCaseFree(aCase);
+                }
+        }
+        DSCaseLinearProgrammingContextEnd();
+bail:
+        return NULL;
+}
+
+/**
+ * \brief Delivers the valid cases stored in the reorder buffer of a visitor
+ * in increasing index.
+ *
+ * \details This function is called by the visiting thread while the workers
+ * fill the reorder buffer.  Results are flushed as soon as the next index to
+ * be delivered has been processed; while it has not, the visiting thread
+ * processes unclaimed indices itself, so that the cases are delivered even if
+ * no worker of the thread pool is available.  The visitor is called without
+ * holding the lock, and the workers are woken up to stop when all the cases
+ * have been delivered or the visitor stops the enumeration.
+ *
+ * \param pdata The data of the visiting thread, sharing the range and the
+ *        visitor of the workers.
+ */
+extern void DSParallelVisitorDeliverInOrder(struct pthread_struct * pdata)
+{
+        ds_parallelvisitor_t * visit;
+        DSUInteger slot, index;
+        DSCase * aCase;
+        bool shouldContinue;
+        if (pdata == NULL || pdata->range == NULL) {
+                DSError(M_DS_NULL ": Parallel worker data is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        visit = pdata->functionArguments[0];
+        if (visit == NULL || visit->buffer == NULL) {
+                DSError(M_DS_NULL ": Case visitor has no reorder buffer", A_DS_ERROR);
+                goto bail;
+        }
+        DSCaseLinearProgrammingContextBegin();
+        pthread_mutex_lock(&visit->lock);
+        while (visit->stop == false && visit->nextDelivered < pdata->range->end) {
+                slot = (visit->nextDelivered-pdata->range->begin) % visit->bufferSize;
+                if (visit->isDone[slot] == true) {
+                        aCase = visit->buffer[slot];
+                        visit->buffer[slot] = NULL;
+                        visit->isDone[slot] = false;
+                        visit->nextDelivered++;
+                        pthread_cond_broadcast(&visit->changed);
+                        if (aCase == NULL)
+                                continue;
+                        pthread_mutex_unlock(&visit->lock);
+                        visit->numberVisited++;
+                        shouldContinue = visit->visitor(aCase, visit->context);
+                        DSCaseFree(aCase);
+                        pthread_mutex_lock(&visit->lock);
+                        if (shouldContinue == false)
+                                visit->stop = true;
+                } else if (dsParallelVisitorClaimIndex(visit, pdata->range, &index) == true) {
+                        dsParallelVisitorProcessIndex(pdata, visit, index);
+                } else {
+                        pthread_cond_wait(&visit->changed, &visit->lock);
+                }
+        }
+        visit->stop = true;
+        pthread_cond_broadcast(&visit->changed);
+        pthread_mutex_unlock(&visit->lock);
+        DSCaseLinearProgrammingContextEnd();
+bail:
+        return;
+}
+
+/**
+ * \brief Tests the validity of the case with a complete signature found by
+ * the branch-and-bound search, adding it to the valid cases if it is valid.
+ */
+static void dsParallelPrunedValidityTestSignature(DSDesignSpace * ds, const DSUInteger * signature)
+{
+        DSCase * aCase;
+        const DSCyclicalCase * cyclicalCase;
+        bool isValid;
+        aCase = DSCaseLazyWithTermsFromDesignSpace(ds, signature);
+        if (aCase == NULL)
+                goto bail;
+        isValid = DSCaseIsValidWithNeighbor(aCase, true, NULL);
+        if (isValid == false) {
+                cyclicalCase = DSDesignSpaceCyclicalCaseWithCaseNumber(ds, DSCaseNumber(aCase));
+                if (cyclicalCase != NULL)
+                        isValid = DSCyclicalCaseIsValid(cyclicalCase, true);
+        }
+        if (isValid == true)
+                DSCaseSetAddCaseNumber(ds->validCases, DSCaseNumber(aCase));
+        DSCaseFree(aCase);
+bail:
+        return;
+}
+
+/**
+ * \brief Tests if the first rows of the condition matrices of a node can be
+ * satisfied.
+ */
+static bool dsParallelPrunedConditionsAreFeasible(const ds_parallelprunednode_t * node, const DSUInteger numberOfConditions)
+{
+        bool isFeasible = true;
+        DSMatrixView CdView, CiView, deltaView;
+        DSMatrix * Cd, * Ci = NULL, * delta;
+        if (numberOfConditions == 0)
+                goto bail;
+        Cd = DSMatrixViewOfRows(&CdView, node->Cd, 0, numberOfConditions);
+        if (node->Ci != NULL)
+                Ci = DSMatrixViewOfRows(&CiView, node->Ci, 0, numberOfConditions);
+        delta = DSMatrixViewOfRows(&deltaView, node->delta, 0, numberOfConditions);
+        isFeasible = DSCaseConditionMatricesAreValid(Cd, Ci, delta);
+bail:
+        return isFeasible;
+}
+
+/**
+ * \brief Creates a node of the branch-and-bound search for a child of a node,
+ * copying the signature and the conditions of the path to the child.
+ */
+static ds_parallelprunednode_t * dsParallelPrunedNodeForChild(const ds_parallelprunednode_t * node, const DSUInteger * signature, const DSUInteger depth, const DSUInteger numberOfConditions)
+{
+        ds_parallelprunednode_t * child;
+        DSUInteger numberOfPositions = 2*DSGMASystemNumberOfEquations(node->ds->gma);
+        DSMatrixView sourceView, destinationView;
+        child = DSSecureMalloc(sizeof(ds_parallelprunednode_t));
+        *child = *node;
+        child->depth = depth;
+        child->signature = DSSecureMalloc(sizeof(DSUInteger)*numberOfPositions);
+        memcpy(child->signature, signature, sizeof(DSUInteger)*numberOfPositions);
+        child->numberOfConditions = numberOfConditions;
+        child->Cd = DSMatrixAlloc(DSMatrixRows(node->Cd), DSMatrixColumns(node->Cd));
+        child->Ci = (node->Ci != NULL) ? DSMatrixAlloc(DSMatrixRows(node->Ci), DSMatrixColumns(node->Ci)) : NULL;
+        child->delta = DSMatrixAlloc(DSMatrixRows(node->delta), 1);
+        if (numberOfConditions == 0)
+                goto bail;
+        DSMatrixCopyInto(DSMatrixViewOfRows(&destinationView, child->Cd, 0, numberOfConditions),
+                         DSMatrixViewOfRows(&sourceView, node->Cd, 0, numberOfConditions));
+        DSMatrixCopyInto(DSMatrixViewOfRows(&destinationView, child->delta, 0, numberOfConditions),
+                         DSMatrixViewOfRows(&sourceView, node->delta, 0, numberOfConditions));
+        if (child->Ci != NULL)
+                DSMatrixCopyInto(DSMatrixViewOfRows(&destinationView, child->Ci, 0, numberOfConditions),
+                                 DSMatrixViewOfRows(&sourceView, node->Ci, 0, numberOfConditions));
+bail:
+        return child;
+}
+
+/**
+ * \brief Visits a node of the branch-and-bound search.
+ *
+ * \details The first numberOfConditions rows of the condition matrices of the
+ * node hold the conditions of the partial signature of the node.  The
+ * conditions of each child only add the rows of the position being fixed,
+ * which overwrite those of the previous child.
+ */
+static void dsParallelPrunedValidityVisitNode(const ds_parallelprunednode_t * node, DSUInteger * signature, const DSUInteger depth, const DSUInteger numberOfConditions)
+{
+        DSUInteger term, numberOfPositions, childConditions;
+        const DSUInteger * termList;
+        termList = DSGMASystemSignature(node->ds->gma);
+        numberOfPositions = 2*DSGMASystemNumberOfEquations(node->ds->gma);
+        if (depth == numberOfPositions) {
+                dsParallelPrunedValidityTestSignature(node->ds, signature);
+                goto bail;
+        }
+        for (term = 1; term <= termList[depth]; term++) {
+                signature[depth] = term;
+                childConditions = numberOfConditions;
+                /** A single term adds no conditions; the parent is known to be feasible **/
+                if (termList[depth] > 1) {
+                        if (DSGMASystemTermConflictsWithSignature(node->ds->gma, signature, depth) == true)
+                                continue;
+                        childConditions += DSDesignSpaceDominanceConditionsInto(node->ds, depth, term, node->Cd, node->Ci, node->delta, numberOfConditions);
+                        if (dsParallelPrunedConditionsAreFeasible(node, childConditions) == false)
+                                continue;
+                }
+                if (depth < node->splitDepth) {
+                        DSThreadPoolGroupSubmit(node->group, DSParallelWorkerPrunedValidity,
+                                                dsParallelPrunedNodeForChild(node, signature, depth+1, childConditions));
+                } else {
+                        dsParallelPrunedValidityVisitNode(node, signature, depth+1, childConditions);
+                }
+        }
+bail:
+        return;
+}
+
+/**
+ * \brief Worker searching the subtree of a node of the branch-and-bound search
+ * over dominance signatures.
+ *
+ * \details The node passed to the worker is freed when the worker finishes.
+ *
+ * \see dsDesignSpaceCalculateValidityByPrunning
+ */
+extern void * DSParallelWorkerPrunedValidity(void * prunedNode)
+{
+        ds_parallelprunednode_t * node = NULL;
+        if (prunedNode == NULL) {
+                DSError(M_DS_NULL ": Parallel worker data is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        node = (ds_parallelprunednode_t *)prunedNode;
+        if (node->ds == NULL) {
+                DSError(M_DS_DESIGN_SPACE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (node->ds->gma == NULL) {
+                DSError(M_DS_GMA_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (node->ds->validCases == NULL) {
+                DSError(M_DS_NULL ": Set of valid cases is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (node->Cd == NULL || node->delta == NULL) {
+                DSError(M_DS_MAT_NULL ": Conditions of the node are NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (node->group == NULL)
+                node->splitDepth = 0;
+        DSCaseLinearProgrammingContextBegin();
+        dsParallelPrunedValidityVisitNode(node, node->signature, node->depth, node->numberOfConditions);
+        DSCaseLinearProgrammingContextEnd();
+bail:
+        if (node != NULL) {
+                DSSecureFree(node->signature);
+                if (node->Cd != NULL)
+                        DSMatrixFree(node->Cd);
+                if (node->Ci != NULL)
+                        DSMatrixFree(node->Ci);
+                if (node->delta != NULL)
+                        DSMatrixFree(node->delta);
+                DSSecureFree(node);
+        }
+        return NULL;
 }
 
 extern void * DSParallelWorkerValidityResolveCycles(void * pthread_struct)
 {
         struct pthread_struct * pdata = NULL;
-        DSUInteger j, numberValidSubcases, caseNumber;
+        DSUInteger j, numberValidSubcases, index, caseNumber;
+        ds_parallelcursor_t cursor = {0, 0};
         DSCase *aCase;
         const DSCyclicalCase * cyclicalCase;
         char nameString[100], subcaseString[1000];
@@ -329,8 +891,8 @@ extern void * DSParallelWorkerValidityResolveCycles(void * pthread_struct)
                 goto bail;
         }
         pdata = (struct pthread_struct *)pthread_struct;
-        if (pdata->stack == NULL) {
-                DSError(M_DS_NULL ": Stack in parallel worker is NULL", A_DS_ERROR);
+        if (pdata->range == NULL) {
+                DSError(M_DS_NULL ": Range in parallel worker is NULL", A_DS_ERROR);
                 goto bail;
         }
         if (pdata->ds == NULL) {
@@ -338,7 +900,7 @@ extern void * DSParallelWorkerValidityResolveCycles(void * pthread_struct)
                 goto bail;
         }
         if (pdata->ds->validCases == NULL) {
-                DSError(M_DS_NULL ": Dictionary of valid cases is NULL", A_DS_ERROR);
+                DSError(M_DS_NULL ": Set of valid cases is NULL", A_DS_ERROR);
                 goto bail;
         }
         if (pdata->ds->gma == NULL) {
@@ -346,10 +908,9 @@ extern void * DSParallelWorkerValidityResolveCycles(void * pthread_struct)
                 goto bail;
         }
         pdata->returnPointer = DSDictionaryAlloc();
-        glp_init_env();
-        /** Data in stack MUST be a case number, if not an error will occur **/
-        while (pdata->stack->count > 0)  {
-                caseNumber = (DSUInteger)DSParallelStackPop(pdata->stack);
+        DSCaseLinearProgrammingContextBegin();
+        while (DSParallelRangeNextIndex(pdata->range, &cursor, &index) == true) {
+                caseNumber = DSParallelRangeCaseNumberAtIndex(pdata->range, index);
                 if (caseNumber == 0) {
                         continue;
                 }
@@ -379,15 +940,16 @@ extern void * DSParallelWorkerValidityResolveCycles(void * pthread_struct)
                         DSCaseFree(aCase);
                 }
         }
-        glp_free_env();
+        DSCaseLinearProgrammingContextEnd();
 bail:
-        pthread_exit(NULL);
+        return NULL;
 }
 
 extern void * DSParallelWorkerValidityForSliceResolveCycles(void * pthread_struct)
 {
         struct pthread_struct * pdata = NULL;
-        DSUInteger j, numberValidSubcases, caseNumber;
+        DSUInteger j, numberValidSubcases, index, caseNumber;
+        ds_parallelcursor_t cursor = {0, 0};
         DSCase *aCase;
         const DSCyclicalCase * cyclicalCase;
         char nameString[100], subcaseString[1000];
@@ -399,8 +961,8 @@ extern void * DSParallelWorkerValidityForSliceResolveCycles(void * pthread_struc
                 goto bail;
         }
         pdata = (struct pthread_struct *)pthread_struct;
-        if (pdata->stack == NULL) {
-                DSError(M_DS_NULL ": Stack in parallel worker is NULL", A_DS_ERROR);
+        if (pdata->range == NULL) {
+                DSError(M_DS_NULL ": Range in parallel worker is NULL", A_DS_ERROR);
                 goto bail;
         }
         if (pdata->ds == NULL) {
@@ -408,7 +970,7 @@ extern void * DSParallelWorkerValidityForSliceResolveCycles(void * pthread_struc
                 goto bail;
         }
         if (pdata->ds->validCases == NULL) {
-                DSError(M_DS_NULL ": Dictionary of valid cases is NULL", A_DS_ERROR);
+                DSError(M_DS_NULL ": Set of valid cases is NULL", A_DS_ERROR);
                 goto bail;
         }
         if (pdata->ds->gma == NULL) {
@@ -426,10 +988,9 @@ extern void * DSParallelWorkerValidityForSliceResolveCycles(void * pthread_struc
                 goto bail;
         }
         pdata->returnPointer = DSDictionaryAlloc();
-        glp_init_env();
-        /** Data in stack MUST be a case number, if not an error will occur **/
-        while (pdata->stack->count > 0)  {
-                caseNumber = (DSUInteger)DSParallelStackPop(pdata->stack);
+        DSCaseLinearProgrammingContextBegin();
+        while (DSParallelRangeNextIndex(pdata->range, &cursor, &index) == true) {
+                caseNumber = DSParallelRangeCaseNumberAtIndex(pdata->range, index);
                 if (caseNumber == 0) {
                         continue;
                 }
@@ -461,15 +1022,16 @@ extern void * DSParallelWorkerValidityForSliceResolveCycles(void * pthread_struc
                         DSCaseFree(aCase);
                 }
         }
-        glp_free_env();
+        DSCaseLinearProgrammingContextEnd();
 bail:
-        pthread_exit(NULL);
+        return NULL;
 }
 
 extern void * DSParallelWorkerValiditySlice(void * pthread_struct)
 {
         struct pthread_struct * pdata = NULL;
-        DSUInteger caseNumber;
+        DSUInteger index, caseNumber;
+        ds_parallelcursor_t cursor = {0, 0};
         DSCase *aCase;
         DSVariablePool * lower, *upper;
         bool strict;
@@ -480,8 +1042,8 @@ extern void * DSParallelWorkerValiditySlice(void * pthread_struct)
                 goto bail;
         }
         pdata = (struct pthread_struct *)pthread_struct;
-        if (pdata->stack == NULL) {
-                DSError(M_DS_NULL ": Stack in parallel worker is NULL", A_DS_ERROR);
+        if (pdata->range == NULL) {
+                DSError(M_DS_NULL ": Range in parallel worker is NULL", A_DS_ERROR);
                 goto bail;
         }
         if (pdata->ds == NULL) {
@@ -489,7 +1051,7 @@ extern void * DSParallelWorkerValiditySlice(void * pthread_struct)
                 goto bail;
         }
         if (pdata->ds->validCases == NULL) {
-                DSError(M_DS_NULL ": Dictionary of valid cases is NULL", A_DS_ERROR);
+                DSError(M_DS_NULL ": Set of valid cases is NULL", A_DS_ERROR);
                 goto bail;
         }
         if (pdata->ds->gma == NULL) {
@@ -504,10 +1066,9 @@ extern void * DSParallelWorkerValiditySlice(void * pthread_struct)
         upper = pdata->functionArguments[1];
         strict = (bool)pdata->functionArguments[2];
         pdata->returnPointer = DSDictionaryAlloc();
-        glp_init_env();
-        /** Data in stack MUST be a case number, if not an error will occur **/
-        while (pdata->stack->count > 0)  {
-                caseNumber = DSParallelStackPop(pdata->stack);
+        DSCaseLinearProgrammingContextBegin();
+        while (DSParallelRangeNextIndex(pdata->range, &cursor, &index) == true) {
+                caseNumber = DSParallelRangeCaseNumberAtIndex(pdata->range, index);
                 if (caseNumber == 0) {
                         continue;
                 }
@@ -528,7 +1089,7 @@ extern void * DSParallelWorkerValiditySlice(void * pthread_struct)
                         DSCaseFree(aCase);
                 }
         }
-        glp_free_env();
+        DSCaseLinearProgrammingContextEnd();
 bail:
-        pthread_exit(NULL);
+        return NULL;
 }
@@ -29,6 +29,8 @@
 
 #include <pthread.h>
 #include "DSTypes.h"
+#include "DSDesignSpace.h"
+#include "DSThreadPool.h"
 
 #ifndef __DS_DESIGN_SPACE_PARALLEL__
 #define __DS_DESIGN_SPACE_PARALLEL__
@@ -37,6 +39,11 @@
 #define DS_STACK_ARG_CASENUM  0
 #define DS_STACK_ARG_CASE     1
 
+#define DS_PARALLEL_RANGE_MIN_CHUNK      1
+#define DS_PARALLEL_RANGE_CHUNK_FACTOR   2
+
+#define DS_PARALLEL_PRUNING_TASK_FACTOR  8
+
 /**
  * \brief Stack object used by the worker threads.
  *
@@ -69,15 +76,93 @@ typedef struct {
 } ds_parallelstack_t;
 
 /**
- * \brief Data structure passed to a pthread.
+ * \brief Range of case indices processed by the parallel workers.
+ *
+ * \details The workers claim contiguous [first, last) chunks of the range by
+ * atomically advancing the next unclaimed index (see DSParallelRangeNextChunk).
+ * The size of the range data structure is independent of the number of cases
+ * being processed; if the cases to process are not contiguous, the indices of
+ * the range refer to positions in the caseNumbers array.
+ */
+typedef struct {
+        DSUInteger begin;                //!< The first index of the range.
+        DSUInteger end;                  //!< One past the last index of the range.
+        volatile DSUInteger next;        //!< The next index not yet claimed by a worker.
+        DSUInteger numberOfWorkers;      //!< The number of workers sharing the range.
+        const DSUInteger * caseNumbers;  //!< Optional array with the case numbers at each index.
+        DSCase ** cases;                 //!< Optional array of cases, indexed from begin.
+        char argument_type;              //!< Indicates if the range refers to case numbers or cases.
+} ds_parallelrange_t;
+
+/**
+ * \brief Chunk of a ds_parallelrange_t currently being processed by a worker.
+ */
+typedef struct {
+        DSUInteger current;              //!< The next index to process.
+        DSUInteger end;                  //!< One past the last index of the chunk.
+} ds_parallelcursor_t;
+
+/**
+ * \brief Visitor shared by the workers streaming valid cases.
+ *
+ * \details When the visitor has a reorder buffer, workers claim the indices of
+ * the range one at a time and store each result in the slot of its index
+ * modulo the size of the buffer, so that the visiting thread can deliver the
+ * valid cases in order as consecutive results arrive (see
+ * DSParallelVisitorDeliverInOrder).  An index is only claimed if it is less
+ * than the size of the buffer ahead of the next index to be delivered.
+ * Otherwise, workers call the visitor directly, serialized by the lock.
  *
- * \details This data structure has two fields, one is a pointer to a 
- * ds_parallelstack_t object; this stack containes a stack of case numbers
- * to be processed in parallel.  Each stack is not designed to be accessed
- * concurrently, but should still be thread safe.
+ * \see DSDesignSpaceVisitValidCases
+ */
+typedef struct {
+        DSDesignSpaceCaseVisitor visitor; //!< The function called with each valid case.
+        void * context;                   //!< The user data passed to the visitor.
+        bool validityKnown;               //!< Indicates if the cases processed are known to be valid.
+        volatile bool stop;               //!< Set when the visitor requests that the enumeration stops.
+        DSUInteger numberVisited;         //!< The number of cases passed to the visitor.
+        pthread_mutex_t lock;             //!< The mutex serializing calls to the visitor and protecting the reorder buffer.
+        DSCase ** buffer;                 //!< The reorder buffer with the valid cases not yet delivered, or NULL.
+        bool * isDone;                    //!< Indicates if the index of each slot of the buffer has been processed.
+        DSUInteger bufferSize;            //!< The number of slots of the reorder buffer.
+        DSUInteger nextClaimed;           //!< The next index of the range to be claimed by a worker.
+        DSUInteger nextDelivered;         //!< The next index of the range to be delivered to the visitor.
+        pthread_cond_t changed;           //!< Signaled when a result is stored or delivered.
+} ds_parallelvisitor_t;
+
+/**
+ * \brief Node of the branch-and-bound search over dominance signatures.
+ *
+ * \details The first depth entries of the signature are fixed and their
+ * dominance conditions are known to be feasible.  Nodes shallower than the
+ * split depth submit each feasible child as a new task to the group; deeper
+ * nodes search their subtree sequentially.  Each node owns its signature and
+ * its condition matrices, whose first rows hold the additional conditions of
+ * the design space and the dominance conditions of the partial signature; the
+ * remaining rows are used by the descendants of the node.
+ */
+typedef struct {
+        DSDesignSpace * ds;              //!< The design space being searched.
+        DSThreadPoolGroup * group;       //!< The group of tasks of the search; NULL for a serial search.
+        DSUInteger * signature;          //!< The partial signature of the node.
+        DSUInteger depth;                //!< The number of fixed entries of the signature.
+        DSUInteger splitDepth;           //!< The depth up to which children are submitted as tasks.
+        DSMatrix * Cd;                   //!< The conditions of the dependent variables.
+        DSMatrix * Ci;                   //!< The conditions of the independent variables; NULL if there are none.
+        DSMatrix * delta;                //!< The constant terms of the conditions.
+        DSUInteger numberOfConditions;   //!< The number of rows of the conditions of the node.
+} ds_parallelprunednode_t;
+
+/**
+ * \brief Data structure passed to a thread pool task.
+ *
+ * \details One of these data structures is passed to each task submitted to
+ * the thread pool (see DSThreadPoolRun).  All the tasks processing the same
+ * cases share a pointer to a single ds_parallelrange_t object, from which each
+ * task claims chunks of cases to be processed.
  */
 struct pthread_struct {
-        ds_parallelstack_t * stack;
+        ds_parallelrange_t * range;
         DSDesignSpace * ds;
         DSUInteger numberOfArguments;
         void ** functionArguments;
@@ -93,11 +178,19 @@ extern void DSParallelStackPush(ds_parallelstack_t *stack, void * integer);
 extern const void * DSParallelStackPop(ds_parallelstack_t *stack);
 extern void DSParallelStackAddCase(ds_parallelstack_t *stack, DSCase * aCase);
 
+extern void DSParallelRangeInit(ds_parallelrange_t * range, const DSUInteger begin, const DSUInteger end, const DSUInteger numberOfWorkers);
+extern bool DSParallelRangeNextChunk(ds_parallelrange_t * range, DSUInteger * first, DSUInteger * last);
+extern bool DSParallelRangeNextIndex(ds_parallelrange_t * range, ds_parallelcursor_t * cursor, DSUInteger * index);
+extern DSUInteger DSParallelRangeCaseNumberAtIndex(const ds_parallelrange_t * range, const DSUInteger index);
+
 extern void * DSParallelWorkerCases(void * pthread_struct);
 extern void * DSParallelWorkerCyclicalCases(void * pthread_struct);
 extern void * DSParallelWorkerCasesSaveToDisk(void * pthread_struct);
 
 extern void * DSParallelWorkerValidity(void * pthread_struct);
+extern void * DSParallelWorkerVisitValidCases(void * pthread_struct);
+extern void DSParallelVisitorDeliverInOrder(struct pthread_struct * pdata);
+extern void * DSParallelWorkerPrunedValidity(void * prunedNode);
 extern void * DSParallelWorkerValiditySlice(void * pthread_struct);
 
 
@@ -645,31 +645,35 @@ bail:
 
 
 
-static double dsExpressionEvaluateMathematicalFunction(const DSExpression *function, const DSVariablePool * pool)
+/**
+ * \brief The names of the mathematical functions, in the order of their
+ * function indices.
+ */
+static const char * dsExpressionFunctionNames[] = {"log", "ln", "log10", "cos", "sin", "abs", "sign", "sqrt", "real", "imag", NULL};
+
+static int dsExpressionFunctionIndex(const char * name)
 {
-        double value = 0, eval = NAN;
-        double complex complex_value;
-        int functionIndex;
-        DSVariablePool *functionNames = NULL;
-        if (function == NULL) {
-                DSError(M_DS_NULL ": Expression node is null", A_DS_ERROR);
-                goto bail;
-        }
-        if (DSExpressionType(function) != DS_EXPRESSION_TYPE_FUNCTION) {
-                DSError(M_DS_WRONG ": Expression node must be a function", A_DS_ERROR);
+        int functionIndex = -1;
+        if (name == NULL)
                 goto bail;
-        }
-        functionNames = DSVariablePoolByParsingString("log : 1, ln : 1, log10 : 1, cos : 1, sin : 1, abs : 1, sign : 1, sqrt : 1, real : 1, imag : 1");
-        if (DSVariablePoolHasVariableWithName(functionNames, DSExpressionVariable(function)) == false) {
-                DSError(M_DS_WRONG ": Function name not recognized", A_DS_ERROR);
-                goto bail;
-        }
-        functionIndex =DSVariablePoolIndexOfVariableWithName(functionNames, DSExpressionVariable(function));
-        if (functionIndex == ds_function_index_real || functionIndex == ds_function_index_imag) {
-                complex_value = DSExpressionEvaluateComplexWithVariablePool(DSExpressionBranchAtIndex(function, 0), pool);
-        } else {
-                value = DSExpressionEvaluateWithVariablePool(DSExpressionBranchAtIndex(function, 0), pool);
-        }
+        for (functionIndex = 0; dsExpressionFunctionNames[functionIndex] != NULL; functionIndex++)
+                if (strcmp(dsExpressionFunctionNames[functionIndex], name) == 0)
+                        break;
+        if (dsExpressionFunctionNames[functionIndex] == NULL)
+                functionIndex = -1;
+bail:
+        return functionIndex;
+}
+
+/**
+ * \brief Applies a mathematical function to a real value.
+ *
+ * \details The real and imag functions are not applied by this function, as
+ * their argument is evaluated as a complex number.
+ */
+static double dsExpressionApplyFunction(const int functionIndex, const double value)
+{
+        double eval = NAN;
         switch (functionIndex) {
                 case ds_function_index_ln:
                         eval = log(value);
@@ -698,18 +702,89 @@ static double dsExpressionEvaluateMathematicalFunction(const DSExpression *funct
                 case ds_function_index_sqrt:
                         eval = sqrt(value);
                         break;
+                default:
+                        break;
+        }
+        return eval;
+}
+
+static double complex dsExpressionApplyFunctionComplex(const int functionIndex, const double complex value)
+{
+        double complex eval = NAN;
+        switch (functionIndex) {
+                case ds_function_index_ln:
+                        eval = clog(value);
+                        break;
+                case ds_function_index_log:
+                case ds_function_index_log10:
+                        eval = log10(creal(value));
+                        if (cimag(value) == 0.0) {
+                                eval = log10(creal(value));
+                        } else {
+                                DSError(M_DS_NOT_IMPL ": Using log10 of real part.", A_DS_WARN);
+                        }
+                        break;
+                case ds_function_index_cos:
+                        eval = ccos(value);
+                        break;
+                case ds_function_index_sin:
+                        eval = csin(value);
+                        break;
+                case ds_function_index_abs:
+                        eval = cabs(value);
+                        break;
+                case ds_function_index_sign:
+                        if (creal(value) > 0.0f)
+                                eval = 1.0f;
+                        else if (creal(value) < 0.0f)
+                                eval = -1.0f;
+                        else if (cimag(value) > 0.0f)
+                                eval = 1.0f;
+                        else if (cimag(value) < 0.0f)
+                                eval = -1.0f;
+                        else
+                                eval = 0.0f;
+                        break;
+                case ds_function_index_sqrt:
+                        eval = csqrt(value);
+                        break;
                 case ds_function_index_real:
-                        eval = creal(complex_value);
+                        eval = creal(value);
                         break;
                 case ds_function_index_imag:
-                        eval = cimag(complex_value);
+                        eval = cimag(value);
                         break;
                 default:
                         break;
         }
+        return eval;
+}
+
+static double dsExpressionEvaluateMathematicalFunction(const DSExpression *function, const DSVariablePool * pool)
+{
+        double eval = NAN;
+        double complex complex_value;
+        int functionIndex;
+        if (function == NULL) {
+                DSError(M_DS_NULL ": Expression node is null", A_DS_ERROR);
+                goto bail;
+        }
+        if (DSExpressionType(function) != DS_EXPRESSION_TYPE_FUNCTION) {
+                DSError(M_DS_WRONG ": Expression node must be a function", A_DS_ERROR);
+                goto bail;
+        }
+        functionIndex = dsExpressionFunctionIndex(DSExpressionVariable(function));
+        if (functionIndex < 0) {
+                DSError(M_DS_WRONG ": Function name not recognized", A_DS_ERROR);
+                goto bail;
+        }
+        if (functionIndex == ds_function_index_real || functionIndex == ds_function_index_imag) {
+                complex_value = DSExpressionEvaluateComplexWithVariablePool(DSExpressionBranchAtIndex(function, 0), pool);
+                eval = (functionIndex == ds_function_index_real) ? creal(complex_value) : cimag(complex_value);
+        } else {
+                eval = dsExpressionApplyFunction(functionIndex, DSExpressionEvaluateWithVariablePool(DSExpressionBranchAtIndex(function, 0), pool));
+        }
 bail:
-        if (functionNames != NULL)
-                DSVariablePoolFree(functionNames);
         return eval;
 }
 
@@ -776,8 +851,8 @@ bail:
 
 static double complex dsExpressionEvaluateMathematicalFunctionComplex(const DSExpression *function, const DSVariablePool * pool)
 {
-        double complex value, eval = NAN;
-        DSVariablePool *functionNames = NULL;
+        double complex eval = NAN;
+        int functionIndex;
         if (function == NULL) {
                 DSError(M_DS_NULL ": Expression node is null", A_DS_ERROR);
                 goto bail;
@@ -786,61 +861,13 @@ static double complex dsExpressionEvaluateMathematicalFunctionComplex(const DSEx
                 DSError(M_DS_WRONG ": Expression node must be a function", A_DS_ERROR);
                 goto bail;
         }
-        functionNames = DSVariablePoolByParsingString("log : 1, ln : 1, log10 : 1, cos : 1, sin : 1, abs : 1, sign : 1, sqrt : 1, real : 1, imag : 1");
-        if (DSVariablePoolHasVariableWithName(functionNames, DSExpressionVariable(function)) == false) {
+        functionIndex = dsExpressionFunctionIndex(DSExpressionVariable(function));
+        if (functionIndex < 0) {
                 DSError(M_DS_WRONG ": Function name not recognized", A_DS_ERROR);
                 goto bail;
         }
-        value = DSExpressionEvaluateComplexWithVariablePool(DSExpressionBranchAtIndex(function, 0), pool);
-        switch (DSVariablePoolIndexOfVariableWithName(functionNames, DSExpressionVariable(function))) {
-                case ds_function_index_ln:
-                        eval = clog(value);
-                        break;
-                case ds_function_index_log:
-                case ds_function_index_log10:
-                        eval = log10(creal(value));
-                        if (cimag(value) == 0.0) {
-                                eval = log10(creal(value));
-                        } else {
-                                DSError(M_DS_NOT_IMPL ": Using log10 of real part.", A_DS_WARN);
-                        }
-                        break;
-                case ds_function_index_cos:
-                        eval = ccos(value);
-                        break;
-                case ds_function_index_sin:
-                        eval = csin(value);
-                        break;
-                case ds_function_index_abs:
-                        eval = cabs(value);
-                        break;
-                case ds_function_index_sign:
-                        if (creal(value) > 0.0f)
-                                eval = 1.0f;
-                        else if (creal(value) < 0.0f)
-                                eval = -1.0f;
-                        else if (cimag(value) > 0.0f)
-                                eval = 1.0f;
-                        else if (cimag(value) < 0.0f)
-                                eval = -1.0f;
-                        else
-                                eval = 0.0f;
-                        break;
-                case ds_function_index_sqrt:
-                        eval = csqrt(value);
-                        break;
-                case ds_function_index_real:
-                        eval = creal(value);
-                        break;
-                case ds_function_index_imag:
-                        eval = cimag(value);
-                        break;
-                default:
-                        break;
-        }
+        eval = dsExpressionApplyFunctionComplex(functionIndex, DSExpressionEvaluateComplexWithVariablePool(DSExpressionBranchAtIndex(function, 0), pool));
 bail:
-        if (functionNames != NULL)
-                DSVariablePoolFree(functionNames);
         return eval;
 }
 
@@ -907,6 +934,370 @@ bail:
 }
 
 
+#if defined(__APPLE__) && defined (__MACH__)
+#pragma mark - Compiled expressions
+#endif
+
+#define DS_EXPRESSION_PROGRAM_CONSTANT          0    //!< Pushes the constant of the instruction.
+#define DS_EXPRESSION_PROGRAM_VARIABLE          1    //!< Pushes the value in the slot of the instruction.
+#define DS_EXPRESSION_PROGRAM_IMAGINARY         2    //!< Pushes the imaginary unit.
+#define DS_EXPRESSION_PROGRAM_ADD               3    //!< Replaces the operands on top of the stack by their sum.
+#define DS_EXPRESSION_PROGRAM_MULTIPLY          4    //!< Replaces the operands on top of the stack by their product.
+#define DS_EXPRESSION_PROGRAM_POWER             5    //!< Replaces a base and an exponent by the power.
+#define DS_EXPRESSION_PROGRAM_FUNCTION          6    //!< Applies a mathematical function to the top of the stack.
+#define DS_EXPRESSION_PROGRAM_REAL_PART         7    //!< Pushes the real part of a subprogram.
+#define DS_EXPRESSION_PROGRAM_IMAGINARY_PART    8    //!< Pushes the imaginary part of a subprogram.
+
+#define DS_EXPRESSION_PROGRAM_INIT_LENGTH       16
+#define DS_EXPRESSION_PROGRAM_STACK_SIZE        64   //!< Stack entries kept on the call stack; deeper programs use the heap.
+
+/**
+ * \brief State of the compilation of an expression.
+ */
+typedef struct {
+        DSExpressionProgram * program;
+        const DSVariablePool * layout;
+        DSUInteger capacity;
+        DSUInteger depth;
+        bool failed;
+} ds_expression_compiler_t;
+
+extern void DSExpressionProgramFree(DSExpressionProgram * program)
+{
+        DSUInteger i;
+        if (program == NULL) {
+                DSError(M_DS_NULL ": Expression program is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        for (i = 0; i < program->numberOfSubprograms; i++)
+                DSExpressionProgramFree(program->subprograms[i]);
+        if (program->subprograms != NULL)
+                DSSecureFree(program->subprograms);
+        if (program->instructions != NULL)
+                DSSecureFree(program->instructions);
+        DSSecureFree(program);
+bail:
+        return;
+}
+
+/**
+ * \brief Appends an instruction to a program being compiled.
+ *
+ * \details Every instruction pushes one value after popping its operands, so
+ * the depth of the stack is tracked here to size the stack of the evaluators.
+ */
+static void dsExpressionProgramEmit(ds_expression_compiler_t * compiler, const int opcode, const DSUInteger argument, const double constant, const DSUInteger numberOfOperands)
+{
+        DSExpressionProgram * program = compiler->program;
+        if (program->numberOfInstructions == compiler->capacity) {
+                compiler->capacity = (compiler->capacity == 0) ? DS_EXPRESSION_PROGRAM_INIT_LENGTH : 2*compiler->capacity;
+                if (program->instructions == NULL)
+                        program->instructions = DSSecureMalloc(sizeof(DSExpressionInstruction)*compiler->capacity);
+                else
+                        program->instructions = DSSecureRealloc(program->instructions, sizeof(DSExpressionInstruction)*compiler->capacity);
+        }
+        program->instructions[program->numberOfInstructions].opcode = opcode;
+        program->instructions[program->numberOfInstructions].argument = argument;
+        program->instructions[program->numberOfInstructions].constant = constant;
+        program->numberOfInstructions++;
+        compiler->depth = compiler->depth-numberOfOperands+1;
+        if (compiler->depth > program->stackSize)
+                program->stackSize = compiler->depth;
+}
+
+static void dsExpressionProgramCompileNode(ds_expression_compiler_t * compiler, const DSExpression * expression)
+{
+        DSExpressionProgram * program = compiler->program;
+        DSExpressionProgram * subprogram;
+        DSUInteger i;
+        int functionIndex;
+        if (expression == NULL) {
+                DSError(M_DS_NULL ": Expression is NULL", A_DS_ERROR);
+                compiler->failed = true;
+                goto bail;
+        }
+        switch (DSExpressionType(expression)) {
+                case DS_EXPRESSION_TYPE_VARIABLE:
+                        if (DSExpressionVariable(expression) == NULL) {
+                                DSError(M_DS_NULL ": Expression variable is NULL", A_DS_ERROR);
+                                compiler->failed = true;
+                        } else if (strcmp(DSExpressionVariable(expression), DSExpressionImaginaryNumber) == 0) {
+                                dsExpressionProgramEmit(compiler, DS_EXPRESSION_PROGRAM_IMAGINARY, 0, 0.0, 0);
+                        } else if (compiler->layout != NULL && DSVariablePoolHasVariableWithName(compiler->layout, DSExpressionVariable(expression)) == true) {
+                                dsExpressionProgramEmit(compiler, DS_EXPRESSION_PROGRAM_VARIABLE,
+                                                        DSVariablePoolIndexOfVariableWithName(compiler->layout, DSExpressionVariable(expression)), 0.0, 0);
+                        } else {
+                                DSError(M_DS_WRONG ": Variable pool does not have variable.", A_DS_ERROR);
+                                compiler->failed = true;
+                        }
+                        break;
+                case DS_EXPRESSION_TYPE_CONSTANT:
+                        dsExpressionProgramEmit(compiler, DS_EXPRESSION_PROGRAM_CONSTANT, 0, DSExpressionConstant(expression), 0);
+                        break;
+                case DS_EXPRESSION_TYPE_FUNCTION:
+                        functionIndex = dsExpressionFunctionIndex(DSExpressionVariable(expression));
+                        if (functionIndex < 0) {
+                                DSError(M_DS_WRONG ": Function name not recognized", A_DS_ERROR);
+                                compiler->failed = true;
+                                break;
+                        }
+                        if (functionIndex == ds_function_index_real || functionIndex == ds_function_index_imag) {
+                                subprogram = DSExpressionProgramCompile(DSExpressionBranchAtIndex(expression, 0), compiler->layout);
+                                if (subprogram == NULL) {
+                                        compiler->failed = true;
+                                        break;
+                                }
+                                if (program->subprograms == NULL)
+                                        program->subprograms = DSSecureMalloc(sizeof(DSExpressionProgram *));
+                                else
+                                        program->subprograms = DSSecureRealloc(program->subprograms, sizeof(DSExpressionProgram *)*(program->numberOfSubprograms+1));
+                                program->subprograms[program->numberOfSubprograms] = subprogram;
+                                dsExpressionProgramEmit(compiler,
+                                                        (functionIndex == ds_function_index_real) ? DS_EXPRESSION_PROGRAM_REAL_PART : DS_EXPRESSION_PROGRAM_IMAGINARY_PART,
+                                                        program->numberOfSubprograms++, 0.0, 0);
+                                break;
+                        }
+                        dsExpressionProgramCompileNode(compiler, DSExpressionBranchAtIndex(expression, 0));
+                        if (compiler->failed == true)
+                                break;
+                        dsExpressionProgramEmit(compiler, DS_EXPRESSION_PROGRAM_FUNCTION, functionIndex, 0.0, 1);
+                        break;
+                case DS_EXPRESSION_TYPE_OPERATOR:
+                        switch (DSExpressionOperator(expression)) {
+                                case '+':
+                                case '*':
+                                        for (i = 0; i < DSExpressionNumberOfBranches(expression) && compiler->failed == false; i++)
+                                                dsExpressionProgramCompileNode(compiler, DSExpressionBranchAtIndex(expression, i));
+                                        if (compiler->failed == true)
+                                                break;
+                                        dsExpressionProgramEmit(compiler,
+                                                                (DSExpressionOperator(expression) == '+') ? DS_EXPRESSION_PROGRAM_ADD : DS_EXPRESSION_PROGRAM_MULTIPLY,
+                                                                DSExpressionNumberOfBranches(expression), 0.0, DSExpressionNumberOfBranches(expression));
+                                        break;
+                                case '^':
+                                        dsExpressionProgramCompileNode(compiler, DSExpressionBranchAtIndex(expression, 0));
+                                        if (compiler->failed == false)
+                                                dsExpressionProgramCompileNode(compiler, DSExpressionBranchAtIndex(expression, 1));
+                                        if (compiler->failed == true)
+                                                break;
+                                        dsExpressionProgramEmit(compiler, DS_EXPRESSION_PROGRAM_POWER, 2, 0.0, 2);
+                                        break;
+                                default:
+                                        DSError(M_DS_WRONG "Operators cannot be evaluated as a function", A_DS_WARN);
+                                        compiler->failed = true;
+                                        break;
+                        }
+                        break;
+                default:
+                        DSError(M_DS_WRONG ": Expression node type is undefined", A_DS_ERROR);
+                        compiler->failed = true;
+                        break;
+        }
+bail:
+        return;
+}
+
+/**
+ * \brief Compiles an expression to a program for a stack machine.
+ *
+ * \details The variables of the expression are looked up in the layout once,
+ * and are replaced by their index in the layout.  The program can then be
+ * evaluated at many points with DSExpressionProgramEvaluate or
+ * DSExpressionProgramEvaluateComplex, with arrays of values in the order of
+ * the variables of the layout, without name lookups or recursion.
+ *
+ * \param expression The DSExpression to compile.
+ * \param layout The DSVariablePool with the variables of the expression.  May
+ *        be NULL if the expression has no variables.
+ *
+ * \return A new DSExpressionProgram, or NULL if the expression has variables
+ *         that are not in the layout or cannot be evaluated.  The caller is
+ *         responsible for freeing the program with DSExpressionProgramFree.
+ */
+extern DSExpressionProgram * DSExpressionProgramCompile(const DSExpression * expression, const DSVariablePool * layout)
+{
+        DSExpressionProgram * program = NULL;
+        ds_expression_compiler_t compiler = {NULL, layout, 0, 0, false};
+        if (expression == NULL) {
+                DSError(M_DS_NULL ": Expression is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        program = DSSecureCalloc(sizeof(DSExpressionProgram), 1);
+        if (layout != NULL)
+                program->numberOfSlots = DSVariablePoolNumberOfVariables(layout);
+        compiler.program = program;
+        dsExpressionProgramCompileNode(&compiler, expression);
+        if (compiler.failed == true) {
+                DSExpressionProgramFree(program);
+                program = NULL;
+        }
+bail:
+        return program;
+}
+
+/**
+ * \brief Evaluates a compiled expression with an array of values.
+ *
+ * \details The result is equal to that of DSExpressionEvaluateWithVariablePool
+ * with a variable pool with the same variables as the layout of the program,
+ * and with these values.
+ *
+ * \param program The DSExpressionProgram to evaluate.
+ * \param values An array with the value of each variable of the layout used to
+ *        compile the program, in the order of the layout.
+ *
+ * \return The value of the expression.
+ */
+extern double DSExpressionProgramEvaluate(const DSExpressionProgram * program, const double * values)
+{
+        double value = NAN;
+        const DSExpressionInstruction * instruction;
+        DSUInteger i, j, top = 0;
+        double stackValues[DS_EXPRESSION_PROGRAM_STACK_SIZE], * stack = stackValues;
+        if (program == NULL) {
+                DSError(M_DS_NULL ": Expression program is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (values == NULL && program->numberOfSlots > 0) {
+                DSError(M_DS_NULL ": Array of values is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (program->stackSize > DS_EXPRESSION_PROGRAM_STACK_SIZE)
+                stack = DSSecureMalloc(sizeof(double)*program->stackSize);
+        {
+                for (i = 0; i < program->numberOfInstructions; i++) {
+                        instruction = program->instructions+i;
+                        switch (instruction->opcode) {
+                                case DS_EXPRESSION_PROGRAM_CONSTANT:
+                                        stack[top++] = instruction->constant;
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_VARIABLE:
+                                        stack[top++] = values[instruction->argument];
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_IMAGINARY:
+                                        stack[top++] = NAN;
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_ADD:
+                                        value = 0;
+                                        for (j = top-instruction->argument; j < top; j++)
+                                                value += stack[j];
+                                        top -= instruction->argument;
+                                        stack[top++] = value;
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_MULTIPLY:
+                                        value = 1;
+                                        for (j = top-instruction->argument; j < top; j++)
+                                                value *= stack[j];
+                                        top -= instruction->argument;
+                                        stack[top++] = value;
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_POWER:
+                                        top--;
+                                        stack[top-1] = pow(stack[top-1], stack[top]);
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_FUNCTION:
+                                        stack[top-1] = dsExpressionApplyFunction((int)instruction->argument, stack[top-1]);
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_REAL_PART:
+                                        stack[top++] = creal(DSExpressionProgramEvaluateComplex(program->subprograms[instruction->argument], values));
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_IMAGINARY_PART:
+                                        stack[top++] = cimag(DSExpressionProgramEvaluateComplex(program->subprograms[instruction->argument], values));
+                                        break;
+                                default:
+                                        break;
+                        }
+                }
+                value = stack[0];
+        }
+bail:
+        if (stack != stackValues)
+                DSSecureFree(stack);
+        return value;
+}
+
+/**
+ * \brief Evaluates a compiled expression as a complex number with an array of
+ * values.
+ *
+ * \details The result is equal to that of
+ * DSExpressionEvaluateComplexWithVariablePool with a variable pool with the
+ * same variables as the layout of the program, and with these values.
+ *
+ * \param program The DSExpressionProgram to evaluate.
+ * \param values An array with the value of each variable of the layout used to
+ *        compile the program, in the order of the layout.
+ *
+ * \return The complex value of the expression.
+ */
+extern double complex DSExpressionProgramEvaluateComplex(const DSExpressionProgram * program, const double * values)
+{
+        double complex value = NAN;
+        const DSExpressionInstruction * instruction;
+        DSUInteger i, j, top = 0;
+        double complex stackValues[DS_EXPRESSION_PROGRAM_STACK_SIZE], * stack = stackValues;
+        if (program == NULL) {
+                DSError(M_DS_NULL ": Expression program is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (values == NULL && program->numberOfSlots > 0) {
+                DSError(M_DS_NULL ": Array of values is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (program->stackSize > DS_EXPRESSION_PROGRAM_STACK_SIZE)
+                stack = DSSecureMalloc(sizeof(double complex)*program->stackSize);
+        {
+                for (i = 0; i < program->numberOfInstructions; i++) {
+                        instruction = program->instructions+i;
+                        switch (instruction->opcode) {
+                                case DS_EXPRESSION_PROGRAM_CONSTANT:
+                                        stack[top++] = instruction->constant;
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_VARIABLE:
+                                        stack[top++] = values[instruction->argument];
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_IMAGINARY:
+                                        stack[top++] = I;
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_ADD:
+                                        value = 0;
+                                        for (j = top-instruction->argument; j < top; j++)
+                                                value += stack[j];
+                                        top -= instruction->argument;
+                                        stack[top++] = value;
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_MULTIPLY:
+                                        value = 1;
+                                        for (j = top-instruction->argument; j < top; j++)
+                                                value *= stack[j];
+                                        top -= instruction->argument;
+                                        stack[top++] = value;
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_POWER:
+                                        top--;
+                                        stack[top-1] = cpow(stack[top-1], stack[top]);
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_FUNCTION:
+                                        stack[top-1] = dsExpressionApplyFunctionComplex((int)instruction->argument, stack[top-1]);
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_REAL_PART:
+                                        stack[top++] = creal(DSExpressionProgramEvaluateComplex(program->subprograms[instruction->argument], values));
+                                        break;
+                                case DS_EXPRESSION_PROGRAM_IMAGINARY_PART:
+                                        stack[top++] = cimag(DSExpressionProgramEvaluateComplex(program->subprograms[instruction->argument], values));
+                                        break;
+                                default:
+                                        break;
+                        }
+                }
+                value = stack[0];
+        }
+bail:
+        if (stack != stackValues)
+                DSSecureFree(stack);
+        return value;
+}
+
 extern DSExpression * DSExpressionEquationLHSExpression(const DSExpression *expression)
 {
         DSExpression * lhs = NULL;
@@ -95,6 +95,15 @@ extern DSExpression * DSExpressionEquationLHSExpression(const DSExpression *expr
 extern DSExpression * DSExpressionEquationRHSExpression(const DSExpression *expression);
 extern DSVariablePool * DSExpressionVariablesInExpression(const DSExpression * expression);
 
+#if defined(__APPLE__) && defined (__MACH__)
+#pragma mark - Compiled expressions
+#endif
+
+extern DSExpressionProgram * DSExpressionProgramCompile(const DSExpression * expression, const DSVariablePool * layout);
+extern void DSExpressionProgramFree(DSExpressionProgram * program);
+extern double DSExpressionProgramEvaluate(const DSExpressionProgram * program, const double * values);
+extern double complex DSExpressionProgramEvaluateComplex(const DSExpressionProgram * program, const double * values);
+
 #if defined(__APPLE__) && defined (__MACH__)
 #pragma mark - Utility functions
 #endif
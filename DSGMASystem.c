@@ -39,6 +39,7 @@
 #include "DSGMASystemParsingAux.h"
 #include "DSMatrix.h"
 #include "DSMatrixArray.h"
+#include "DSCase.h"
 
 #define DS_GMA_EQUATION_STR_BUF      1000
 
@@ -64,8 +65,20 @@
 #define DSGMAHd(x)                       ((x)->Hd)
 #define DSGMAHi(x)                       ((x)->Hi)
 #define DSGMASignature(x)                   ((x)->signature)
+#define DSGMATermConflicts(x)               ((x)->termConflicts)
+#define DSGMATermExponents(x)               ((x)->termExponents)
 /*\}*/
 
+/**
+ * \brief Tolerance used when comparing dominance conditions of two terms.
+ */
+#define DS_GMA_TERM_CONFLICT_TOLERANCE   1E-14
+
+static void dsGMATermConflictsFree(DSGMATermConflicts * table);
+static void dsGMATermExponentsFree(DSGMATermExponents * exponents);
+static DSGMATermExponents * dsGMATermExponentsCopy(const DSGMATermExponents * exponents, const DSUInteger numberOfPositions);
+static void dsGMASystemCompressExponents(DSGMASystem * gma);
+
 
 #if defined (__APPLE__) && defined (__MACH__)
 #pragma mark - Allocation, deallocation and initialization
@@ -104,12 +117,7 @@ extern DSGMASystem * DSGMASystemCopy(const DSGMASystem * gma)
         DSGMAXd(copy) = DSVariablePoolCopy(DSGMAXd(gma));
         DSGMAXd_a(copy) = DSVariablePoolCopy(DSGMAXd_a(gma));
         DSGMAXi(copy) = DSVariablePoolCopy(DSGMAXi(gma));
-        DSGMAGd(copy) = DSMatrixArrayCopy(DSGMAGd(gma));
-        DSGMAHd(copy) = DSMatrixArrayCopy(DSGMAHd(gma));
-        if (DSVariablePoolNumberOfVariables(DSGMAXi(copy)) > 0) {
-                DSGMAGi(copy) = DSMatrixArrayCopy(DSGMAGi(gma));
-                DSGMAHi(copy) = DSMatrixArrayCopy(DSGMAHi(gma));
-        }
+        DSGMATermExponents(copy) = dsGMATermExponentsCopy(DSGMASystemTermExponents(gma), 2*numberOfEquations);
         DSGMAAlpha(copy) = DSMatrixCopy(DSGMAAlpha(gma));
         DSGMABeta(copy) = DSMatrixCopy(DSGMABeta(gma));
         DSGMASignature(copy) = DSSecureCalloc(sizeof(DSUInteger), numberOfEquations*2);
@@ -153,12 +161,17 @@ extern void DSGMASystemFree(DSGMASystem * gma)
         }
         if (DSGMAGi(gma) != NULL)
                 DSMatrixArrayFree(DSGMAGi(gma));
-        DSMatrixArrayFree(DSGMAHd(gma));
+        if (DSGMAHd(gma) != NULL)
+                DSMatrixArrayFree(DSGMAHd(gma));
         if (DSGMAHi(gma) != NULL)
                 DSMatrixArrayFree(DSGMAHi(gma));
         if (DSGMASignature(gma) != NULL) {
                 DSSecureFree(DSGMASignature(gma));
         }
+        if (DSGMATermConflicts(gma) != NULL)
+                dsGMATermConflictsFree(DSGMATermConflicts(gma));
+        if (DSGMATermExponents(gma) != NULL)
+                dsGMATermExponentsFree(DSGMATermExponents(gma));
         DSSecureFree(gma);
 bail:
         return;
@@ -694,6 +707,7 @@ static void dsGMASystemCreateSystemMatrices(DSGMASystem *gma, gma_parseraux_t **
                 DSGMASignature(gma)[2*i] = p;
                 DSGMASignature(gma)[2*i+1] = n;
         }
+        dsGMASystemCompressExponents(gma);
 bail:
         return;
 }
@@ -1026,7 +1040,7 @@ static void dsGMASystemEquationAddPositiveTermToString(const DSGMASystem *gma,
                                                        DSUInteger *length)
 {
         DSUInteger i, numberOfXd, numberOfXi;
-        DSMatrixArray *Gd, *Gi;
+        const DSMatrixArray *Gd, *Gi;
         DSMatrix *alpha;
         double value;
         char tempString[100];
@@ -1057,8 +1071,8 @@ static void dsGMASystemEquationAddPositiveTermToString(const DSGMASystem *gma,
                 goto bail;
         }
         numberOfXi = DSVariablePoolNumberOfVariables(DSGMAXi(gma));
-        Gd = DSGMAGd(gma);
-        Gi = DSGMAGi(gma);
+        Gd = DSGMASystemGd(gma);
+        Gi = DSGMASystemGi(gma);
         alpha = DSGMAAlpha(gma);
         sprintf(tempString, "%lf", DSMatrixDoubleValue(alpha, equation, pterm));
         if (*length-strlen(*string) < 100) {
@@ -1098,7 +1112,7 @@ static void dsGMASystemEquationAddNegativeTermToString(const DSGMASystem *gma,
                                                        DSUInteger *length)
 {
         DSUInteger i, numberOfXd, numberOfXi;
-        DSMatrixArray *Hd, *Hi;
+        const DSMatrixArray *Hd, *Hi;
         DSMatrix *beta;
         char tempString[100];
         const char *name;
@@ -1129,8 +1143,8 @@ static void dsGMASystemEquationAddNegativeTermToString(const DSGMASystem *gma,
                 goto bail;
         }
         numberOfXi = DSVariablePoolNumberOfVariables(DSGMAXi(gma));
-        Hd = DSGMAHd(gma);
-        Hi = DSGMAHi(gma);
+        Hd = DSGMASystemHd(gma);
+        Hi = DSGMASystemHi(gma);
         beta = DSGMABeta(gma);
         sprintf(tempString, "%lf", DSMatrixDoubleValue(beta, equation, nterm));
         if (*length-strlen(*string) < 100) {
@@ -1316,6 +1330,49 @@ bail:
         return beta;
 }
 
+/**
+ * \brief Creates the dense exponent matrices of one kind of term of a GMA
+ * system from its table of term exponents.
+ *
+ * \details The GMA system keeps the nonzero exponents of its terms (see
+ * DSGMASystemTermExponents); the dense Gd, Gi, Hd and Hi arrays are only
+ * created when they are accessed, and are then kept with the GMA system.
+ * Each matrix has one row per term of the widest equation, as when the
+ * system is parsed.
+ *
+ * \return A new DSMatrixArray with one matrix per equation, or NULL if the
+ *         exponents of independent variables are requested and the GMA
+ *         system has none.
+ */
+static DSMatrixArray * dsGMASystemDenseExponents(const DSGMASystem * gma, const bool positive, const bool dependent)
+{
+        DSMatrixArray * array = NULL;
+        DSMatrix * K;
+        const DSGMATermExponents * exponents = DSGMATermExponents(gma);
+        DSUInteger i, j, t, position, numberOfXd, numberOfXi, numberOfTerms;
+        numberOfXd = DSVariablePoolNumberOfVariables(DSGMAXd(gma));
+        numberOfXi = DSVariablePoolNumberOfVariables(DSGMAXi(gma));
+        if (dependent == false && numberOfXi == 0)
+                goto bail;
+        numberOfTerms = DSMatrixColumns((positive == true) ? DSGMAAlpha(gma) : DSGMABeta(gma));
+        array = DSMatrixArrayAlloc();
+        for (i = 0; i < numberOfXd; i++) {
+                K = DSMatrixCalloc(numberOfTerms, (dependent == true) ? numberOfXd : numberOfXi);
+                position = 2*i + ((positive == true) ? 0 : 1);
+                for (t = 0; t < DSGMASignature(gma)[position]; t++) {
+                        for (j = exponents->start[exponents->offsets[position]+t]; j < exponents->start[exponents->offsets[position]+t+1]; j++) {
+                                if (dependent == true && exponents->variables[j] < numberOfXd)
+                                        DSMatrixSetDoubleValue(K, t, exponents->variables[j], exponents->exponents[j]);
+                                else if (dependent == false && exponents->variables[j] >= numberOfXd)
+                                        DSMatrixSetDoubleValue(K, t, exponents->variables[j]-numberOfXd, exponents->exponents[j]);
+                        }
+                }
+                DSMatrixArrayAddMatrix(array, K);
+        }
+bail:
+        return array;
+}
+
 extern const DSMatrixArray *DSGMASystemGd(const DSGMASystem *gma)
 {
         DSMatrixArray * gd = NULL;
@@ -1324,6 +1381,14 @@ extern const DSMatrixArray *DSGMASystemGd(const DSGMASystem *gma)
                 goto bail;
         }
         gd = DSGMAGd(gma);
+        if (gd != NULL || DSGMATermExponents(gma) == NULL)
+                goto bail;
+        gd = dsGMASystemDenseExponents(gma, true, true);
+        if (__sync_bool_compare_and_swap(&((DSGMASystem *)gma)->Gd, NULL, gd) == false) {
+                if (gd != NULL)
+                        DSMatrixArrayFree(gd);
+                gd = DSGMAGd(gma);
+        }
 bail:
         return gd;
 }
@@ -1336,6 +1401,14 @@ extern const DSMatrixArray *DSGMASystemGi(const DSGMASystem *gma)
                 goto bail;
         }
         gi = DSGMAGi(gma);
+        if (gi != NULL || DSGMATermExponents(gma) == NULL)
+                goto bail;
+        gi = dsGMASystemDenseExponents(gma, true, false);
+        if (__sync_bool_compare_and_swap(&((DSGMASystem *)gma)->Gi, NULL, gi) == false) {
+                if (gi != NULL)
+                        DSMatrixArrayFree(gi);
+                gi = DSGMAGi(gma);
+        }
 bail:
         return gi;
 }
@@ -1348,6 +1421,14 @@ extern const DSMatrixArray *DSGMASystemHd(const DSGMASystem *gma)
                 goto bail;
         }
         hd = DSGMAHd(gma);
+        if (hd != NULL || DSGMATermExponents(gma) == NULL)
+                goto bail;
+        hd = dsGMASystemDenseExponents(gma, false, true);
+        if (__sync_bool_compare_and_swap(&((DSGMASystem *)gma)->Hd, NULL, hd) == false) {
+                if (hd != NULL)
+                        DSMatrixArrayFree(hd);
+                hd = DSGMAHd(gma);
+        }
 bail:
         return hd;
 }
@@ -1360,6 +1441,14 @@ extern const DSMatrixArray *DSGMASystemHi(const DSGMASystem *gma)
                 goto bail;
         }
         hi = DSGMAHi(gma);
+        if (hi != NULL || DSGMATermExponents(gma) == NULL)
+                goto bail;
+        hi = dsGMASystemDenseExponents(gma, false, false);
+        if (__sync_bool_compare_and_swap(&((DSGMASystem *)gma)->Hi, NULL, hi) == false) {
+                if (hi != NULL)
+                        DSMatrixArrayFree(hi);
+                hi = DSGMAHi(gma);
+        }
 bail:
         return hi;
 }
@@ -1424,6 +1513,445 @@ bail:
         return signature;
 }
 
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Dominance conflicts
+#endif
+
+static void dsGMATermConflictsFree(DSGMATermConflicts * table)
+{
+        if (table->offsets != NULL)
+                DSSecureFree(table->offsets);
+        if (table->conflicts != NULL)
+                DSSecureFree(table->conflicts);
+        DSSecureFree(table);
+}
+
+/**
+ * \brief Creates the dominance conditions of a term of a GMA system.
+ *
+ * \details The conditions are stored as the rows of a matrix, with the
+ * difference of exponents for each dependent and independent variable followed
+ * by the logarithm of the ratio of coefficients, such that the term is
+ * dominant when every row satisfies C*y + delta > 0.
+ *
+ * \return A new DSMatrix with one row for each of the other terms on the same
+ *         side of the equation, or NULL if the term is the only one.
+ */
+static DSMatrix * dsGMASystemTermConditions(const DSGMASystem * gma, const DSUInteger position, const DSUInteger term)
+{
+        DSMatrix * conditions = NULL;
+        DSUInteger j, l, numberOfXd, numberOfXi, numberOfTerms;
+        const DSMatrix * coefficients;
+        double value, * row;
+        numberOfTerms = DSGMASignature(gma)[position];
+        if (numberOfTerms < 2)
+                goto bail;
+        numberOfXd = DSVariablePoolNumberOfVariables(DSGMAXd(gma));
+        numberOfXi = DSVariablePoolNumberOfVariables(DSGMAXi(gma));
+        coefficients = (position % 2 == 0) ? DSGMAAlpha(gma) : DSGMABeta(gma);
+        conditions = DSMatrixCalloc(numberOfTerms-1, numberOfXd+numberOfXi+1);
+        for (j = 0, l = 0; j < numberOfTerms; j++) {
+                if (j == term)
+                        continue;
+                row = &DSMatrixElement(conditions, l, 0);
+                DSGMASystemAddTermExponents(gma, position, term, 1.0, row, row+numberOfXd);
+                DSGMASystemAddTermExponents(gma, position, j, -1.0, row, row+numberOfXd);
+                value = log10(DSMatrixDoubleValue(coefficients, position/2, term)
+                              /DSMatrixDoubleValue(coefficients, position/2, j));
+                DSMatrixSetDoubleValue(conditions, l, numberOfXd+numberOfXi, value);
+                l++;
+        }
+bail:
+        return conditions;
+}
+
+/**
+ * \brief Checks if the dominance conditions of two terms contradict each
+ * other.
+ *
+ * \details Two conditions C1*y + delta1 > 0 and C2*y + delta2 > 0 with
+ * C1 = -C2 can only be satisfied together if delta1 + delta2 > 0.  A condition
+ * paired with itself detects terms whose condition has no variables and a
+ * non-positive constant.
+ */
+static bool dsGMASystemTermConditionsConflict(const DSMatrix * conditions1, const DSMatrix * conditions2)
+{
+        bool conflict = false;
+        DSUInteger i, j, k, columns;
+        if (conditions1 == NULL || conditions2 == NULL)
+                goto bail;
+        columns = DSMatrixColumns(conditions1);
+        for (i = 0; i < DSMatrixRows(conditions1); i++) {
+                for (j = 0; j < DSMatrixRows(conditions2); j++) {
+                        for (k = 0; k < columns-1; k++) {
+                                if (fabs(DSMatrixDoubleValue(conditions1, i, k)+DSMatrixDoubleValue(conditions2, j, k)) > DS_GMA_TERM_CONFLICT_TOLERANCE)
+                                        break;
+                        }
+                        if (k < columns-1)
+                                continue;
+                        if (DSMatrixDoubleValue(conditions1, i, columns-1)+DSMatrixDoubleValue(conditions2, j, columns-1) <= DS_GMA_TERM_CONFLICT_TOLERANCE) {
+                                conflict = true;
+                                goto bail;
+                        }
+                }
+        }
+bail:
+        return conflict;
+}
+
+static DSGMATermConflicts * dsGMASystemCalculateTermConflicts(const DSGMASystem * gma)
+{
+        DSGMATermConflicts * table = NULL;
+        DSMatrix ** conditions = NULL;
+        DSUInteger i, j, t, numberOfPositions, numberOfChoices;
+        bool conflict;
+        numberOfPositions = 2*DSGMASystemNumberOfEquations(gma);
+        table = DSSecureCalloc(sizeof(DSGMATermConflicts), 1);
+        table->offsets = DSSecureCalloc(sizeof(DSUInteger), numberOfPositions+1);
+        for (i = 0; i < numberOfPositions; i++)
+                table->offsets[i+1] = table->offsets[i]+DSGMASignature(gma)[i];
+        numberOfChoices = table->offsets[numberOfPositions];
+        table->numberOfChoices = numberOfChoices;
+        table->conflicts = DSSecureCalloc(sizeof(char), numberOfChoices*numberOfChoices);
+        conditions = DSSecureCalloc(sizeof(DSMatrix *), numberOfChoices);
+        for (i = 0; i < numberOfPositions; i++) {
+                for (t = 0; t < DSGMASignature(gma)[i]; t++)
+                        conditions[table->offsets[i]+t] = dsGMASystemTermConditions(gma, i, t);
+        }
+        /** Choices on the same side of an equation are mutually exclusive and are never paired **/
+        for (i = 0; i < numberOfPositions; i++) {
+                for (t = table->offsets[i]; t < table->offsets[i+1]; t++) {
+                        conflict = dsGMASystemTermConditionsConflict(conditions[t], conditions[t]);
+                        table->conflicts[t*numberOfChoices+t] = conflict;
+                        for (j = table->offsets[i+1]; j < numberOfChoices; j++) {
+                                conflict = dsGMASystemTermConditionsConflict(conditions[t], conditions[j]);
+                                table->conflicts[t*numberOfChoices+j] = conflict;
+                                table->conflicts[j*numberOfChoices+t] = conflict;
+                        }
+                }
+        }
+        for (i = 0; i < numberOfChoices; i++) {
+                if (conditions[i] != NULL)
+                        DSMatrixFree(conditions[i]);
+        }
+        DSSecureFree(conditions);
+        return table;
+}
+
+/**
+ * \brief Returns the table of conflicting dominant terms of a GMA system.
+ *
+ * \details The table is calculated from the exponents and coefficients of the
+ * GMA system the first time it is needed and kept with the GMA system.  The
+ * table is published atomically, so concurrent callers may calculate it more
+ * than once but always share a single table.
+ *
+ * \param gma The DSGMASystem whose term conflicts are returned.
+ *
+ * \return A pointer to the DSGMATermConflicts of the GMA system.
+ */
+extern const DSGMATermConflicts * DSGMASystemTermConflicts(const DSGMASystem * gma)
+{
+        DSGMATermConflicts * table = NULL;
+        if (gma == NULL) {
+                DSError(M_DS_GMA_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (DSGMASignature(gma) == NULL) {
+                DSError(M_DS_WRONG ": GMA signature is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        table = DSGMATermConflicts(gma);
+        if (table != NULL)
+                goto bail;
+        table = dsGMASystemCalculateTermConflicts(gma);
+        if (__sync_bool_compare_and_swap(&((DSGMASystem *)gma)->termConflicts, NULL, table) == false) {
+                dsGMATermConflictsFree(table);
+                table = DSGMATermConflicts(gma);
+        }
+bail:
+        return table;
+}
+
+/**
+ * \brief Checks if a dominant term conflicts with itself or with the dominant
+ * terms that precede it in a signature.
+ *
+ * \details This function is meant for searches that extend a signature one
+ * position at a time, where the preceding positions have already been checked.
+ *
+ * \param gma The DSGMASystem of the signature.
+ * \param signature The signature with the dominant terms, starting at 1.
+ * \param position The position of the dominant term being checked.
+ *
+ * \return A boolean value that is true if the dominant term at position can
+ *         never be dominant together with the terms in positions 0 to
+ *         position.
+ */
+extern bool DSGMASystemTermConflictsWithSignature(const DSGMASystem * gma, const DSUInteger * signature, const DSUInteger position)
+{
+        bool conflict = false;
+        const DSGMATermConflicts * table;
+        const char * row;
+        DSUInteger i;
+        if (signature == NULL) {
+                DSError(M_DS_NULL ": Signature is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        table = DSGMASystemTermConflicts(gma);
+        if (table == NULL)
+                goto bail;
+        if (position >= 2*DSGMASystemNumberOfEquations(gma)) {
+                DSError(M_DS_WRONG ": Signature position is out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        row = table->conflicts + (table->offsets[position]+signature[position]-1)*table->numberOfChoices;
+        for (i = 0; i <= position; i++) {
+                if (row[table->offsets[i]+signature[i]-1] != 0) {
+                        conflict = true;
+                        break;
+                }
+        }
+bail:
+        return conflict;
+}
+
+/**
+ * \brief Checks if any two dominant terms of a signature conflict.
+ *
+ * \details Signatures with conflicting terms have dominance conditions that
+ * cannot be satisfied, and can be discarded without constructing their case.
+ *
+ * \param gma The DSGMASystem of the signature.
+ * \param signature The signature with the dominant terms, starting at 1.
+ * \param numberOfTerms The number of positions of the signature being checked.
+ *
+ * \return A boolean value that is true if the first numberOfTerms positions of
+ *         the signature contain a conflicting pair.
+ */
+extern bool DSGMASystemSignatureHasTermConflicts(const DSGMASystem * gma, const DSUInteger * signature, const DSUInteger numberOfTerms)
+{
+        bool conflict = false;
+        DSUInteger i;
+        for (i = 0; i < numberOfTerms; i++) {
+                conflict = DSGMASystemTermConflictsWithSignature(gma, signature, i);
+                if (conflict == true)
+                        break;
+        }
+        return conflict;
+}
+
+/**
+ * \brief Checks if any two dominant terms of a case conflict.
+ *
+ * \see DSGMASystemSignatureHasTermConflicts
+ */
+extern bool DSGMASystemCaseNumberHasTermConflicts(const DSGMASystem * gma, const DSUInteger caseNumber)
+{
+        bool conflict = false;
+        DSUInteger * signature = NULL;
+        signature = DSCaseSignatureForCaseNumber(caseNumber, gma);
+        if (signature == NULL)
+                goto bail;
+        conflict = DSGMASystemSignatureHasTermConflicts(gma, signature, 2*DSGMASystemNumberOfEquations(gma));
+        DSSecureFree(signature);
+bail:
+        return conflict;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Term exponents
+#endif
+
+static void dsGMATermExponentsFree(DSGMATermExponents * exponents)
+{
+        if (exponents->offsets != NULL)
+                DSSecureFree(exponents->offsets);
+        if (exponents->start != NULL)
+                DSSecureFree(exponents->start);
+        if (exponents->variables != NULL)
+                DSSecureFree(exponents->variables);
+        if (exponents->exponents != NULL)
+                DSSecureFree(exponents->exponents);
+        DSSecureFree(exponents);
+}
+
+static DSGMATermExponents * dsGMATermExponentsCopy(const DSGMATermExponents * exponents, const DSUInteger numberOfPositions)
+{
+        DSGMATermExponents * copy = NULL;
+        DSUInteger numberOfExponents;
+        if (exponents == NULL)
+                goto bail;
+        numberOfExponents = exponents->start[exponents->numberOfTerms];
+        copy = DSSecureCalloc(sizeof(DSGMATermExponents), 1);
+        copy->numberOfTerms = exponents->numberOfTerms;
+        copy->offsets = DSSecureMalloc(sizeof(DSUInteger)*(numberOfPositions+1));
+        memcpy(copy->offsets, exponents->offsets, sizeof(DSUInteger)*(numberOfPositions+1));
+        copy->start = DSSecureMalloc(sizeof(DSUInteger)*(exponents->numberOfTerms+1));
+        memcpy(copy->start, exponents->start, sizeof(DSUInteger)*(exponents->numberOfTerms+1));
+        copy->variables = DSSecureMalloc(sizeof(DSUInteger)*(numberOfExponents+1));
+        memcpy(copy->variables, exponents->variables, sizeof(DSUInteger)*numberOfExponents);
+        copy->exponents = DSSecureMalloc(sizeof(double)*(numberOfExponents+1));
+        memcpy(copy->exponents, exponents->exponents, sizeof(double)*numberOfExponents);
+bail:
+        return copy;
+}
+
+/**
+ * \brief Collects the nonzero exponents of the terms of a GMA system.
+ *
+ * \details The dense exponent matrices are read twice, first to count the
+ * nonzero exponents of each term and then to store them, so the arrays of the
+ * table are allocated once with their final size.
+ */
+static DSGMATermExponents * dsGMASystemCalculateTermExponents(const DSGMASystem * gma)
+{
+        DSGMATermExponents * exponents = NULL;
+        const DSMatrix * Kd, * Ki;
+        DSUInteger i, t, k, n, numberOfPositions, numberOfXd, numberOfXi;
+        numberOfPositions = 2*DSGMASystemNumberOfEquations(gma);
+        numberOfXd = DSVariablePoolNumberOfVariables(DSGMAXd(gma));
+        numberOfXi = DSVariablePoolNumberOfVariables(DSGMAXi(gma));
+        exponents = DSSecureCalloc(sizeof(DSGMATermExponents), 1);
+        exponents->offsets = DSSecureCalloc(sizeof(DSUInteger), numberOfPositions+1);
+        for (i = 0; i < numberOfPositions; i++)
+                exponents->offsets[i+1] = exponents->offsets[i]+DSGMASignature(gma)[i];
+        exponents->numberOfTerms = exponents->offsets[numberOfPositions];
+        exponents->start = DSSecureCalloc(sizeof(DSUInteger), exponents->numberOfTerms+1);
+        for (n = 0; n < 2; n++) {
+                for (i = 0; i < numberOfPositions; i++) {
+                        Kd = DSMatrixArrayMatrix((i % 2 == 0) ? DSGMAGd(gma) : DSGMAHd(gma), i/2);
+                        Ki = (numberOfXi == 0) ? NULL : DSMatrixArrayMatrix((i % 2 == 0) ? DSGMAGi(gma) : DSGMAHi(gma), i/2);
+                        for (t = exponents->offsets[i]; t < exponents->offsets[i+1]; t++) {
+                                if (n == 0)
+                                        exponents->start[t+1] = exponents->start[t];
+                                for (k = 0; k < numberOfXd+numberOfXi; k++) {
+                                        if (k < numberOfXd && DSMatrixElement(Kd, t-exponents->offsets[i], k) == 0.0)
+                                                continue;
+                                        if (k >= numberOfXd && DSMatrixElement(Ki, t-exponents->offsets[i], k-numberOfXd) == 0.0)
+                                                continue;
+                                        if (n == 0) {
+                                                exponents->start[t+1]++;
+                                                continue;
+                                        }
+                                        exponents->variables[exponents->start[t]] = k;
+                                        exponents->exponents[exponents->start[t]++] = (k < numberOfXd) ? DSMatrixElement(Kd, t-exponents->offsets[i], k) : DSMatrixElement(Ki, t-exponents->offsets[i], k-numberOfXd);
+                                }
+                        }
+                }
+                if (n == 0) {
+                        exponents->variables = DSSecureMalloc(sizeof(DSUInteger)*(exponents->start[exponents->numberOfTerms]+1));
+                        exponents->exponents = DSSecureMalloc(sizeof(double)*(exponents->start[exponents->numberOfTerms]+1));
+                }
+        }
+        /** The second pass advances each start to the start of the next term **/
+        for (t = exponents->numberOfTerms; t > 0; t--)
+                exponents->start[t] = exponents->start[t-1];
+        exponents->start[0] = 0;
+        return exponents;
+}
+
+/**
+ * \brief Replaces the dense exponent matrices of a new GMA system with its
+ * table of term exponents.
+ *
+ * \details This function is called once the exponents of a GMA system are
+ * final.  The dense matrices are freed, and are only created again if they
+ * are accessed (see DSGMASystemGd).
+ */
+static void dsGMASystemCompressExponents(DSGMASystem * gma)
+{
+        if (DSGMAGd(gma) == NULL || DSGMAHd(gma) == NULL) {
+                DSError(M_DS_WRONG ": GMA exponents are NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (DSGMATermExponents(gma) != NULL)
+                dsGMATermExponentsFree(DSGMATermExponents(gma));
+        DSGMATermExponents(gma) = dsGMASystemCalculateTermExponents(gma);
+        DSMatrixArrayFree(DSGMAGd(gma));
+        DSMatrixArrayFree(DSGMAHd(gma));
+        if (DSGMAGi(gma) != NULL)
+                DSMatrixArrayFree(DSGMAGi(gma));
+        if (DSGMAHi(gma) != NULL)
+                DSMatrixArrayFree(DSGMAHi(gma));
+        DSGMAGd(gma) = NULL;
+        DSGMAGi(gma) = NULL;
+        DSGMAHd(gma) = NULL;
+        DSGMAHi(gma) = NULL;
+bail:
+        return;
+}
+
+/**
+ * \brief Returns the nonzero exponents of the terms of a GMA system.
+ *
+ * \details The table is calculated when the GMA system is created, and is
+ * the only copy of the exponents kept by the GMA system unless the dense
+ * exponent matrices are accessed.  Building the rows of a case from this
+ * table takes time proportional to the number of nonzero kinetic orders of
+ * its terms, rather than to the number of variables.
+ *
+ * \param gma The DSGMASystem whose term exponents are returned.
+ *
+ * \return A pointer to the DSGMATermExponents of the GMA system.
+ */
+extern const DSGMATermExponents * DSGMASystemTermExponents(const DSGMASystem * gma)
+{
+        DSGMATermExponents * exponents = NULL;
+        if (gma == NULL) {
+                DSError(M_DS_GMA_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        exponents = DSGMATermExponents(gma);
+        if (exponents == NULL)
+                DSError(M_DS_WRONG ": GMA term exponents are NULL", A_DS_ERROR);
+bail:
+        return exponents;
+}
+
+/**
+ * \brief Adds a multiple of the exponents of a term of a GMA system to a row
+ * of dependent variables and a row of independent variables.
+ *
+ * \details Only the nonzero exponents of the term are visited.  The rows are
+ * arrays with one value per dependent and independent variable, such as a row
+ * of a DSMatrix.  For a single row with the dependent variables followed by
+ * the independent variables, xiRow is xdRow plus the number of dependent
+ * variables.
+ *
+ * \param gma The DSGMASystem with the term.
+ * \param position The side of the equations with the term, twice the equation
+ *        for positive terms and twice the equation plus one for negative
+ *        terms.
+ * \param term The index of the term, starting at 0.
+ * \param factor The factor multiplying the exponents.
+ * \param xdRow The row of dependent variables.
+ * \param xiRow The row of independent variables, which may be NULL if the GMA
+ *        system has no independent variables.
+ */
+extern void DSGMASystemAddTermExponents(const DSGMASystem * gma, const DSUInteger position, const DSUInteger term, const double factor, double * xdRow, double * xiRow)
+{
+        const DSGMATermExponents * exponents;
+        DSUInteger i, t, numberOfXd;
+        exponents = DSGMASystemTermExponents(gma);
+        if (exponents == NULL)
+                goto bail;
+        if (position >= 2*DSGMASystemNumberOfEquations(gma) || term >= DSGMASignature(gma)[position]) {
+                DSError(M_DS_WRONG ": Term is out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        numberOfXd = DSVariablePoolNumberOfVariables(DSGMAXd(gma));
+        t = exponents->offsets[position]+term;
+        for (i = exponents->start[t]; i < exponents->start[t+1]; i++) {
+                if (exponents->variables[i] < numberOfXd)
+                        xdRow[exponents->variables[i]] += factor*exponents->exponents[i];
+                else
+                        xiRow[exponents->variables[i]-numberOfXd] += factor*exponents->exponents[i];
+        }
+bail:
+        return;
+}
+
 #if defined (__APPLE__) && defined (__MACH__)
 #pragma mark - S-System functions
 #endif
@@ -1909,6 +2437,7 @@ extern DSGMASystem * DSGMASystemFromGMASystemMessage(const DSGMASystemMessage *
         for (i = 0; i < message->n_signature; i++) {
                 gma->signature[i] = message->signature[i];
         }
+        dsGMASystemCompressExponents(gma);
 bail:
         return gma;
 }
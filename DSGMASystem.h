@@ -87,6 +87,22 @@ extern const DSVariablePool *DSGMASystemXi(const DSGMASystem *gma);
 extern const DSUInteger DSGMASystemNumberOfCases(const DSGMASystem *gma);
 extern const DSUInteger * DSGMASystemSignature(const DSGMASystem *gma);
 
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Dominance conflicts
+#endif
+
+extern const DSGMATermConflicts * DSGMASystemTermConflicts(const DSGMASystem * gma);
+extern bool DSGMASystemTermConflictsWithSignature(const DSGMASystem * gma, const DSUInteger * signature, const DSUInteger position);
+extern bool DSGMASystemSignatureHasTermConflicts(const DSGMASystem * gma, const DSUInteger * signature, const DSUInteger numberOfTerms);
+extern bool DSGMASystemCaseNumberHasTermConflicts(const DSGMASystem * gma, const DSUInteger caseNumber);
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Term exponents
+#endif
+
+extern const DSGMATermExponents * DSGMASystemTermExponents(const DSGMASystem * gma);
+extern void DSGMASystemAddTermExponents(const DSGMASystem * gma, const DSUInteger position, const DSUInteger term, const double factor, double * xdRow, double * xiRow);
+
 
 
 #if defined (__APPLE__) && defined (__MACH__)
@@ -0,0 +1,971 @@
+/**
+ * \file DSLinearProblem.c
+ * \brief Implementation file with functions for building and solving linear
+ * problems independently of the linear programming package.
+ *
+ * \details Each backend is a function that solves a problem, together with
+ * the largest problem it accepts.  Backends are tried in order, starting from
+ * the backend selected with DSLinearProblemSetBackend, until one of them
+ * accepts the problem and does not fail.  The dense simplex method works in
+ * a workspace owned by the problem object, so solving a problem that fits in
+ * the workspace does not allocate memory.
+ *
+ * Copyright (C) 2011-2014 Jason Lomnitz.\n\n
+ *
+ * This file is part of the Design Space Toolbox V2 (C Library).
+ *
+ * The Design Space Toolbox V2 is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Design Space Toolbox V2 is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Design Space Toolbox. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * \author Jason Lomnitz.
+ * \date 2014
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <glpk.h>
+#include "DSMemoryManager.h"
+#include "DSMatrix.h"
+#include "DSLinearProblem.h"
+
+/**
+ * \brief The largest violation of a bound accepted in a solution of the dense
+ * simplex method.
+ */
+#define DS_LINEAR_PROBLEM_PRIMAL_TOLERANCE      1E-9
+
+/**
+ * \brief The smallest reduced cost of a variable entering the basis of the
+ * dense simplex method.
+ */
+#define DS_LINEAR_PROBLEM_DUAL_TOLERANCE        1E-9
+
+/**
+ * \brief The smallest pivot element of the dense simplex method.
+ */
+#define DS_LINEAR_PROBLEM_PIVOT_TOLERANCE       1E-9
+
+#define DS_LINEAR_PROBLEM_AT_LOWER              0
+#define DS_LINEAR_PROBLEM_AT_UPPER              1
+#define DS_LINEAR_PROBLEM_AT_ZERO               2
+#define DS_LINEAR_PROBLEM_BASIC                 3
+
+/**
+ * \brief A backend solving linear problems.
+ *
+ * \details A backend returns DS_LINEAR_PROBLEM_FAILED if it cannot solve a
+ * problem, in which case the next backend is tried.
+ */
+typedef struct {
+        DSUInteger maximumRows;                          //!< The largest number of rows accepted, 0 if there is no limit.
+        DSUInteger maximumColumns;                       //!< The largest number of columns accepted, 0 if there is no limit.
+        DSUInteger (*solve)(DSLinearProblem * problem);  //!< The function solving the problem.
+} ds_lpbackend_t;
+
+/**
+ * \brief The state of the dense simplex method, stored in the workspace of a
+ * problem.
+ *
+ * \details The variables are the columns of the problem, followed by one
+ * slack variable for each row and an artificial variable used to find an
+ * initial feasible basis.  The tableau is the inverse of the basis times the
+ * coefficients of all the variables, so the columns of the slack variables
+ * hold the inverse of the basis.
+ */
+typedef struct {
+        DSUInteger numberOfRows;          //!< The number of rows of the tableau.
+        DSUInteger numberOfVariables;     //!< The number of columns of the tableau.
+        double * tableau;                 //!< A numberOfRows by numberOfVariables array with the tableau.
+        double * values;                  //!< The value of each variable.
+        double * costs;                   //!< The cost of each variable in the current phase.
+        double * lower;                   //!< The lower bound of each variable.
+        double * upper;                   //!< The upper bound of each variable.
+        double * artificial;              //!< The coefficient of the artificial variable in each row.
+        double * residual;                //!< The right hand side of each row minus the nonbasic terms.
+        int * basis;                      //!< The variable that is basic in each row.
+        int * state;                      //!< The state of each variable.
+} ds_lpdense_t;
+
+static DSUInteger dsLinearProblemSolveDense(DSLinearProblem * problem);
+static DSUInteger dsLinearProblemSolveGLPK(DSLinearProblem * problem);
+
+/**
+ * \brief The backends, in the order in which they are tried.
+ *
+ * \details The order must match the values of the DS_LINEAR_PROBLEM_BACKEND
+ * options.
+ */
+static const ds_lpbackend_t dsLinearProblemBackends[] = {
+        {DS_LINEAR_PROBLEM_DENSE_MAXIMUM_ROWS, DS_LINEAR_PROBLEM_DENSE_MAXIMUM_COLUMNS, dsLinearProblemSolveDense},
+        {0, 0, dsLinearProblemSolveGLPK}
+};
+
+#define DS_LINEAR_PROBLEM_NUMBER_OF_BACKENDS    (sizeof(dsLinearProblemBackends)/sizeof(ds_lpbackend_t))
+
+static DSUInteger dsLinearProblemBackendOption = DS_LINEAR_PROBLEM_BACKEND_AUTOMATIC;
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Backend options
+#endif
+
+/**
+ * \brief Selects the first backend tried when solving linear problems.
+ *
+ * \param backend DS_LINEAR_PROBLEM_BACKEND_AUTOMATIC to solve small problems
+ *        with the dense simplex method, or DS_LINEAR_PROBLEM_BACKEND_GLPK to
+ *        solve every problem with GLPK.
+ */
+extern void DSLinearProblemSetBackend(const DSUInteger backend)
+{
+        if (backend >= DS_LINEAR_PROBLEM_NUMBER_OF_BACKENDS) {
+                DSError(M_DS_WRONG ": Linear problem backend is not valid", A_DS_ERROR);
+                goto bail;
+        }
+        dsLinearProblemBackendOption = backend;
+bail:
+        return;
+}
+
+extern DSUInteger DSLinearProblemBackend(void)
+{
+        return dsLinearProblemBackendOption;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Allocation, deallocation and initialization
+#endif
+
+extern DSLinearProblem * DSLinearProblemAlloc(void)
+{
+        return DSSecureCalloc(sizeof(DSLinearProblem), 1);
+}
+
+extern void DSLinearProblemFree(DSLinearProblem * problem)
+{
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (problem->coefficients != NULL)
+                DSSecureFree(problem->coefficients);
+        if (problem->constants != NULL)
+                DSSecureFree(problem->constants);
+        if (problem->lower != NULL)
+                DSSecureFree(problem->lower);
+        if (problem->upper != NULL)
+                DSSecureFree(problem->upper);
+        if (problem->objective != NULL)
+                DSSecureFree(problem->objective);
+        if (problem->solution != NULL)
+                DSSecureFree(problem->solution);
+        if (problem->workspace != NULL)
+                DSSecureFree(problem->workspace);
+        if (problem->indices != NULL)
+                DSSecureFree(problem->indices);
+        if (problem->glpkProblem != NULL)
+                glp_delete_prob(problem->glpkProblem);
+        DSSecureFree(problem);
+bail:
+        return;
+}
+
+/**
+ * \brief Makes room in the workspace of a problem for the given number of
+ * floating point and integer values.
+ */
+static void dsLinearProblemReserveWorkspace(DSLinearProblem * problem, const DSUInteger numberOfValues, const DSUInteger numberOfIndices)
+{
+        if (numberOfValues > problem->workspaceSize) {
+                if (problem->workspace != NULL)
+                        DSSecureFree(problem->workspace);
+                problem->workspace = DSSecureMalloc(sizeof(double)*numberOfValues);
+                problem->workspaceSize = numberOfValues;
+        }
+        if (numberOfIndices > problem->indicesSize) {
+                if (problem->indices != NULL)
+                        DSSecureFree(problem->indices);
+                problem->indices = DSSecureMalloc(sizeof(int)*numberOfIndices);
+                problem->indicesSize = numberOfIndices;
+        }
+}
+
+/**
+ * \brief Sets the dimensions of a linear problem and resets its data.
+ *
+ * \details All coefficients, constants and objective coefficients are set to
+ * zero, all variables are made free and the objective is minimized.  The
+ * arrays of the problem are only reallocated if the problem grows beyond
+ * its capacity.
+ *
+ * \param problem The DSLinearProblem being resized.
+ * \param numberOfRows The number of constraints of the problem.
+ * \param numberOfColumns The number of variables of the problem.
+ */
+extern void DSLinearProblemResize(DSLinearProblem * problem, const DSUInteger numberOfRows, const DSUInteger numberOfColumns)
+{
+        DSUInteger i;
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (numberOfRows > problem->rowCapacity || numberOfColumns > problem->columnCapacity || problem->coefficients == NULL) {
+                if (numberOfRows > problem->rowCapacity)
+                        problem->rowCapacity = numberOfRows;
+                if (numberOfColumns > problem->columnCapacity)
+                        problem->columnCapacity = numberOfColumns;
+                if (problem->coefficients != NULL) {
+                        DSSecureFree(problem->coefficients);
+                        DSSecureFree(problem->constants);
+                        DSSecureFree(problem->lower);
+                        DSSecureFree(problem->upper);
+                        DSSecureFree(problem->objective);
+                        DSSecureFree(problem->solution);
+                }
+                problem->coefficients = DSSecureMalloc(sizeof(double)*(problem->rowCapacity*problem->columnCapacity+1));
+                problem->constants = DSSecureMalloc(sizeof(double)*(problem->rowCapacity+1));
+                problem->lower = DSSecureMalloc(sizeof(double)*(problem->columnCapacity+1));
+                problem->upper = DSSecureMalloc(sizeof(double)*(problem->columnCapacity+1));
+                problem->objective = DSSecureMalloc(sizeof(double)*(problem->columnCapacity+1));
+                problem->solution = DSSecureMalloc(sizeof(double)*(problem->columnCapacity+1));
+        }
+        problem->numberOfRows = numberOfRows;
+        problem->numberOfColumns = numberOfColumns;
+        memset(problem->coefficients, 0, sizeof(double)*numberOfRows*numberOfColumns);
+        memset(problem->constants, 0, sizeof(double)*numberOfRows);
+        for (i = 0; i < numberOfColumns; i++) {
+                problem->lower[i] = -INFINITY;
+                problem->upper[i] = INFINITY;
+                problem->objective[i] = 0.0;
+                problem->solution[i] = 0.0;
+        }
+        problem->objectiveConstant = 0.0;
+        problem->maximize = false;
+        problem->objectiveValue = 0.0;
+        problem->status = DS_LINEAR_PROBLEM_UNSOLVED;
+bail:
+        return;
+}
+
+/**
+ * \brief Loads the constraints A*x <= b in a linear problem.
+ *
+ * \details The problem is resized to the dimensions of A, so all its
+ * variables are free and its objective is zero.
+ */
+extern void DSLinearProblemLoadMatrices(DSLinearProblem * problem, const DSMatrix * A, const DSMatrix * b)
+{
+        DSUInteger i;
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (A == NULL || b == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (DSMatrixRows(A) != DSMatrixRows(b)) {
+                DSError(M_DS_MAT_OUTOFBOUNDS ": Number of constraints must match", A_DS_ERROR);
+                goto bail;
+        }
+        DSLinearProblemResize(problem, DSMatrixRows(A), DSMatrixColumns(A));
+        memcpy(problem->coefficients, DSMatrixData(A), sizeof(double)*problem->numberOfRows*problem->numberOfColumns);
+        for (i = 0; i < problem->numberOfRows; i++)
+                problem->constants[i] = DSMatrixElement(b, i, 0);
+bail:
+        return;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Setter functions
+#endif
+
+extern void DSLinearProblemSetCoefficient(DSLinearProblem * problem, const DSUInteger row, const DSUInteger column, const double value)
+{
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (row >= problem->numberOfRows || column >= problem->numberOfColumns) {
+                DSError(M_DS_WRONG ": Coefficient is out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        problem->coefficients[row*problem->numberOfColumns+column] = value;
+        problem->status = DS_LINEAR_PROBLEM_UNSOLVED;
+bail:
+        return;
+}
+
+extern void DSLinearProblemSetConstant(DSLinearProblem * problem, const DSUInteger row, const double value)
+{
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (row >= problem->numberOfRows) {
+                DSError(M_DS_WRONG ": Constraint is out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        problem->constants[row] = value;
+        problem->status = DS_LINEAR_PROBLEM_UNSOLVED;
+bail:
+        return;
+}
+
+/**
+ * \brief Sets the bounds of a variable of a linear problem.
+ *
+ * \details A bound of -INFINITY or INFINITY leaves the variable unbounded in
+ * that direction, and equal bounds fix the variable.
+ */
+extern void DSLinearProblemSetColumnBounds(DSLinearProblem * problem, const DSUInteger column, const double lower, const double upper)
+{
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (column >= problem->numberOfColumns) {
+                DSError(M_DS_WRONG ": Variable is out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        problem->lower[column] = lower;
+        problem->upper[column] = upper;
+        problem->status = DS_LINEAR_PROBLEM_UNSOLVED;
+bail:
+        return;
+}
+
+extern void DSLinearProblemSetObjectiveCoefficient(DSLinearProblem * problem, const DSUInteger column, const double value)
+{
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (column >= problem->numberOfColumns) {
+                DSError(M_DS_WRONG ": Variable is out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        problem->objective[column] = value;
+        problem->status = DS_LINEAR_PROBLEM_UNSOLVED;
+bail:
+        return;
+}
+
+extern void DSLinearProblemSetObjectiveConstant(DSLinearProblem * problem, const double value)
+{
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        problem->objectiveConstant = value;
+        problem->status = DS_LINEAR_PROBLEM_UNSOLVED;
+bail:
+        return;
+}
+
+extern void DSLinearProblemSetMaximize(DSLinearProblem * problem, const bool maximize)
+{
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        problem->maximize = maximize;
+        problem->status = DS_LINEAR_PROBLEM_UNSOLVED;
+bail:
+        return;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Getter functions
+#endif
+
+extern DSUInteger DSLinearProblemNumberOfRows(const DSLinearProblem * problem)
+{
+        DSUInteger numberOfRows = 0;
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        numberOfRows = problem->numberOfRows;
+bail:
+        return numberOfRows;
+}
+
+extern DSUInteger DSLinearProblemNumberOfColumns(const DSLinearProblem * problem)
+{
+        DSUInteger numberOfColumns = 0;
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        numberOfColumns = problem->numberOfColumns;
+bail:
+        return numberOfColumns;
+}
+
+extern bool DSLinearProblemColumnIsFixed(const DSLinearProblem * problem, const DSUInteger column)
+{
+        bool isFixed = false;
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (column >= problem->numberOfColumns) {
+                DSError(M_DS_WRONG ": Variable is out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        isFixed = (problem->lower[column] == problem->upper[column]);
+bail:
+        return isFixed;
+}
+
+extern double DSLinearProblemColumnLowerBound(const DSLinearProblem * problem, const DSUInteger column)
+{
+        double lower = NAN;
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (column >= problem->numberOfColumns) {
+                DSError(M_DS_WRONG ": Variable is out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        lower = problem->lower[column];
+bail:
+        return lower;
+}
+
+extern double DSLinearProblemColumnUpperBound(const DSLinearProblem * problem, const DSUInteger column)
+{
+        double upper = NAN;
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (column >= problem->numberOfColumns) {
+                DSError(M_DS_WRONG ": Variable is out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        upper = problem->upper[column];
+bail:
+        return upper;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Dense simplex method
+#endif
+
+/**
+ * \brief Divides a row of the tableau by its element in a column, and
+ * eliminates the column from all other rows.
+ */
+static void dsLinearProblemDensePivot(ds_lpdense_t * dense, const DSUInteger row, const DSUInteger column)
+{
+        DSUInteger i, j, numberOfVariables = dense->numberOfVariables;
+        double * pivotRow = dense->tableau+row*numberOfVariables, * current, factor;
+        factor = 1.0/pivotRow[column];
+        for (j = 0; j < numberOfVariables; j++)
+                pivotRow[j] *= factor;
+        pivotRow[column] = 1.0;
+        for (i = 0; i < dense->numberOfRows; i++) {
+                if (i == row)
+                        continue;
+                current = dense->tableau+i*numberOfVariables;
+                factor = current[column];
+                if (factor == 0.0)
+                        continue;
+                for (j = 0; j < numberOfVariables; j++)
+                        current[j] -= factor*pivotRow[j];
+                current[column] = 0.0;
+        }
+        dense->basis[row] = column;
+        dense->state[column] = DS_LINEAR_PROBLEM_BASIC;
+}
+
+/**
+ * \brief Calculates the values of the basic variables from the nonbasic
+ * variables, removing the rounding errors accumulated by the iterations.
+ */
+static void dsLinearProblemDenseUpdateBasicValues(const DSLinearProblem * problem, ds_lpdense_t * dense)
+{
+        DSUInteger i, j, n = problem->numberOfColumns, m = dense->numberOfRows;
+        DSUInteger artificial = dense->numberOfVariables-1;
+        const double * inverse;
+        double value;
+        for (i = 0; i < m; i++) {
+                value = problem->constants[i];
+                for (j = 0; j < n; j++) {
+                        if (dense->state[j] != DS_LINEAR_PROBLEM_BASIC)
+                                value -= problem->coefficients[i*n+j]*dense->values[j];
+                }
+                if (dense->state[n+i] != DS_LINEAR_PROBLEM_BASIC)
+                        value -= dense->values[n+i];
+                if (dense->state[artificial] != DS_LINEAR_PROBLEM_BASIC)
+                        value -= dense->artificial[i]*dense->values[artificial];
+                dense->residual[i] = value;
+        }
+        for (i = 0; i < m; i++) {
+                inverse = dense->tableau+i*dense->numberOfVariables+n;
+                value = 0.0;
+                for (j = 0; j < m; j++)
+                        value += inverse[j]*dense->residual[j];
+                dense->values[dense->basis[i]] = value;
+        }
+}
+
+/**
+ * \brief Iterates the bounded simplex method with the costs of the current
+ * phase, starting from a feasible basis.
+ *
+ * \details The entering variable is the one with the largest reduced cost.
+ * After a long sequence of degenerate iterations, the smallest index rule is
+ * used instead to prevent cycling.  A variable whose bounds are reached
+ * before any basic variable reaches its bounds moves to its other bound
+ * without changing the basis.
+ *
+ * \return DS_LINEAR_PROBLEM_OPTIMAL, DS_LINEAR_PROBLEM_UNBOUNDED or
+ *         DS_LINEAR_PROBLEM_FAILED if the iteration limit is reached.
+ */
+static DSUInteger dsLinearProblemDenseIterate(ds_lpdense_t * dense, const DSUInteger maximumIterations)
+{
+        DSUInteger status = DS_LINEAR_PROBLEM_FAILED;
+        DSUInteger i, j, iteration, degenerate = 0;
+        DSUInteger m = dense->numberOfRows, numberOfVariables = dense->numberOfVariables;
+        int entering, leaving, variable;
+        double reducedCost, largest, direction, alpha, pivot, ratio, step;
+        bool smallestIndex = false;
+        for (iteration = 0; iteration < maximumIterations; iteration++) {
+                entering = -1;
+                largest = 0.0;
+                direction = 0.0;
+                for (j = 0; j < numberOfVariables; j++) {
+                        if (dense->state[j] == DS_LINEAR_PROBLEM_BASIC || dense->lower[j] == dense->upper[j])
+                                continue;
+                        reducedCost = dense->costs[j];
+                        for (i = 0; i < m; i++) {
+                                if (dense->costs[dense->basis[i]] != 0.0)
+                                        reducedCost -= dense->costs[dense->basis[i]]*dense->tableau[i*numberOfVariables+j];
+                        }
+                        if (fabs(reducedCost) <= DS_LINEAR_PROBLEM_DUAL_TOLERANCE)
+                                continue;
+                        if (dense->state[j] == DS_LINEAR_PROBLEM_AT_LOWER && reducedCost > 0.0)
+                                continue;
+                        if (dense->state[j] == DS_LINEAR_PROBLEM_AT_UPPER && reducedCost < 0.0)
+                                continue;
+                        if (entering == -1 || fabs(reducedCost) > largest) {
+                                entering = j;
+                                largest = fabs(reducedCost);
+                                direction = (reducedCost < 0.0) ? 1.0 : -1.0;
+                        }
+                        if (smallestIndex == true)
+                                break;
+                }
+                if (entering == -1) {
+                        status = DS_LINEAR_PROBLEM_OPTIMAL;
+                        break;
+                }
+                step = dense->upper[entering]-dense->lower[entering];
+                leaving = -1;
+                pivot = 0.0;
+                for (i = 0; i < m; i++) {
+                        alpha = direction*dense->tableau[i*numberOfVariables+entering];
+                        variable = dense->basis[i];
+                        if (alpha > DS_LINEAR_PROBLEM_PIVOT_TOLERANCE && dense->lower[variable] != -INFINITY)
+                                ratio = (dense->values[variable]-dense->lower[variable])/alpha;
+                        else if (alpha < -DS_LINEAR_PROBLEM_PIVOT_TOLERANCE && dense->upper[variable] != INFINITY)
+                                ratio = (dense->upper[variable]-dense->values[variable])/(-alpha);
+                        else
+                                continue;
+                        if (ratio < 0.0)
+                                ratio = 0.0;
+                        if (ratio < step) {
+                                step = ratio;
+                                leaving = i;
+                                pivot = alpha;
+                        } else if (ratio == step && leaving != -1) {
+                                if (smallestIndex == true ? variable < dense->basis[leaving] : fabs(alpha) > fabs(pivot)) {
+                                        leaving = i;
+                                        pivot = alpha;
+                                }
+                        }
+                }
+                if (step == INFINITY) {
+                        status = DS_LINEAR_PROBLEM_UNBOUNDED;
+                        break;
+                }
+                degenerate = (step <= DS_LINEAR_PROBLEM_PRIMAL_TOLERANCE) ? degenerate+1 : 0;
+                if (degenerate > numberOfVariables)
+                        smallestIndex = true;
+                dense->values[entering] += direction*step;
+                for (i = 0; i < m; i++)
+                        dense->values[dense->basis[i]] -= direction*dense->tableau[i*numberOfVariables+entering]*step;
+                if (leaving == -1) {
+                        if (direction > 0.0) {
+                                dense->values[entering] = dense->upper[entering];
+                                dense->state[entering] = DS_LINEAR_PROBLEM_AT_UPPER;
+                        } else {
+                                dense->values[entering] = dense->lower[entering];
+                                dense->state[entering] = DS_LINEAR_PROBLEM_AT_LOWER;
+                        }
+                        continue;
+                }
+                variable = dense->basis[leaving];
+                if (pivot > 0.0) {
+                        dense->values[variable] = dense->lower[variable];
+                        dense->state[variable] = DS_LINEAR_PROBLEM_AT_LOWER;
+                } else {
+                        dense->values[variable] = dense->upper[variable];
+                        dense->state[variable] = DS_LINEAR_PROBLEM_AT_UPPER;
+                }
+                dsLinearProblemDensePivot(dense, leaving, entering);
+        }
+        return status;
+}
+
+/**
+ * \brief Builds the initial tableau of the dense simplex method, with the
+ * slack variables as the basis.
+ *
+ * \details Each column starts at its finite bound, or at zero if it is free.
+ *
+ * \return A boolean value indicating if the bounds of every column are
+ *         consistent.
+ */
+static bool dsLinearProblemDenseSetUp(DSLinearProblem * problem, ds_lpdense_t * dense)
+{
+        bool isConsistent = false;
+        DSUInteger i, j, n = problem->numberOfColumns, m = problem->numberOfRows;
+        DSUInteger numberOfVariables = n+m+1;
+        double * workspace;
+        dsLinearProblemReserveWorkspace(problem, m*numberOfVariables+4*numberOfVariables+2*m, m+numberOfVariables);
+        workspace = problem->workspace;
+        dense->numberOfRows = m;
+        dense->numberOfVariables = numberOfVariables;
+        dense->tableau = workspace;
+        dense->values = dense->tableau+m*numberOfVariables;
+        dense->costs = dense->values+numberOfVariables;
+        dense->lower = dense->costs+numberOfVariables;
+        dense->upper = dense->lower+numberOfVariables;
+        dense->artificial = dense->upper+numberOfVariables;
+        dense->residual = dense->artificial+m;
+        dense->basis = problem->indices;
+        dense->state = dense->basis+m;
+        memset(dense->tableau, 0, sizeof(double)*m*numberOfVariables);
+        for (j = 0; j < n; j++) {
+                if (problem->lower[j] > problem->upper[j])
+                        goto bail;
+                dense->lower[j] = problem->lower[j];
+                dense->upper[j] = problem->upper[j];
+                dense->costs[j] = 0.0;
+                if (dense->lower[j] != -INFINITY) {
+                        dense->values[j] = dense->lower[j];
+                        dense->state[j] = DS_LINEAR_PROBLEM_AT_LOWER;
+                } else if (dense->upper[j] != INFINITY) {
+                        dense->values[j] = dense->upper[j];
+                        dense->state[j] = DS_LINEAR_PROBLEM_AT_UPPER;
+                } else {
+                        dense->values[j] = 0.0;
+                        dense->state[j] = DS_LINEAR_PROBLEM_AT_ZERO;
+                }
+        }
+        for (j = n; j < numberOfVariables; j++) {
+                dense->lower[j] = 0.0;
+                dense->upper[j] = INFINITY;
+                dense->costs[j] = 0.0;
+                dense->values[j] = 0.0;
+                dense->state[j] = DS_LINEAR_PROBLEM_AT_LOWER;
+        }
+        for (i = 0; i < m; i++) {
+                for (j = 0; j < n; j++)
+                        dense->tableau[i*numberOfVariables+j] = problem->coefficients[i*n+j];
+                dense->tableau[i*numberOfVariables+n+i] = 1.0;
+                dense->artificial[i] = 0.0;
+                dense->basis[i] = n+i;
+                dense->state[n+i] = DS_LINEAR_PROBLEM_BASIC;
+        }
+        dsLinearProblemDenseUpdateBasicValues(problem, dense);
+        isConsistent = true;
+bail:
+        return isConsistent;
+}
+
+/**
+ * \brief Solves a linear problem with a dense bounded simplex method.
+ *
+ * \details If the slack variables of the initial basis violate their bounds,
+ * a single artificial variable is added to every violated row and pivoted
+ * into the row with the largest violation, which makes the basis feasible.
+ * The first phase minimizes the artificial variable, and the second phase
+ * minimizes the objective with the artificial variable fixed at zero.
+ */
+static DSUInteger dsLinearProblemSolveDense(DSLinearProblem * problem)
+{
+        DSUInteger status = DS_LINEAR_PROBLEM_FAILED;
+        DSUInteger i, j, n = problem->numberOfColumns, m = problem->numberOfRows;
+        DSUInteger artificial, maximumIterations, worst = 0;
+        double sign = (problem->maximize == true) ? -1.0 : 1.0, step;
+        ds_lpdense_t dense;
+        if (dsLinearProblemDenseSetUp(problem, &dense) == false) {
+                status = DS_LINEAR_PROBLEM_INFEASIBLE;
+                goto bail;
+        }
+        artificial = dense.numberOfVariables-1;
+        maximumIterations = 20*dense.numberOfVariables+100;
+        for (i = 1; i < m; i++) {
+                if (dense.values[n+i] < dense.values[n+worst])
+                        worst = i;
+        }
+        if (m > 0 && dense.values[n+worst] < -DS_LINEAR_PROBLEM_PRIMAL_TOLERANCE) {
+                for (i = 0; i < m; i++) {
+                        if (dense.values[n+i] < 0.0) {
+                                dense.artificial[i] = -1.0;
+                                dense.tableau[i*dense.numberOfVariables+artificial] = -1.0;
+                        }
+                }
+                step = -dense.values[n+worst];
+                dense.values[artificial] = step;
+                for (i = 0; i < m; i++)
+                        dense.values[n+i] -= dense.artificial[i]*step;
+                dense.values[n+worst] = 0.0;
+                dense.state[n+worst] = DS_LINEAR_PROBLEM_AT_LOWER;
+                dsLinearProblemDensePivot(&dense, worst, artificial);
+                dense.costs[artificial] = 1.0;
+                if (dsLinearProblemDenseIterate(&dense, maximumIterations) != DS_LINEAR_PROBLEM_OPTIMAL)
+                        goto bail;
+                dsLinearProblemDenseUpdateBasicValues(problem, &dense);
+                if (dense.values[artificial] > DS_LINEAR_PROBLEM_PRIMAL_TOLERANCE) {
+                        status = DS_LINEAR_PROBLEM_INFEASIBLE;
+                        goto bail;
+                }
+                dense.costs[artificial] = 0.0;
+                dense.upper[artificial] = 0.0;
+                if (dense.state[artificial] != DS_LINEAR_PROBLEM_BASIC)
+                        dense.values[artificial] = 0.0;
+        }
+        for (j = 0; j < n; j++)
+                dense.costs[j] = sign*problem->objective[j];
+        status = dsLinearProblemDenseIterate(&dense, maximumIterations);
+        if (status == DS_LINEAR_PROBLEM_FAILED)
+                goto bail;
+        dsLinearProblemDenseUpdateBasicValues(problem, &dense);
+        for (j = 0; j < dense.numberOfVariables; j++) {
+                if (dense.values[j] < dense.lower[j]-DS_LINEAR_PROBLEM_PRIMAL_TOLERANCE
+                    || dense.values[j] > dense.upper[j]+DS_LINEAR_PROBLEM_PRIMAL_TOLERANCE) {
+                        status = DS_LINEAR_PROBLEM_FAILED;
+                        goto bail;
+                }
+        }
+        problem->objectiveValue = problem->objectiveConstant;
+        for (j = 0; j < n; j++) {
+                problem->solution[j] = dense.values[j];
+                problem->objectiveValue += problem->objective[j]*dense.values[j];
+        }
+        if (status == DS_LINEAR_PROBLEM_UNBOUNDED)
+                problem->objectiveValue = -sign*INFINITY;
+bail:
+        return status;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - GLPK
+#endif
+
+/**
+ * \brief Solves a linear problem with the simplex method of GLPK.
+ *
+ * \details The GLPK problem object is kept with the problem, and its basis is
+ * reused to warm start the next problem with the same dimensions.
+ */
+static DSUInteger dsLinearProblemSolveGLPK(DSLinearProblem * problem)
+{
+        DSUInteger status = DS_LINEAR_PROBLEM_FAILED;
+        DSUInteger i, j, n = problem->numberOfColumns, m = problem->numberOfRows;
+        glp_prob * linearProblem;
+        int count, result;
+        double * values, lower, upper;
+        glp_term_out(GLP_OFF);
+        if (problem->glpkProblem == NULL)
+                problem->glpkProblem = glp_create_prob();
+        linearProblem = problem->glpkProblem;
+        if (glp_get_num_rows(linearProblem) != m || glp_get_num_cols(linearProblem) != n) {
+                glp_erase_prob(linearProblem);
+                if (m > 0)
+                        glp_add_rows(linearProblem, m);
+                if (n > 0)
+                        glp_add_cols(linearProblem, n);
+        }
+        dsLinearProblemReserveWorkspace(problem, n+1, n+1);
+        values = problem->workspace;
+        for (i = 0; i < m; i++) {
+                count = 0;
+                for (j = 0; j < n; j++) {
+                        if (problem->coefficients[i*n+j] == 0.0)
+                                continue;
+                        count++;
+                        problem->indices[count] = j+1;
+                        values[count] = problem->coefficients[i*n+j];
+                }
+                glp_set_mat_row(linearProblem, i+1, count, problem->indices, values);
+                glp_set_row_bnds(linearProblem, i+1, GLP_UP, 0.0, problem->constants[i]);
+        }
+        for (j = 0; j < n; j++) {
+                lower = problem->lower[j];
+                upper = problem->upper[j];
+                if (lower > upper) {
+                        status = DS_LINEAR_PROBLEM_INFEASIBLE;
+                        goto bail;
+                }
+                if (lower == -INFINITY && upper == INFINITY)
+                        glp_set_col_bnds(linearProblem, j+1, GLP_FR, 0.0, 0.0);
+                else if (lower == -INFINITY)
+                        glp_set_col_bnds(linearProblem, j+1, GLP_UP, 0.0, upper);
+                else if (upper == INFINITY)
+                        glp_set_col_bnds(linearProblem, j+1, GLP_LO, lower, 0.0);
+                else if (lower == upper)
+                        glp_set_col_bnds(linearProblem, j+1, GLP_FX, lower, upper);
+                else
+                        glp_set_col_bnds(linearProblem, j+1, GLP_DB, lower, upper);
+                glp_set_obj_coef(linearProblem, j+1, problem->objective[j]);
+        }
+        glp_set_obj_coef(linearProblem, 0, problem->objectiveConstant);
+        glp_set_obj_dir(linearProblem, (problem->maximize == true) ? GLP_MAX : GLP_MIN);
+        result = glp_simplex(linearProblem, NULL);
+        if (result == GLP_EBADB || result == GLP_ESING || result == GLP_ECOND) {
+                glp_std_basis(linearProblem);
+                glp_simplex(linearProblem, NULL);
+        }
+        switch (glp_get_status(linearProblem)) {
+                case GLP_OPT:
+                        status = DS_LINEAR_PROBLEM_OPTIMAL;
+                        break;
+                case GLP_FEAS:
+                        status = DS_LINEAR_PROBLEM_FEASIBLE;
+                        break;
+                case GLP_NOFEAS:
+                        status = DS_LINEAR_PROBLEM_INFEASIBLE;
+                        break;
+                case GLP_UNBND:
+                        status = DS_LINEAR_PROBLEM_UNBOUNDED;
+                        break;
+                default:
+                        status = DS_LINEAR_PROBLEM_FAILED;
+                        break;
+        }
+        for (j = 0; j < n; j++)
+                problem->solution[j] = glp_get_col_prim(linearProblem, j+1);
+        problem->objectiveValue = glp_get_obj_val(linearProblem);
+        if (status == DS_LINEAR_PROBLEM_UNBOUNDED)
+                problem->objectiveValue = (problem->maximize == true) ? INFINITY : -INFINITY;
+bail:
+        return status;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Solution
+#endif
+
+/**
+ * \brief Solves a linear problem with the first backend that accepts it.
+ *
+ * \details A backend accepts a problem if the problem is within its size
+ * limits.  If the backend fails, for example because the dense simplex
+ * method does not converge, the problem is solved by the next backend.
+ *
+ * \param problem The DSLinearProblem being solved.
+ *
+ * \return The status of the solution.
+ */
+extern DSUInteger DSLinearProblemSolve(DSLinearProblem * problem)
+{
+        DSUInteger i, status = DS_LINEAR_PROBLEM_FAILED;
+        const ds_lpbackend_t * backend;
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        for (i = dsLinearProblemBackendOption; i < DS_LINEAR_PROBLEM_NUMBER_OF_BACKENDS; i++) {
+                backend = dsLinearProblemBackends+i;
+                if (backend->maximumRows != 0 && problem->numberOfRows > backend->maximumRows)
+                        continue;
+                if (backend->maximumColumns != 0 && problem->numberOfColumns > backend->maximumColumns)
+                        continue;
+                status = backend->solve(problem);
+                if (status != DS_LINEAR_PROBLEM_FAILED)
+                        break;
+        }
+        problem->status = status;
+bail:
+        return status;
+}
+
+extern DSUInteger DSLinearProblemStatus(const DSLinearProblem * problem)
+{
+        DSUInteger status = DS_LINEAR_PROBLEM_UNSOLVED;
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        status = problem->status;
+bail:
+        return status;
+}
+
+/**
+ * \brief Determines if the last solution of a linear problem satisfies all
+ * its constraints and bounds.
+ *
+ * \details Solutions of unbounded problems are feasible, and their objective
+ * value is -INFINITY or INFINITY.
+ */
+extern bool DSLinearProblemIsFeasible(const DSLinearProblem * problem)
+{
+        bool isFeasible = false;
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        isFeasible = (problem->status == DS_LINEAR_PROBLEM_OPTIMAL
+                      || problem->status == DS_LINEAR_PROBLEM_FEASIBLE
+                      || problem->status == DS_LINEAR_PROBLEM_UNBOUNDED);
+bail:
+        return isFeasible;
+}
+
+extern double DSLinearProblemObjectiveValue(const DSLinearProblem * problem)
+{
+        double value = NAN;
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        value = problem->objectiveValue;
+bail:
+        return value;
+}
+
+extern double DSLinearProblemColumnValue(const DSLinearProblem * problem, const DSUInteger column)
+{
+        double value = NAN;
+        if (problem == NULL) {
+                DSError(M_DS_LINEAR_PROBLEM_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (column >= problem->numberOfColumns) {
+                DSError(M_DS_WRONG ": Variable is out of bounds", A_DS_ERROR);
+                goto bail;
+        }
+        value = problem->solution[column];
+bail:
+        return value;
+}
@@ -0,0 +1,131 @@
+/**
+ * \file DSLinearProblem.h
+ * \brief Header file with functions for building and solving linear problems
+ * independently of the linear programming package.
+ *
+ * \details A linear problem minimizes or maximizes c*x subject to A*x <= b
+ * and lower <= x <= upper.  Problems are solved by a backend chosen by the
+ * size of the problem: problems with few rows and columns, such as the
+ * validity tests of cases, are solved by a dense bounded simplex method that
+ * works in the memory of the problem object, and larger problems are solved
+ * by GLPK.  The dense method also falls back to GLPK if it does not converge.
+ *
+ * Copyright (C) 2011-2014 Jason Lomnitz.\n\n
+ *
+ * This file is part of the Design Space Toolbox V2 (C Library).
+ *
+ * The Design Space Toolbox V2 is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Design Space Toolbox V2 is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Design Space Toolbox. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * \author Jason Lomnitz.
+ * \date 2014
+ */
+
+#include <stdbool.h>
+#include "DSTypes.h"
+#include "DSErrors.h"
+
+#ifndef __DS_LINEAR_PROBLEM__
+#define __DS_LINEAR_PROBLEM__
+
+#define M_DS_LINEAR_PROBLEM_NULL        M_DS_NULL ": Linear problem is NULL"
+
+/**
+ * \brief Backend choosing the dense simplex method for small problems and
+ * GLPK for all others.
+ */
+#define DS_LINEAR_PROBLEM_BACKEND_AUTOMATIC     0
+
+/**
+ * \brief Backend solving every problem with GLPK.
+ */
+#define DS_LINEAR_PROBLEM_BACKEND_GLPK          1
+
+/**
+ * \brief The largest number of rows of a problem solved by the dense simplex
+ * method.
+ */
+#define DS_LINEAR_PROBLEM_DENSE_MAXIMUM_ROWS    64
+
+/**
+ * \brief The largest number of columns of a problem solved by the dense
+ * simplex method.
+ */
+#define DS_LINEAR_PROBLEM_DENSE_MAXIMUM_COLUMNS 32
+
+#define DS_LINEAR_PROBLEM_UNSOLVED              0    //!< The problem has not been solved since it was last changed.
+#define DS_LINEAR_PROBLEM_OPTIMAL               1    //!< The solution is optimal.
+#define DS_LINEAR_PROBLEM_FEASIBLE              2    //!< The solution is feasible, but may not be optimal.
+#define DS_LINEAR_PROBLEM_INFEASIBLE            3    //!< The problem has no feasible solution.
+#define DS_LINEAR_PROBLEM_UNBOUNDED             4    //!< The objective is unbounded; the solution is feasible.
+#define DS_LINEAR_PROBLEM_FAILED                5    //!< The problem could not be solved.
+
+#ifdef __cplusplus
+__BEGIN_DECLS
+#endif
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Backend options
+#endif
+
+extern void DSLinearProblemSetBackend(const DSUInteger backend);
+extern DSUInteger DSLinearProblemBackend(void);
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Allocation, deallocation and initialization
+#endif
+
+extern DSLinearProblem * DSLinearProblemAlloc(void);
+extern void DSLinearProblemFree(DSLinearProblem * problem);
+
+extern void DSLinearProblemResize(DSLinearProblem * problem, const DSUInteger numberOfRows, const DSUInteger numberOfColumns);
+extern void DSLinearProblemLoadMatrices(DSLinearProblem * problem, const DSMatrix * A, const DSMatrix * b);
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Setter functions
+#endif
+
+extern void DSLinearProblemSetCoefficient(DSLinearProblem * problem, const DSUInteger row, const DSUInteger column, const double value);
+extern void DSLinearProblemSetConstant(DSLinearProblem * problem, const DSUInteger row, const double value);
+extern void DSLinearProblemSetColumnBounds(DSLinearProblem * problem, const DSUInteger column, const double lower, const double upper);
+extern void DSLinearProblemSetObjectiveCoefficient(DSLinearProblem * problem, const DSUInteger column, const double value);
+extern void DSLinearProblemSetObjectiveConstant(DSLinearProblem * problem, const double value);
+extern void DSLinearProblemSetMaximize(DSLinearProblem * problem, const bool maximize);
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Getter functions
+#endif
+
+extern DSUInteger DSLinearProblemNumberOfRows(const DSLinearProblem * problem);
+extern DSUInteger DSLinearProblemNumberOfColumns(const DSLinearProblem * problem);
+extern bool DSLinearProblemColumnIsFixed(const DSLinearProblem * problem, const DSUInteger column);
+extern double DSLinearProblemColumnLowerBound(const DSLinearProblem * problem, const DSUInteger column);
+extern double DSLinearProblemColumnUpperBound(const DSLinearProblem * problem, const DSUInteger column);
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Solution
+#endif
+
+extern DSUInteger DSLinearProblemSolve(DSLinearProblem * problem);
+
+extern DSUInteger DSLinearProblemStatus(const DSLinearProblem * problem);
+extern bool DSLinearProblemIsFeasible(const DSLinearProblem * problem);
+extern double DSLinearProblemObjectiveValue(const DSLinearProblem * problem);
+extern double DSLinearProblemColumnValue(const DSLinearProblem * problem, const DSUInteger column);
+
+#ifdef __cplusplus
+__END_DECLS
+#endif
+
+#endif
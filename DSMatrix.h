@@ -49,6 +49,23 @@
 #define DSMatrixColumns(x)          ((x)->columns)
 
 #define DSMatrixInternalPointer(x)  ((x)->mat)
+#define DSMatrixData(x)             ((x)->data)
+
+/**
+ * \brief Accesses the value of a matrix at a row and column without checking
+ * the matrix or the bounds.
+ *
+ * \details The macro may be used both to read and to assign values.  It is
+ * meant for loops over matrices whose dimensions have already been checked;
+ * DSMatrixDoubleValue and DSMatrixSetDoubleValue should be used elsewhere.
+ */
+#define DSMatrixElement(x, i, j)    ((x)->data[(i)*(x)->columns+(j)])
+
+/**
+ * \brief Absolute value of the determinant below which a matrix is considered
+ * singular by DSMatrixInverse.
+ */
+#define DS_MATRIX_SINGULAR_DETERMINANT  1E-14
 
 #ifdef __cplusplus
 __BEGIN_DECLS
@@ -73,9 +90,13 @@ __BEGIN_DECLS
 
 extern DSMatrix * DSMatrixAlloc(const DSUInteger rows, const DSUInteger columns);
 extern DSMatrix * DSMatrixCalloc(const DSUInteger rows, const DSUInteger columns);
+extern DSMatrix * DSMatrixWithData(const DSUInteger rows, const DSUInteger columns, double * data);
 extern DSMatrix * DSMatrixCopy(const DSMatrix *original);
 extern void DSMatrixFree(DSMatrix *matrix);
 
+extern DSMatrix * DSMatrixViewOfRows(DSMatrixView *view, const DSMatrix *matrix, const DSUInteger firstRow, const DSUInteger numberOfRows);
+extern DSMatrix * DSMatrixViewWithData(DSMatrixView *view, const DSUInteger rows, const DSUInteger columns, double * data);
+
 #if defined(__APPLE__) && defined (__MACH__)
 #pragma mark - Factory functions
 #endif
@@ -154,11 +175,25 @@ extern DSMatrix * DSMatrixSubMatrixIncludingRowsAndColumns(const DSMatrix *matri
 extern DSMatrix * DSMatrixAppendMatrices(const DSMatrix *firstMatrix, 
                                          const DSMatrix *secondMatrix,
                                          const bool byColumn);
+
+extern void DSMatrixSubMatrixIncludingRowsInto(DSMatrix *result,
+                                               const DSMatrix *matrix,
+                                               const DSUInteger numberOfRows,
+                                               const DSUInteger *rows);
+extern void DSMatrixSubMatrixIncludingColumnsInto(DSMatrix *result,
+                                                  const DSMatrix *matrix,
+                                                  const DSUInteger numberOfColumns,
+                                                  const DSUInteger *columns);
+extern void DSMatrixAppendMatricesInto(DSMatrix *result,
+                                       const DSMatrix *firstMatrix,
+                                       const DSMatrix *secondMatrix,
+                                       const bool byColumn);
 extern void DSMatrixSwitchRows(DSMatrix *matrix, const DSUInteger rowA, const DSUInteger rowB);
 extern void DSMatrixSwitchColumns(DSMatrix *matrix, const DSUInteger columnA, const DSUInteger columnB);
 extern void DSMatrixClearRow(DSMatrix *matrix, const DSUInteger row);
 extern void DSMatrixClearColumns(DSMatrix *matrix, const DSUInteger column);
 
+extern DSUInteger * DSMatrixFirstOccurrenceOfRows(const DSMatrix *matrix);
 extern DSMatrix * DSMatrixWithUniqueRows(const DSMatrix *matrix);
 
 extern void DSMatrixPrint(const DSMatrix *matrix);
@@ -190,6 +225,13 @@ extern void DSMatrixApplyFunction(DSMatrix *matrix, double (*function)(double));
 
 extern void DSMatrixMultiplyByScalar(DSMatrix *matrix, const double value);
 
+extern void DSMatrixCopyInto(DSMatrix *destination, const DSMatrix *source);
+extern void DSMatrixMultiplyMatricesInto(DSMatrix *result,
+                                         const double alpha,
+                                         const DSMatrix *lvalue,
+                                         const DSMatrix *rvalue,
+                                         const double beta);
+
 #if defined(__APPLE__) && defined (__MACH__)
 #pragma mark Linear Algebra
 #endif
@@ -202,6 +244,7 @@ extern double DSMatrixMinor(const DSMatrix *matrix,
 
 extern DSMatrix * DSMatrixTranspose(const DSMatrix *matrix);
 extern DSMatrix * DSMatrixInverse(const DSMatrix *matrix);
+extern DSMatrix * DSMatrixInverseWithDeterminant(const DSMatrix *matrix, double * determinant);
 extern DSMatrixArray * DSMatrixSVD(const DSMatrix *matrix);
 extern DSMatrixArray * DSMatrixQRD(const DSMatrix *matrix);
 extern DSMatrix * DSMatrixRightNullspace(const DSMatrix *matrix);
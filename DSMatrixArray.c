@@ -128,6 +128,31 @@ bail:
         return;
 }
 
+/**
+ * \brief Frees a DSMatrixArray without freeing its matrices.
+ *
+ * \details Frees the internal pointer to the array of matrices and the
+ * DSMatrixArray data type, leaving the contained matrices allocated.  This
+ * function is used when the ownership of the matrices is transferred to
+ * another structure, which is then responsible for freeing them.
+ *
+ * \param array The DSMatrixArray to be freed.
+ *
+ * \see DSMatrixArrayFree
+ */
+extern void DSMatrixArrayFreeWithoutMatrices(DSMatrixArray *array)
+{
+        if (array == NULL) {
+                DSError(M_DS_NULL, A_DS_WARN);
+                goto bail;
+        }
+        if (DSMatrixArrayInternalPointer(array) != NULL)
+                DSSecureFree(DSMatrixArrayInternalPointer(array));
+        DSSecureFree(array);
+bail:
+        return;
+}
+
 #if defined(__APPLE__) && defined (__MACH__)
 #pragma mark - Factory functions
 #endif
@@ -43,6 +43,7 @@ __BEGIN_DECLS
 extern DSMatrixArray * DSMatrixArrayAlloc(void);
 extern DSMatrixArray * DSMatrixArrayCopy(const DSMatrixArray * array);
 extern void DSMatrixArrayFree(DSMatrixArray *array);
+extern void DSMatrixArrayFreeWithoutMatrices(DSMatrixArray *array);
 
 #if defined(__APPLE__) && defined (__MACH__)
 #pragma mark - Factory functions
@@ -33,6 +33,7 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
 
 #include <gsl/gsl_linalg.h>
 #include <gsl/gsl_blas.h>
@@ -48,11 +49,79 @@
 #define DSMatrixSetColumns(x,y)                    ((x)->columns = (y))
 //#if defined(__MATRIX_BACK__) && __MATRIX_BACK__ == __MAT_GSL__
 
+/**
+ * \brief The number of multiply-add operations in a matrix product above which
+ * the product is calculated by BLAS.
+ *
+ * \details Products of small matrices, such as those of the S-systems of
+ * cases, are faster as a direct loop over the values than through the
+ * overhead of a BLAS call.
+ */
+#define DS_MATRIX_BLAS_THRESHOLD                4096
+
+/**
+ * \brief Internal layout of a DSMatrix.
+ *
+ * \details The matrix, the GSL descriptor of its values and the values
+ * themselves are allocated as a single block of memory.  The GSL descriptor
+ * does not own its values, and is only used for the operations that are
+ * done by GSL.  Matrices created with an array of values use that array
+ * instead of the values in the block.
+ */
+typedef struct {
+        DSMatrix matrix;
+        gsl_matrix internal;
+        double values[];
+} ds_matrix_storage_t;
+
+/* The storage of a DSMatrixView must fit and be aligned for the GSL descriptor of its values. */
+_Static_assert(sizeof(((DSMatrixView *)NULL)->internal) >= sizeof(gsl_matrix),
+               "DSMatrixView internal storage is smaller than gsl_matrix");
+_Static_assert(__alignof__(((DSMatrixView *)NULL)->internal) >= __alignof__(gsl_matrix),
+               "DSMatrixView internal storage is not aligned for gsl_matrix");
+
 
 #if defined(__APPLE__) && defined (__MACH__)
 #pragma mark - Allocation, Free and Initialization functions
 #endif
 
+static void dsMatrixInitialize(DSMatrix * matrix, gsl_matrix * internal, const DSUInteger rows, const DSUInteger columns, double * data)
+{
+        internal->size1 = rows;
+        internal->size2 = columns;
+        internal->tda = columns;
+        internal->data = data;
+        internal->block = NULL;
+        internal->owner = 0;
+        DSMatrixSetRows(matrix, rows);
+        DSMatrixSetColumns(matrix, columns);
+        DSMatrixData(matrix) = data;
+        DSMatrixInternalPointer(matrix) = internal;
+}
+
+static DSMatrix * dsMatrixAllocWithStorage(const DSUInteger rows, const DSUInteger columns, double * data)
+{
+        ds_matrix_storage_t * storage = NULL;
+        if (data == NULL) {
+                storage = DSSecureMalloc(sizeof(ds_matrix_storage_t)+sizeof(double)*rows*columns);
+                data = storage->values;
+        } else {
+                storage = DSSecureMalloc(sizeof(ds_matrix_storage_t));
+        }
+        dsMatrixInitialize(&(storage->matrix), &(storage->internal), rows, columns, data);
+        return &(storage->matrix);
+}
+
+static bool dsMatrixIndicesAreInBounds(const DSUInteger numberOfIndices, const DSUInteger * indices, const DSUInteger bound)
+{
+        DSUInteger i;
+        for (i = 0; i < numberOfIndices; i++) {
+                if (indices[i] >= bound)
+                        return false;
+        }
+        return true;
+}
+
 /**
  * \brief Memory allocation for a DSMatrix using malloc.
  *
@@ -75,13 +144,7 @@ extern DSMatrix * DSMatrixAlloc(const DSUInteger rows, const DSUInteger columns)
                 DSError(M_DS_WRONG, A_DS_WARN);
                 goto bail;
         }
-        aMatrix = DSSecureMalloc(sizeof(DSMatrix *)*1);
-        DSMatrixInternalPointer(aMatrix) = NULL;
-        DSMatrixSetRows(aMatrix, rows);
-        DSMatrixSetColumns(aMatrix, columns);
-        DSMatrixInternalPointer(aMatrix) =gsl_matrix_alloc(rows, columns);
-        if (DSMatrixInternalPointer(aMatrix) == NULL)
-                DSError(M_DS_MALLOC, A_DS_KILLNOW);
+        aMatrix = dsMatrixAllocWithStorage(rows, columns, NULL);
 bail:
         return aMatrix;
 }
@@ -108,13 +171,38 @@ extern DSMatrix * DSMatrixCalloc(const DSUInteger rows, const DSUInteger columns
                 DSError(M_DS_WRONG, A_DS_WARN);
                 goto bail;
         }
-        aMatrix = DSSecureMalloc(sizeof(DSMatrix *)*1);
-        DSMatrixInternalPointer(aMatrix) = NULL;
-        DSMatrixSetRows(aMatrix, rows);
-        DSMatrixSetColumns(aMatrix, columns);
-        DSMatrixInternalPointer(aMatrix) = gsl_matrix_calloc(rows, columns);
-        if (DSMatrixInternalPointer(aMatrix) == NULL)
-                DSError(M_DS_MALLOC, A_DS_KILLNOW);
+        aMatrix = dsMatrixAllocWithStorage(rows, columns, NULL);
+        memset(DSMatrixData(aMatrix), 0, sizeof(double)*rows*columns);
+bail:
+        return aMatrix;
+}
+
+/**
+ * \brief Creates a DSMatrix that takes ownership of an array of values.
+ *
+ * \details The matrix uses the array as its data without copying it, and the
+ * array is freed with the matrix.  The array must have been allocated with
+ * DSSecureMalloc, DSSecureCalloc or DSSecureRealloc.
+ *
+ * \param rows A DSUInteger with the number of rows in the new matrix.
+ * \param columns A DSUInteger with the number of columns in the new matrix.
+ * \param data An array with rows*columns values stored by row.
+ *
+ * \return If the matrix was created, a new pointer to a DSMatrix is returned.
+ * Otherwise, NULL is returned.
+ */
+extern DSMatrix * DSMatrixWithData(const DSUInteger rows, const DSUInteger columns, double * data)
+{
+        DSMatrix *aMatrix = NULL;
+        if (data == NULL) {
+                DSError(M_DS_NULL ": Array of values is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (rows == 0 || columns == 0) {
+                DSError(M_DS_WRONG, A_DS_WARN);
+                goto bail;
+        }
+        aMatrix = dsMatrixAllocWithStorage(rows, columns, data);
 bail:
         return aMatrix;
 }
@@ -139,7 +227,7 @@ extern DSMatrix * DSMatrixCopy(const DSMatrix *original)
                 goto bail;
         }
         matrix = DSMatrixAlloc(DSMatrixRows(original), DSMatrixColumns(original));
-       gsl_matrix_memcpy(DSMatrixInternalPointer(matrix), DSMatrixInternalPointer(original));
+        memcpy(DSMatrixData(matrix), DSMatrixData(original), sizeof(double)*DSMatrixRows(original)*DSMatrixColumns(original));
 bail:
         return matrix;
 }
@@ -155,17 +243,93 @@ bail:
  */
 extern void DSMatrixFree(DSMatrix *matrix)
 {
+        ds_matrix_storage_t * storage = NULL;
         if (matrix == NULL) {
                 DSError(M_DS_MAT_NULL, A_DS_FATAL);
                 goto bail;
         }
-        if (DSMatrixInternalPointer(matrix) != NULL)
-               gsl_matrix_free(DSMatrixInternalPointer(matrix));
+        storage = (ds_matrix_storage_t *)matrix;
+        if (DSMatrixData(matrix) != storage->values)
+                DSSecureFree(DSMatrixData(matrix));
         DSSecureFree(matrix);
 bail:
         return;
 }
 
+/**
+ * \brief Creates a view of consecutive rows of a DSMatrix.
+ *
+ * \details The rows of a matrix are stored consecutively, so the view uses
+ * the values of the matrix without copying them, and changes to the values
+ * of the view change the matrix.  The view must not be freed.
+ *
+ * \param view The DSMatrixView, usually on the stack, that stores the view.
+ * \param matrix The DSMatrix with the rows.
+ * \param firstRow A DSUInteger with the first row in view.
+ * \param numberOfRows A DSUInteger with the number of rows in view.
+ *
+ * \return If the view was created, a pointer to a DSMatrix within the view
+ * is returned. Otherwise, NULL is returned.
+ */
+extern DSMatrix * DSMatrixViewOfRows(DSMatrixView *view, const DSMatrix *matrix, const DSUInteger firstRow, const DSUInteger numberOfRows)
+{
+        DSMatrix * aMatrix = NULL;
+        if (view == NULL) {
+                DSError(M_DS_NULL ": Matrix view is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (matrix == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (numberOfRows == 0 || firstRow+numberOfRows > DSMatrixRows(matrix)) {
+                DSError(M_DS_MAT_OUTOFBOUNDS, A_DS_ERROR);
+                goto bail;
+        }
+        aMatrix = &(view->matrix);
+        dsMatrixInitialize(aMatrix, (gsl_matrix *)view->internal, numberOfRows, DSMatrixColumns(matrix),
+                           &DSMatrixElement(matrix, firstRow, 0));
+bail:
+        return aMatrix;
+}
+
+/**
+ * \brief Creates a matrix view of an array of values.
+ *
+ * \details The view is used to calculate results in storage provided by the
+ * caller, such as an array on the stack, without allocating a matrix.  The
+ * array is not copied and is not freed with the view.  The view must not be
+ * freed.
+ *
+ * \param view The DSMatrixView, usually on the stack, that stores the view.
+ * \param rows A DSUInteger with the number of rows of the view.
+ * \param columns A DSUInteger with the number of columns of the view.
+ * \param data An array with at least rows*columns values stored by row.
+ *
+ * \return If the view was created, a pointer to a DSMatrix within the view
+ * is returned. Otherwise, NULL is returned.
+ */
+extern DSMatrix * DSMatrixViewWithData(DSMatrixView *view, const DSUInteger rows, const DSUInteger columns, double * data)
+{
+        DSMatrix * aMatrix = NULL;
+        if (view == NULL) {
+                DSError(M_DS_NULL ": Matrix view is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (data == NULL) {
+                DSError(M_DS_NULL ": Array of values is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (rows == 0 || columns == 0) {
+                DSError(M_DS_WRONG, A_DS_WARN);
+                goto bail;
+        }
+        aMatrix = &(view->matrix);
+        dsMatrixInitialize(aMatrix, (gsl_matrix *)view->internal, rows, columns, data);
+bail:
+        return aMatrix;
+}
+
 
 #if defined(__APPLE__) && defined (__MACH__)
 #pragma mark - Factory functions
@@ -384,9 +548,7 @@ extern DSMatrix * DSMatrixByMultiplyingMatrix(const DSMatrix *lvalue, const DSMa
                 goto bail;
         }
         matrix = DSMatrixAlloc(DSMatrixRows(lvalue), DSMatrixColumns(rvalue));
-        gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, 1.0, 
-                       DSMatrixInternalPointer(lvalue), 
-                       DSMatrixInternalPointer(rvalue), 0, DSMatrixInternalPointer(matrix));
+        DSMatrixMultiplyMatricesInto(matrix, 1.0, lvalue, rvalue, 0.0);
 bail:
         return matrix;
 }
@@ -408,6 +570,7 @@ bail:
 extern DSMatrix * DSMatrixBySubstractingScalar(const DSMatrix *lvalue, const double rvalue)
 {
         DSMatrix * matrix = NULL;
+        DSUInteger i;
         if (lvalue == NULL) {
                 DSError(M_DS_NULL, A_DS_ERROR);
                 goto bail;
@@ -416,7 +579,8 @@ extern DSMatrix * DSMatrixBySubstractingScalar(const DSMatrix *lvalue, const dou
         if (rvalue == 0.0) {
                 goto bail;
         }
-       gsl_matrix_add_constant(DSMatrixInternalPointer(matrix), -rvalue);
+        for (i = 0; i < DSMatrixRows(matrix)*DSMatrixColumns(matrix); i++)
+                DSMatrixData(matrix)[i] -= rvalue;
 bail:
         return matrix;
 }
@@ -424,6 +588,7 @@ bail:
 extern DSMatrix * DSMatrixByAddingScalar(const DSMatrix *lvalue, const double rvalue)
 {
         DSMatrix * matrix = NULL;
+        DSUInteger i;
         if (lvalue == NULL) {
                 DSError(M_DS_NULL, A_DS_ERROR);
                 goto bail;
@@ -432,7 +597,8 @@ extern DSMatrix * DSMatrixByAddingScalar(const DSMatrix *lvalue, const double rv
         if (rvalue == 0.0) {
                 goto bail;
         }
-       gsl_matrix_add_constant(DSMatrixInternalPointer(matrix), rvalue);
+        for (i = 0; i < DSMatrixRows(matrix)*DSMatrixColumns(matrix); i++)
+                DSMatrixData(matrix)[i] += rvalue;
 bail:
         return matrix;
 }
@@ -449,7 +615,7 @@ extern DSMatrix * DSMatrixByDividingScalar(const DSMatrix *lvalue, const double
                 DSMatrixSetDoubleValueAll(matrix, INFINITY);
                 goto bail;
         }
-       gsl_matrix_scale(DSMatrixInternalPointer(matrix), 1.0/rvalue);
+        DSMatrixMultiplyByScalar(matrix, 1.0/rvalue);
 bail:
         return matrix;
 }
@@ -466,7 +632,7 @@ extern DSMatrix * DSMatrixByMultiplyingScalar(const DSMatrix *lvalue, const doub
                 DSMatrixSetDoubleValueAll(matrix, 0.0);
                 goto bail;
         }
-       gsl_matrix_scale(DSMatrixInternalPointer(matrix), rvalue);
+        DSMatrixMultiplyByScalar(matrix, rvalue);
 bail:
         return matrix;
 }
@@ -538,7 +704,7 @@ extern double DSMatrixDoubleValue(const DSMatrix *matrix, const DSUInteger row,
                 DSError(M_DS_MAT_OUTOFBOUNDS, A_DS_ERROR);
                 goto bail;
         }
-        value =gsl_matrix_get(DSMatrixInternalPointer(matrix), row, column);
+        value = DSMatrixElement(matrix, row, column);
 bail:
         return value;
 }
@@ -557,7 +723,7 @@ extern void DSMatrixSetDoubleValue(DSMatrix *matrix, const DSUInteger row, const
                 DSError(M_DS_MAT_OUTOFBOUNDS, A_DS_ERROR);
                 goto bail;
         }
-       gsl_matrix_set(DSMatrixInternalPointer(matrix), row, column, value);
+        DSMatrixElement(matrix, row, column) = value;
 bail:
         return;
 }
@@ -625,6 +791,7 @@ bail:
  */
 extern void DSMatrixSetDoubleValueAll(DSMatrix *matrix, const double value)
 {
+        DSUInteger i;
         if (matrix == NULL) {
                 DSError(M_DS_NULL, A_DS_WARN);
                 goto bail;
@@ -633,7 +800,8 @@ extern void DSMatrixSetDoubleValueAll(DSMatrix *matrix, const double value)
                 DSError(M_DS_MAT_NOINTERNAL, A_DS_WARN);
                 goto bail;
         }
-       gsl_matrix_set_all(DSMatrixInternalPointer(matrix), value);
+        for (i = 0; i < DSMatrixRows(matrix)*DSMatrixColumns(matrix); i++)
+                DSMatrixData(matrix)[i] = value;
 bail:
         return;
 }
@@ -761,8 +929,9 @@ bail:
 
 extern DSMatrix * DSMatrixSubMatrixExcludingColumns(const DSMatrix *matrix, const DSUInteger numberOfColumns, const DSUInteger *columns)
 {
+        DSUInteger i, j, k;
+        DSUInteger *columnsToInclude = NULL;
         DSMatrix * submatrix = NULL;
-        DSMatrix *transpose, *subTranspose;
         if (matrix == NULL) {
                 DSError(M_DS_MAT_NULL, A_DS_WARN);
                 goto bail;
@@ -775,11 +944,21 @@ extern DSMatrix * DSMatrixSubMatrixExcludingColumns(const DSMatrix *matrix, cons
                 submatrix = NULL;
                 goto bail;
         }
-        transpose = DSMatrixTranspose(matrix);
-        subTranspose = DSMatrixSubMatrixExcludingRows(transpose, numberOfColumns, columns);
-        submatrix = DSMatrixTranspose(subTranspose);
-        DSMatrixFree(transpose);
-        DSMatrixFree(subTranspose);
+        if (columns == NULL) {
+                DSError("Null array for columns", A_DS_WARN);
+                goto bail;
+        }
+        columnsToInclude = DSSecureMalloc(sizeof(DSUInteger)*DSMatrixColumns(matrix));
+        k = 0;
+        for (i = 0; i < DSMatrixColumns(matrix); i++) {
+                for (j = 0; j < numberOfColumns; j++)
+                        if (columns[j] == i)
+                                break;
+                if (j == numberOfColumns)
+                        columnsToInclude[k++] = i;
+        }
+        submatrix = DSMatrixSubMatrixIncludingColumns(matrix, k, columnsToInclude);
+        DSSecureFree(columnsToInclude);
 bail:
         return submatrix;
 }
@@ -813,7 +992,6 @@ bail:
 extern DSMatrix * DSMatrixSubMatrixIncludingRows(const DSMatrix *matrix, const DSUInteger numberOfRows,
                                                  const DSUInteger * rows)
 {
-        DSUInteger i, j;
         DSMatrix *submatrix = NULL;
         if (matrix == NULL) {
                 DSError(M_DS_MAT_NULL, A_DS_WARN);
@@ -826,13 +1004,12 @@ extern DSMatrix * DSMatrixSubMatrixIncludingRows(const DSMatrix *matrix, const D
                 DSError("Null array for rows", A_DS_WARN);
                 goto bail;
         }
-        submatrix = DSMatrixAlloc(numberOfRows, DSMatrixColumns(matrix));
-        for (i = 0; i < numberOfRows; i++) {
-                for (j = 0; j < DSMatrixColumns(matrix); j++) {
-                        DSMatrixSetDoubleValue(submatrix, i, j,
-                                               DSMatrixDoubleValue(matrix, rows[i], j));
-                }
+        if (dsMatrixIndicesAreInBounds(numberOfRows, rows, DSMatrixRows(matrix)) == false) {
+                DSError(M_DS_MAT_OUTOFBOUNDS, A_DS_ERROR);
+                goto bail;
         }
+        submatrix = DSMatrixAlloc(numberOfRows, DSMatrixColumns(matrix));
+        DSMatrixSubMatrixIncludingRowsInto(submatrix, matrix, numberOfRows, rows);
 bail:
         return submatrix;
 }
@@ -867,7 +1044,6 @@ extern DSMatrix * DSMatrixSubMatrixIncludingColumns(const DSMatrix *matrix,
                                                     const DSUInteger *columns)
 {
         DSMatrix * submatrix = NULL;
-        DSMatrix *transpose, *subTranspose;
         if (matrix == NULL) {
                 DSError(M_DS_MAT_NULL, A_DS_WARN);
                 goto bail;
@@ -876,11 +1052,16 @@ extern DSMatrix * DSMatrixSubMatrixIncludingColumns(const DSMatrix *matrix,
                 DSError("No columns being included", A_DS_WARN);
                 goto bail;
         }
-        transpose = DSMatrixTranspose(matrix);
-        subTranspose = DSMatrixSubMatrixIncludingRows(transpose, numberOfColumns, columns);
-        submatrix = DSMatrixTranspose(subTranspose);
-        DSMatrixFree(transpose);
-        DSMatrixFree(subTranspose);
+        if (columns == NULL) {
+                DSError("Null array for columns", A_DS_WARN);
+                goto bail;
+        }
+        if (dsMatrixIndicesAreInBounds(numberOfColumns, columns, DSMatrixColumns(matrix)) == false) {
+                DSError(M_DS_MAT_OUTOFBOUNDS, A_DS_ERROR);
+                goto bail;
+        }
+        submatrix = DSMatrixAlloc(DSMatrixRows(matrix), numberOfColumns);
+        DSMatrixSubMatrixIncludingColumnsInto(submatrix, matrix, numberOfColumns, columns);
 bail:
         return submatrix;
 }
@@ -986,8 +1167,7 @@ extern DSMatrix * DSMatrixAppendMatrices(const DSMatrix *firstMatrix,
                                          const DSMatrix *secondMatrix,
                                          const bool byColumn)
 {
-        DSMatrix *matrix = NULL, *current;
-        DSUInteger i, j, k, l;
+        DSMatrix *matrix = NULL;
         if (firstMatrix == NULL || secondMatrix == NULL) {
                 DSError(M_DS_MAT_NULL, A_DS_WARN);
                 goto bail;
@@ -1006,25 +1186,134 @@ extern DSMatrix * DSMatrixAppendMatrices(const DSMatrix *firstMatrix,
                 matrix = DSMatrixAlloc(DSMatrixRows(firstMatrix) + DSMatrixRows(secondMatrix),
                                        DSMatrixColumns(firstMatrix));
         }
+        DSMatrixAppendMatricesInto(matrix, firstMatrix, secondMatrix, byColumn);
+bail:
+        return matrix;
+}
+
+/**
+ * \brief Copies rows of a matrix into a matrix provided by the caller.
+ *
+ * \details The result must have numberOfRows rows and the same number of
+ * columns as the matrix, and must not share values with the matrix.
+ *
+ * \see DSMatrixSubMatrixIncludingRows
+ */
+extern void DSMatrixSubMatrixIncludingRowsInto(DSMatrix *result,
+                                               const DSMatrix *matrix,
+                                               const DSUInteger numberOfRows,
+                                               const DSUInteger *rows)
+{
+        DSUInteger i;
+        if (result == NULL || matrix == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (rows == NULL) {
+                DSError("Null array for rows", A_DS_ERROR);
+                goto bail;
+        }
+        if (DSMatrixRows(result) != numberOfRows || DSMatrixColumns(result) != DSMatrixColumns(matrix)) {
+                DSError(M_DS_WRONG ": Dimensions of result do not match", A_DS_ERROR);
+                goto bail;
+        }
+        if (dsMatrixIndicesAreInBounds(numberOfRows, rows, DSMatrixRows(matrix)) == false) {
+                DSError(M_DS_MAT_OUTOFBOUNDS, A_DS_ERROR);
+                goto bail;
+        }
+        for (i = 0; i < numberOfRows; i++) {
+                memcpy(&DSMatrixElement(result, i, 0),
+                       &DSMatrixElement(matrix, rows[i], 0),
+                       sizeof(double)*DSMatrixColumns(matrix));
+        }
+bail:
+        return;
+}
+
+/**
+ * \brief Copies columns of a matrix into a matrix provided by the caller.
+ *
+ * \details The result must have the same number of rows as the matrix and
+ * numberOfColumns columns, and must not share values with the matrix.
+ *
+ * \see DSMatrixSubMatrixIncludingColumns
+ */
+extern void DSMatrixSubMatrixIncludingColumnsInto(DSMatrix *result,
+                                                  const DSMatrix *matrix,
+                                                  const DSUInteger numberOfColumns,
+                                                  const DSUInteger *columns)
+{
+        DSUInteger i, j;
+        if (result == NULL || matrix == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (columns == NULL) {
+                DSError("Null array for columns", A_DS_ERROR);
+                goto bail;
+        }
+        if (DSMatrixRows(result) != DSMatrixRows(matrix) || DSMatrixColumns(result) != numberOfColumns) {
+                DSError(M_DS_WRONG ": Dimensions of result do not match", A_DS_ERROR);
+                goto bail;
+        }
+        if (dsMatrixIndicesAreInBounds(numberOfColumns, columns, DSMatrixColumns(matrix)) == false) {
+                DSError(M_DS_MAT_OUTOFBOUNDS, A_DS_ERROR);
+                goto bail;
+        }
         for (i = 0; i < DSMatrixRows(matrix); i++) {
-                for (j = 0; j < DSMatrixColumns(matrix); j++) {
-                        current = (DSMatrix *)firstMatrix;
-                        k = i;
-                        l = j;
-                        if (byColumn == true && j >= DSMatrixColumns(firstMatrix)) {
-                                l = j - DSMatrixColumns(firstMatrix);
-                                current = (DSMatrix *)secondMatrix;
-                        } else if (byColumn == false && i >= DSMatrixRows(firstMatrix)) {
-                                k = i - DSMatrixRows(firstMatrix);
-                                current = (DSMatrix *)secondMatrix;
-                        }
-                        DSMatrixSetDoubleValue(matrix, i, j,
-                                               DSMatrixDoubleValue(current, k, l));
+                for (j = 0; j < numberOfColumns; j++) {
+                        DSMatrixElement(result, i, j) = DSMatrixElement(matrix, i, columns[j]);
                 }
         }
-        
 bail:
-        return matrix;
+        return;
+}
+
+/**
+ * \brief Appends two matrices into a matrix provided by the caller.
+ *
+ * \details The result must have the dimensions of the appended matrices, and
+ * must not share values with either of them.
+ *
+ * \see DSMatrixAppendMatrices
+ */
+extern void DSMatrixAppendMatricesInto(DSMatrix *result,
+                                       const DSMatrix *firstMatrix,
+                                       const DSMatrix *secondMatrix,
+                                       const bool byColumn)
+{
+        DSUInteger i;
+        if (result == NULL || firstMatrix == NULL || secondMatrix == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (byColumn == true) {
+                if (DSMatrixRows(firstMatrix) != DSMatrixRows(secondMatrix)
+                    || DSMatrixRows(result) != DSMatrixRows(firstMatrix)
+                    || DSMatrixColumns(result) != DSMatrixColumns(firstMatrix)+DSMatrixColumns(secondMatrix)) {
+                        DSError(M_DS_WRONG ": Dimensions of result do not match", A_DS_ERROR);
+                        goto bail;
+                }
+                for (i = 0; i < DSMatrixRows(result); i++) {
+                        memcpy(&DSMatrixElement(result, i, 0), &DSMatrixElement(firstMatrix, i, 0),
+                               sizeof(double)*DSMatrixColumns(firstMatrix));
+                        memcpy(&DSMatrixElement(result, i, DSMatrixColumns(firstMatrix)), &DSMatrixElement(secondMatrix, i, 0),
+                               sizeof(double)*DSMatrixColumns(secondMatrix));
+                }
+                goto bail;
+        }
+        if (DSMatrixColumns(firstMatrix) != DSMatrixColumns(secondMatrix)
+            || DSMatrixColumns(result) != DSMatrixColumns(firstMatrix)
+            || DSMatrixRows(result) != DSMatrixRows(firstMatrix)+DSMatrixRows(secondMatrix)) {
+                DSError(M_DS_WRONG ": Dimensions of result do not match", A_DS_ERROR);
+                goto bail;
+        }
+        memcpy(DSMatrixData(result), DSMatrixData(firstMatrix),
+               sizeof(double)*DSMatrixRows(firstMatrix)*DSMatrixColumns(firstMatrix));
+        memcpy(&DSMatrixElement(result, DSMatrixRows(firstMatrix), 0), DSMatrixData(secondMatrix),
+               sizeof(double)*DSMatrixRows(secondMatrix)*DSMatrixColumns(secondMatrix));
+bail:
+        return;
 }
 
 extern void DSMatrixSwitchRows(DSMatrix *matrix, const DSUInteger rowA, const DSUInteger rowB)
@@ -1054,7 +1343,7 @@ extern void DSMatrixClearRow(DSMatrix *matrix, const DSUInteger row)
                 goto bail;
         }
         for (i = 0; i < DSMatrixColumns(matrix); i++) {
-                DSMatrixSetDoubleValue(matrix, row, i, 0.0f);
+                DSMatrixElement(matrix, row, i) = 0.0f;
         }
 bail:
         return;
@@ -1072,7 +1361,7 @@ extern void DSMatrixClearColumns(DSMatrix *matrix, const DSUInteger column)
                 goto bail;
         }
         for (i = 0; i < DSMatrixRows(matrix); i++) {
-                DSMatrixSetDoubleValue(matrix, i, column, 0.0f);
+                DSMatrixElement(matrix, i, column) = 0.0f;
         }
 bail:
         return;
@@ -1093,45 +1382,106 @@ bail:
         return;
 }
 
-extern DSMatrix * DSMatrixWithUniqueRows(const DSMatrix *matrix)
+/**
+ * \brief Calculates the hash of a row of values.
+ *
+ * \details Negative zeros are hashed as positive zeros, so that rows that
+ * compare equal have the same hash.  Each value is mixed into the hash, so
+ * values that only differ in their exponent are spread over the table.
+ */
+static uint64_t dsMatrixRowHash(const double * row, const DSUInteger numberOfColumns)
 {
-        DSMatrix *newMatrix = NULL;
-        bool * rowsToRemove = NULL;
-        DSUInteger * indexRowsToRemove;
-        DSUInteger i, j, k, numberToRemove;
+        uint64_t hash = 0x9E3779B97F4A7C15ULL, bits;
+        double value;
+        DSUInteger i;
+        for (i = 0; i < numberOfColumns; i++) {
+                value = (row[i] == 0.0) ? 0.0 : row[i];
+                memcpy(&bits, &value, sizeof(uint64_t));
+                hash ^= bits;
+                hash ^= hash >> 31;
+                hash *= 0xBF58476D1CE4E5B9ULL;
+                hash ^= hash >> 29;
+        }
+        hash *= 0x94D049BB133111EBULL;
+        hash ^= hash >> 32;
+        return hash;
+}
+
+static bool dsMatrixRowsAreEqual(const double * rowA, const double * rowB, const DSUInteger numberOfColumns)
+{
+        DSUInteger i;
+        for (i = 0; i < numberOfColumns; i++)
+                if (rowA[i] != rowB[i])
+                        return false;
+        return true;
+}
+
+/**
+ * \brief Finds the first occurrence of each row of a matrix.
+ *
+ * \details The rows are inserted in an open addressing hash table, so the
+ * rows of the matrix are compared in linear expected time.  Rows are compared
+ * exactly, with a negative zero equal to a positive zero; rows with NaN values
+ * are never equal to another row.
+ *
+ * \param matrix The DSMatrix with the rows to compare.
+ *
+ * \return An array with one element per row, with the index of the first row
+ *         of the matrix equal to that row.  The caller is responsible for
+ *         freeing the array.
+ */
+extern DSUInteger * DSMatrixFirstOccurrenceOfRows(const DSMatrix *matrix)
+{
+        DSUInteger * firstRows = NULL, * table = NULL;
+        DSUInteger i, j, mask, numberOfRows, numberOfColumns;
         if (matrix == NULL) {
                 DSError(M_DS_MAT_NULL, A_DS_ERROR);
                 goto bail;
         }
-        numberToRemove = 0;
-        rowsToRemove = DSSecureCalloc(sizeof(bool), DSMatrixRows(matrix));
-        for (i = 0; i < DSMatrixRows(matrix)-1; i++) {
-                if (rowsToRemove[i] == true)
-                        continue;
-                for (j = i+1; j < DSMatrixRows(matrix); j++) {
-                        if (rowsToRemove[j] == true)
-                                continue;
-                        for (k = 0; k < DSMatrixColumns(matrix); k++)
-                                if (gsl_matrix_get(DSMatrixInternalPointer(matrix), i, k) !=
-                                   gsl_matrix_get(DSMatrixInternalPointer(matrix), j, k))
-                                        break;
-                        if (k == DSMatrixColumns(matrix)) {
-                                rowsToRemove[j] = true;
-                                numberToRemove++;
+        numberOfRows = DSMatrixRows(matrix);
+        numberOfColumns = DSMatrixColumns(matrix);
+        firstRows = DSSecureMalloc(sizeof(DSUInteger)*(numberOfRows+1));
+        for (mask = 1; mask < 2*numberOfRows; mask <<= 1);
+        table = DSSecureMalloc(sizeof(DSUInteger)*mask);
+        for (j = 0; j < mask; j++)
+                table[j] = numberOfRows;
+        mask--;
+        for (i = 0; i < numberOfRows; i++) {
+                j = (DSUInteger)dsMatrixRowHash(&DSMatrixElement(matrix, i, 0), numberOfColumns) & mask;
+                firstRows[i] = i;
+                for (; table[j] != numberOfRows; j = (j+1) & mask) {
+                        if (dsMatrixRowsAreEqual(&DSMatrixElement(matrix, i, 0), &DSMatrixElement(matrix, table[j], 0), numberOfColumns) == true) {
+                                firstRows[i] = table[j];
+                                break;
                         }
                 }
+                if (firstRows[i] == i)
+                        table[j] = i;
         }
-        j = 0;
-        if (numberToRemove != 0) {
-                indexRowsToRemove = DSSecureCalloc(sizeof(DSUInteger), numberToRemove);
-                for (i = 0; i < DSMatrixRows(matrix); i++) {
-                        if (rowsToRemove[i] == true)
-                                indexRowsToRemove[j++] = i;
-                }
-                newMatrix = DSMatrixSubMatrixExcludingRows(matrix, numberToRemove, indexRowsToRemove);
-                DSSecureFree(indexRowsToRemove);
+        DSSecureFree(table);
+bail:
+        return firstRows;
+}
+
+extern DSMatrix * DSMatrixWithUniqueRows(const DSMatrix *matrix)
+{
+        DSMatrix *newMatrix = NULL;
+        DSUInteger * firstRows = NULL;
+        DSUInteger i, numberToRemove;
+        if (matrix == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
+                goto bail;
         }
-        DSSecureFree(rowsToRemove);
+        firstRows = DSMatrixFirstOccurrenceOfRows(matrix);
+        numberToRemove = 0;
+        /* The indices of the rows to remove overwrite rows already visited. */
+        for (i = 0; i < DSMatrixRows(matrix); i++) {
+                if (firstRows[i] != i)
+                        firstRows[numberToRemove++] = i;
+        }
+        if (numberToRemove != 0)
+                newMatrix = DSMatrixSubMatrixExcludingRows(matrix, numberToRemove, firstRows);
+        DSSecureFree(firstRows);
 bail:
         return newMatrix;
 }
@@ -1389,6 +1739,7 @@ bail:
 
 extern void DSMatrixAddByMatrix(DSMatrix *addTo, const DSMatrix *addBy)
 {
+        DSUInteger i;
         if (addTo == NULL) {
                 DSError(M_DS_MAT_NULL, A_DS_ERROR);
                 goto bail;
@@ -1402,8 +1753,8 @@ extern void DSMatrixAddByMatrix(DSMatrix *addTo, const DSMatrix *addBy)
         } else if (DSMatrixColumns(addTo) != DSMatrixColumns(addBy)) {
                 DSError("Matrix columns do not match", A_DS_ERROR);
         } else {
-               gsl_matrix_add(DSMatrixInternalPointer(addTo),
-                               DSMatrixInternalPointer(addBy));
+                for (i = 0; i < DSMatrixRows(addTo)*DSMatrixColumns(addTo); i++)
+                        DSMatrixData(addTo)[i] += DSMatrixData(addBy)[i];
         }
 bail:
         return;
@@ -1411,6 +1762,7 @@ bail:
 
 extern void DSMatrixSubstractByMatrix(DSMatrix *addTo, const DSMatrix *addBy)
 {
+        DSUInteger i;
         if (addTo == NULL) {
                 DSError(M_DS_MAT_NULL, A_DS_ERROR);
                 goto bail;
@@ -1424,8 +1776,8 @@ extern void DSMatrixSubstractByMatrix(DSMatrix *addTo, const DSMatrix *addBy)
         } else if (DSMatrixColumns(addTo) != DSMatrixColumns(addBy)) {
                 DSError("Matrix columns do not match", A_DS_ERROR);
         } else {
-               gsl_matrix_sub(DSMatrixInternalPointer(addTo),
-                               DSMatrixInternalPointer(addBy));
+                for (i = 0; i < DSMatrixRows(addTo)*DSMatrixColumns(addTo); i++)
+                        DSMatrixData(addTo)[i] -= DSMatrixData(addBy)[i];
         }
 bail:
         return;
@@ -1439,10 +1791,7 @@ extern void DSMatrixApplyFunction(DSMatrix *matrix, double (*function)(double))
         }
         for (i = 0; i < DSMatrixRows(matrix); i++) {
                 for (j = 0; j < DSMatrixColumns(matrix); j++) {
-                        DSMatrixSetDoubleValue(matrix,
-                                               i, j,
-                                               function(DSMatrixDoubleValue(matrix,
-                                                                            i, j)));
+                        DSMatrixElement(matrix, i, j) = function(DSMatrixElement(matrix, i, j));
                 }
         }
 bail:
@@ -1452,11 +1801,103 @@ bail:
 
 extern void DSMatrixMultiplyByScalar(DSMatrix *matrix, const double value)
 {
+        DSUInteger i;
         if (matrix == NULL) {
                 DSError(M_DS_MAT_NULL, A_DS_ERROR);
                 goto bail;
         }
-       gsl_matrix_scale(DSMatrixInternalPointer(matrix), value);
+        for (i = 0; i < DSMatrixRows(matrix)*DSMatrixColumns(matrix); i++)
+                DSMatrixData(matrix)[i] *= value;
+bail:
+        return;
+}
+
+/**
+ * \brief Copies the values of a matrix into a matrix of the same dimensions.
+ *
+ * \param destination The DSMatrix whose values are replaced.
+ * \param source The DSMatrix with the values that are copied.
+ */
+extern void DSMatrixCopyInto(DSMatrix *destination, const DSMatrix *source)
+{
+        if (destination == NULL || source == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (DSMatrixRows(destination) != DSMatrixRows(source) || DSMatrixColumns(destination) != DSMatrixColumns(source)) {
+                DSError(M_DS_WRONG ": Matrix dimensions do not match", A_DS_ERROR);
+                goto bail;
+        }
+        memmove(DSMatrixData(destination), DSMatrixData(source),
+                sizeof(double)*DSMatrixRows(source)*DSMatrixColumns(source));
+bail:
+        return;
+}
+
+/**
+ * \brief Calculates result = alpha*lvalue*rvalue + beta*result.
+ *
+ * \details The product is accumulated into a matrix provided by the caller,
+ * in the manner of the BLAS function dgemm, so that chains of products and
+ * sums need no intermediate matrices.  If beta is zero, the values of the
+ * result are not read.  The result must not share values with either
+ * operand.  Products of small matrices are calculated directly, and larger
+ * products are calculated by BLAS.
+ *
+ * \param result The DSMatrix where the result is accumulated, with the rows
+ *               of lvalue and the columns of rvalue.
+ * \param alpha A double with the factor of the product.
+ * \param lvalue The DSMatrix on the left of the product.
+ * \param rvalue The DSMatrix on the right of the product.
+ * \param beta A double with the factor of the original result.
+ */
+extern void DSMatrixMultiplyMatricesInto(DSMatrix *result,
+                                         const double alpha,
+                                         const DSMatrix *lvalue,
+                                         const DSMatrix *rvalue,
+                                         const double beta)
+{
+        DSUInteger i, j, k;
+        double value, *row;
+        if (result == NULL || lvalue == NULL || rvalue == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (DSMatrixColumns(lvalue) != DSMatrixRows(rvalue)) {
+                DSError("Matrix dimensions do not match", A_DS_ERROR);
+                goto bail;
+        }
+        if (DSMatrixRows(result) != DSMatrixRows(lvalue) || DSMatrixColumns(result) != DSMatrixColumns(rvalue)) {
+                DSError(M_DS_WRONG ": Dimensions of result do not match", A_DS_ERROR);
+                goto bail;
+        }
+        if (result == lvalue || result == rvalue) {
+                DSError(M_DS_WRONG ": Result must not be an operand", A_DS_ERROR);
+                goto bail;
+        }
+        if (DSMatrixRows(lvalue)*DSMatrixColumns(lvalue)*DSMatrixColumns(rvalue) > DS_MATRIX_BLAS_THRESHOLD) {
+                gsl_blas_dgemm(CblasNoTrans, CblasNoTrans, alpha,
+                               DSMatrixInternalPointer(lvalue),
+                               DSMatrixInternalPointer(rvalue), beta, DSMatrixInternalPointer(result));
+                goto bail;
+        }
+        for (i = 0; i < DSMatrixRows(result); i++) {
+                row = &DSMatrixElement(result, i, 0);
+                if (beta == 0.0) {
+                        for (j = 0; j < DSMatrixColumns(result); j++)
+                                row[j] = 0.0;
+                } else if (beta != 1.0) {
+                        for (j = 0; j < DSMatrixColumns(result); j++)
+                                row[j] *= beta;
+                }
+                for (k = 0; k < DSMatrixColumns(lvalue); k++) {
+                        value = alpha*DSMatrixElement(lvalue, i, k);
+                        if (value == 0.0)
+                                continue;
+                        for (j = 0; j < DSMatrixColumns(rvalue); j++)
+                                row[j] += value*DSMatrixElement(rvalue, k, j);
+                }
+        }
 bail:
         return;
 }
@@ -1522,43 +1963,69 @@ bail:
 extern DSMatrix * DSMatrixTranspose(const DSMatrix *matrix)
 {
         DSMatrix *transpose = NULL;
+        DSUInteger i, j;
         if (matrix == NULL) {
                 DSError(M_DS_MAT_NULL, A_DS_WARN);
                 goto bail;
         }
         transpose = DSMatrixAlloc(DSMatrixColumns(matrix), DSMatrixRows(matrix));
-        gsl_matrix_transpose_memcpy(DSMatrixInternalPointer(transpose), 
-                                    DSMatrixInternalPointer(matrix));
+        for (i = 0; i < DSMatrixRows(matrix); i++)
+                for (j = 0; j < DSMatrixColumns(matrix); j++)
+                        DSMatrixElement(transpose, j, i) = DSMatrixElement(matrix, i, j);
 bail:
         return transpose;
 }
 
-extern DSMatrix * DSMatrixInverse(const DSMatrix *matrix)
+/**
+ * \brief Calculates the inverse and the determinant of a square matrix.
+ *
+ * \details The determinant and the inverse are calculated from the same LU
+ * decomposition.  The matrix is considered singular if the absolute value of
+ * its determinant is less than DS_MATRIX_SINGULAR_DETERMINANT.
+ *
+ * \param matrix The square DSMatrix to invert.
+ * \param determinant A pointer to a double where the determinant is stored,
+ *        even if the matrix is singular.  May be NULL.
+ *
+ * \return A new DSMatrix with the inverse, or NULL if the matrix is singular.
+ */
+extern DSMatrix * DSMatrixInverseWithDeterminant(const DSMatrix *matrix, double * determinant)
 {
-       gsl_matrix *LU;
-        gsl_permutation *p;
+       gsl_matrix *LU = NULL;
+        gsl_permutation *p = NULL;
         DSMatrix *aMatrix = NULL;
+        double value = NAN;
         int sign;
         if (matrix == NULL)
                 goto bail;
         if (DSMatrixIsSquare(matrix) == false)
                 goto bail;
-        if (fabs(DSMatrixDeterminant(matrix)) < 1E-14) {
-                DSError("Matrix to invert is singular", A_DS_NOERROR);
-                goto bail;
-        }
-        aMatrix = DSMatrixAlloc(DSMatrixRows(matrix), DSMatrixColumns(matrix));
         p = gsl_permutation_alloc(DSMatrixRows(matrix));
         LU =gsl_matrix_alloc(DSMatrixRows(matrix), DSMatrixColumns(matrix));
        gsl_matrix_memcpy(LU, DSMatrixInternalPointer(matrix));
         gsl_linalg_LU_decomp(LU, p, &sign);
+        value = gsl_linalg_LU_det(LU, sign);
+        if (fabs(value) < DS_MATRIX_SINGULAR_DETERMINANT) {
+                DSError("Matrix to invert is singular", A_DS_NOERROR);
+                goto bail;
+        }
+        aMatrix = DSMatrixAlloc(DSMatrixRows(matrix), DSMatrixColumns(matrix));
         gsl_linalg_LU_invert(LU, p, DSMatrixInternalPointer(aMatrix));
-        gsl_permutation_free(p);
-       gsl_matrix_free(LU);
 bail:
+        if (p != NULL)
+                gsl_permutation_free(p);
+        if (LU != NULL)
+               gsl_matrix_free(LU);
+        if (determinant != NULL)
+                *determinant = value;
         return aMatrix;
 }
 
+extern DSMatrix * DSMatrixInverse(const DSMatrix *matrix)
+{
+        return DSMatrixInverseWithDeterminant(matrix, NULL);
+}
+
 extern DSMatrixArray * DSMatrixSVD(const DSMatrix *matrix)
 {
         DSMatrix *S, *U, *V;
@@ -30,9 +30,14 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
 #include "DSStd.h"
 #include "lrslib.h"
 #include "DSCase.h"
+#include "DSThreadPool.h"
+#include "DSNVertexEnumeration.h"
 /**
  \brief Defining the largest denominator for Multiple Precision. This is 
  * important for vertex enumeration, which is very sensitive to precision error.
@@ -115,68 +120,78 @@ DSRational dsDoubleToRational(double aDouble, DSUInteger maxden) {
         return ((fabs(rat1.error) < fabs(rat2.error)) ? rat1 : rat2);
 }
 
-/* Building the constraints for lrs using the A and B matrix, in the format of
- Ax*b = 0 */
-void buildConstraints(lrs_dic *P, lrs_dat *Q, const DSMatrix *A, const DSMatrix *b, const DSVariablePool * lower, const DSVariablePool * upper)
+/**
+ * \brief Calculates the rational coefficients of the constraints of a vertex
+ * enumeration problem.
+ *
+ * \details The constraints are stored by row in the format used by lrs, each
+ * row being b + Ax >= 0.  The first rows are the conditions of the case,
+ * followed by a lower and an upper bound for each variable.  Both arrays must
+ * have room for (rows(A)+2*columns(A))*(columns(A)+1) values.
+ */
+static void dsVertexEnumerationRationalConstraints(const DSMatrix *A, const DSMatrix *b, const DSVariablePool * lower, const DSVariablePool * upper, long int * numerators, long int * denominators)
 {
         DSUInteger i, j;
         long int m, n;
-        long int *numerators, *denominators;
-//        double *A;
-//        double *b;
-        int Am, An, bm, bn;
+        long int *rowNumerators, *rowDenominators;
         DSRational rational;
-        if (P == NULL || Q == NULL || A == NULL || b == NULL)
-                goto bail;
-        n = Q->n;
-        m = Q->m-2*(n-1);
-        /* We get matrices from Matlab mxArray, each pointer is (double*) */
-        
-        Am = DSMatrixRows(A);
-        An = DSMatrixColumns(A);
-        bm = DSMatrixRows(A);
-        bn = DSMatrixColumns(A);
-        
-        /* Allocate integer vectors for MP arithmetic in lrs */
-        numerators = DSSecureCalloc(sizeof(long int), n);
-        denominators = DSSecureCalloc(sizeof(long int), n);
+        m = DSMatrixRows(A);
+        n = DSMatrixColumns(A)+1;
         for (i = 0; i < m; i++) {
+                rowNumerators = numerators+i*n;
+                rowDenominators = denominators+i*n;
                 /* convert to rational approx. */
                 rational = dsDoubleToRational(DSMatrixDoubleValue(b, i, 0), MP_DENOMINATOR_PRECISION);
-                numerators[0]=rational.numerator;
-                denominators[0] = rational.denominator;
+                rowNumerators[0]=rational.numerator;
+                rowDenominators[0] = rational.denominator;
                 for (j = 1; j < n; j++) {
                         rational = dsDoubleToRational(DSMatrixDoubleValue(A, i, j-1),
                                                       MP_DENOMINATOR_PRECISION);
-                        numerators[j]=rational.numerator;
-                        denominators[j] = rational.denominator;
+                        rowNumerators[j]=rational.numerator;
+                        rowDenominators[j] = rational.denominator;
                 }
-                /* Insert information to lrs structures, both A and b */
-                lrs_set_row(P, Q, i+1, numerators, denominators, GE);
         }
         for (i = 0; i < 2*(n-1); i++) {
+                rowNumerators = numerators+(i+m)*n;
+                rowDenominators = denominators+(i+m)*n;
                 if (i % 2 == 0)
-                        numerators[0] = -log10(DSVariableValue(DSVariablePoolVariableAtIndex(lower, i/2)));
+                        rowNumerators[0] = -log10(DSVariableValue(DSVariablePoolVariableAtIndex(lower, i/2)));
                 else
-                        numerators[0] = log10(DSVariableValue(DSVariablePoolVariableAtIndex(upper, i/2)));
-                denominators[0] = 1;
-                for (j = 1; j < n; j++) {
-                        numerators[j] = 0;
-                        denominators[j] = 1;
-                }
-                numerators[1+i/2] = ((i % 2 == 0) ? 1 : -1);
+                        rowNumerators[0] = log10(DSVariableValue(DSVariablePoolVariableAtIndex(upper, i/2)));
+                rowDenominators[0] = 1;
                 for (j = 1; j < n; j++) {
+                        rowNumerators[j] = 0;
+                        rowDenominators[j] = 1;
                 }
-                /* Inserting additional constraints, to bound the polytopes */
-                lrs_set_row(P, Q, i+m+1, numerators, denominators, GE);
+                rowNumerators[1+i/2] = ((i % 2 == 0) ? 1 : -1);
         }
+}
+
+/* Building the constraints for lrs using the A and B matrix, in the format of
+ Ax*b = 0 */
+void buildConstraints(lrs_dic *P, lrs_dat *Q, const DSMatrix *A, const DSMatrix *b, const DSVariablePool * lower, const DSVariablePool * upper)
+{
+        DSUInteger i;
+        long int m, n;
+        long int *numerators, *denominators;
+        if (P == NULL || Q == NULL || A == NULL || b == NULL)
+                goto bail;
+        n = Q->n;
+        m = Q->m;
+        /* Allocate integer vectors for MP arithmetic in lrs */
+        numerators = DSSecureCalloc(sizeof(long int), n*m);
+        denominators = DSSecureCalloc(sizeof(long int), n*m);
+        dsVertexEnumerationRationalConstraints(A, b, lower, upper, numerators, denominators);
+        /* Insert information to lrs structures, both A and b, followed by the
+         additional constraints that bound the polytopes */
+        for (i = 0; i < m; i++)
+                lrs_set_row(P, Q, i+1, numerators+i*n, denominators+i*n, GE);
         DSSecureFree(numerators);
         DSSecureFree(denominators);
 bail:
         return;
 }
 
-
 /* Implementation of reverse search algorithm. */
 float *reverseSearch(lrs_dic *P, lrs_dat *Q, long int *numRows, long int **cobasis)
 {
@@ -242,6 +257,507 @@ bail:
 }
 
 
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Fixed-width arithmetic
+#endif
+
+/**
+ * \brief Options of the vertex enumeration.
+ *
+ * \see DSNVertexEnumerationSetOptions
+ */
+static unsigned char dsVertexEnumerationOptions = DS_VERTEX_ENUMERATION_FIXED_WIDTH | DS_VERTEX_ENUMERATION_PARALLEL;
+
+/**
+ * \brief Lock serializing the calls to lrs, which keeps its state in global
+ * variables.
+ */
+static pthread_mutex_t dsVertexEnumerationLrsLock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * \brief Sets the options used by DSCaseNDVertexEnumeration.
+ *
+ * \details The options are a combination of DS_VERTEX_ENUMERATION_FIXED_WIDTH,
+ * which enumerates the vertices with overflow-checked 128-bit integers before
+ * falling back to the multiple precision arithmetic of lrs, and
+ * DS_VERTEX_ENUMERATION_PARALLEL, which distributes each step of the fixed-width
+ * enumeration over the thread pool.  Both options are set by default.
+ *
+ * \param options The new options of the vertex enumeration.
+ */
+extern void DSNVertexEnumerationSetOptions(const unsigned char options)
+{
+        dsVertexEnumerationOptions = options;
+        __sync_synchronize();
+}
+
+extern unsigned char DSNVertexEnumerationOptions(void)
+{
+        return dsVertexEnumerationOptions;
+}
+
+/**
+ * \brief A 128-bit integer used by the fixed-width vertex enumeration.
+ */
+typedef __int128 ds_int128_t;
+
+/**
+ * \brief The vertices of a polytope in homogeneous integer coordinates.
+ *
+ * \details Each vertex has dimensions+1 coordinates, the first one being a
+ * positive denominator shared by the others.  The incidence of each vertex has
+ * one bit per constraint, set when the vertex lies on the constraint.
+ */
+typedef struct {
+        DSUInteger dimensions;
+        DSUInteger numberOfWords;
+        DSUInteger numberOfVertices;
+        ds_int128_t * coordinates;
+        unsigned long * incidence;
+} ds_intvertices_t;
+
+/**
+ * \brief Data of one task of a fixed-width cut.
+ *
+ * \details The tasks of a cut share the vertices and their values for the
+ * constraint, and each task creates the new vertices for an interleaved
+ * subset of the vertices on the positive side of the constraint.
+ */
+typedef struct {
+        const ds_intvertices_t * polytope;
+        const ds_int128_t * values;
+        DSUInteger constraint;
+        DSUInteger task;
+        DSUInteger numberOfTasks;
+        ds_intvertices_t created;
+        bool overflow;
+} ds_intcut_t;
+
+#define DS_VERTEX_ENUMERATION_WORD_BITS                (sizeof(unsigned long)*8)
+
+/**
+ * \brief The largest number of dimensions enumerated with fixed-width
+ * arithmetic, as the initial polytope is a box with 2^dimensions vertices.
+ */
+#define DS_VERTEX_ENUMERATION_FIXED_WIDTH_MAXIMUM_DIMENSIONS   16
+
+/**
+ * \brief The smallest number of vertex pairs tested in a cut before the cut
+ * is distributed over the thread pool.
+ */
+#define DS_VERTEX_ENUMERATION_PARALLEL_PAIRS           4096
+
+#define dsIntVerticesCoordinates(x, i)                 ((x)->coordinates+(i)*((x)->dimensions+1))
+#define dsIntVerticesIncidence(x, i)                   ((x)->incidence+(i)*(x)->numberOfWords)
+
+static unsigned __int128 dsInt128Magnitude(const ds_int128_t value)
+{
+        return (value < 0) ? -(unsigned __int128)value : (unsigned __int128)value;
+}
+
+static unsigned __int128 dsInt128GreatestCommonDivisor(unsigned __int128 a, unsigned __int128 b)
+{
+        unsigned __int128 t;
+        while (b != 0) {
+                t = a % b;
+                a = b;
+                b = t;
+        }
+        return a;
+}
+
+/**
+ * \brief Divides the homogeneous coordinates of a vertex by their greatest
+ * common divisor, keeping the integers as small as possible.
+ */
+static void dsIntVertexReduce(ds_int128_t * coordinates, const DSUInteger size)
+{
+        DSUInteger i;
+        unsigned __int128 divisor = 0;
+        for (i = 0; i < size && divisor != 1; i++)
+                divisor = dsInt128GreatestCommonDivisor(dsInt128Magnitude(coordinates[i]), divisor);
+        if (divisor <= 1)
+                goto bail;
+        for (i = 0; i < size; i++)
+                coordinates[i] /= (ds_int128_t)divisor;
+bail:
+        return;
+}
+
+/**
+ * \brief Converts the rational coefficients of a constraint to integers.
+ *
+ * \details The coefficients are multiplied by the least common multiple of
+ * their denominators, and must fit in 64 bits so that the products with the
+ * coordinates of a vertex can be checked in 128 bits.  The rational
+ * approximation of a negative coefficient may have a negative denominator.
+ *
+ * \return A boolean value indicating if the constraint could be converted.
+ */
+static bool dsVertexEnumerationIntegerConstraint(const long int * numerators, const long int * denominators, const DSUInteger size, ds_int128_t * row)
+{
+        bool converted = false;
+        DSUInteger i;
+        ds_int128_t multiple = 1, factor, denominator;
+        for (i = 0; i < size; i++) {
+                if (denominators[i] == 0)
+                        goto bail;
+                denominator = dsInt128Magnitude(denominators[i]);
+                factor = denominator/(ds_int128_t)dsInt128GreatestCommonDivisor(multiple, denominator);
+                if (__builtin_mul_overflow(multiple, factor, &multiple) || multiple > INT64_MAX)
+                        goto bail;
+        }
+        for (i = 0; i < size; i++) {
+                if (__builtin_mul_overflow((ds_int128_t)numerators[i], multiple/(ds_int128_t)denominators[i], &row[i]))
+                        goto bail;
+                if (row[i] > INT64_MAX || row[i] < -INT64_MAX)
+                        goto bail;
+        }
+        converted = true;
+bail:
+        return converted;
+}
+
+/**
+ * \brief Evaluates a constraint at a vertex, b*v0 + A*v.
+ *
+ * \return A boolean value indicating if the value was calculated without
+ *         overflow.
+ */
+static bool dsIntVertexConstraintValue(const ds_int128_t * row, const ds_int128_t * coordinates, const DSUInteger size, ds_int128_t * value)
+{
+        bool calculated = false;
+        DSUInteger i;
+        ds_int128_t product;
+        *value = 0;
+        for (i = 0; i < size; i++) {
+                if (__builtin_mul_overflow(row[i], coordinates[i], &product))
+                        goto bail;
+                if (__builtin_add_overflow(*value, product, value))
+                        goto bail;
+        }
+        calculated = true;
+bail:
+        return calculated;
+}
+
+static void dsIntVerticesAppend(ds_intvertices_t * vertices, const ds_int128_t * coordinates, const unsigned long * incidence, DSUInteger * capacity)
+{
+        DSUInteger size = vertices->dimensions+1;
+        if (vertices->numberOfVertices == *capacity) {
+                if (*capacity == 0) {
+                        *capacity = 16;
+                        vertices->coordinates = DSSecureMalloc(sizeof(ds_int128_t)*size*(*capacity));
+                        vertices->incidence = DSSecureMalloc(sizeof(unsigned long)*vertices->numberOfWords*(*capacity));
+                } else {
+                        *capacity = 2*(*capacity);
+                        vertices->coordinates = DSSecureRealloc(vertices->coordinates, sizeof(ds_int128_t)*size*(*capacity));
+                        vertices->incidence = DSSecureRealloc(vertices->incidence, sizeof(unsigned long)*vertices->numberOfWords*(*capacity));
+                }
+        }
+        memcpy(dsIntVerticesCoordinates(vertices, vertices->numberOfVertices), coordinates, sizeof(ds_int128_t)*size);
+        memcpy(dsIntVerticesIncidence(vertices, vertices->numberOfVertices), incidence, sizeof(unsigned long)*vertices->numberOfWords);
+        vertices->numberOfVertices++;
+}
+
+static void dsIntVerticesFreeData(ds_intvertices_t * vertices)
+{
+        if (vertices->coordinates != NULL)
+                DSSecureFree(vertices->coordinates);
+        if (vertices->incidence != NULL)
+                DSSecureFree(vertices->incidence);
+        vertices->coordinates = NULL;
+        vertices->incidence = NULL;
+        vertices->numberOfVertices = 0;
+}
+
+/**
+ * \brief Determines if two vertices are joined by an edge of the polytope.
+ *
+ * \details Two vertices are adjacent if they share at least dimensions-1
+ * constraints and no other vertex lies on all of the shared constraints.
+ *
+ * \param common An array with room for the incidence of a vertex, where the
+ *        shared constraints are stored.
+ */
+static bool dsIntVerticesAreAdjacent(const ds_intvertices_t * vertices, const DSUInteger vertex1, const DSUInteger vertex2, unsigned long * common)
+{
+        bool adjacent = false;
+        DSUInteger i, k, count = 0;
+        const unsigned long * incidence1 = dsIntVerticesIncidence(vertices, vertex1);
+        const unsigned long * incidence2 = dsIntVerticesIncidence(vertices, vertex2);
+        const unsigned long * other;
+        for (k = 0; k < vertices->numberOfWords; k++) {
+                common[k] = incidence1[k] & incidence2[k];
+                count += __builtin_popcountl(common[k]);
+        }
+        if (count+1 < vertices->dimensions)
+                goto bail;
+        for (i = 0; i < vertices->numberOfVertices; i++) {
+                if (i == vertex1 || i == vertex2)
+                        continue;
+                other = dsIntVerticesIncidence(vertices, i);
+                for (k = 0; k < vertices->numberOfWords; k++) {
+                        if ((other[k] & common[k]) != common[k])
+                                break;
+                }
+                if (k == vertices->numberOfWords)
+                        goto bail;
+        }
+        adjacent = true;
+bail:
+        return adjacent;
+}
+
+/**
+ * \brief Thread pool task creating the vertices of a cut.
+ *
+ * \details A new vertex is created on each edge joining a vertex on the
+ * positive side of the constraint to a vertex on the negative side.  As the
+ * arithmetic is exact, the new vertex lies exactly on the constraint.
+ */
+static void * dsVertexEnumerationCutTask(void * argument)
+{
+        ds_intcut_t * cut = argument;
+        const ds_intvertices_t * polytope = cut->polytope;
+        DSUInteger i, j, k, size, capacity = 0;
+        ds_int128_t * coordinates = NULL, a, b;
+        unsigned long * common = NULL;
+        const ds_int128_t * positive, * negative;
+        size = polytope->dimensions+1;
+        cut->created.dimensions = polytope->dimensions;
+        cut->created.numberOfWords = polytope->numberOfWords;
+        cut->created.numberOfVertices = 0;
+        cut->created.coordinates = NULL;
+        cut->created.incidence = NULL;
+        cut->overflow = false;
+        coordinates = DSSecureMalloc(sizeof(ds_int128_t)*size);
+        common = DSSecureMalloc(sizeof(unsigned long)*polytope->numberOfWords);
+        for (i = cut->task; i < polytope->numberOfVertices; i += cut->numberOfTasks) {
+                if (cut->values[i] <= 0)
+                        continue;
+                positive = dsIntVerticesCoordinates(polytope, i);
+                for (j = 0; j < polytope->numberOfVertices; j++) {
+                        if (cut->values[j] >= 0)
+                                continue;
+                        if (dsIntVerticesAreAdjacent(polytope, i, j, common) == false)
+                                continue;
+                        negative = dsIntVerticesCoordinates(polytope, j);
+                        for (k = 0; k < size; k++) {
+                                if (__builtin_mul_overflow(cut->values[i], negative[k], &a)
+                                    || __builtin_mul_overflow(cut->values[j], positive[k], &b)
+                                    || __builtin_sub_overflow(a, b, &coordinates[k])) {
+                                        cut->overflow = true;
+                                        goto bail;
+                                }
+                        }
+                        dsIntVertexReduce(coordinates, size);
+                        common[cut->constraint/DS_VERTEX_ENUMERATION_WORD_BITS] |= 1UL << (cut->constraint % DS_VERTEX_ENUMERATION_WORD_BITS);
+                        dsIntVerticesAppend(&cut->created, coordinates, common, &capacity);
+                }
+        }
+bail:
+        DSSecureFree(coordinates);
+        DSSecureFree(common);
+        return NULL;
+}
+
+/**
+ * \brief Cuts a polytope with a constraint.
+ *
+ * \details Vertices on the negative side of the constraint are removed and new
+ * vertices are created on the edges crossing the constraint.  When there are
+ * many edges to test and the parallel option is set, the vertices on the
+ * positive side are distributed over the thread pool.
+ *
+ * \return A boolean value indicating if the cut was calculated without
+ *         overflow.
+ */
+static bool dsVertexEnumerationCut(ds_intvertices_t * polytope, const ds_int128_t * row, const DSUInteger constraint)
+{
+        bool cut = false;
+        DSUInteger i, t, numberOfPositive = 0, numberOfNegative = 0, numberOfTasks = 1, capacity = 0;
+        DSUInteger size = polytope->dimensions+1;
+        ds_int128_t * values = NULL;
+        ds_intcut_t * tasks = NULL;
+        ds_intvertices_t cutPolytope;
+        unsigned long * incidence;
+        if (polytope->numberOfVertices == 0) {
+                cut = true;
+                goto bail;
+        }
+        values = DSSecureMalloc(sizeof(ds_int128_t)*polytope->numberOfVertices);
+        for (i = 0; i < polytope->numberOfVertices; i++) {
+                if (dsIntVertexConstraintValue(row, dsIntVerticesCoordinates(polytope, i), size, values+i) == false)
+                        goto bail;
+                if (values[i] > 0)
+                        numberOfPositive++;
+                else if (values[i] < 0)
+                        numberOfNegative++;
+                else {
+                        incidence = dsIntVerticesIncidence(polytope, i);
+                        incidence[constraint/DS_VERTEX_ENUMERATION_WORD_BITS] |= 1UL << (constraint % DS_VERTEX_ENUMERATION_WORD_BITS);
+                }
+        }
+        if (numberOfNegative == 0) {
+                cut = true;
+                goto bail;
+        }
+        if ((dsVertexEnumerationOptions & DS_VERTEX_ENUMERATION_PARALLEL) != 0
+            && numberOfPositive*numberOfNegative >= DS_VERTEX_ENUMERATION_PARALLEL_PAIRS) {
+                numberOfTasks = DSThreadPoolNumberOfThreads();
+                if (numberOfTasks > numberOfPositive)
+                        numberOfTasks = numberOfPositive;
+                if (numberOfTasks == 0)
+                        numberOfTasks = 1;
+        }
+        tasks = DSSecureCalloc(sizeof(ds_intcut_t), numberOfTasks);
+        for (t = 0; t < numberOfTasks; t++) {
+                tasks[t].polytope = polytope;
+                tasks[t].values = values;
+                tasks[t].constraint = constraint;
+                tasks[t].task = t;
+                tasks[t].numberOfTasks = numberOfTasks;
+        }
+        if (numberOfTasks > 1)
+                DSThreadPoolRun(dsVertexEnumerationCutTask, tasks, sizeof(ds_intcut_t), numberOfTasks);
+        else
+                dsVertexEnumerationCutTask(tasks);
+        cutPolytope.dimensions = polytope->dimensions;
+        cutPolytope.numberOfWords = polytope->numberOfWords;
+        cutPolytope.numberOfVertices = 0;
+        cutPolytope.coordinates = NULL;
+        cutPolytope.incidence = NULL;
+        for (i = 0; i < polytope->numberOfVertices; i++) {
+                if (values[i] >= 0)
+                        dsIntVerticesAppend(&cutPolytope, dsIntVerticesCoordinates(polytope, i), dsIntVerticesIncidence(polytope, i), &capacity);
+        }
+        for (t = 0; t < numberOfTasks; t++) {
+                for (i = 0; i < tasks[t].created.numberOfVertices; i++)
+                        dsIntVerticesAppend(&cutPolytope, dsIntVerticesCoordinates(&tasks[t].created, i), dsIntVerticesIncidence(&tasks[t].created, i), &capacity);
+        }
+        dsIntVerticesFreeData(polytope);
+        *polytope = cutPolytope;
+        cut = true;
+        for (t = 0; t < numberOfTasks; t++) {
+                if (tasks[t].overflow == true)
+                        cut = false;
+        }
+bail:
+        if (tasks != NULL) {
+                for (t = 0; t < numberOfTasks; t++)
+                        dsIntVerticesFreeData(&tasks[t].created);
+                DSSecureFree(tasks);
+        }
+        if (values != NULL)
+                DSSecureFree(values);
+        return cut;
+}
+
+/**
+ * \brief Enumerates the vertices of a polytope with fixed-width integer
+ * arithmetic.
+ *
+ * \details The polytope is calculated with the double description method:
+ * the vertices of the box defined by the bounds are cut by one condition at a
+ * time, using homogeneous 128-bit integer coordinates with overflow checks.
+ * The vertices and cobases are returned in the same format as reverseSearch,
+ * the cobasis of each vertex being its first tight constraints.
+ *
+ * \param numerators The numerators of the constraints, as calculated by
+ *        dsVertexEnumerationRationalConstraints.
+ * \param denominators The denominators of the constraints.
+ * \param m The number of conditions, not including the bounds.
+ * \param n The number of variables plus one.
+ *
+ * \return A boolean value indicating if the vertices were enumerated.  If
+ *         false, the problem did not fit in fixed-width arithmetic and must
+ *         be solved with lrs.
+ */
+static bool dsVertexEnumerationFixedWidth(const long int * numerators, const long int * denominators, const long int m, const long int n, float ** vertices, long int * numRows, long int ** cobasis)
+{
+        bool enumerated = false;
+        DSUInteger i, j, k, d, numberOfConstraints, capacity = 0;
+        ds_int128_t * rows = NULL, * coordinates = NULL, * vertex, lowerBound, upperBound;
+        unsigned long * incidence = NULL, bits;
+        ds_intvertices_t polytope = {0};
+        float * vertexData = NULL;
+        long int * cobasisData = NULL;
+        *vertices = NULL;
+        *cobasis = NULL;
+        *numRows = 0;
+        d = n-1;
+        numberOfConstraints = m+2*d;
+        if (d == 0 || d > DS_VERTEX_ENUMERATION_FIXED_WIDTH_MAXIMUM_DIMENSIONS)
+                goto bail;
+        rows = DSSecureMalloc(sizeof(ds_int128_t)*numberOfConstraints*n);
+        for (i = 0; i < numberOfConstraints; i++) {
+                if (dsVertexEnumerationIntegerConstraint(numerators+i*n, denominators+i*n, n, rows+i*n) == false)
+                        goto bail;
+        }
+        polytope.dimensions = d;
+        polytope.numberOfWords = (numberOfConstraints+DS_VERTEX_ENUMERATION_WORD_BITS-1)/DS_VERTEX_ENUMERATION_WORD_BITS;
+        coordinates = DSSecureMalloc(sizeof(ds_int128_t)*n);
+        incidence = DSSecureMalloc(sizeof(unsigned long)*polytope.numberOfWords);
+        /** The bounds are x_j >= -lower_j and x_j <= upper_j, in rows m+2j and m+2j+1 **/
+        for (j = 0; j < d; j++) {
+                lowerBound = -rows[(m+2*j)*n];
+                upperBound = rows[(m+2*j+1)*n];
+                if (rows[(m+2*j)*n+1+j] != 1 || rows[(m+2*j+1)*n+1+j] != -1)
+                        goto bail;
+                if (lowerBound > upperBound) {
+                        enumerated = true;
+                        goto bail;
+                }
+        }
+        for (i = 0; i < (1UL << d); i++) {
+                memset(incidence, 0, sizeof(unsigned long)*polytope.numberOfWords);
+                coordinates[0] = 1;
+                for (j = 0; j < d; j++) {
+                        k = m+2*j+((i >> j) & 1);
+                        coordinates[1+j] = ((i >> j) & 1) ? rows[k*n] : -rows[k*n];
+                        incidence[k/DS_VERTEX_ENUMERATION_WORD_BITS] |= 1UL << (k % DS_VERTEX_ENUMERATION_WORD_BITS);
+                }
+                dsIntVerticesAppend(&polytope, coordinates, incidence, &capacity);
+        }
+        for (i = 0; i < m; i++) {
+                if (dsVertexEnumerationCut(&polytope, rows+i*n, i) == false)
+                        goto bail;
+        }
+        if (polytope.numberOfVertices > 0) {
+                vertexData = DSSecureMalloc(sizeof(float)*d*polytope.numberOfVertices);
+                cobasisData = DSSecureMalloc(sizeof(long int)*d*polytope.numberOfVertices);
+        }
+        for (i = 0; i < polytope.numberOfVertices; i++) {
+                vertex = dsIntVerticesCoordinates(&polytope, i);
+                for (j = 0; j < d; j++)
+                        vertexData[i*d+j] = (float)((long double)vertex[1+j]/(long double)vertex[0]);
+                j = 0;
+                for (k = 0; k < polytope.numberOfWords && j < d; k++) {
+                        bits = dsIntVerticesIncidence(&polytope, i)[k];
+                        while (bits != 0 && j < d) {
+                                cobasisData[i*d+j++] = k*DS_VERTEX_ENUMERATION_WORD_BITS+__builtin_ctzl(bits)+1;
+                                bits &= bits-1;
+                        }
+                }
+                for (; j < d; j++)
+                        cobasisData[i*d+j] = 0;
+        }
+        *vertices = vertexData;
+        *cobasis = cobasisData;
+        *numRows = polytope.numberOfVertices;
+        enumerated = true;
+bail:
+        dsIntVerticesFreeData(&polytope);
+        if (coordinates != NULL)
+                DSSecureFree(coordinates);
+        if (incidence != NULL)
+                DSSecureFree(incidence);
+        if (rows != NULL)
+                DSSecureFree(rows);
+        return enumerated;
+}
+
 /* Mex gateway function */
 DSMatrixArray * DSCaseNDVertexEnumeration(const DSCase *aCase, const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds)
 {
@@ -251,7 +767,8 @@ DSMatrixArray * DSCaseNDVertexEnumeration(const DSCase *aCase, const DSVariableP
         DSMatrix *b;
         DSMatrix *vertices, *cobasisMatrix;
         long int *cobasis = NULL, rows = 0;
-        float *temp;
+        long int *numerators, *denominators, numberOfConstraints;
+        float *temp = NULL;
         lrs_dic *P;
         lrs_dat *Q;
         int Am, An, bm, bn;
@@ -271,6 +788,17 @@ DSMatrixArray * DSCaseNDVertexEnumeration(const DSCase *aCase, const DSVariableP
                 goto exit;
         }
         
+        numberOfConstraints = Am+2*An;
+        numerators = DSSecureCalloc(sizeof(long int), numberOfConstraints*(An+1));
+        denominators = DSSecureCalloc(sizeof(long int), numberOfConstraints*(An+1));
+        dsVertexEnumerationRationalConstraints(A, b, lowerBounds, upperBounds, numerators, denominators);
+        if ((dsVertexEnumerationOptions & DS_VERTEX_ENUMERATION_FIXED_WIDTH) != 0) {
+                if (dsVertexEnumerationFixedWidth(numerators, denominators, Am, An+1, &temp, &rows, &cobasis) == true)
+                        goto output;
+        }
+        /* lrs is not reentrant, and falls back to multiple precision when
+         the fixed-width arithmetic overflows */
+        pthread_mutex_lock(&dsVertexEnumerationLrsLock);
         lrs_init("DST Test");
         Q = lrs_alloc_dat("LRS globals");
         Q->n = An+1;
@@ -278,26 +806,30 @@ DSMatrixArray * DSCaseNDVertexEnumeration(const DSCase *aCase, const DSVariableP
         P = lrs_alloc_dic(Q);
         buildConstraints(P, Q, A, b, lowerBounds, upperBounds);
         temp = reverseSearch(P, Q, &rows, &cobasis);
-        vertices  = DSMatrixAlloc(rows, Q->n-1);
+        lrs_free_dic(P, Q);
+        lrs_free_dat(Q);
+        lrs_close("DST Test");
+        pthread_mutex_unlock(&dsVertexEnumerationLrsLock);
+output:
+        vertices  = DSMatrixAlloc(rows, An);
         for (i = 0; i < rows; i++) {
-                for (j = 0; j < Q->n-1; j++) {
-                        DSMatrixSetDoubleValue(vertices, i, j, temp[i*(Q->n-1)+j]);
+                for (j = 0; j < An; j++) {
+                        DSMatrixSetDoubleValue(vertices, i, j, temp[i*An+j]);
                 }
         }
-        cobasisMatrix  = DSMatrixAlloc(rows, Q->n-1);
+        cobasisMatrix  = DSMatrixAlloc(rows, An);
         for (i = 0; i < rows; i++) {
-                for (j = 0; j < Q->n-1; j++) {
+                for (j = 0; j < An; j++) {
                         /* Matlab stores by column, we stored by row. Need to invert */
-                        DSMatrixSetDoubleValue(cobasisMatrix, i, j, 1.0*cobasis[i*(Q->n-1)+j]);
+                        DSMatrixSetDoubleValue(cobasisMatrix, i, j, 1.0*cobasis[i*An+j]);
                 }
         }
         vertexEnumeration =DSMatrixArrayAlloc();
         DSMatrixArrayAddMatrix(vertexEnumeration, vertices);
         DSMatrixArrayAddMatrix(vertexEnumeration, cobasisMatrix);
         /* Cleaning up */
-        lrs_free_dic(P, Q);
-        lrs_free_dat(Q);
-        lrs_close("DST Test");
+        DSSecureFree(numerators);
+        DSSecureFree(denominators);
         if (temp != NULL)
                 DSSecureFree(temp);
         if (cobasis != NULL)
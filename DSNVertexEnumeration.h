@@ -30,8 +30,23 @@
 #ifndef DesignSpaceToolboxV2_DSNVertexEnumeration_h
 #define DesignSpaceToolboxV2_DSNVertexEnumeration_h
 
+/**
+ * \brief Option enumerating vertices with overflow-checked fixed-width integer
+ * arithmetic, using lrs only when the arithmetic overflows.
+ */
+#define DS_VERTEX_ENUMERATION_FIXED_WIDTH       0x01
+
+/**
+ * \brief Option distributing the fixed-width vertex enumeration over the
+ * thread pool.
+ */
+#define DS_VERTEX_ENUMERATION_PARALLEL          0x02
+
 DSMatrixArray * DSCaseNDVertexEnumeration(const DSCase *aCase, const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds);
 
+extern void DSNVertexEnumerationSetOptions(const unsigned char options);
+extern unsigned char DSNVertexEnumerationOptions(void);
+
 
 
 #endif
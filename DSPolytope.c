@@ -0,0 +1,532 @@
+/**
+ * \file DSPolytope.c
+ * \brief Implementation file with functions for dealing with convex polytopes
+ * defined by half-spaces.
+ *
+ * \details
+ *
+ * Copyright (C) 2011-2014 Jason Lomnitz.\n\n
+ *
+ * This file is part of the Design Space Toolbox V2 (C Library).
+ *
+ * The Design Space Toolbox V2 is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Design Space Toolbox V2 is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Design Space Toolbox. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * \author Jason Lomnitz.
+ * \date 2014
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "DSMemoryManager.h"
+#include "DSMatrix.h"
+#include "DSMatrixArray.h"
+#include "DSVertices.h"
+#include "DSPolytope.h"
+
+/**
+ * \brief The number of facets stored in each word of an incidence bitset.
+ */
+#define DS_POLYTOPE_WORD_BITS           (sizeof(unsigned long)*8)
+
+#define dsPolytopeVertex(p, v)          ((p)->vertices+(v)*(p)->dimensions)
+#define dsPolytopeIncidence(p, v)       ((p)->incidence+(v)*(p)->numberOfWords)
+#define dsPolytopeHalfSpace(p, f)       ((p)->halfSpaces+(f)*((p)->dimensions+1))
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Construction
+#endif
+
+static double dsPolytopeHalfSpaceValue(const DSPolytope * polytope, const DSUInteger facet, const double * coordinates)
+{
+        DSUInteger i;
+        const double * halfSpace = dsPolytopeHalfSpace(polytope, facet);
+        double value = halfSpace[polytope->dimensions];
+        for (i = 0; i < polytope->dimensions; i++)
+                value += halfSpace[i]*coordinates[i];
+        return value;
+}
+
+/**
+ * \brief Determines if two vertices of a polytope are the endpoints of an
+ * edge.
+ *
+ * \details This is the combinatorial test of the double description method.
+ * The facets shared by both vertices must be enough to define a line, and no
+ * other vertex may lie on all of them; otherwise the segment between the
+ * vertices crosses the interior of a face.
+ *
+ * \param common An array of numberOfWords words where the shared facets are
+ *        stored.
+ */
+static bool dsPolytopeIncidenceAreAdjacent(const DSPolytope * polytope, const DSUInteger vertex1, const DSUInteger vertex2, unsigned long * common)
+{
+        bool areAdjacent = false;
+        DSUInteger i, w, count = 0;
+        const unsigned long * incidence;
+        for (w = 0; w < polytope->numberOfWords; w++) {
+                common[w] = dsPolytopeIncidence(polytope, vertex1)[w] & dsPolytopeIncidence(polytope, vertex2)[w];
+                count += __builtin_popcountl(common[w]);
+        }
+        if (count+1 < polytope->dimensions)
+                goto bail;
+        for (i = 0; i < polytope->numberOfVertices; i++) {
+                if (i == vertex1 || i == vertex2)
+                        continue;
+                incidence = dsPolytopeIncidence(polytope, i);
+                for (w = 0; w < polytope->numberOfWords; w++) {
+                        if ((common[w] & ~incidence[w]) != 0)
+                                break;
+                }
+                if (w == polytope->numberOfWords)
+                        goto bail;
+        }
+        areAdjacent = true;
+bail:
+        return areAdjacent;
+}
+
+/**
+ * \brief Adds a vertex to a polytope.
+ *
+ * \details If merge is true and the polytope already has a vertex at the same
+ * coordinates, the incidence of the new vertex is added to the existing
+ * vertex instead.
+ */
+static void dsPolytopeAppendVertex(DSPolytope * polytope, const double * coordinates, const unsigned long * incidence, const bool merge)
+{
+        DSUInteger i, j;
+        for (i = 0; merge == true && i < polytope->numberOfVertices; i++) {
+                for (j = 0; j < polytope->dimensions; j++) {
+                        if (fabs(dsPolytopeVertex(polytope, i)[j]-coordinates[j]) >= DS_POLYTOPE_TOLERANCE)
+                                break;
+                }
+                if (j < polytope->dimensions)
+                        continue;
+                for (j = 0; j < polytope->numberOfWords; j++)
+                        dsPolytopeIncidence(polytope, i)[j] |= incidence[j];
+                goto bail;
+        }
+        i = polytope->numberOfVertices++;
+        if (i == 0) {
+                polytope->vertices = DSSecureMalloc(sizeof(double)*polytope->dimensions);
+                polytope->incidence = DSSecureMalloc(sizeof(unsigned long)*polytope->numberOfWords);
+        } else {
+                polytope->vertices = DSSecureRealloc(polytope->vertices, sizeof(double)*polytope->dimensions*(i+1));
+                polytope->incidence = DSSecureRealloc(polytope->incidence, sizeof(unsigned long)*polytope->numberOfWords*(i+1));
+        }
+        memcpy(dsPolytopeVertex(polytope, i), coordinates, sizeof(double)*polytope->dimensions);
+        memcpy(dsPolytopeIncidence(polytope, i), incidence, sizeof(unsigned long)*polytope->numberOfWords);
+bail:
+        return;
+}
+
+/**
+ * \brief Cuts a polytope with the half-space of one of its facets.
+ *
+ * \details Vertices outside the half-space are removed, and a new vertex is
+ * created where each edge between a removed and a kept vertex crosses the
+ * facet.  Vertices on the facet keep their position and the facet is added
+ * to their incidence.
+ */
+static void dsPolytopeCut(DSPolytope * polytope, const DSUInteger facet)
+{
+        DSPolytope previous;
+        DSUInteger i, j, k, numberOfOutside = 0;
+        double * values = NULL, * coordinates = NULL, t;
+        unsigned long * common = NULL, bit;
+        if (polytope->numberOfVertices == 0)
+                goto bail;
+        bit = 1UL << (facet % DS_POLYTOPE_WORD_BITS);
+        values = DSSecureMalloc(sizeof(double)*polytope->numberOfVertices);
+        for (i = 0; i < polytope->numberOfVertices; i++) {
+                values[i] = dsPolytopeHalfSpaceValue(polytope, facet, dsPolytopeVertex(polytope, i));
+                if (values[i] < -DS_POLYTOPE_TOLERANCE)
+                        numberOfOutside++;
+        }
+        if (numberOfOutside == 0) {
+                for (i = 0; i < polytope->numberOfVertices; i++) {
+                        if (values[i] <= DS_POLYTOPE_TOLERANCE)
+                                dsPolytopeIncidence(polytope, i)[facet / DS_POLYTOPE_WORD_BITS] |= bit;
+                }
+                goto bail;
+        }
+        previous = *polytope;
+        polytope->numberOfVertices = 0;
+        polytope->vertices = NULL;
+        polytope->incidence = NULL;
+        common = DSSecureMalloc(sizeof(unsigned long)*polytope->numberOfWords);
+        coordinates = DSSecureMalloc(sizeof(double)*polytope->dimensions);
+        for (i = 0; i < previous.numberOfVertices; i++) {
+                if (values[i] < -DS_POLYTOPE_TOLERANCE)
+                        continue;
+                if (values[i] <= DS_POLYTOPE_TOLERANCE)
+                        dsPolytopeIncidence(&previous, i)[facet / DS_POLYTOPE_WORD_BITS] |= bit;
+                dsPolytopeAppendVertex(polytope, dsPolytopeVertex(&previous, i), dsPolytopeIncidence(&previous, i), false);
+        }
+        for (i = 0; i < previous.numberOfVertices; i++) {
+                if (values[i] <= DS_POLYTOPE_TOLERANCE)
+                        continue;
+                for (j = 0; j < previous.numberOfVertices; j++) {
+                        if (values[j] >= -DS_POLYTOPE_TOLERANCE)
+                                continue;
+                        if (dsPolytopeIncidenceAreAdjacent(&previous, i, j, common) == false)
+                                continue;
+                        t = values[i]/(values[i]-values[j]);
+                        for (k = 0; k < polytope->dimensions; k++)
+                                coordinates[k] = dsPolytopeVertex(&previous, i)[k] + t*(dsPolytopeVertex(&previous, j)[k]-dsPolytopeVertex(&previous, i)[k]);
+                        common[facet / DS_POLYTOPE_WORD_BITS] |= bit;
+                        dsPolytopeAppendVertex(polytope, coordinates, common, true);
+                }
+        }
+        if (previous.vertices != NULL)
+                DSSecureFree(previous.vertices);
+        if (previous.incidence != NULL)
+                DSSecureFree(previous.incidence);
+bail:
+        if (values != NULL)
+                DSSecureFree(values);
+        if (coordinates != NULL)
+                DSSecureFree(coordinates);
+        if (common != NULL)
+                DSSecureFree(common);
+        return;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Allocation, deallocation and initialization
+#endif
+
+/**
+ * \brief Creates the polytope defined by a box and a set of half-spaces.
+ *
+ * \details Each half-space is of the form a*x + c >= 0, where a is a row of
+ * the coefficient matrix and c is the corresponding row of the constants.
+ * The polytope starts as the box and is cut by one half-space at a time, so
+ * facets are never calculated with linear programming.  Facet i is the
+ * half-space in row i; the lower and upper bounds of coordinate j are facets
+ * n+2j and n+2j+1, where n is the number of half-spaces.  The box has
+ * 2^dimensions vertices, so this function is intended for low dimensional
+ * slices.
+ *
+ * \param coefficients A DSMatrix with one row per half-space and one column
+ *        per dimension.
+ * \param constants A DSMatrix with one column and one row per half-space.
+ * \param lower An array with the lower bound of each coordinate.
+ * \param upper An array with the upper bound of each coordinate.
+ *
+ * \return A new DSPolytope, which has no vertices if the intersection is
+ *         empty.
+ */
+extern DSPolytope * DSPolytopeFromHalfSpaces(const DSMatrix * coefficients, const DSMatrix * constants, const double * lower, const double * upper)
+{
+        DSPolytope * polytope = NULL;
+        DSUInteger i, j, corner, numberOfHalfSpaces;
+        double * coordinates = NULL, * halfSpace;
+        unsigned long * incidence = NULL;
+        if (coefficients == NULL || constants == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (lower == NULL || upper == NULL) {
+                DSError(M_DS_NULL ": Array of bounds is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (DSMatrixRows(coefficients) != DSMatrixRows(constants)) {
+                DSError(M_DS_WRONG ": Number of coefficients and constants must match", A_DS_ERROR);
+                goto bail;
+        }
+        numberOfHalfSpaces = DSMatrixRows(coefficients);
+        polytope = DSSecureCalloc(sizeof(DSPolytope), 1);
+        polytope->dimensions = DSMatrixColumns(coefficients);
+        polytope->numberOfFacets = numberOfHalfSpaces+2*polytope->dimensions;
+        polytope->numberOfWords = (polytope->numberOfFacets + DS_POLYTOPE_WORD_BITS - 1)/DS_POLYTOPE_WORD_BITS;
+        polytope->halfSpaces = DSSecureCalloc(sizeof(double), polytope->numberOfFacets*(polytope->dimensions+1));
+        for (i = 0; i < numberOfHalfSpaces; i++) {
+                halfSpace = dsPolytopeHalfSpace(polytope, i);
+                for (j = 0; j < polytope->dimensions; j++)
+                        halfSpace[j] = DSMatrixDoubleValue(coefficients, i, j);
+                halfSpace[polytope->dimensions] = DSMatrixDoubleValue(constants, i, 0);
+        }
+        for (j = 0; j < polytope->dimensions; j++) {
+                if (lower[j] > upper[j]) {
+                        DSError(M_DS_WRONG ": Lower bounds must not be greater than upper bounds", A_DS_ERROR);
+                        DSPolytopeFree(polytope);
+                        polytope = NULL;
+                        goto bail;
+                }
+                halfSpace = dsPolytopeHalfSpace(polytope, numberOfHalfSpaces+2*j);
+                halfSpace[j] = 1.0;
+                halfSpace[polytope->dimensions] = -lower[j];
+                halfSpace = dsPolytopeHalfSpace(polytope, numberOfHalfSpaces+2*j+1);
+                halfSpace[j] = -1.0;
+                halfSpace[polytope->dimensions] = upper[j];
+        }
+        coordinates = DSSecureMalloc(sizeof(double)*polytope->dimensions);
+        incidence = DSSecureMalloc(sizeof(unsigned long)*polytope->numberOfWords);
+        for (corner = 0; corner < (1U << polytope->dimensions); corner++) {
+                memset(incidence, 0, sizeof(unsigned long)*polytope->numberOfWords);
+                for (j = 0; j < polytope->dimensions; j++) {
+                        i = numberOfHalfSpaces+2*j+((corner >> j) & 1);
+                        coordinates[j] = ((corner >> j) & 1) ? upper[j] : lower[j];
+                        incidence[i / DS_POLYTOPE_WORD_BITS] |= 1UL << (i % DS_POLYTOPE_WORD_BITS);
+                }
+                dsPolytopeAppendVertex(polytope, coordinates, incidence, true);
+        }
+        for (i = 0; i < numberOfHalfSpaces; i++)
+                dsPolytopeCut(polytope, i);
+bail:
+        if (coordinates != NULL)
+                DSSecureFree(coordinates);
+        if (incidence != NULL)
+                DSSecureFree(incidence);
+        return polytope;
+}
+
+extern void DSPolytopeFree(DSPolytope * polytope)
+{
+        if (polytope == NULL) {
+                DSError(M_DS_POLYTOPE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (polytope->halfSpaces != NULL)
+                DSSecureFree(polytope->halfSpaces);
+        if (polytope->vertices != NULL)
+                DSSecureFree(polytope->vertices);
+        if (polytope->incidence != NULL)
+                DSSecureFree(polytope->incidence);
+        DSSecureFree(polytope);
+bail:
+        return;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Vertices and facets
+#endif
+
+extern DSUInteger DSPolytopeNumberOfVertices(const DSPolytope * polytope)
+{
+        DSUInteger numberOfVertices = 0;
+        if (polytope == NULL) {
+                DSError(M_DS_POLYTOPE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        numberOfVertices = polytope->numberOfVertices;
+bail:
+        return numberOfVertices;
+}
+
+extern DSUInteger DSPolytopeNumberOfFacets(const DSPolytope * polytope)
+{
+        DSUInteger numberOfFacets = 0;
+        if (polytope == NULL) {
+                DSError(M_DS_POLYTOPE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        numberOfFacets = polytope->numberOfFacets;
+bail:
+        return numberOfFacets;
+}
+
+extern bool DSPolytopeVertexIsOnFacet(const DSPolytope * polytope, const DSUInteger vertex, const DSUInteger facet)
+{
+        bool isOnFacet = false;
+        if (polytope == NULL) {
+                DSError(M_DS_POLYTOPE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (vertex >= polytope->numberOfVertices || facet >= polytope->numberOfFacets) {
+                DSError(M_DS_WRONG ": Index out of range", A_DS_ERROR);
+                goto bail;
+        }
+        isOnFacet = ((dsPolytopeIncidence(polytope, vertex)[facet / DS_POLYTOPE_WORD_BITS] >> (facet % DS_POLYTOPE_WORD_BITS)) & 1);
+bail:
+        return isOnFacet;
+}
+
+extern bool DSPolytopeVerticesAreAdjacent(const DSPolytope * polytope, const DSUInteger vertex1, const DSUInteger vertex2)
+{
+        bool areAdjacent = false;
+        unsigned long * common = NULL;
+        if (polytope == NULL) {
+                DSError(M_DS_POLYTOPE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (vertex1 >= polytope->numberOfVertices || vertex2 >= polytope->numberOfVertices) {
+                DSError(M_DS_WRONG ": Index out of range", A_DS_ERROR);
+                goto bail;
+        }
+        if (vertex1 == vertex2)
+                goto bail;
+        common = DSSecureMalloc(sizeof(unsigned long)*polytope->numberOfWords);
+        areAdjacent = dsPolytopeIncidenceAreAdjacent(polytope, vertex1, vertex2, common);
+        DSSecureFree(common);
+bail:
+        return areAdjacent;
+}
+
+/**
+ * \brief Creates a DSVertices object with the vertices of a polytope.
+ *
+ * \details The vertices keep the order of the polytope, so the index of a
+ * vertex is the same as in DSPolytopeConnectivityMatrix.
+ */
+extern DSVertices * DSPolytopeVertices(const DSPolytope * polytope)
+{
+        DSVertices * vertices = NULL;
+        DSUInteger i;
+        if (polytope == NULL) {
+                DSError(M_DS_POLYTOPE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        vertices = DSVerticesAlloc(polytope->dimensions);
+        for (i = 0; i < polytope->numberOfVertices; i++)
+                DSVerticesAddVertex(vertices, dsPolytopeVertex(polytope, i));
+bail:
+        return vertices;
+}
+
+/**
+ * \brief Creates a matrix indicating the vertices of a polytope joined by an
+ * edge.
+ *
+ * \return A new DSMatrix where element (i, j) is 1 if vertices i and j are
+ *         adjacent and 0 otherwise.
+ */
+extern DSMatrix * DSPolytopeConnectivityMatrix(const DSPolytope * polytope)
+{
+        DSMatrix * connectivity = NULL;
+        DSUInteger i, j;
+        unsigned long * common = NULL;
+        if (polytope == NULL) {
+                DSError(M_DS_POLYTOPE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (polytope->numberOfVertices == 0)
+                goto bail;
+        connectivity = DSMatrixCalloc(polytope->numberOfVertices, polytope->numberOfVertices);
+        common = DSSecureMalloc(sizeof(unsigned long)*polytope->numberOfWords);
+        for (i = 0; i < polytope->numberOfVertices; i++) {
+                for (j = i+1; j < polytope->numberOfVertices; j++) {
+                        if (dsPolytopeIncidenceAreAdjacent(polytope, i, j, common) == false)
+                                continue;
+                        DSMatrixSetDoubleValue(connectivity, i, j, 1.0);
+                        DSMatrixSetDoubleValue(connectivity, j, i, 1.0);
+                }
+        }
+        DSSecureFree(common);
+bail:
+        return connectivity;
+}
+
+static bool dsPolytopeFacetsHaveSameVertices(const DSPolytope * polytope, const DSUInteger facet1, const DSUInteger facet2)
+{
+        DSUInteger i;
+        for (i = 0; i < polytope->numberOfVertices; i++) {
+                if (DSPolytopeVertexIsOnFacet(polytope, i, facet1) != DSPolytopeVertexIsOnFacet(polytope, i, facet2))
+                        break;
+        }
+        return (i == polytope->numberOfVertices);
+}
+
+/**
+ * \brief Creates the faces of a three dimensional polytope.
+ *
+ * \details Each face is a matrix with one vertex per row, ordered around the
+ * facet and with the first vertex repeated at the end to close the polygon.
+ * Facets that contain fewer than three vertices are not faces and are
+ * skipped, as are facets with the same vertices as a previous facet.  The vertices of a face are ordered by their angle around the
+ * centroid of the face, measured in the plane of the facet.
+ *
+ * \return A new DSMatrixArray with the faces of the polytope.
+ */
+extern DSMatrixArray * DSPolytope3DFaces(const DSPolytope * polytope)
+{
+        DSMatrixArray * faces = NULL;
+        DSMatrix * face;
+        DSUInteger f, i, j, k, numberOfVertices, * indices = NULL;
+        double centroid[3], u[3], w[3], d[3], * angles = NULL, norm, angle;
+        const double * normal;
+        if (polytope == NULL) {
+                DSError(M_DS_POLYTOPE_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (polytope->dimensions != 3) {
+                DSError(M_DS_WRONG ": Polytope must be three dimensional", A_DS_ERROR);
+                goto bail;
+        }
+        faces = DSMatrixArrayAlloc();
+        if (polytope->numberOfVertices == 0)
+                goto bail;
+        indices = DSSecureMalloc(sizeof(DSUInteger)*polytope->numberOfVertices);
+        angles = DSSecureMalloc(sizeof(double)*polytope->numberOfVertices);
+        for (f = 0; f < polytope->numberOfFacets; f++) {
+                normal = dsPolytopeHalfSpace(polytope, f);
+                if (normal[0] == 0 && normal[1] == 0 && normal[2] == 0)
+                        continue;
+                numberOfVertices = 0;
+                centroid[0] = centroid[1] = centroid[2] = 0;
+                for (i = 0; i < polytope->numberOfVertices; i++) {
+                        if (DSPolytopeVertexIsOnFacet(polytope, i, f) == false)
+                                continue;
+                        indices[numberOfVertices++] = i;
+                        for (k = 0; k < 3; k++)
+                                centroid[k] += dsPolytopeVertex(polytope, i)[k];
+                }
+                if (numberOfVertices < 3)
+                        continue;
+                for (j = 0; j < f; j++) {
+                        if (dsPolytopeFacetsHaveSameVertices(polytope, f, j) == true)
+                                break;
+                }
+                if (j < f)
+                        continue;
+                for (k = 0; k < 3; k++) {
+                        centroid[k] /= numberOfVertices;
+                        u[k] = dsPolytopeVertex(polytope, indices[0])[k]-centroid[k];
+                }
+                w[0] = normal[1]*u[2]-normal[2]*u[1];
+                w[1] = normal[2]*u[0]-normal[0]*u[2];
+                w[2] = normal[0]*u[1]-normal[1]*u[0];
+                norm = sqrt(w[0]*w[0]+w[1]*w[1]+w[2]*w[2]);
+                if (norm == 0)
+                        continue;
+                /** Insertion sort; faces have few vertices **/
+                for (i = 0; i < numberOfVertices; i++) {
+                        for (k = 0; k < 3; k++)
+                                d[k] = dsPolytopeVertex(polytope, indices[i])[k]-centroid[k];
+                        angle = atan2(d[0]*w[0]+d[1]*w[1]+d[2]*w[2], d[0]*u[0]+d[1]*u[1]+d[2]*u[2]);
+                        j = indices[i];
+                        for (k = i; k > 0 && angles[k-1] > angle; k--) {
+                                angles[k] = angles[k-1];
+                                indices[k] = indices[k-1];
+                        }
+                        angles[k] = angle;
+                        indices[k] = j;
+                }
+                face = DSMatrixAlloc(numberOfVertices+1, 3);
+                for (i = 0; i <= numberOfVertices; i++) {
+                        for (k = 0; k < 3; k++)
+                                DSMatrixSetDoubleValue(face, i, k, dsPolytopeVertex(polytope, indices[i % numberOfVertices])[k]);
+                }
+                DSMatrixArrayAddMatrix(faces, face);
+        }
+bail:
+        if (indices != NULL)
+                DSSecureFree(indices);
+        if (angles != NULL)
+                DSSecureFree(angles);
+        return faces;
+}
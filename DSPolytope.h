@@ -0,0 +1,78 @@
+/**
+ * \file DSPolytope.h
+ * \brief Header file with functions for dealing with convex polytopes defined
+ * by half-spaces.
+ *
+ * \details A polytope is calculated from a box and a set of half-spaces with
+ * the double description method: the vertices of the box are cut by one
+ * half-space at a time, and new vertices are created on the edges that cross
+ * each half-space.  Edges are found from the facets shared by two vertices, so
+ * no linear problem is solved.  The result has the vertices, the facets and
+ * the vertex-facet incidence of the polytope.
+ *
+ * Copyright (C) 2011-2014 Jason Lomnitz.\n\n
+ *
+ * This file is part of the Design Space Toolbox V2 (C Library).
+ *
+ * The Design Space Toolbox V2 is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Design Space Toolbox V2 is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Design Space Toolbox. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * \author Jason Lomnitz.
+ * \date 2014
+ */
+
+#include <stdbool.h>
+#include "DSTypes.h"
+#include "DSErrors.h"
+
+#ifndef __DS_POLYTOPE__
+#define __DS_POLYTOPE__
+
+#define M_DS_POLYTOPE_NULL              M_DS_NULL ": Polytope is NULL"
+
+/**
+ * \brief The distance to a half-space below which a vertex is considered to
+ * lie on its facet.
+ */
+#define DS_POLYTOPE_TOLERANCE           1E-12
+
+#ifdef __cplusplus
+__BEGIN_DECLS
+#endif
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Allocation, deallocation and initialization
+#endif
+
+extern DSPolytope * DSPolytopeFromHalfSpaces(const DSMatrix * coefficients, const DSMatrix * constants, const double * lower, const double * upper);
+extern void DSPolytopeFree(DSPolytope * polytope);
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Vertices and facets
+#endif
+
+extern DSUInteger DSPolytopeNumberOfVertices(const DSPolytope * polytope);
+extern DSUInteger DSPolytopeNumberOfFacets(const DSPolytope * polytope);
+extern bool DSPolytopeVertexIsOnFacet(const DSPolytope * polytope, const DSUInteger vertex, const DSUInteger facet);
+extern bool DSPolytopeVerticesAreAdjacent(const DSPolytope * polytope, const DSUInteger vertex1, const DSUInteger vertex2);
+
+extern DSVertices * DSPolytopeVertices(const DSPolytope * polytope);
+extern DSMatrix * DSPolytopeConnectivityMatrix(const DSPolytope * polytope);
+extern DSMatrixArray * DSPolytope3DFaces(const DSPolytope * polytope);
+
+#ifdef __cplusplus
+__END_DECLS
+#endif
+
+#endif
@@ -65,12 +65,20 @@
 #define DSSSysHd(x)                       ((x)->Hd)
 #define DSSSysHi(x)                       ((x)->Hi)
 #define DSSSysM(x)                        ((x)->M)
+#define DSSSysNumberOfUpdates(x)          ((x)->numberOfUpdates)
+#define DSSSysDeterminant(x)              ((x)->determinant)
 
 #define DSSSysIsSingular(x)               ((x)->isSingular)
 #define DSSSysShouldFreeXd(x)             ((x)->shouldFreeXd)
 #define DSSSysShouldFreeXi(x)             ((x)->shouldFreeXi)
 /*\}*/
 
+/**
+ * \brief The number of values of temporary vectors kept on the stack; larger
+ * vectors, which depend on the size of the model, are allocated on the heap.
+ */
+#define DS_SSYSTEM_STACK_WORKSPACE_SIZE   256
+
 #if defined (__APPLE__) && defined (__MACH__)
 #pragma  mark - Function Prototypes
 #endif
@@ -122,6 +130,8 @@ extern DSSSystem * DSSSystemCopy(const DSSSystem * original)
         DSSSystemSetIsSingular(newSSys, DSSSystemIsSingular(original));
         if (DSSSystemIsSingular(newSSys) == false) {
                 DSSSysM(newSSys) = DSMatrixCopy(DSSSysM(original));
+                DSSSysNumberOfUpdates(newSSys) = DSSSysNumberOfUpdates(original);
+                DSSSysDeterminant(newSSys) = DSSSysDeterminant(original);
         }
 bail:
         return newSSys;
@@ -403,8 +413,9 @@ static void dsSSystemSolveEquations(DSSSystem *ssys)
                 goto bail;
         }
         DSSSystemSetIsSingular(ssys, true);
+        DSSSysNumberOfUpdates(ssys) = 0;
         Ad = DSMatrixBySubstractingMatrix(DSSSysGd(ssys), DSSSysHd(ssys));
-        M = DSMatrixInverse(Ad);
+        M = DSMatrixInverseWithDeterminant(Ad, &DSSSysDeterminant(ssys));
         if (M != NULL) {
                 DSSSystemSetIsSingular(ssys, false);
                 DSSSysM(ssys) = M;
@@ -414,6 +425,114 @@ bail:
         return;
 }
 
+/**
+ * \brief Calculates the inverse of the Ad matrix of an S-System by updating
+ * the inverse of a neighboring S-System.
+ *
+ * \details Each row of Ad that differs between the two S-Systems is replaced
+ * with a rank-one Sherman-Morrison update of the inverse, at a cost
+ * proportional to the square of the number of equations.  The update is
+ * abandoned if too many rows differ, if the neighbor has no inverse, if the
+ * inverse has already been updated DS_SSYSTEM_MAXIMUM_SOLUTION_UPDATES times
+ * since its last full inversion, or if the update is ill-conditioned, in which
+ * case the S-System must be solved from scratch.
+ *
+ * The determinant of Ad is multiplied by the denominator of each update.  If
+ * it comes within DS_SSYSTEM_DETERMINANT_MARGIN of the singularity threshold
+ * of DSMatrixInverse, the update is also abandoned, so that an S-System is
+ * singular under the same test whether it is solved or updated.
+ *
+ * \return A boolean value indicating if the inverse was calculated.
+ */
+static bool dsSSystemUpdateSolutionFromNeighbor(DSSSystem *ssys, const DSSSystem *neighbor)
+{
+        bool updated = false;
+        DSMatrix *M = NULL;
+        DSUInteger i, j, k, n, numberOfUpdates, numberOfChangedRows;
+        double *difference = NULL, *u = NULL, *w = NULL;
+        double denominator, value, maximumU, maximumW, determinant;
+        bool *changed = NULL;
+        if (neighbor == NULL)
+                goto bail;
+        if (DSSSystemIsSingular(neighbor) == true || DSSSysM(neighbor) == NULL)
+                goto bail;
+        n = DSMatrixRows(DSSSysGd(ssys));
+        if (DSMatrixRows(DSSSysM(neighbor)) != n || DSMatrixColumns(DSSSysM(neighbor)) != n)
+                goto bail;
+        changed = DSSecureCalloc(sizeof(bool), n);
+        for (i = 0, numberOfChangedRows = 0; i < n; i++) {
+                for (j = 0; j < n; j++) {
+                        if (DSMatrixDoubleValue(DSSSysGd(ssys), i, j) != DSMatrixDoubleValue(DSSSysGd(neighbor), i, j) ||
+                            DSMatrixDoubleValue(DSSSysHd(ssys), i, j) != DSMatrixDoubleValue(DSSSysHd(neighbor), i, j)) {
+                                changed[i] = true;
+                                numberOfChangedRows++;
+                                break;
+                        }
+                }
+        }
+        numberOfUpdates = DSSSysNumberOfUpdates(neighbor)+numberOfChangedRows;
+        /** Several rank-one updates cost as much as a full inversion **/
+        if (numberOfChangedRows*DS_SSYSTEM_UPDATE_ROW_FACTOR > n || numberOfUpdates > DS_SSYSTEM_MAXIMUM_SOLUTION_UPDATES)
+                goto bail;
+        determinant = DSSSysDeterminant(neighbor);
+        if (isfinite(determinant) == 0)
+                goto bail;
+        M = DSMatrixCopy(DSSSysM(neighbor));
+        difference = DSSecureMalloc(sizeof(double)*n);
+        u = DSSecureMalloc(sizeof(double)*n);
+        w = DSSecureMalloc(sizeof(double)*n);
+        for (i = 0; i < n; i++) {
+                if (changed[i] == false)
+                        continue;
+                for (j = 0; j < n; j++) {
+                        difference[j] = DSMatrixDoubleValue(DSSSysGd(ssys), i, j)-DSMatrixDoubleValue(DSSSysHd(ssys), i, j);
+                        difference[j] -= DSMatrixDoubleValue(DSSSysGd(neighbor), i, j)-DSMatrixDoubleValue(DSSSysHd(neighbor), i, j);
+                }
+                maximumU = 0;
+                maximumW = 0;
+                for (k = 0; k < n; k++) {
+                        u[k] = DSMatrixDoubleValue(M, k, i);
+                        value = 0;
+                        for (j = 0; j < n; j++)
+                                value += difference[j]*DSMatrixDoubleValue(M, j, k);
+                        w[k] = value;
+                        maximumU = (fabs(u[k]) > maximumU) ? fabs(u[k]) : maximumU;
+                        maximumW = (fabs(w[k]) > maximumW) ? fabs(w[k]) : maximumW;
+                }
+                /** The denominator is the ratio of the determinants of the new and old Ad **/
+                denominator = 1.0+w[i];
+                if (fabs(denominator) <= DS_SSYSTEM_UPDATE_TOLERANCE*(1.0+maximumU*maximumW))
+                        goto bail;
+                determinant *= denominator;
+                if (fabs(determinant) < DS_SSYSTEM_DETERMINANT_MARGIN*DS_MATRIX_SINGULAR_DETERMINANT)
+                        goto bail;
+                for (j = 0; j < n; j++) {
+                        if (u[j] == 0)
+                                continue;
+                        for (k = 0; k < n; k++)
+                                DSMatrixSetDoubleValue(M, j, k, DSMatrixDoubleValue(M, j, k)-u[j]*w[k]/denominator);
+                }
+        }
+        DSSSysM(ssys) = M;
+        DSSSysNumberOfUpdates(ssys) = numberOfUpdates;
+        DSSSysDeterminant(ssys) = determinant;
+        DSSSystemSetIsSingular(ssys, false);
+        M = NULL;
+        updated = true;
+bail:
+        if (M != NULL)
+                DSMatrixFree(M);
+        if (changed != NULL)
+                DSSecureFree(changed);
+        if (difference != NULL)
+                DSSecureFree(difference);
+        if (u != NULL)
+                DSSecureFree(u);
+        if (w != NULL)
+                DSSecureFree(w);
+        return updated;
+}
+
 extern void DSSSystemRecalculateSolution(DSSSystem * ssys)
 {
         if (ssys == NULL) {
@@ -1108,9 +1227,30 @@ extern DSSSystem * DSSSystemFromGMAWithDominantTerms(const DSGMASystem * gma, co
 }
 
 extern DSSSystem * DSSSystemWithTermsFromGMA(const DSGMASystem * gma, const DSUInteger * termArray)
+{
+        return DSSSystemWithTermsFromGMAAndNeighbor(gma, termArray, NULL);
+}
+
+/**
+ * \brief Creates an S-System with the dominant terms of a GMA system, reusing
+ * the solution of a neighboring S-System.
+ *
+ * \details Neighboring S-Systems, such as those of consecutive signatures in
+ * Gray code order, differ in a few rows of Ad.  When possible, the inverse of
+ * Ad is obtained by rank-one updates of the inverse of the neighbor instead
+ * of a full inversion; otherwise the S-System is solved from scratch.
+ *
+ * \param gma The DSGMASystem with the terms of the S-System.
+ * \param termArray The signature with the dominant terms, starting at 1.
+ * \param neighbor An S-System of the same GMA system, or NULL.
+ *
+ * \return A new DSSSystem with the dominant terms, or NULL if the term array
+ *         is out of bounds.
+ */
+extern DSSSystem * DSSSystemWithTermsFromGMAAndNeighbor(const DSGMASystem * gma, const DSUInteger * termArray, const DSSSystem * neighbor)
 {
         DSSSystem *ssys = NULL;
-        DSUInteger i, j, term1, term2, numberOfEquations, numberOfXi;
+        DSUInteger i, term1, term2, numberOfEquations, numberOfXi;
         if (gma == NULL) {
                 DSError(M_DS_NULL ": Template GMA to make S-System is NULL", A_DS_ERROR);
                 goto bail;
@@ -1138,21 +1278,15 @@ extern DSSSystem * DSSSystemWithTermsFromGMA(const DSGMASystem * gma, const DSUI
                                        DSMatrixDoubleValue(DSGMASystemAlpha(gma), i/2, term1-1));
                 DSMatrixSetDoubleValue(DSSSysBeta(ssys), i/2, 0, 
                                        DSMatrixDoubleValue(DSGMASystemBeta(gma), i/2, term2-1));
-                for (j = 0; j < numberOfEquations; j++) {
-                        DSMatrixSetDoubleValue(DSSSysGd(ssys), i/2, j, 
-                                               DSMatrixArrayDoubleWithIndices(DSGMASystemGd(gma), i/2, term1-1, j));
-                        DSMatrixSetDoubleValue(DSSSysHd(ssys), i/2, j, 
-                                               DSMatrixArrayDoubleWithIndices(DSGMASystemHd(gma), i/2, term2-1, j));
-                }
-                for (j = 0; j < numberOfXi; j++) {
-                        DSMatrixSetDoubleValue(DSSSysGi(ssys), i/2, j, 
-                                               DSMatrixArrayDoubleWithIndices(DSGMASystemGi(gma), i/2, term1-1, j));
-                        DSMatrixSetDoubleValue(DSSSysHi(ssys), i/2, j, 
-                                               DSMatrixArrayDoubleWithIndices(DSGMASystemHi(gma), i/2, term2-1, j));
-                }
+                /** The exponent matrices are zero, so only nonzero exponents are set **/
+                DSGMASystemAddTermExponents(gma, i, term1-1, 1.0, &DSMatrixElement(DSSSysGd(ssys), i/2, 0),
+                                            (numberOfXi > 0) ? &DSMatrixElement(DSSSysGi(ssys), i/2, 0) : NULL);
+                DSGMASystemAddTermExponents(gma, i+1, term2-1, 1.0, &DSMatrixElement(DSSSysHd(ssys), i/2, 0),
+                                            (numberOfXi > 0) ? &DSMatrixElement(DSSSysHi(ssys), i/2, 0) : NULL);
         }
         if (i == 2*numberOfEquations) {
-                dsSSystemSolveEquations(ssys);
+                if (dsSSystemUpdateSolutionFromNeighbor(ssys, neighbor) == false)
+                        dsSSystemSolveEquations(ssys);
         } else {
                 DSSSystemFree(ssys);
                 ssys = NULL;
@@ -1398,7 +1532,11 @@ static void dsSSystemSolutionToString(const DSSSystem *ssys,
                                       DSUInteger *length, const bool inLog)
 {
         DSUInteger i, numberOfXd, numberOfXi;
-        DSMatrix *MAi, *MB, *B, *Ai;
+        DSMatrix *M, *MAi, *MB, *B;
+        DSMatrixView MView, MAiView, MBView, BView;
+        double MBValue;
+        double stackWorkspace[DS_SSYSTEM_STACK_WORKSPACE_SIZE];
+        double *workspace = stackWorkspace, *BValues, *MAiValues;
         char tempString[100] = "\0";
         const char *name;
         double value;
@@ -1427,44 +1565,51 @@ static void dsSSystemSolutionToString(const DSSSystem *ssys,
                 goto bail;
         }
         numberOfXi = DSVariablePoolNumberOfVariables(DSSSysXi(ssys));
-        B = DSSSystemB(ssys);
-        Ai = DSSSystemAi(ssys);
-        if (numberOfXi != 0) {
-                MAi = DSMatrixByMultiplyingMatrix(DSSSysM(ssys), Ai);
-                DSMatrixFree(Ai);
-        }
-        MB = DSMatrixByMultiplyingMatrix(DSSSysM(ssys), B);
-        DSMatrixFree(B);
-        if (inLog == true) 
-                sprintf(tempString, "%lf", DSMatrixDoubleValue(MB, equation, 0));
-        else
-                sprintf(tempString, "10^%lf", DSMatrixDoubleValue(MB, equation, 0));
-        if (*length-strlen(*string) < 100) {
-                *length += 1000;
-                *string = DSSecureRealloc(*string, sizeof(char)**length);
-        }
-        strncat(*string, tempString, *length-strlen(*string));
-        for (i = 0; i < numberOfXi; i++) {
+        if (DSMatrixRows(DSSSysM(ssys))+numberOfXi > DS_SSYSTEM_STACK_WORKSPACE_SIZE)
+                workspace = DSSecureMalloc(sizeof(double)*(DSMatrixRows(DSSSysM(ssys))+numberOfXi));
+        BValues = workspace;
+        MAiValues = BValues+DSMatrixRows(DSSSysM(ssys));
+        {
+                M = DSMatrixViewOfRows(&MView, DSSSysM(ssys), equation, 1);
+                B = DSMatrixViewWithData(&BView, DSMatrixRows(DSSSysM(ssys)), 1, BValues);
+                MB = DSMatrixViewWithData(&MBView, 1, 1, &MBValue);
+                DSSSystemBInto(ssys, B);
+                DSMatrixMultiplyMatricesInto(MB, 1.0, M, B, 0.0);
+                if (numberOfXi != 0) {
+                        MAi = DSMatrixViewWithData(&MAiView, 1, numberOfXi, MAiValues);
+                        DSMatrixMultiplyMatricesInto(MAi, 1.0, M, DSSSysGi(ssys), 0.0);
+                        DSMatrixMultiplyMatricesInto(MAi, -1.0, M, DSSSysHi(ssys), 1.0);
+                }
+                if (inLog == true) 
+                        sprintf(tempString, "%lf", MBValue);
+                else
+                        sprintf(tempString, "10^%lf", MBValue);
                 if (*length-strlen(*string) < 100) {
                         *length += 1000;
                         *string = DSSecureRealloc(*string, sizeof(char)**length);
                 }
-                name = DSVariableName(DSVariablePoolAllVariables(DSSSysXi(ssys))[i]);
-                value = -DSMatrixDoubleValue(MAi, equation, i);
-                if (value == 0.0)
-                        continue;
-                if (inLog == true)
-                        sprintf(tempString, "+%lf*log(%s)", value, name);
-                else if (value == 1.0)
-                        sprintf(tempString, "*%s", name);
-                else
-                        sprintf(tempString, "*%s^%lf", name, value);
                 strncat(*string, tempString, *length-strlen(*string));
+                for (i = 0; i < numberOfXi; i++) {
+                        if (*length-strlen(*string) < 100) {
+                                *length += 1000;
+                                *string = DSSecureRealloc(*string, sizeof(char)**length);
+                        }
+                        name = DSVariableName(DSVariablePoolAllVariables(DSSSysXi(ssys))[i]);
+                        value = -MAiValues[i];
+                        if (value == 0.0)
+                                continue;
+                        if (inLog == true)
+                                sprintf(tempString, "+%lf*log(%s)", value, name);
+                        else if (value == 1.0)
+                                sprintf(tempString, "*%s", name);
+                        else
+                                sprintf(tempString, "*%s^%lf", name, value);
+                        strncat(*string, tempString, *length-strlen(*string));
+                }
         }
-        if (numberOfXi != 0)
-                DSMatrixFree(MAi);
-        DSMatrixFree(MB);
 bail:
+        if (workspace != stackWorkspace)
+                DSSecureFree(workspace);
         return;
 }
 
@@ -1949,7 +2094,6 @@ bail:
 extern DSMatrix * DSSSystemB(const DSSSystem * ssys)
 {
         DSMatrix *B = NULL;
-        DSUInteger i;
         if (ssys == NULL) {
                 DSError(M_DS_MAT_NULL ": B is NULL", A_DS_ERROR);
                 goto bail;
@@ -1963,12 +2107,46 @@ extern DSMatrix * DSSSystemB(const DSSSystem * ssys)
                 goto bail;
         }
         B = DSMatrixAlloc(DSMatrixRows(DSSSysBeta(ssys)), 1);
+        DSSSystemBInto(ssys, B);
+bail:
+        return B;
+}
+
+/**
+ * \brief Calculates the vector B of an S-System into a matrix provided by
+ * the caller.
+ *
+ * \details B is the logarithm of the ratio of the rate constants of each
+ * equation.  The matrix must have one column and a row for each equation,
+ * and may be a DSMatrixView of storage on the stack.
+ *
+ * \param ssys The DSSSystem whose vector B is calculated.
+ * \param B The DSMatrix where the vector B is stored.
+ */
+extern void DSSSystemBInto(const DSSSystem * ssys, DSMatrix * B)
+{
+        DSUInteger i;
+        if (ssys == NULL) {
+                DSError(M_DS_SSYS_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (B == NULL) {
+                DSError(M_DS_MAT_NULL ": B is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (DSSSysAlpha(ssys) == NULL || DSSSysBeta(ssys) == NULL) {
+                DSError(M_DS_MAT_NULL ": Alpha/beta matrix is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (DSMatrixRows(B) != DSMatrixRows(DSSSysBeta(ssys)) || DSMatrixRows(B) != DSMatrixRows(DSSSysAlpha(ssys)) || DSMatrixColumns(B) != 1) {
+                DSError(M_DS_WRONG ": Dimensions of B do not match the S-System", A_DS_ERROR);
+                goto bail;
+        }
         for (i = 0; i < DSMatrixRows(B); i++) {
-                DSMatrixSetDoubleValue(B, i, 0,
-                                       log10(DSMatrixDoubleValue(DSSSysBeta(ssys), i, 0)/DSMatrixDoubleValue(DSSSysAlpha(ssys), i, 0)));
+                DSMatrixElement(B, i, 0) = log10(DSMatrixElement(DSSSysBeta(ssys), i, 0)/DSMatrixElement(DSSSysAlpha(ssys), i, 0));
         }
 bail:
-        return B;
+        return;
 }
 
 extern DSMatrix * DSSSystemA(const DSSSystem * ssys)
@@ -2115,51 +2293,48 @@ bail:
 extern DSMatrix * DSSSystemSteadyStateValues(const DSSSystem *ssys, const DSVariablePool *Xi0)
 {
         DSMatrix * steadyState = NULL;
-        DSMatrix *Xi = NULL;
-        DSMatrix *MAi, *MAiXi, *B = NULL, *Ai = NULL;
-        DSVariablePool *pool = NULL;
-        DSUInteger i;
+        DSMatrix *Xi, *B;
+        DSMatrixView XiView, BView;
+        DSUInteger i, numberOfEquations, numberOfXi;
+        double stackWorkspace[DS_SSYSTEM_STACK_WORKSPACE_SIZE];
+        double *workspace = stackWorkspace, *BValues, *XiValues;
         const char *name;
         if (ssys == NULL) {
                 DSError(M_DS_SSYS_NULL, A_DS_ERROR);
                 goto bail;
         }
-        if (Xi0 == NULL && DSVariablePoolNumberOfVariables(DSSSysXi(ssys)) != 0) {
+        numberOfXi = DSVariablePoolNumberOfVariables(DSSSysXi(ssys));
+        if (Xi0 == NULL && numberOfXi != 0) {
                 DSError(M_DS_VAR_NULL ": Xi0 variable pool is NULL", A_DS_ERROR);
                 goto bail;
         }
         if (DSSSystemHasSolution(ssys) == false)
                 goto bail;
-        B = DSSSystemB(ssys);
-        steadyState = DSMatrixByMultiplyingMatrix(DSSSysM(ssys), B);
-        if (DSVariablePoolNumberOfVariables(DSSSysXi(ssys)) != 0) {
-                pool = DSVariablePoolAlloc();
-                for (i=0; i < DSVariablePoolNumberOfVariables(DSSSysXi(ssys)); i++) {
-                        name =  DSVariableName(DSVariablePoolAllVariables(DSSSysXi(ssys))[i]);
-                        DSVariablePoolAddVariableWithName(pool, name);
-                        if (DSVariablePoolHasVariableWithName(Xi0, name) == false) {
-                                DSMatrixFree(steadyState);
-                                DSVariablePoolFree(pool);
-                                steadyState = NULL;
-                                goto bail;
+        numberOfEquations = DSMatrixRows(DSSSysM(ssys));
+        if (numberOfEquations+numberOfXi > DS_SSYSTEM_STACK_WORKSPACE_SIZE)
+                workspace = DSSecureMalloc(sizeof(double)*(numberOfEquations+numberOfXi));
+        BValues = workspace;
+        XiValues = BValues+numberOfEquations;
+        {
+                B = DSMatrixViewWithData(&BView, numberOfEquations, 1, BValues);
+                DSSSystemBInto(ssys, B);
+                if (numberOfXi != 0) {
+                        for (i = 0; i < numberOfXi; i++) {
+                                name =  DSVariableName(DSVariablePoolAllVariables(DSSSysXi(ssys))[i]);
+                                if (DSVariablePoolHasVariableWithName(Xi0, name) == false)
+                                        goto bail;
+                                XiValues[i] = log10(DSVariableValue(DSVariablePoolVariableWithName(Xi0, name)));
                         }
-                        DSVariablePoolSetValueForVariableWithName(pool,  name, DSVariableValue(DSVariablePoolVariableWithName(Xi0, name)));
+                        Xi = DSMatrixViewWithData(&XiView, numberOfXi, 1, XiValues);
+                        DSMatrixMultiplyMatricesInto(B, -1.0, DSSSysGi(ssys), Xi, 1.0);
+                        DSMatrixMultiplyMatricesInto(B, 1.0, DSSSysHi(ssys), Xi, 1.0);
                 }
-                Ai = DSSSystemAi(ssys);
-                Xi = DSVariablePoolValuesAsVector(pool, false);
-                DSMatrixApplyFunction(Xi, log10);
-                MAi = DSMatrixByMultiplyingMatrix(DSSSysM(ssys), Ai);
-                MAiXi = DSMatrixByMultiplyingMatrix(MAi, Xi);
-                DSMatrixSubstractByMatrix(steadyState, MAiXi);
-                DSMatrixFree(Ai);
-                DSMatrixFree(Xi);
-                DSMatrixFree(MAi);
-                DSMatrixFree(MAiXi);
-                DSVariablePoolFree(pool);
+                steadyState = DSMatrixAlloc(numberOfEquations, 1);
+                DSMatrixMultiplyMatricesInto(steadyState, 1.0, DSSSysM(ssys), B, 0.0);
         }
 bail:
-        if (B != NULL)
-                DSMatrixFree(B);
+        if (workspace != stackWorkspace)
+                DSSecureFree(workspace);
         return steadyState;
 }
 
@@ -3310,6 +3485,8 @@ extern DSSSystem * DSSSystemFromSSystemMessage(const DSSSystemMessage * message)
         ssystem->modifierFlags = message->modifierflag;
         if (message->m != NULL) {
                 ssystem->M = DSMatrixFromMatrixMessage(message->m);
+                /** The determinant is not encoded; decoded solutions are not updated **/
+                ssystem->determinant = NAN;
         } else {
                 ssystem->M = NULL;
         }
@@ -42,6 +42,32 @@ __BEGIN_DECLS
 #define DS_SSYSTEM_FLAG_FREE_XD           0x02
 #define DS_SSYSTEM_FLAG_FREE_XI           0x04
 
+/**
+ * \brief Maximum number of rank-one updates applied to the inverse of Ad
+ * before it is calculated again from scratch, limiting the accumulation of
+ * rounding errors.
+ */
+#define DS_SSYSTEM_MAXIMUM_SOLUTION_UPDATES   32
+
+/**
+ * \brief Relative tolerance of the denominator of a rank-one update of the
+ * inverse of Ad, below which the update is considered ill-conditioned.
+ */
+#define DS_SSYSTEM_UPDATE_TOLERANCE           1E-8
+
+/**
+ * \brief Factor of DS_MATRIX_SINGULAR_DETERMINANT below which the determinant
+ * of an updated Ad is too close to the singularity threshold, and the inverse
+ * is calculated from scratch so that DSMatrixInverse decides if Ad is singular.
+ */
+#define DS_SSYSTEM_DETERMINANT_MARGIN         1E3
+
+/**
+ * \brief The inverse of Ad is only updated if at most one in this many rows
+ * change.
+ */
+#define DS_SSYSTEM_UPDATE_ROW_FACTOR          3
+
 
 #if defined (__APPLE__) && defined (__MACH__)
 #pragma mark - Allocation, deallocation and initialization
@@ -56,6 +82,7 @@ extern void DSSSystemFree(DSSSystem * ssys);
 
 //__deprecated extern DSSSystem * DSSSystemFromGMAWithDominantTerms(const DSGMASystem * gma, const DSUInteger * termList);
 extern DSSSystem * DSSSystemWithTermsFromGMA(const DSGMASystem * gma, const DSUInteger * termArray);
+extern DSSSystem * DSSSystemWithTermsFromGMAAndNeighbor(const DSGMASystem * gma, const DSUInteger * termArray, const DSSSystem * neighbor);
 extern DSSSystem * DSSSystemByParsingStringList(char * const * const string, const DSVariablePool * const Xd_a, ...);
 extern DSSSystem * DSSSystemByParsingStrings(char * const * const strings, const DSVariablePool * const Xd_a, const DSUInteger numberOfEquations);
 
@@ -133,6 +160,7 @@ extern DSMatrix * DSSSystemAd_t(const DSSSystem * ssys);
 
 extern DSMatrix * DSSSystemAi(const DSSSystem * ssys);
 extern DSMatrix * DSSSystemB(const DSSSystem * ssys);
+extern void DSSSystemBInto(const DSSSystem * ssys, DSMatrix * B);
 extern DSMatrix * DSSSystemA(const DSSSystem * ssys);
 extern DSMatrix * DSSSystemG(const DSSSystem *ssys);
 extern DSMatrix * DSSSystemH(const DSSSystem *ssys);
@@ -54,10 +54,16 @@
 #include "DSCase.h"
 #include "DSDesignSpace.h"
 #include "DSVertices.h"
+#include "DSPolytope.h"
+#include "DSLinearProblem.h"
 #include "DSDictionary.h"
 #include "DSStack.h"
+#include "DSCaseSet.h"
+#include "DSCaseIndex.h"
+#include "DSCaseIntersection.h"
 #include "DSCyclicalCase.h"
 #include "DSNVertexEnumeration.h"
+#include "DSThreadPool.h"
 
 
 #ifndef __DS_STD_INCLUDE__
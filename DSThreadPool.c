@@ -0,0 +1,593 @@
+/**
+ * \file DSThreadPool.c
+ * \brief Implementation file with functions for the library-wide persistent
+ * thread pool used by the parallel design space functions.
+ *
+ * \details
+ *
+ * Copyright (C) 2011-2014 Jason Lomnitz.\n\n
+ *
+ * This file is part of the Design Space Toolbox V2 (C Library).
+ *
+ * The Design Space Toolbox V2 is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Design Space Toolbox V2 is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Design Space Toolbox. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * \author Jason Lomnitz.
+ * \date 2014
+ */
+
+#include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "DSErrors.h"
+#include "DSMemoryManager.h"
+#include "DSThreadPool.h"
+
+#define DS_THREAD_POOL_DEQUE_INITIAL_SIZE    64
+#define DS_THREAD_POOL_STACK_SIZE            (8*1024*1024)
+#define DS_THREAD_POOL_MAXIMUM_HOOKS         8
+
+typedef struct {
+        DSThreadPoolFunction function;
+        void * argument;
+        DSThreadPoolGroup * group;
+} ds_threadpool_task_t;
+
+/**
+ * \brief Double ended queue of tasks owned by a single worker.
+ *
+ * \details The owner pushes and pops tasks at the bottom of the deque, while
+ * other threads steal tasks from the top.  Each deque has its own mutex, so
+ * that workers only contend with each other when stealing.
+ */
+typedef struct {
+        ds_threadpool_task_t * tasks;   //!< Circular buffer of tasks.
+        DSUInteger size;                //!< The size of the circular buffer.
+        DSUInteger top;                 //!< The index of the oldest task.
+        DSUInteger count;               //!< The number of tasks in the deque.
+        pthread_mutex_t lock;           //!< The mutex protecting the deque.
+} ds_threadpool_deque_t;
+
+struct ds_threadpool_group {
+        DSUInteger pending;             //!< Number of submitted tasks not yet completed, protected by lock.
+        pthread_mutex_t lock;           //!< Mutex protecting pending, used with the completion condition.
+        pthread_cond_t completed;       //!< Condition signaled when pending reaches zero.
+};
+
+typedef struct {
+        DSUInteger numberOfThreads;     //!< Number of worker threads.
+        pthread_t * threads;            //!< The worker threads.
+        ds_threadpool_deque_t * deques; //!< One deque per worker thread.
+        long queued;                    //!< Number of tasks waiting in all deques, protected by lock.
+        volatile DSUInteger nextDeque;  //!< Round robin index for tasks submitted by external threads.
+        bool shutdown;                  //!< Flag indicating the workers should exit.
+        pthread_mutex_t lock;           //!< Mutex protecting queued and shutdown, used with the work condition.
+        pthread_cond_t workAvailable;   //!< Condition signaled when tasks are queued.
+} ds_threadpool_t;
+
+struct ds_threadpool_worker_data {
+        ds_threadpool_t * pool;
+        DSUInteger index;
+};
+
+static ds_threadpool_t * sharedPool = NULL;
+static DSUInteger requestedNumberOfThreads = 0;
+static pthread_mutex_t sharedPoolLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t workerKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t workerKey;
+static DSThreadPoolThreadHook threadBeginHooks[DS_THREAD_POOL_MAXIMUM_HOOKS];
+static DSThreadPoolThreadHook threadEndHooks[DS_THREAD_POOL_MAXIMUM_HOOKS];
+static volatile DSUInteger numberOfThreadHooks = 0;
+static pthread_mutex_t threadHooksLock = PTHREAD_MUTEX_INITIALIZER;
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Internal deque functions
+#endif
+
+static void dsThreadPoolDequeInit(ds_threadpool_deque_t * deque)
+{
+        deque->size = DS_THREAD_POOL_DEQUE_INITIAL_SIZE;
+        deque->tasks = DSSecureMalloc(sizeof(ds_threadpool_task_t)*deque->size);
+        deque->top = 0;
+        deque->count = 0;
+        pthread_mutex_init(&deque->lock, NULL);
+}
+
+static void dsThreadPoolDequeDestroy(ds_threadpool_deque_t * deque)
+{
+        DSSecureFree(deque->tasks);
+        pthread_mutex_destroy(&deque->lock);
+}
+
+static void dsThreadPoolDequePushBottom(ds_threadpool_deque_t * deque, ds_threadpool_task_t task)
+{
+        DSUInteger i;
+        ds_threadpool_task_t * tasks;
+        pthread_mutex_lock(&deque->lock);
+        if (deque->count == deque->size) {
+                tasks = DSSecureMalloc(sizeof(ds_threadpool_task_t)*deque->size*2);
+                for (i = 0; i < deque->count; i++)
+                        tasks[i] = deque->tasks[(deque->top+i) % deque->size];
+                DSSecureFree(deque->tasks);
+                deque->tasks = tasks;
+                deque->top = 0;
+                deque->size *= 2;
+        }
+        deque->tasks[(deque->top+deque->count) % deque->size] = task;
+        deque->count++;
+        pthread_mutex_unlock(&deque->lock);
+}
+
+static bool dsThreadPoolDequePopBottom(ds_threadpool_deque_t * deque, ds_threadpool_task_t * task)
+{
+        bool found = false;
+        pthread_mutex_lock(&deque->lock);
+        if (deque->count > 0) {
+                deque->count--;
+                *task = deque->tasks[(deque->top+deque->count) % deque->size];
+                found = true;
+        }
+        pthread_mutex_unlock(&deque->lock);
+        return found;
+}
+
+static bool dsThreadPoolDequeStealTop(ds_threadpool_deque_t * deque, ds_threadpool_task_t * task)
+{
+        bool found = false;
+        if (deque->count == 0)
+                goto bail;
+        pthread_mutex_lock(&deque->lock);
+        if (deque->count > 0) {
+                *task = deque->tasks[deque->top];
+                deque->top = (deque->top+1) % deque->size;
+                deque->count--;
+                found = true;
+        }
+        pthread_mutex_unlock(&deque->lock);
+bail:
+        return found;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Internal pool functions
+#endif
+
+static void dsThreadPoolMakeWorkerKey(void)
+{
+        pthread_key_create(&workerKey, NULL);
+}
+
+/**
+ * \brief Takes a task from the pool on behalf of a thread.
+ *
+ * \details Workers first pop from the bottom of their own deque, and then
+ * steal from the top of the other deques starting at the neighboring worker.
+ * External threads only steal.
+ */
+static bool dsThreadPoolTakeTask(ds_threadpool_t * pool, DSInteger workerIndex, ds_threadpool_task_t * task)
+{
+        DSUInteger i, start;
+        bool found = false;
+        if (workerIndex >= 0)
+                found = dsThreadPoolDequePopBottom(&pool->deques[workerIndex], task);
+        start = (workerIndex >= 0) ? (DSUInteger)workerIndex+1 : 0;
+        for (i = 0; i < pool->numberOfThreads && found == false; i++)
+                found = dsThreadPoolDequeStealTop(&pool->deques[(start+i) % pool->numberOfThreads], task);
+        if (found == true) {
+                pthread_mutex_lock(&pool->lock);
+                pool->queued--;
+                pthread_mutex_unlock(&pool->lock);
+        }
+        return found;
+}
+
+/**
+ * \brief Executes a task and marks it as completed in its group.
+ *
+ * \details The pending count is decremented and the waiters are woken while
+ * holding the group lock, so that a waiter cannot observe the group as
+ * completed, and free it, before this function is done with it.
+ */
+static void dsThreadPoolExecuteTask(ds_threadpool_task_t * task)
+{
+        DSThreadPoolGroup * group = task->group;
+        task->function(task->argument);
+        pthread_mutex_lock(&group->lock);
+        if (--group->pending == 0)
+                pthread_cond_broadcast(&group->completed);
+        pthread_mutex_unlock(&group->lock);
+}
+
+/**
+ * \brief Runs the begin hooks registered since the worker last ran them.
+ *
+ * \details Hooks are only appended to the registry, so a worker that has run
+ * the first hooksRun begin hooks runs the rest before its next task.  Hooks
+ * registered after the workers started are picked up this way without
+ * restarting the pool.
+ *
+ * \return The number of begin hooks run by the worker.
+ */
+static DSUInteger dsThreadPoolRunBeginHooks(DSUInteger hooksRun)
+{
+        DSUInteger numberOfHooks = __sync_fetch_and_add(&numberOfThreadHooks, 0);
+        for (; hooksRun < numberOfHooks; hooksRun++)
+                threadBeginHooks[hooksRun]();
+        return hooksRun;
+}
+
+static void dsThreadPoolRunEndHooks(DSUInteger hooksRun)
+{
+        while (hooksRun > 0)
+                threadEndHooks[--hooksRun]();
+}
+
+static void * dsThreadPoolWorker(void * argument)
+{
+        struct ds_threadpool_worker_data * data = argument;
+        ds_threadpool_t * pool = data->pool;
+        DSInteger index = (DSInteger)data->index;
+        ds_threadpool_task_t task;
+        DSUInteger hooksRun = 0;
+        DSSecureFree(data);
+        pthread_setspecific(workerKey, (void *)(long)(index+1));
+        hooksRun = dsThreadPoolRunBeginHooks(hooksRun);
+        while (true) {
+                if (dsThreadPoolTakeTask(pool, index, &task) == true) {
+                        hooksRun = dsThreadPoolRunBeginHooks(hooksRun);
+                        dsThreadPoolExecuteTask(&task);
+                        continue;
+                }
+                pthread_mutex_lock(&pool->lock);
+                while (pool->queued <= 0 && pool->shutdown == false)
+                        pthread_cond_wait(&pool->workAvailable, &pool->lock);
+                if (pool->shutdown == true && pool->queued <= 0) {
+                        pthread_mutex_unlock(&pool->lock);
+                        break;
+                }
+                pthread_mutex_unlock(&pool->lock);
+        }
+        dsThreadPoolRunEndHooks(hooksRun);
+        return NULL;
+}
+
+static DSUInteger dsThreadPoolEffectiveNumberOfThreads(DSUInteger numberOfThreads)
+{
+        long int numberOfProcessors;
+        if (numberOfThreads == 0) {
+                numberOfProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+                numberOfThreads = (numberOfProcessors > 0) ? (DSUInteger)numberOfProcessors : 1;
+        }
+        return numberOfThreads;
+}
+
+static ds_threadpool_t * dsThreadPoolAlloc(DSUInteger numberOfThreads)
+{
+        DSUInteger i;
+        ds_threadpool_t * pool = NULL;
+        struct ds_threadpool_worker_data * data;
+        pthread_attr_t attr;
+        pthread_once(&workerKeyOnce, dsThreadPoolMakeWorkerKey);
+        numberOfThreads = dsThreadPoolEffectiveNumberOfThreads(numberOfThreads);
+        pool = DSSecureCalloc(sizeof(ds_threadpool_t), 1);
+        pool->numberOfThreads = numberOfThreads;
+        pool->deques = DSSecureCalloc(sizeof(ds_threadpool_deque_t), numberOfThreads);
+        pool->threads = DSSecureCalloc(sizeof(pthread_t), numberOfThreads);
+        pthread_mutex_init(&pool->lock, NULL);
+        pthread_cond_init(&pool->workAvailable, NULL);
+        for (i = 0; i < numberOfThreads; i++)
+                dsThreadPoolDequeInit(&pool->deques[i]);
+        pthread_attr_init(&attr);
+        pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
+        /** The default stack size of secondary threads is platform dependent **/
+        pthread_attr_setstacksize(&attr, DS_THREAD_POOL_STACK_SIZE);
+        for (i = 0; i < numberOfThreads; i++) {
+                data = DSSecureMalloc(sizeof(struct ds_threadpool_worker_data));
+                data->pool = pool;
+                data->index = i;
+                if (pthread_create(&pool->threads[i], &attr, dsThreadPoolWorker, data) != 0)
+                        DSError(M_DS_NOTHREAD, A_DS_FATAL);
+        }
+        pthread_attr_destroy(&attr);
+        return pool;
+}
+
+static void dsThreadPoolFree(ds_threadpool_t * pool)
+{
+        DSUInteger i;
+        pthread_mutex_lock(&pool->lock);
+        pool->shutdown = true;
+        pthread_cond_broadcast(&pool->workAvailable);
+        pthread_mutex_unlock(&pool->lock);
+        for (i = 0; i < pool->numberOfThreads; i++)
+                pthread_join(pool->threads[i], NULL);
+        for (i = 0; i < pool->numberOfThreads; i++)
+                dsThreadPoolDequeDestroy(&pool->deques[i]);
+        pthread_cond_destroy(&pool->workAvailable);
+        pthread_mutex_destroy(&pool->lock);
+        DSSecureFree(pool->deques);
+        DSSecureFree(pool->threads);
+        DSSecureFree(pool);
+}
+
+static ds_threadpool_t * dsThreadPoolShared(void)
+{
+        ds_threadpool_t * pool;
+        pthread_mutex_lock(&sharedPoolLock);
+        if (sharedPool == NULL)
+                sharedPool = dsThreadPoolAlloc(requestedNumberOfThreads);
+        pool = sharedPool;
+        pthread_mutex_unlock(&sharedPoolLock);
+        return pool;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Thread pool configuration
+#endif
+
+/**
+ * \brief Sets the number of worker threads used by the thread pool.
+ *
+ * \details If the thread pool is running with a different number of threads,
+ * the existing workers are stopped and a new pool is created the next time
+ * parallel work is requested.  This function must not be called while
+ * parallel work is in progress.
+ *
+ * \param numberOfThreads The number of worker threads.  A value of 0 uses the
+ *        number of online processors.
+ */
+extern void DSThreadPoolSetNumberOfThreads(const DSUInteger numberOfThreads)
+{
+        ds_threadpool_t * pool = NULL;
+        if (DSThreadPoolCurrentWorkerIndex() >= 0) {
+                DSError(M_DS_WRONG ": Number of threads cannot be changed from a worker thread", A_DS_ERROR);
+                goto bail;
+        }
+        pthread_mutex_lock(&sharedPoolLock);
+        requestedNumberOfThreads = numberOfThreads;
+        if (sharedPool != NULL && sharedPool->numberOfThreads != dsThreadPoolEffectiveNumberOfThreads(numberOfThreads)) {
+                pool = sharedPool;
+                sharedPool = NULL;
+        }
+        pthread_mutex_unlock(&sharedPoolLock);
+        if (pool != NULL)
+                dsThreadPoolFree(pool);
+bail:
+        return;
+}
+
+/**
+ * \brief Returns the number of worker threads used by the thread pool.
+ *
+ * \details This function creates the thread pool if it has not been created.
+ */
+extern DSUInteger DSThreadPoolNumberOfThreads(void)
+{
+        return dsThreadPoolShared()->numberOfThreads;
+}
+
+/**
+ * \brief Returns the index of the worker executing the calling thread.
+ *
+ * \return A value in [0, DSThreadPoolNumberOfThreads()) if called from a task
+ *         executed by a worker thread, -1 otherwise.
+ */
+extern DSInteger DSThreadPoolCurrentWorkerIndex(void)
+{
+        pthread_once(&workerKeyOnce, dsThreadPoolMakeWorkerKey);
+        return (DSInteger)(long)pthread_getspecific(workerKey)-1;
+}
+
+/**
+ * \brief Stops all the worker threads of the thread pool.
+ *
+ * \details The pool is re-created the next time parallel work is requested.
+ */
+extern void DSThreadPoolShutdown(void)
+{
+        ds_threadpool_t * pool;
+        if (DSThreadPoolCurrentWorkerIndex() >= 0) {
+                DSError(M_DS_WRONG ": Thread pool cannot be shut down from a worker thread", A_DS_ERROR);
+                goto bail;
+        }
+        pthread_mutex_lock(&sharedPoolLock);
+        pool = sharedPool;
+        sharedPool = NULL;
+        pthread_mutex_unlock(&sharedPoolLock);
+        if (pool != NULL)
+                dsThreadPoolFree(pool);
+bail:
+        return;
+}
+
+/**
+ * \brief Registers a pair of functions run by every worker thread when it
+ * starts and when it exits.
+ *
+ * \details Worker threads run the begin function before executing their next
+ * task, including workers that were already running when the hooks were
+ * registered, and run the end functions in the reverse order of registration
+ * when they exit.  Registering the same pair of functions more than once has
+ * no effect.  Hooks cannot be removed.
+ *
+ * \param begin The function run by each worker thread when it starts.
+ * \param end The function run by each worker thread when it exits.
+ */
+extern void DSThreadPoolAddThreadHooks(DSThreadPoolThreadHook begin, DSThreadPoolThreadHook end)
+{
+        DSUInteger i;
+        if (begin == NULL || end == NULL) {
+                DSError(M_DS_NULL ": Thread pool hook is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        pthread_mutex_lock(&threadHooksLock);
+        for (i = 0; i < numberOfThreadHooks; i++) {
+                if (threadBeginHooks[i] == begin && threadEndHooks[i] == end)
+                        break;
+        }
+        if (i < numberOfThreadHooks) {
+                pthread_mutex_unlock(&threadHooksLock);
+                goto bail;
+        }
+        if (numberOfThreadHooks == DS_THREAD_POOL_MAXIMUM_HOOKS) {
+                pthread_mutex_unlock(&threadHooksLock);
+                DSError(M_DS_WRONG ": Too many thread pool hooks", A_DS_ERROR);
+                goto bail;
+        }
+        threadBeginHooks[numberOfThreadHooks] = begin;
+        threadEndHooks[numberOfThreadHooks] = end;
+        /** The hooks are stored before the workers can see the new count **/
+        __sync_fetch_and_add(&numberOfThreadHooks, 1);
+        pthread_mutex_unlock(&threadHooksLock);
+bail:
+        return;
+}
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Task groups
+#endif
+
+extern DSThreadPoolGroup * DSThreadPoolGroupAlloc(void)
+{
+        DSThreadPoolGroup * group = NULL;
+        group = DSSecureCalloc(sizeof(DSThreadPoolGroup), 1);
+        pthread_mutex_init(&group->lock, NULL);
+        pthread_cond_init(&group->completed, NULL);
+        return group;
+}
+
+extern void DSThreadPoolGroupFree(DSThreadPoolGroup * group)
+{
+        DSUInteger pending;
+        if (group == NULL) {
+                DSError(M_DS_THREAD_POOL_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        pthread_mutex_lock(&group->lock);
+        pending = group->pending;
+        pthread_mutex_unlock(&group->lock);
+        if (pending != 0) {
+                DSError(M_DS_WRONG ": Freeing thread pool group with pending tasks", A_DS_WARN);
+                DSThreadPoolGroupWait(group);
+        }
+        pthread_cond_destroy(&group->completed);
+        pthread_mutex_destroy(&group->lock);
+        DSSecureFree(group);
+bail:
+        return;
+}
+
+/**
+ * \brief Submits a task to the thread pool as part of a group.
+ *
+ * \details Tasks submitted from a worker thread are pushed onto the deque of
+ * that worker; tasks submitted from other threads are distributed among the
+ * worker deques in a round robin fashion.
+ */
+extern void DSThreadPoolGroupSubmit(DSThreadPoolGroup * group, DSThreadPoolFunction function, void * argument)
+{
+        ds_threadpool_t * pool;
+        ds_threadpool_task_t task;
+        DSInteger index;
+        if (group == NULL) {
+                DSError(M_DS_THREAD_POOL_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (function == NULL) {
+                DSError(M_DS_NULL ": Thread pool task function is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        pool = dsThreadPoolShared();
+        task.function = function;
+        task.argument = argument;
+        task.group = group;
+        pthread_mutex_lock(&group->lock);
+        group->pending++;
+        pthread_mutex_unlock(&group->lock);
+        index = DSThreadPoolCurrentWorkerIndex();
+        if (index < 0)
+                index = (DSInteger)(__sync_fetch_and_add(&pool->nextDeque, 1) % pool->numberOfThreads);
+        dsThreadPoolDequePushBottom(&pool->deques[index], task);
+        pthread_mutex_lock(&pool->lock);
+        pool->queued++;
+        pthread_cond_signal(&pool->workAvailable);
+        pthread_mutex_unlock(&pool->lock);
+bail:
+        return;
+}
+
+/**
+ * \brief Waits until all the tasks submitted to a group have completed.
+ *
+ * \details The calling thread executes queued tasks while it waits, and only
+ * blocks when there are no tasks left to take.
+ */
+extern void DSThreadPoolGroupWait(DSThreadPoolGroup * group)
+{
+        ds_threadpool_t * pool;
+        ds_threadpool_task_t task;
+        DSInteger index;
+        if (group == NULL) {
+                DSError(M_DS_THREAD_POOL_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        pool = dsThreadPoolShared();
+        index = DSThreadPoolCurrentWorkerIndex();
+        pthread_mutex_lock(&group->lock);
+        while (group->pending > 0) {
+                pthread_mutex_unlock(&group->lock);
+                if (dsThreadPoolTakeTask(pool, index, &task) == true) {
+                        dsThreadPoolExecuteTask(&task);
+                        pthread_mutex_lock(&group->lock);
+                        continue;
+                }
+                pthread_mutex_lock(&group->lock);
+                if (group->pending > 0)
+                        pthread_cond_wait(&group->completed, &group->lock);
+        }
+        pthread_mutex_unlock(&group->lock);
+bail:
+        return;
+}
+
+/**
+ * \brief Executes a function over an array of arguments using the thread pool.
+ *
+ * \details This function submits one task per element of the argument array
+ * and returns when all tasks have completed.  It replaces the creation and
+ * joining of one pthread per argument.
+ *
+ * \param function The function executed by each task.
+ * \param arguments A C array with the arguments of each task.
+ * \param argumentSize The size of each element in the arguments array.
+ * \param numberOfTasks The number of elements in the arguments array.
+ */
+extern void DSThreadPoolRun(DSThreadPoolFunction function, void * arguments, const size_t argumentSize, const DSUInteger numberOfTasks)
+{
+        DSUInteger i;
+        DSThreadPoolGroup * group = NULL;
+        if (function == NULL) {
+                DSError(M_DS_NULL ": Thread pool task function is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (numberOfTasks == 0)
+                goto bail;
+        group = DSThreadPoolGroupAlloc();
+        for (i = 0; i < numberOfTasks; i++)
+                DSThreadPoolGroupSubmit(group, function, (char *)arguments+i*argumentSize);
+        DSThreadPoolGroupWait(group);
+        DSThreadPoolGroupFree(group);
+bail:
+        return;
+}
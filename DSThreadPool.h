@@ -0,0 +1,103 @@
+/**
+ * \file DSThreadPool.h
+ * \brief Header file with functions for the library-wide persistent thread
+ * pool used by the parallel design space functions.
+ *
+ * \details The thread pool is created lazily the first time parallel work is
+ * requested, and its threads persist until the number of threads is changed
+ * or the pool is explicitly shut down.  Each worker thread owns a deque of
+ * tasks; a worker pushes and pops tasks at the bottom of its own deque, and
+ * idle workers steal tasks from the top of the deques of other workers.
+ *
+ * Threads waiting for a group of tasks to finish execute pending tasks while
+ * they wait, which makes it safe to submit tasks from within a task (e.g. when
+ * the validity of a cyclical case requires the analysis of its internal design
+ * space).
+ *
+ * Copyright (C) 2011-2014 Jason Lomnitz.\n\n
+ *
+ * This file is part of the Design Space Toolbox V2 (C Library).
+ *
+ * The Design Space Toolbox V2 is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * The Design Space Toolbox V2 is distributed in the hope that it will be
+ * useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with the Design Space Toolbox. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * \author Jason Lomnitz.
+ * \date 2014
+ */
+
+#include <stdlib.h>
+#include "DSTypes.h"
+#include "DSErrors.h"
+
+#ifndef __DS_THREAD_POOL__
+#define __DS_THREAD_POOL__
+
+#define M_DS_THREAD_POOL_NULL           M_DS_NULL ": Thread pool group is NULL"
+
+#ifdef __cplusplus
+__BEGIN_DECLS
+#endif
+
+/**
+ * \brief Opaque data type representing a set of tasks submitted to the
+ * thread pool that can be waited on as a unit.
+ */
+typedef struct ds_threadpool_group DSThreadPoolGroup;
+
+/**
+ * \brief Function prototype for tasks executed by the thread pool.
+ *
+ * \details This prototype is identical to the start routine of a pthread, so
+ * that the existing parallel workers can be submitted to the thread pool
+ * without modification.  The return value of the task is ignored.
+ */
+typedef void * (*DSThreadPoolFunction)(void *);
+
+/**
+ * \brief Function prototype for the functions run by each worker thread when
+ * it starts and when it exits.
+ *
+ * \details Libraries that keep per-thread state register a pair of these
+ * functions with DSThreadPoolAddThreadHooks, so that the state lives as long
+ * as the worker thread instead of being created by every task.
+ */
+typedef void (*DSThreadPoolThreadHook)(void);
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Thread pool configuration
+#endif
+
+extern void DSThreadPoolSetNumberOfThreads(const DSUInteger numberOfThreads);
+extern DSUInteger DSThreadPoolNumberOfThreads(void);
+extern DSInteger DSThreadPoolCurrentWorkerIndex(void);
+extern void DSThreadPoolShutdown(void);
+extern void DSThreadPoolAddThreadHooks(DSThreadPoolThreadHook begin, DSThreadPoolThreadHook end);
+
+#if defined (__APPLE__) && defined (__MACH__)
+#pragma mark - Task groups
+#endif
+
+extern DSThreadPoolGroup * DSThreadPoolGroupAlloc(void);
+extern void DSThreadPoolGroupFree(DSThreadPoolGroup * group);
+
+extern void DSThreadPoolGroupSubmit(DSThreadPoolGroup * group, DSThreadPoolFunction function, void * argument);
+extern void DSThreadPoolGroupWait(DSThreadPoolGroup * group);
+
+extern void DSThreadPoolRun(DSThreadPoolFunction function, void * arguments, const size_t argumentSize, const DSUInteger numberOfTasks);
+
+#ifdef __cplusplus
+__END_DECLS
+#endif
+
+#endif
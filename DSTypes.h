@@ -83,10 +83,36 @@ typedef unsigned int DSUInteger;
  * \see DSVertices.c
  */
 typedef struct {
-        double **vertices;           //!< Array of points represented by n floats.
+        double *vertices;            //!< Contiguous array with the coordinates of the points, one point per row.
         DSUInteger dimensions;       //!< Value indicating the dimensions of the points.
         DSUInteger numberOfVertices; //!< Value indicating the number of vertices.
+        DSUInteger capacity;         //!< Value indicating the number of points that fit in the array of coordinates.
+        DSUInteger hashTableSize;    //!< Value indicating the number of slots in the hash table, a power of two.
+        DSUInteger *hashTable;       //!< Hash table with the index plus one of each point, by grid cell, used to detect equal points.
 } DSVertices;
+
+/**
+ * \brief Data type representing a bounded convex polytope by its vertices and
+ * its vertex-facet incidence.
+ *
+ * \details The polytope is the intersection of a box with a set of
+ * half-spaces a*x + c >= 0.  Facets are numbered by the order of their
+ * half-spaces, followed by the lower and upper bounds of each coordinate.
+ * The incidence of each vertex is a bitset with the facets that contain the
+ * vertex.
+ *
+ * \see DSPolytope.h
+ * \see DSPolytope.c
+ */
+typedef struct {
+        DSUInteger dimensions;          //!< The number of coordinates of each vertex.
+        DSUInteger numberOfFacets;      //!< The number of half-spaces, including the bounds of the box.
+        double * halfSpaces;            //!< A numberOfFacets by dimensions+1 array with the coefficients and constant of each half-space.
+        DSUInteger numberOfVertices;    //!< The number of vertices of the polytope.
+        double * vertices;              //!< A numberOfVertices by dimensions array with the coordinates of the vertices.
+        DSUInteger numberOfWords;       //!< The number of words in the incidence bitset of each vertex.
+        unsigned long * incidence;      //!< A numberOfVertices by numberOfWords array with the incidence bitsets.
+} DSPolytope;
  
 /**
  * \brief Basic variable structure containing name, value and NSString with
@@ -156,6 +182,26 @@ typedef struct {
         pthread_mutex_t pushpop;        //!< The mutex used when pushing and popping data from the stack.
 } DSStack;
 
+/**
+ * \brief Set of case numbers stored as a bitset.
+ *
+ * \details The case set is used to store the case numbers of valid cases. Case
+ *          number n is represented by bit n-1, so membership tests and
+ *          insertions are constant time and do not allocate memory. Insertions
+ *          use atomic operations and are safe to perform concurrently without
+ *          locks. Iterating over the set always yields case numbers in
+ *          increasing order.
+ *
+ * \see DSCaseSet.h
+ * \see DSCaseSet.c
+ */
+typedef struct {
+        unsigned long * words;          //!< The array of words storing the bits of the set.
+        DSUInteger numberOfWords;       //!< The number of words in the words array.
+        DSUInteger maximumCaseNumber;   //!< The largest case number that can be stored in the set.
+        DSUInteger count;               //!< The number of case numbers in the set.
+} DSCaseSet;
+
 /**
  * \brief Data type used to lock different properties of the DSVariablePool.
  *
@@ -223,6 +269,38 @@ typedef struct dsexpression {
         struct dsexpression **branches;  //!< Array of expression nodes with children nodes.
 } DSExpression;
 
+/**
+ * \brief Data type representing one instruction of a compiled expression.
+ *
+ * \see DSExpressionProgram
+ */
+typedef struct {
+        int opcode;                      //!< Integer specifying the operation of the instruction.
+        DSUInteger argument;             //!< The slot, number of operands, function or subprogram used by the instruction.
+        double constant;                 //!< The value pushed by a constant instruction.
+} DSExpressionInstruction;
+
+/**
+ * \brief Data type representing a DSExpression compiled to a program for a
+ * stack machine.
+ *
+ * \details The variables of the expression are resolved once to slots, the
+ * indices of the variables in the DSVariablePool used to compile the
+ * expression, and the program is evaluated with an array of values in the
+ * order of that pool.  The arguments of the real and imag functions are
+ * compiled as subprograms, as they are always evaluated as complex numbers.
+ *
+ * \see DSExpressionProgramCompile
+ */
+typedef struct dsexpressionprogram {
+        DSUInteger numberOfInstructions;               //!< The number of instructions of the program.
+        DSExpressionInstruction *instructions;         //!< The array of instructions, in order of execution.
+        DSUInteger stackSize;                          //!< The largest number of values on the stack during evaluation.
+        DSUInteger numberOfSlots;                      //!< The number of values expected by the program.
+        DSUInteger numberOfSubprograms;                //!< The number of subprograms of the program.
+        struct dsexpressionprogram **subprograms;      //!< The programs evaluating the arguments of the real and imag functions.
+} DSExpressionProgram;
+
 /**
  * \brief Data type representing a symbolic matrix.
  *
@@ -252,6 +330,9 @@ typedef struct {
  * Thus, the matrix API should be independent of implementation, and hence
  * a new matrix library could be used if chosen.
  *
+ * The values are stored by row in a contiguous array, which is normally part
+ * of the same allocation as the matrix and its internal representation.
+ *
  * \see DSMatrix.h
  * \see DSMatrix.c
  */
@@ -259,8 +340,25 @@ typedef struct {
         void *mat;          //!< The pointer to the internal representation of the matrix.
         DSUInteger rows;    //!< A DSUInteger specifying the number of rows in the matrix.
         DSUInteger columns; //!< A DSUInteger specifying the number of columns in the matrix.
+        double *data;       //!< The pointer to the values of the matrix, stored by row.
 } DSMatrix;
 
+/**
+ * \brief Data type for a matrix that uses the values of another matrix or of
+ * an array without copying them.
+ *
+ * \details Views are usually declared on the stack, and are used as matrices
+ * through the pointer returned by DSMatrixViewOfRows or DSMatrixViewWithData.
+ * A view does not own its values, must not be freed with DSMatrixFree, and is
+ * only valid while the values it refers to are valid.
+ *
+ * \see DSMatrix.h
+ */
+typedef struct {
+        DSMatrix matrix;    //!< The matrix that refers to the values in view.
+        void *internal[6];  //!< Storage for the internal representation of the matrix.
+} DSMatrixView;
+
 
 /**
  * \brief Data type representing a matrix with complex values.
@@ -293,6 +391,43 @@ typedef struct {
 } DSMatrixArray;
 
 
+/**
+ * \brief Data type representing the pairwise conflicts between dominant term
+ * choices of a GMA-System.
+ *
+ * \details
+ * A choice is a dominant term of one side of one equation.  The choices of
+ * side i are numbered consecutively starting at offsets[i], and two choices
+ * conflict if the dominance conditions of both can never be satisfied
+ * simultaneously.  The table is a numberOfChoices by numberOfChoices matrix
+ * of flags; a choice that conflicts with itself can never be dominant.
+ */
+typedef struct {
+        DSUInteger numberOfChoices;   //!< A DSUInteger with the total number of terms of the GMA system.
+        DSUInteger *offsets;          //!< An array with the index of the first choice of each side of each equation.
+        char *conflicts;              //!< A numberOfChoices by numberOfChoices array of flags indicating conflicting choices.
+} DSGMATermConflicts;
+
+/**
+ * \brief Data type representing the nonzero exponents of the terms of a
+ * GMA-System.
+ *
+ * \details
+ * The terms of side i of the equations are numbered consecutively starting at
+ * offsets[i], as in DSGMATermConflicts.  The exponents of term t are stored in
+ * compressed sparse row format, in positions start[t] to start[t+1]-1 of the
+ * variables and exponents arrays.  A variable index below the number of
+ * dependent variables refers to Xd; larger indices refer to Xi, following the
+ * dependent variables.
+ */
+typedef struct {
+        DSUInteger numberOfTerms;     //!< A DSUInteger with the total number of terms of the GMA system.
+        DSUInteger *offsets;          //!< An array with the index of the first term of each side of each equation.
+        DSUInteger *start;            //!< An array with the position of the first nonzero exponent of each term, followed by the number of nonzero exponents.
+        DSUInteger *variables;        //!< An array with the variable index of each nonzero exponent.
+        double *exponents;            //!< An array with the value of each nonzero exponent.
+} DSGMATermExponents;
+
 /**
  * \brief Data type representing a GMA-System.
  *
@@ -302,6 +437,8 @@ typedef struct {
  * represented according to the Gs and Hs.  Also, matrices are split up 
  * relating to either dependent and independent parameters.  The GMA system
  * uses an array of matrices to represent all the terms in all of the equations.
+ * Once the system is created, its exponents are kept in termExponents, and
+ * the exponent matrices are only created when they are accessed.
  *
  */
 typedef struct {
@@ -316,6 +453,8 @@ typedef struct {
         DSVariablePool *Xd_t;    //!< A pointer to the DSVariablePool with the dynamic dependent variables.
         DSVariablePool *Xi;      //!< A pointer to the DSVariablePool with the all independent variables of the model.
         DSUInteger *signature;   //!< An array of DSUIntegers indicating the number of positive and negative terms for each equations as pairs of values.
+        DSGMATermConflicts *termConflicts; //!< The table of conflicting dominant terms, calculated when first needed.
+        DSGMATermExponents *termExponents; //!< The nonzero exponents of the terms, calculated when the system is created.
 } DSGMASystem;
 
 /**
@@ -335,6 +474,8 @@ typedef struct {
         DSMatrix *Hd;                  //!< A DSMatrix object with the exponent for the jth dependent variable of of the ith equations.
         DSMatrix *Hi;                  //!< A DSMatrix object with the exponent for the jth independent variable of the ith equations.
         DSMatrix *M;                   //!< A DSMatrix object with the inverse of the Ad matrix.
+        DSUInteger numberOfUpdates;    //!< The number of rank-one updates applied to M since it was last inverted.
+        double determinant;            //!< The determinant of the Ad matrix, kept up to date by the rank-one updates of M.
         DSVariablePool *Xd;            //!< A pointer to the DSVariablePool with the all dependent variables of the model.
         DSVariablePool *Xd_a;          //!< A pointer to the DSVariablePool with the algebraic dependent variables.
         DSVariablePool *Xd_t;          //!< A pointer to the DSVariablePool with the dynamic dependent variables.
@@ -360,6 +501,10 @@ typedef struct {
  * If the case is generated from a design space, then the design space is
  * responsible for freeing the Xi and Xd variable pools; otherwise the internal
  * S-System is responsible for freeing this data.
+ *
+ * \note A lazy case only has its signature, case number and condition
+ * matrices.  The S-System, boundary matrices and case identifier are
+ * calculated the first time they are accessed.
  */
 typedef struct {
         const DSVariablePool *Xd;         //!< A pointer to the DSVariablePool with the dependent variables.
@@ -375,11 +520,119 @@ typedef struct {
         DSUInteger *signature;            //!< The case signature indicating the dominant terms used to generate the case.
         char * caseIdentifier;            //!< A case identifier used to identify cases and subcases [will replace case number].
         bool freeVariables;               //!< Flag indicating if the Case object should free the dependent, algebraic and independent variables.
+        const DSGMASystem *pendingGMA;    //!< The GMA system used to complete the construction of a lazy case, or NULL if the case is complete.
+        const char *pendingPrefix;        //!< The prefix of the case identifier of a lazy case.
 } DSCase;
 
 
 typedef DSCase DSPseudoCase;
 
+/**
+ * \brief Data type with the number of cases decided by each stage of the
+ * validity screening.
+ *
+ * \details Cases are screened with simple arithmetic tests on their
+ * conditions before a linear problem is built.  Each counter is the number of
+ * cases decided by one test; cases that no test decides are counted as linear
+ * problems.
+ *
+ * \see DSCaseValidityScreeningCounters
+ */
+typedef struct {
+        DSUInteger zeroRows;              //!< Cases rejected by a condition without variables that is not satisfied.
+        DSUInteger opposingRows;          //!< Cases rejected by a pair of opposite conditions with incompatible constants.
+        DSUInteger knownPoint;            //!< Cases accepted because a previously found point satisfies their conditions.
+        DSUInteger linearProblems;        //!< Cases that were not decided by the screening and built a linear problem.
+} DSCaseScreeningCounters;
+
+/**
+ * \brief Data type representing a spatial index of cases used to find the
+ * cases that are valid at a point.
+ *
+ * \details The index stores the bounding box of the region of validity of
+ * each case in a packed binary tree of bounding boxes.  Each node covers a
+ * contiguous range of the ordered cases, and its children split the range at
+ * the median of the widest dimension.  Points are located by descending into
+ * the nodes that contain them, and the conditions of the cases in the leaves
+ * that are reached are evaluated exactly.  All coordinates are log10 values
+ * of the independent variables.
+ *
+ * \see DSCaseIndex.h
+ * \see DSCaseIndex.c
+ */
+typedef struct {
+        DSUInteger dimensions;            //!< The number of independent variables.
+        DSVariablePool * Xi;              //!< A variable pool with the independent variables, in the order of the coordinates.
+        DSUInteger numberOfCases;         //!< The number of cases in the index.
+        DSUInteger * caseNumbers;         //!< The case numbers, in the order of the leaves of the tree.
+        double * lower;                   //!< A numberOfCases by dimensions array with the lower corners of the bounding boxes.
+        double * upper;                   //!< A numberOfCases by dimensions array with the upper corners of the bounding boxes.
+        DSUInteger * conditions;          //!< An array with numberOfCases+1 offsets to the first condition of each case.
+        double * conditionValues;         //!< An array with the constant followed by the coefficients of each condition.
+        DSUInteger numberOfNodes;         //!< The number of nodes in the tree.
+        double * nodeLower;               //!< A numberOfNodes by dimensions array with the lower corners of the nodes.
+        double * nodeUpper;               //!< A numberOfNodes by dimensions array with the upper corners of the nodes.
+        DSUInteger * nodeFirst;           //!< The first case covered by each node.
+        DSUInteger * nodeCount;           //!< The number of cases covered by each node.
+        DSUInteger * nodeChildren;        //!< The two children of each node, 0 for leaves.
+} DSCaseIndex;
+
+/**
+ * \brief Data type representing an optimization function that has been parsed
+ * once and can be applied to many cases.
+ *
+ * \details The function is a power law, so its logarithm is a linear function
+ * of the log10 values of the dependent and independent variables.  The
+ * coefficients are stored in the order of the variable pools used to parse
+ * the function, which must be the dependent and independent variables of the
+ * cases it is applied to.  Dependent variables are eliminated for each case
+ * with the solution of its S-system.
+ *
+ * \see DSOptimizationFunctionByParsingString
+ */
+typedef struct {
+        DSMatrix * Od;                    //!< A 1 by |Xd| matrix with the exponents of the dependent variables.
+        DSMatrix * Oi;                    //!< A 1 by |Xi| matrix with the exponents of the independent variables.
+        double delta;                     //!< The log10 value of the constant of the function.
+        bool hasXd;                       //!< Indicates if the function has dependent variables.
+} DSOptimizationFunction;
+
+/**
+ * \brief Data type representing a linear problem of the form A*x <= b with
+ * bounded variables, independent of the package used to solve it.
+ *
+ * \details The coefficients, bounds and objective are stored in dense arrays,
+ * and are passed to a backend when the problem is solved.  Small problems
+ * are solved by a dense simplex method in the workspace of the problem, and
+ * larger problems by GLPK.  The arrays grow with the problem and are never
+ * shrunk, so a problem object reused for problems of similar size does not
+ * allocate memory.
+ *
+ * \see DSLinearProblem.h
+ * \see DSLinearProblem.c
+ */
+typedef struct {
+        DSUInteger numberOfRows;          //!< The number of constraints.
+        DSUInteger numberOfColumns;       //!< The number of variables.
+        DSUInteger rowCapacity;           //!< The number of constraints that fit in the arrays.
+        DSUInteger columnCapacity;        //!< The number of variables that fit in the arrays.
+        double * coefficients;            //!< A numberOfRows by numberOfColumns array with the coefficients A.
+        double * constants;               //!< The right hand side b of each constraint.
+        double * lower;                   //!< The lower bound of each variable, -INFINITY if it has none.
+        double * upper;                   //!< The upper bound of each variable, INFINITY if it has none.
+        double * objective;               //!< The objective coefficient of each variable.
+        double objectiveConstant;         //!< The constant term of the objective.
+        bool maximize;                    //!< Indicates if the objective is maximized instead of minimized.
+        DSUInteger status;                //!< The status of the last solution.
+        double objectiveValue;            //!< The value of the objective at the last solution.
+        double * solution;                //!< The value of each variable at the last solution.
+        double * workspace;               //!< The floating point workspace of the dense simplex method.
+        DSUInteger workspaceSize;         //!< The number of values that fit in the workspace.
+        int * indices;                    //!< The integer workspace of the dense simplex method and of GLPK.
+        DSUInteger indicesSize;           //!< The number of values that fit in the integer workspace.
+        void * glpkProblem;               //!< The GLPK problem object, created when a problem is first solved by GLPK.
+} DSLinearProblem;
+
 typedef struct {
 //        DSExpression *** fluxEquations;
 //        DSUInteger * numberOfFluxes;
@@ -407,7 +660,7 @@ typedef struct {
         const DSVariablePool *Xd;        //!< A pointer to the DSVariablePool with the dependent variables.
         const DSVariablePool *Xd_a;      //!< A pointer to the DSVariablePool with the algebraic dependent variables.
         const DSVariablePool *Xi;        //!< A pointer to the DSVariablePool with the independent variables.
-        DSDictionary * validCases;       //!< DSVariablePool with case number that are valid.
+        DSCaseSet * validCases;          //!< DSCaseSet with case number that are valid.
         DSUInteger numberOfCases;        //!< DSUInteger indicating the maximum number of cases in the design space.
         DSMatrix * Cd, *Ci, *delta;      //!< Condition matrices.
         DSDictionary *cyclicalCases;     //!< DSDictionary containing design space objects with subcases.
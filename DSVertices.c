@@ -28,6 +28,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <math.h>
 #include "DSVertices.h"
 #include "DSErrors.h"
@@ -37,6 +38,29 @@
 #include "DSMatrixArray.h"
 #include "DSVariable.h"
 
+/**
+ * \brief The coordinates of a vertex in the contiguous array of a DSVertices
+ * object.
+ */
+#define dsVerticesVertex(x, i)          ((x)->vertices+(i)*(x)->dimensions)
+
+/**
+ * \brief The size of the grid cells used to hash vertices.
+ *
+ * \details The cells are much larger than DS_VERTICES_TOLERANCE, so that two
+ * vertices within the tolerance are almost always in the same cell; the
+ * neighboring cell is only searched for coordinates close to the edge of
+ * their cell.
+ */
+#define DS_VERTICES_HASH_CELL           1E-10
+
+/**
+ * \brief The largest number of coordinates close to the edge of their cell
+ * for which the neighboring cells are searched; beyond this number all
+ * vertices are compared.
+ */
+#define DS_VERTICES_HASH_NEIGHBORS      8
+
 extern DSVertices * DSVerticesAlloc(const DSUInteger dimensions)
 {
         DSVertices *vertices = NULL;
@@ -47,26 +71,174 @@ extern DSVertices * DSVerticesAlloc(const DSUInteger dimensions)
 
 extern void DSVerticesFree(DSVertices *vertices)
 {
-        DSUInteger i;
         if (vertices == NULL) {
                 DSError(M_DS_VERTICES_NULL, A_DS_ERROR);
                 goto bail;
         }
-        if (vertices->numberOfVertices != 0) {
-                for (i = 0; i < vertices->numberOfVertices; i++) {
-                        DSSecureFree(vertices->vertices[i]);
-                }
+        if (vertices->vertices != NULL)
                 DSSecureFree(vertices->vertices);
-        }
+        if (vertices->hashTable != NULL)
+                DSSecureFree(vertices->hashTable);
         DSSecureFree(vertices);
 bail:
         return;
 }
 
-extern const bool DSVerticesAddVertex(DSVertices *vertices, const double * coordinates)
+/**
+ * \brief Exchanges the vertices of two DSVertices objects.
+ */
+static void dsVerticesSwap(DSVertices * vert1, DSVertices * vert2)
+{
+        DSVertices temp = *vert1;
+        *vert1 = *vert2;
+        *vert2 = temp;
+}
+
+/**
+ * \brief Calculates the grid cell of a coordinate.
+ *
+ * \details The cell is rounded to the nearest integer so that coordinates on
+ * round numbers, such as zero, are in the middle of their cell.  The
+ * neighbor is set to -1 or 1 if the coordinate is close enough to the lower or
+ * upper edge of the cell that a vertex within tolerance may be in the
+ * neighboring cell, and 0 otherwise.
+ */
+static double dsVerticesHashCell(const double coordinate, int * neighbor)
+{
+        double scaled, cell, offset;
+        scaled = coordinate/DS_VERTICES_HASH_CELL+0.5;
+        cell = floor(scaled);
+        offset = (scaled-cell)*DS_VERTICES_HASH_CELL;
+        *neighbor = 0;
+        if (offset < 4*DS_VERTICES_TOLERANCE)
+                *neighbor = -1;
+        else if (DS_VERTICES_HASH_CELL-offset < 4*DS_VERTICES_TOLERANCE)
+                *neighbor = 1;
+        return cell;
+}
+
+static unsigned long long dsVerticesHashCells(const double * cells, const DSUInteger dimensions)
+{
+        DSUInteger i;
+        unsigned long long hash = 14695981039346656037ULL, key;
+        for (i = 0; i < dimensions; i++) {
+                if (fabs(cells[i]) < 4E18)
+                        key = (unsigned long long)(long long)cells[i];
+                else
+                        memcpy(&key, cells+i, sizeof(key));
+                hash = (hash ^ key)*1099511628211ULL;
+                hash ^= hash >> 29;
+        }
+        return hash;
+}
+
+static bool dsVerticesCoordinatesAreEqual(const double * coordinates1, const double * coordinates2, const DSUInteger dimensions)
+{
+        DSUInteger j;
+        for (j = 0; j < dimensions; j++) {
+                if (fabs(coordinates1[j] - coordinates2[j]) >= DS_VERTICES_TOLERANCE)
+                        break;
+        }
+        return (j == dimensions);
+}
+
+/**
+ * \brief Inserts the index of a vertex in the hash table.
+ */
+static void dsVerticesHashInsert(DSVertices * vertices, const DSUInteger index, const unsigned long long hash)
+{
+        DSUInteger slot = (DSUInteger)(hash & (vertices->hashTableSize-1));
+        while (vertices->hashTable[slot] != 0)
+                slot = (slot+1) & (vertices->hashTableSize-1);
+        vertices->hashTable[slot] = index+1;
+}
+
+/**
+ * \brief Doubles the size of the hash table and inserts all vertices again.
+ */
+static void dsVerticesHashGrow(DSVertices * vertices, double * cells)
 {
         DSUInteger i, j;
+        int neighbor;
+        if (vertices->hashTable != NULL)
+                DSSecureFree(vertices->hashTable);
+        vertices->hashTableSize = (vertices->hashTableSize == 0) ? 16 : 2*vertices->hashTableSize;
+        vertices->hashTable = DSSecureCalloc(sizeof(DSUInteger), vertices->hashTableSize);
+        for (i = 0; i < vertices->numberOfVertices; i++) {
+                for (j = 0; j < vertices->dimensions; j++)
+                        cells[j] = dsVerticesHashCell(dsVerticesVertex(vertices, i)[j], &neighbor);
+                dsVerticesHashInsert(vertices, i, dsVerticesHashCells(cells, vertices->dimensions));
+        }
+}
+
+/**
+ * \brief Searches the hash table for a vertex within tolerance of some
+ * coordinates.
+ *
+ * \details The cell of the coordinates is searched first, followed by every
+ * combination of neighboring cells along the dimensions where the coordinates
+ * are close to the edge of their cell.  If there are too many such dimensions
+ * every vertex is compared.
+ *
+ * \return A boolean value indicating if an equal vertex was found.  The hash
+ *         of the cell of the coordinates is stored in the hash argument.
+ */
+static bool dsVerticesHashContains(const DSVertices * vertices, const double * coordinates, double * cells, unsigned long long * hash)
+{
+        bool contains = false;
+        DSUInteger i, j, slot, mask, numberOfNeighbors = 0;
+        DSUInteger neighborIndices[DS_VERTICES_HASH_NEIGHBORS];
+        int neighbors[DS_VERTICES_HASH_NEIGHBORS], neighbor;
+        for (j = 0; j < vertices->dimensions; j++) {
+                cells[j] = dsVerticesHashCell(coordinates[j], &neighbor);
+                if (neighbor == 0)
+                        continue;
+                if (numberOfNeighbors < DS_VERTICES_HASH_NEIGHBORS) {
+                        neighborIndices[numberOfNeighbors] = j;
+                        neighbors[numberOfNeighbors] = neighbor;
+                }
+                numberOfNeighbors++;
+        }
+        *hash = dsVerticesHashCells(cells, vertices->dimensions);
+        if (numberOfNeighbors > DS_VERTICES_HASH_NEIGHBORS) {
+                for (i = 0; i < vertices->numberOfVertices && contains == false; i++)
+                        contains = dsVerticesCoordinatesAreEqual(dsVerticesVertex(vertices, i), coordinates, vertices->dimensions);
+                goto bail;
+        }
+        for (mask = 0; mask < (1U << numberOfNeighbors) && contains == false; mask++) {
+                for (i = 0; i < numberOfNeighbors; i++)
+                        cells[neighborIndices[i]] += ((mask >> i) & 1) ? neighbors[i] : 0;
+                slot = (DSUInteger)(((mask == 0) ? *hash : dsVerticesHashCells(cells, vertices->dimensions)) & (vertices->hashTableSize-1));
+                while (vertices->hashTable[slot] != 0 && contains == false) {
+                        contains = dsVerticesCoordinatesAreEqual(dsVerticesVertex(vertices, vertices->hashTable[slot]-1), coordinates, vertices->dimensions);
+                        slot = (slot+1) & (vertices->hashTableSize-1);
+                }
+                for (i = 0; i < numberOfNeighbors; i++)
+                        cells[neighborIndices[i]] -= ((mask >> i) & 1) ? neighbors[i] : 0;
+        }
+bail:
+        return contains;
+}
+
+/**
+ * \brief Adds a vertex to a DSVertices object, unless an equal vertex has
+ * already been added.
+ *
+ * \details Two vertices are equal if all their coordinates differ by less
+ * than DS_VERTICES_TOLERANCE.  Equal vertices are found through a hash table
+ * of the grid cells of the vertices, so adding n vertices takes O(n) time.
+ * The coordinates are stored in a contiguous array that grows geometrically.
+ *
+ * \param vertices The DSVertices object where the vertex is added.
+ * \param coordinates An array with the coordinates of the vertex.
+ *
+ * \return A boolean value indicating if the vertex was added.
+ */
+extern const bool DSVerticesAddVertex(DSVertices *vertices, const double * coordinates)
+{
         bool isSuccess = false;
+        double * cells = NULL;
+        unsigned long long hash;
         if (vertices == NULL) {
                 DSError(M_DS_VERTICES_NULL, A_DS_ERROR);
                 goto bail;
@@ -75,29 +247,29 @@ extern const bool DSVerticesAddVertex(DSVertices *vertices, const double * coord
                 DSError(M_DS_NULL ": Array of coordinates is NULL", A_DS_ERROR);
                 goto bail;
         }
-        for (i = 0; i < vertices->numberOfVertices; i++) {
-                for (j = 0; j < vertices->dimensions; j++) {
-                        if (fabs(vertices->vertices[i][j] - coordinates[j]) >= 1E-14)
-                                break;
-                        
-                }
-                if (j == vertices->dimensions)
-                        break;
-        }
-        if (i == vertices->numberOfVertices) {
-                isSuccess = true;
-                if (vertices->numberOfVertices == 0) {
-                        vertices->vertices = DSSecureMalloc(sizeof(double*)*1);
+        if (vertices->dimensions == 0)
+                goto bail;
+        cells = DSSecureMalloc(sizeof(double)*vertices->dimensions);
+        if (2*(vertices->numberOfVertices+1) > vertices->hashTableSize)
+                dsVerticesHashGrow(vertices, cells);
+        if (dsVerticesHashContains(vertices, coordinates, cells, &hash) == true)
+                goto bail;
+        if (vertices->numberOfVertices == vertices->capacity) {
+                if (vertices->capacity == 0) {
+                        vertices->capacity = 8;
+                        vertices->vertices = DSSecureMalloc(sizeof(double)*vertices->dimensions*vertices->capacity);
                 } else {
-                        vertices->vertices = DSSecureRealloc(vertices->vertices, sizeof(double*)*(vertices->numberOfVertices+1));
+                        vertices->capacity *= 2;
+                        vertices->vertices = DSSecureRealloc(vertices->vertices, sizeof(double)*vertices->dimensions*vertices->capacity);
                 }
-                vertices->vertices[vertices->numberOfVertices] = DSSecureMalloc(sizeof(double)*vertices->dimensions);
-                for (i = 0; i < vertices->dimensions; i++) {
-                        vertices->vertices[vertices->numberOfVertices][i] = coordinates[i];
-                }
-                vertices->numberOfVertices++;
         }
+        memcpy(dsVerticesVertex(vertices, vertices->numberOfVertices), coordinates, sizeof(double)*vertices->dimensions);
+        dsVerticesHashInsert(vertices, vertices->numberOfVertices, hash);
+        vertices->numberOfVertices++;
+        isSuccess = true;
 bail:
+        if (cells != NULL)
+                DSSecureFree(cells);
         return isSuccess;
 }
 
@@ -120,7 +292,7 @@ extern const bool DSVerticesAreEqual(const DSVertices *vert1, const DSVertices *
         areEqual = true;
         for (i = 0; i < vert1->numberOfVertices; i++) {
                 for (j = 0; j < vert1->dimensions; j++) {
-                        if (fabs(vert1->vertices[i][j] - vert1->vertices[i][j]) >= 1E-14)
+                        if (fabs(dsVerticesVertex(vert1, i)[j] - dsVerticesVertex(vert1, i)[j]) >= 1E-14)
                                 break;
                 }
                 if (j != vert1->dimensions)
@@ -143,7 +315,7 @@ extern const double * DSVerticesVertexAtIndex(const DSVertices *vertices, const
                 DSError(M_DS_WRONG ": Index out of range", A_DS_ERROR);
                 goto bail;
         }
-        vertex = vertices->vertices[index];
+        vertex = dsVerticesVertex(vertices, index);
 bail:
         return vertex;
 }
@@ -165,8 +337,8 @@ static double dsVertices2DSlope(const DSVertices * vertices, const DSUInteger po
                 goto bail;
         }
 
-        subX = (vertices->vertices[pointA][0]-vertices->vertices[pointB][0]);
-        subY = (vertices->vertices[pointA][1]-vertices->vertices[pointB][1]);
+        subX = (dsVerticesVertex(vertices, pointA)[0]-dsVerticesVertex(vertices, pointB)[0]);
+        subY = (dsVerticesVertex(vertices, pointA)[1]-dsVerticesVertex(vertices, pointB)[1]);
         if (subX == 0)
                 m = INFINITY;
         else
@@ -181,7 +353,6 @@ extern void DSVerticesOrder2DVertices(DSVertices *vertices)
         DSUInteger i, current;
         DSUInteger start, indexMinX = 0, indexMinY = 0;
         DSUInteger indexMaxX = 0, indexMaxY = 0;
-        double ** allVertices;
         if (vertices == NULL) {
                 DSError(M_DS_VERTICES_NULL, A_DS_ERROR);
                 goto bail;
@@ -193,15 +364,14 @@ extern void DSVerticesOrder2DVertices(DSVertices *vertices)
         if (vertices->numberOfVertices == 0) {
                 goto bail;
         }
-        allVertices = vertices->vertices;
         for (i = 1; i < vertices->numberOfVertices; i++) {
-                indexMinX = (allVertices[i][0] <= allVertices[indexMinX][0]) ? i : indexMinX;
-                indexMaxX = (allVertices[i][0] > allVertices[indexMaxX][0]) ? i : indexMaxX;
-                indexMinY = (allVertices[i][1] <= allVertices[indexMinY][1]) ? i : indexMinY;
-                indexMaxY = (allVertices[i][1] > allVertices[indexMaxY][1]) ? i : indexMaxY;
+                indexMinX = (dsVerticesVertex(vertices, i)[0] <= dsVerticesVertex(vertices, indexMinX)[0]) ? i : indexMinX;
+                indexMaxX = (dsVerticesVertex(vertices, i)[0] > dsVerticesVertex(vertices, indexMaxX)[0]) ? i : indexMaxX;
+                indexMinY = (dsVerticesVertex(vertices, i)[1] <= dsVerticesVertex(vertices, indexMinY)[1]) ? i : indexMinY;
+                indexMaxY = (dsVerticesVertex(vertices, i)[1] > dsVerticesVertex(vertices, indexMaxY)[1]) ? i : indexMaxY;
         }
         newVertices = DSVerticesAlloc(2);
-        DSVerticesAddVertex(newVertices, allVertices[indexMaxX]);
+        DSVerticesAddVertex(newVertices, dsVerticesVertex(vertices, indexMaxX));
         current = indexMaxX;
         start = indexMaxX;
         while (current != indexMinY) {
@@ -211,12 +381,12 @@ extern void DSVerticesOrder2DVertices(DSVertices *vertices)
                 for (i = 0; i < vertices->numberOfVertices; i++) {
                         if (i == current)
                                 continue;
-                        if (allVertices[i][1] >= allVertices[current][1])
+                        if (dsVerticesVertex(vertices, i)[1] >= dsVerticesVertex(vertices, current)[1])
                                 continue;
                         indexMaxX = (fabs(dsVertices2DSlope(vertices, indexMaxX, current)) < fabs(dsVertices2DSlope(vertices, i, current))) ? i : indexMaxX;
                 }
                 current = indexMaxX;
-                if (DSVerticesAddVertex(newVertices, allVertices[current]) == 0)
+                if (DSVerticesAddVertex(newVertices, dsVerticesVertex(vertices, current)) == 0)
                         break;
         }
         while (current != indexMinX) {
@@ -226,13 +396,13 @@ extern void DSVerticesOrder2DVertices(DSVertices *vertices)
                 for (i = 0; i < vertices->numberOfVertices; i++) {
                         if (i == current)
                                 continue;
-                        if (allVertices[i][0] >= allVertices[current][0])
+                        if (dsVerticesVertex(vertices, i)[0] >= dsVerticesVertex(vertices, current)[0])
                                 continue;
                         indexMinY = (fabs(dsVertices2DSlope(vertices, indexMinY, current)) > fabs(dsVertices2DSlope(vertices, i, current))) ? i : indexMinY;
 
                 }
                 current = indexMinY;
-                if (DSVerticesAddVertex(newVertices, allVertices[current]) == 0)
+                if (DSVerticesAddVertex(newVertices, dsVerticesVertex(vertices, current)) == 0)
                         break;
         }
         while (current != indexMaxY) {
@@ -242,13 +412,13 @@ extern void DSVerticesOrder2DVertices(DSVertices *vertices)
                 for (i = 0; i < vertices->numberOfVertices; i++) {
                         if (i == current)
                                 continue;
-                        if (allVertices[i][1] <= allVertices[current][1])
+                        if (dsVerticesVertex(vertices, i)[1] <= dsVerticesVertex(vertices, current)[1])
                                 continue;
                         indexMinX = (fabs(dsVertices2DSlope(vertices, indexMinX, current)) < fabs(dsVertices2DSlope(vertices, i, current))) ? i : indexMinX;
 
                 }
                 current = indexMinX;
-                if (DSVerticesAddVertex(newVertices, allVertices[current]) == 0)
+                if (DSVerticesAddVertex(newVertices, dsVerticesVertex(vertices, current)) == 0)
                         break;
         }
         while (current != start) {
@@ -258,23 +428,108 @@ extern void DSVerticesOrder2DVertices(DSVertices *vertices)
                 for (i = 0; i < vertices->numberOfVertices; i++) {
                         if (i == current)
                                 continue;
-                        if (allVertices[i][0] <= allVertices[current][0])
+                        if (dsVerticesVertex(vertices, i)[0] <= dsVerticesVertex(vertices, current)[0])
                                 continue;
                         indexMaxY = (fabs(dsVertices2DSlope(vertices, indexMaxY, current)) > fabs(dsVertices2DSlope(vertices, i, current))) ? i : indexMaxY;
 
                 }
                 current = indexMaxY;
-                if (DSVerticesAddVertex(newVertices, allVertices[current]) == 0)
+                if (DSVerticesAddVertex(newVertices, dsVerticesVertex(vertices, current)) == 0)
                         break;
         }
-        vertices->vertices = newVertices->vertices;
-        newVertices->vertices = allVertices;
-        vertices->numberOfVertices = newVertices->numberOfVertices;
+        dsVerticesSwap(vertices, newVertices);
         DSVerticesFree(newVertices);
 bail:
         return;
 }
 
+/**
+ * \brief Creates the vertices of the intersection of a rectangle and a set of
+ * half-planes.
+ *
+ * \details The rectangle is clipped by one half-plane at a time with the
+ * Sutherland-Hodgman algorithm.  Each half-plane is of the form
+ * a*x + b*y + c >= 0, where [a b] is a row of the coefficient matrix and c is
+ * the corresponding row of the constants.  Clipping a convex polygon by a
+ * half-plane adds at most one vertex, so the polygon never has more than
+ * four vertices plus one for each half-plane.  The vertices are returned in
+ * counter-clockwise order and no linear problem is solved.
+ *
+ * \param coefficients A DSMatrix with two columns and one row per half-plane.
+ * \param constants A DSMatrix with one column and one row per half-plane.
+ * \param lower An array with the lower bounds of x and y.
+ * \param upper An array with the upper bounds of x and y.
+ *
+ * \return A new DSVertices object with the vertices of the intersection,
+ *         which has no vertices if the intersection is empty.
+ */
+extern DSVertices * DSVertices2DFromHalfPlanes(const DSMatrix * coefficients, const DSMatrix * constants, const double * lower, const double * upper)
+{
+        DSVertices * vertices = NULL;
+        DSUInteger i, j, numberOfHalfPlanes, numberOfPoints, numberOfClipped;
+        double * points = NULL, * clipped = NULL, * swap;
+        double a, b, c, current, next, t;
+        if (coefficients == NULL || constants == NULL) {
+                DSError(M_DS_MAT_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        if (lower == NULL || upper == NULL) {
+                DSError(M_DS_NULL ": Array of bounds is NULL", A_DS_ERROR);
+                goto bail;
+        }
+        if (DSMatrixColumns(coefficients) != 2 || DSMatrixRows(coefficients) != DSMatrixRows(constants)) {
+                DSError(M_DS_WRONG ": Half-planes must have two coefficients and one constant", A_DS_ERROR);
+                goto bail;
+        }
+        numberOfHalfPlanes = DSMatrixRows(coefficients);
+        vertices = DSVerticesAlloc(2);
+        points = DSSecureMalloc(sizeof(double)*2*(numberOfHalfPlanes+4));
+        clipped = DSSecureMalloc(sizeof(double)*2*(numberOfHalfPlanes+4));
+        points[0] = lower[0];
+        points[1] = lower[1];
+        points[2] = upper[0];
+        points[3] = lower[1];
+        points[4] = upper[0];
+        points[5] = upper[1];
+        points[6] = lower[0];
+        points[7] = upper[1];
+        numberOfPoints = 4;
+        for (i = 0; i < numberOfHalfPlanes && numberOfPoints > 0; i++) {
+                a = DSMatrixDoubleValue(coefficients, i, 0);
+                b = DSMatrixDoubleValue(coefficients, i, 1);
+                c = DSMatrixDoubleValue(constants, i, 0);
+                numberOfClipped = 0;
+                for (j = 0; j < numberOfPoints; j++) {
+                        current = a*points[2*j] + b*points[2*j+1] + c;
+                        next = a*points[2*((j+1)%numberOfPoints)] + b*points[2*((j+1)%numberOfPoints)+1] + c;
+                        if (current >= 0) {
+                                clipped[2*numberOfClipped] = points[2*j];
+                                clipped[2*numberOfClipped+1] = points[2*j+1];
+                                numberOfClipped++;
+                        }
+                        if ((current >= 0) != (next >= 0)) {
+                                t = current/(current-next);
+                                clipped[2*numberOfClipped] = points[2*j] + t*(points[2*((j+1)%numberOfPoints)]-points[2*j]);
+                                clipped[2*numberOfClipped+1] = points[2*j+1] + t*(points[2*((j+1)%numberOfPoints)+1]-points[2*j+1]);
+                                numberOfClipped++;
+                        }
+                }
+                swap = points;
+                points = clipped;
+                clipped = swap;
+                numberOfPoints = numberOfClipped;
+        }
+        /** Coincident vertices are merged when they are added **/
+        for (j = 0; j < numberOfPoints; j++)
+                DSVerticesAddVertex(vertices, points+2*j);
+bail:
+        if (points != NULL)
+                DSSecureFree(points);
+        if (clipped != NULL)
+                DSSecureFree(clipped);
+        return vertices;
+}
+
 extern void DSVerticesPrint(const DSVertices *vertices)
 {
         int (*print)(const char *, ...);
@@ -289,7 +544,7 @@ extern void DSVerticesPrint(const DSVertices *vertices)
                 print = DSPrintf;
         for (i = 0; i < vertices->numberOfVertices; i++) {
                 for (j = 0; j < vertices->dimensions; j++) {
-                        print("%lf\t", vertices->vertices[i][j]);
+                        print("%lf\t", dsVerticesVertex(vertices, i)[j]);
                 }
                 print("\n");
         }
@@ -299,8 +554,8 @@ bail:
 
 extern DSMatrix * DSVerticesToMatrix(const DSVertices * vertices)
 {
-        DSUInteger i, j;
         DSMatrix * matrix = NULL;
+        double * data;
         if (vertices == NULL) {
                 DSError(M_DS_VERTICES_NULL, A_DS_ERROR);
                 goto exit;
@@ -313,16 +568,64 @@ extern DSMatrix * DSVerticesToMatrix(const DSVertices * vertices)
                 DSError(M_DS_WRONG ": Vertices dimensions are 0", A_DS_ERROR);
                 goto exit;
         }
-        matrix = DSMatrixAlloc(vertices->numberOfVertices, vertices->dimensions);
-        for (i = 0; i < vertices->numberOfVertices; i++) {
-                for (j = 0; j < vertices->dimensions; j++) {
-                        DSMatrixSetDoubleValue(matrix, i, j, vertices->vertices[i][j]);
-                }
+        data = DSSecureMalloc(sizeof(double)*vertices->numberOfVertices*vertices->dimensions);
+        memcpy(data, vertices->vertices, sizeof(double)*vertices->numberOfVertices*vertices->dimensions);
+        matrix = DSMatrixWithData(vertices->numberOfVertices, vertices->dimensions, data);
+exit:
+        return matrix;
+}
+
+/**
+ * \brief Creates a matrix with the vertices of a DSVertices object and frees
+ * the object.
+ *
+ * \details The contiguous array of coordinates becomes the data of the
+ * matrix, with one vertex per row, so the coordinates are not copied.
+ *
+ * \param vertices The DSVertices object that is converted to a matrix.  The
+ *        object is freed, and must not be used after calling this function.
+ *
+ * \return A new DSMatrix with the vertices, or NULL if there are no vertices.
+ */
+extern DSMatrix * DSVerticesFreeToMatrix(DSVertices * vertices)
+{
+        DSMatrix * matrix = NULL;
+        if (vertices == NULL) {
+                DSError(M_DS_VERTICES_NULL, A_DS_ERROR);
+                goto exit;
+        }
+        if (vertices->numberOfVertices == 0 || vertices->dimensions == 0) {
+                DSError(M_DS_WRONG ": Vertices are empty", A_DS_ERROR);
+                DSVerticesFree(vertices);
+                goto exit;
         }
+        if (vertices->capacity > vertices->numberOfVertices)
+                vertices->vertices = DSSecureRealloc(vertices->vertices, sizeof(double)*vertices->numberOfVertices*vertices->dimensions);
+        matrix = DSMatrixWithData(vertices->numberOfVertices, vertices->dimensions, vertices->vertices);
+        vertices->vertices = NULL;
+        DSVerticesFree(vertices);
 exit:
         return matrix;
 }
 
+/**
+ * \brief Returns the contiguous array with the coordinates of the vertices.
+ *
+ * \details The array has one row of dimensions coordinates per vertex, and is
+ * owned by the DSVertices object.
+ */
+extern const double * DSVerticesCoordinates(const DSVertices * vertices)
+{
+        const double * coordinates = NULL;
+        if (vertices == NULL) {
+                DSError(M_DS_VERTICES_NULL, A_DS_ERROR);
+                goto bail;
+        }
+        coordinates = vertices->vertices;
+bail:
+        return coordinates;
+}
+
 extern DSMatrix * DSVertices3DConnectivityMatrix(const DSVertices *vertices, const DSCase * aCase, const DSVariablePool * lower, const DSVariablePool * upper, DSUInteger xIndex, DSUInteger yIndex, DSUInteger zIndex)
 {
         DSMatrix * connectivity = NULL, *boundary1, *boundary2;
@@ -353,11 +656,11 @@ extern DSMatrix * DSVertices3DConnectivityMatrix(const DSVertices *vertices, con
                         DSVariablePoolSetValueForVariableWithName(Xi, name, log10(DSVariablePoolValueForVariableWithName(lower, name)));
                 }
                 name = DSVariableName(DSVariablePoolVariableAtIndex(Xi, xIndex));
-                DSVariablePoolSetValueForVariableWithName(Xi, name, vertices->vertices[i][0]);
+                DSVariablePoolSetValueForVariableWithName(Xi, name, dsVerticesVertex(vertices, i)[0]);
                 name = DSVariableName(DSVariablePoolVariableAtIndex(Xi, yIndex));
-                DSVariablePoolSetValueForVariableWithName(Xi, name, vertices->vertices[i][1]);
+                DSVariablePoolSetValueForVariableWithName(Xi, name, dsVerticesVertex(vertices, i)[1]);
                 name = DSVariableName(DSVariablePoolVariableAtIndex(Xi, zIndex));
-                DSVariablePoolSetValueForVariableWithName(Xi, name, vertices->vertices[i][2]);
+                DSVariablePoolSetValueForVariableWithName(Xi, name, dsVerticesVertex(vertices, i)[2]);
                 boundary1 = DSCaseDoubleValueBoundariesAtPoint(aCase, Xi);
                 boundary2 = DSMatrixAlloc(DSMatrixRows(boundary1)+2*numberOfFreeVariables,
                                           1);
@@ -456,11 +759,11 @@ DSMatrixArray * DSVertices3DFaces(const DSVertices *vertices, const DSCase * aCa
                         DSVariablePoolSetValueForVariableWithName(Xi, name, log10(DSVariablePoolValueForVariableWithName(lower, name)));
                 }
                 name = DSVariableName(DSVariablePoolVariableAtIndex(Xi, xIndex));
-                DSVariablePoolSetValueForVariableWithName(Xi, name, vertices->vertices[i][0]);
+                DSVariablePoolSetValueForVariableWithName(Xi, name, dsVerticesVertex(vertices, i)[0]);
                 name = DSVariableName(DSVariablePoolVariableAtIndex(Xi, yIndex));
-                DSVariablePoolSetValueForVariableWithName(Xi, name, vertices->vertices[i][1]);
+                DSVariablePoolSetValueForVariableWithName(Xi, name, dsVerticesVertex(vertices, i)[1]);
                 name = DSVariableName(DSVariablePoolVariableAtIndex(Xi, zIndex));
-                DSVariablePoolSetValueForVariableWithName(Xi, name, vertices->vertices[i][2]);
+                DSVariablePoolSetValueForVariableWithName(Xi, name, dsVerticesVertex(vertices, i)[2]);
                 boundary1 = DSCaseDoubleValueBoundariesAtPoint(aCase, Xi);
                 boundary2 = DSMatrixAlloc(DSMatrixRows(boundary1)+2*numberOfFreeVariables,
                                           1);
@@ -542,9 +845,9 @@ DSMatrixArray * DSVertices3DFaces(const DSVertices *vertices, const DSCase * aCa
                 face = DSMatrixAlloc(numberOfVertices+1, vertices->dimensions);
                 l = 0;
                 do {
-                        DSMatrixSetDoubleValue(face, l, 0, vertices->vertices[indices[j]][0]);
-                        DSMatrixSetDoubleValue(face, l, 1, vertices->vertices[indices[j]][1]);
-                        DSMatrixSetDoubleValue(face, l, 2, vertices->vertices[indices[j]][2]);
+                        DSMatrixSetDoubleValue(face, l, 0, dsVerticesVertex(vertices, indices[j])[0]);
+                        DSMatrixSetDoubleValue(face, l, 1, dsVerticesVertex(vertices, indices[j])[1]);
+                        DSMatrixSetDoubleValue(face, l, 2, dsVerticesVertex(vertices, indices[j])[2]);
                         l++;
                         for (k = 0; k < numberOfVertices; k++) {
                                 if (k == j)
@@ -558,9 +861,9 @@ DSMatrixArray * DSVertices3DFaces(const DSVertices *vertices, const DSCase * aCa
                                 break;
                         }
                 } while (j != 0 && numberOfVertices != 2);
-                DSMatrixSetDoubleValue(face, l, 0, vertices->vertices[indices[j]][0]);
-                DSMatrixSetDoubleValue(face, l, 1, vertices->vertices[indices[j]][1]);
-                DSMatrixSetDoubleValue(face, l, 2, vertices->vertices[indices[j]][2]);
+                DSMatrixSetDoubleValue(face, l, 0, dsVerticesVertex(vertices, indices[j])[0]);
+                DSMatrixSetDoubleValue(face, l, 1, dsVerticesVertex(vertices, indices[j])[1]);
+                DSMatrixSetDoubleValue(face, l, 2, dsVerticesVertex(vertices, indices[j])[2]);
                 l++;
                 DSMatrixArrayAddMatrix(faces, face);
                 DSSecureFree(indices);
@@ -597,7 +900,7 @@ extern DSMatrix * DSVerticesConnectivityMatrix(const DSVertices *vertices, const
         for (i = 0; i < vertices->numberOfVertices; i++) {
                 for (j = 0; j < vertices->dimensions; j++) {
                         name = DSVariableName(DSVariablePoolVariableAtIndex(Xi, j));
-                        DSVariablePoolSetValueForVariableWithName(Xi, name, vertices->vertices[i][j]);
+                        DSVariablePoolSetValueForVariableWithName(Xi, name, dsVerticesVertex(vertices, i)[j]);
                         if (DSVariablePoolValueForVariableWithName(lower, name) != DSVariablePoolValueForVariableWithName(upper, name)) {
                                 if (i == 0) {
                                         numberOfFreeVariables++;
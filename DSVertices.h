@@ -33,6 +33,12 @@
 
 #define M_DS_VERTICES_NULL M_DS_NULL ": Vertices object is NULL"
 
+/**
+ * \brief The largest difference between the coordinates of two vertices that
+ * are considered equal.
+ */
+#define DS_VERTICES_TOLERANCE           1E-14
+
 extern DSVertices * DSVerticesAlloc(const DSUInteger dimensions);
 extern void DSVerticesFree(DSVertices *vertices);
 
@@ -41,12 +47,16 @@ extern const bool DSVerticesAddVertex(DSVertices *vertices, const double * coord
 extern const bool DSVerticesAreEqual(const DSVertices *vert1, const DSVertices *vert2);
 
 extern const double * DSVerticesVertexAtIndex(const DSVertices *vertices, const DSUInteger index);
+extern const double * DSVerticesCoordinates(const DSVertices * vertices);
 
 extern void DSVerticesOrder2DVertices(DSVertices *vertices);
 
+extern DSVertices * DSVertices2DFromHalfPlanes(const DSMatrix * coefficients, const DSMatrix * constants, const double * lower, const double * upper);
+
 extern void DSVerticesPrint(const DSVertices *vertices);
 
 extern DSMatrix * DSVerticesToMatrix(const DSVertices * vertices);
+extern DSMatrix * DSVerticesFreeToMatrix(DSVertices * vertices);
 
 extern DSMatrix * DSVertices3DConnectivityMatrix(const DSVertices *vertices, const DSCase * aCase, const DSVariablePool * lower, const DSVariablePool * upper, DSUInteger xIndex, DSUInteger yIndex, DSUInteger zIndex);
 
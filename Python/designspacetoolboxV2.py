@@ -746,28 +746,17 @@ class DesignSpace:
                 if len(cases)<=1:
                         return None
                 intersections = list()
+                C=[aCase._data for aCase in cases]
+                if lower == None and upper == None:
+                        combinations = designspacetoolbox_test.DSCaseIntersectionsForCases(len(C), C, max(n))
+                else:
+                        combinations = designspacetoolbox_test.DSCaseIntersectionsForCasesAtSlice(len(C), C, max(n), lower._data, upper._data)
                 for i in xrange(len(n)):
-                        if len(cases)<n[i]:
+                        if len(combinations)<n[i]:
                                 break
-                        current=list()
-                        validIndices=list()
-                        comb = itertools.combinations(range(len(cases)), n[i])
-                        for j in comb:
-                                C=[cases[k]._data for k in j]
-                                if lower == None and upper == None:
-                                        if designspacetoolbox_test.DSCaseIntersectionIsValid(n[i], C)==True:
-                                                current.append([cases[k] for k in j])
-                                                [validIndices.append(k) for k in j]
-                                else:
-                                        if designspacetoolbox_test.DSCaseIntersectionIsValidAtSlice(n[i], C, lower._data, upper._data)==True:
-                                                current.append([cases[k] for k in j])
-                                                [validIndices.append(k) for k in j]
+                        current=[[cases[int(k)] for k in j] for j in combinations[n[i]-1]]
                         current.reverse()
-                        if len(current) != 0:
-                                intersections.append(current)
-                        else: 
-                                break
-                        cases=[cases[j] for j in np.unique(validIndices)]
+                        intersections.append(current)
                 return intersections
         def verticesForIntersection(self, cases, lower=None, upper=None):
                 n = len(cases)
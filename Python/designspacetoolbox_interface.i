@@ -74,15 +74,17 @@
         DSUInteger i, j;
         PyObject *tuple = NULL;
         DSVertices * vertices = $1;
+        const double * coordinates;
         if (vertices == NULL) {
                 $result = NULL;
                 return;
         }
+        coordinates = DSVerticesCoordinates(vertices);
         $result = PyList_New(vertices->numberOfVertices);
         for (i = 0; i < vertices->numberOfVertices; i++) {
                 tuple = PyTuple_New(vertices->dimensions);
                 for (j = 0; j < vertices->dimensions; j++) {
-                        PyTuple_SetItem(tuple, j, PyFloat_FromDouble(DSVerticesVertexAtIndex(vertices, i)[j]));
+                        PyTuple_SetItem(tuple, j, PyFloat_FromDouble(coordinates[i*vertices->dimensions+j]));
                 }
                 PyList_SetItem($result, i, tuple);
         }
@@ -108,6 +110,36 @@
         DSMatrixFree(matrix);
 }
 
+%typemap(out) DSMatrixArray * {
+        DSUInteger i, j, k;
+        PyObject *list = NULL, *tuple = NULL;
+        DSMatrixArray *array = $1;
+        DSMatrix *matrix = NULL;
+        if (array == NULL) {
+                $result = NULL;
+                return;
+        }
+        $result = PyList_New(DSMatrixArrayNumberOfMatrices(array));
+        for (k = 0; k < DSMatrixArrayNumberOfMatrices(array); k++) {
+                matrix = DSMatrixArrayMatrix(array, k);
+                if (matrix == NULL) {
+                        Py_INCREF(Py_None);
+                        PyList_SetItem($result, k, Py_None);
+                        continue;
+                }
+                list = PyList_New(DSMatrixRows(matrix));
+                for (i = 0; i < DSMatrixRows(matrix); i++) {
+                        tuple = PyTuple_New(DSMatrixColumns(matrix));
+                        for (j = 0; j < DSMatrixColumns(matrix); j++) {
+                                PyTuple_SetItem(tuple, j, PyFloat_FromDouble(DSMatrixDoubleValue(matrix, i, j)));
+                        }
+                        PyList_SetItem(list, i, tuple);
+                }
+                PyList_SetItem($result, k, list);
+        }
+        DSMatrixArrayFree(array);
+}
+
 %typemap(in) const DSCase ** {
         /* Check if is a list */
         if (PyList_Check($input)) {
@@ -229,6 +261,9 @@ extern DSVertices * DSCaseVerticesFor2DSlice(const DSCase *aCase, const DSVariab
 extern DSVertices * DSCaseVerticesFor1DSlice(const DSCase *aCase, const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds, const char * xVariable);
 extern DSVertices * DSCaseBoundingRangeForVariable(const DSCase *aCase, const char * variable);
 extern DSVertices * DSCaseBoundingRangeForVariableWithConstraints(const DSCase *aCase, const char * variable, DSVariablePool * lowerBounds, DSVariablePool * upperBounds);
+extern DSMatrix * DSCaseBoundingBox(const DSCase *aCase);
+extern DSMatrix * DSCaseBoundingBoxWithConstraints(const DSCase *aCase, const DSVariablePool * lowerBounds, const DSVariablePool * upperBounds);
+extern DSMatrixArray * DSCaseBoundingBoxesForCases(const DSUInteger numberOfCases, const DSCase ** cases, const DSVariablePool * lowerBounds, const DSVariablePool * upperBounds);
 
 extern DSUInteger DSCaseNumber(const DSCase * aCase);
 extern const DSUInteger * DSCaseSignature(const DSCase * aCase);
@@ -237,6 +272,8 @@ extern const DSSSystem * DSCaseSSystem(const DSCase *aCase);
 
 extern const bool DSCaseIntersectionIsValid(const DSUInteger numberOfCases, const DSCase **cases);
 extern const bool DSCaseIntersectionIsValidAtSlice(const DSUInteger numberOfCases, const DSCase **cases,  const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds);
+extern DSMatrixArray * DSCaseIntersectionsForCases(const DSUInteger numberOfCases, const DSCase ** cases, const DSUInteger maximumSize);
+extern DSMatrixArray * DSCaseIntersectionsForCasesAtSlice(const DSUInteger numberOfCases, const DSCase ** cases, const DSUInteger maximumSize, const DSVariablePool * lowerBounds, const DSVariablePool * upperBounds);
 extern const bool DSCaseIsValidAtPoint(const DSCase *aCase, const DSVariablePool * variablesToFix);
 
 extern DSVertices * DSCaseIntersectionVerticesForSlice(const DSUInteger numberOfCases, const DSCase **cases, const DSVariablePool * lowerBounds, const DSVariablePool *upperBounds, const DSUInteger numberOfVariables, const char ** variables);
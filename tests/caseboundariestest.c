@@ -0,0 +1,74 @@
+//
+//  caseboundariestest.c
+//
+//
+//  Tests the removal of duplicate boundaries of a case, which hashes the
+//  rounded directions of the boundaries but only removes boundaries whose
+//  normalized directions are identical.
+//
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <designspace/DSStd.h>
+
+#define NUMBER_OF_BOUNDARIES    5
+
+int main(int argc, const char ** argv) {
+        int i, j, failed = 0;
+        char * strings[2] = {NULL};
+        DSDesignSpace * ds;
+        DSCase * aCase;
+        DSMatrix *U, *zeta;
+        DSUInteger numberOfColumns;
+        /** Rows 0 and 1 differ by less than 2^-40 and must both be kept **/
+        double directions[NUMBER_OF_BOUNDARIES][2] = {
+                {1., 0.5},
+                {1., 0.5+ldexp(1., -42)},
+                {2., 1.},
+                {0., 0.},
+                {-1., 0.25}
+        };
+        double constants[NUMBER_OF_BOUNDARIES] = {1., 0.5, 1., 1., 2.};
+        /** Row 2 is row 0 scaled by two and more restrictive, row 3 is always satisfied **/
+        int expectedRows[] = {1, 2, 4};
+        int numberOfExpectedRows = 3;
+        strings[0] = strdup("x1. = a + b*x1*x2 - c*x1");
+        strings[1] = strdup("x2. = c*x1 - x2");
+        ds = DSDesignSpaceByParsingStrings(strings, NULL, 2);
+        aCase = DSDesignSpaceCaseWithCaseNumber(ds, 1);
+        numberOfColumns = DSVariablePoolNumberOfVariables(DSCaseXi(aCase));
+        U = DSMatrixCalloc(NUMBER_OF_BOUNDARIES, numberOfColumns);
+        zeta = DSMatrixCalloc(NUMBER_OF_BOUNDARIES, 1);
+        for (i = 0; i < NUMBER_OF_BOUNDARIES; i++) {
+                for (j = 0; j < 2; j++)
+                        DSMatrixSetDoubleValue(U, i, j, directions[i][j]);
+                DSMatrixSetDoubleValue(zeta, i, 0, constants[i]);
+        }
+        DSMatrixFree(DSCaseU(aCase));
+        DSMatrixFree(DSCaseZeta(aCase));
+        DSCaseU(aCase) = U;
+        DSCaseZeta(aCase) = zeta;
+        DSCaseRemoveDuplicateBoundaries(aCase);
+        if (DSMatrixRows(DSCaseU(aCase)) != numberOfExpectedRows) {
+                printf("%u boundaries kept, expected %i\n", DSMatrixRows(DSCaseU(aCase)), numberOfExpectedRows);
+                failed++;
+        } else {
+                for (i = 0; i < numberOfExpectedRows; i++) {
+                        for (j = 0; j < 2; j++) {
+                                if (DSMatrixDoubleValue(DSCaseU(aCase), i, j) != directions[expectedRows[i]][j])
+                                        break;
+                        }
+                        if (j < 2 || DSMatrixDoubleValue(DSCaseZeta(aCase), i, 0) != constants[expectedRows[i]]) {
+                                printf("Boundary %i is not boundary %i\n", i, expectedRows[i]);
+                                failed++;
+                        }
+                }
+        }
+        if (failed == 0)
+                printf("DSCaseRemoveDuplicateBoundaries passed!\n");
+        DSCaseFree(aCase);
+        DSDesignSpaceFree(ds);
+        free(strings[0]);
+        free(strings[1]);
+        return (failed > 0);
+}
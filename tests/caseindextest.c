@@ -0,0 +1,153 @@
+//
+//  caseindextest.c
+//
+//
+//  Compares the validity masks calculated by the vectorized kernel of a case
+//  index, serially and over the thread pool, with the validity of each case
+//  tested by DSCaseIsValidAtPoint.
+//
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <designspace/DSStd.h>
+
+#define NUMBER_OF_DIMENSIONS    3
+
+/**
+ * More cases than bits in a mask word, so that the masks have two words.
+ */
+#define NUMBER_OF_CASES         70
+
+#define NUMBER_OF_CONDITIONS    4
+
+/**
+ * Neither number of points is a multiple of DS_CASE_INDEX_TILE, so the last
+ * tile has unused slots.  The larger batch is evaluated over the thread pool.
+ */
+#define NUMBER_OF_SERIAL_POINTS         37
+#define NUMBER_OF_PARALLEL_POINTS       300
+
+static double randomValue(const double lower, const double upper)
+{
+        return lower+(upper-lower)*((double)rand()/(double)RAND_MAX);
+}
+
+/**
+ * Replaces the conditions of a copy of a case with random half-spaces
+ * containing a point of the box [-2, 2]^3 in logarithmic coordinates.
+ */
+static DSCase * randomCase(const DSCase * aCase, const DSUInteger caseNumber)
+{
+        DSUInteger i, j;
+        double center[NUMBER_OF_DIMENSIONS], direction, constant;
+        DSCase * randomCase;
+        DSMatrix *U, *zeta;
+        U = DSMatrixCalloc(NUMBER_OF_CONDITIONS, NUMBER_OF_DIMENSIONS);
+        zeta = DSMatrixCalloc(NUMBER_OF_CONDITIONS, 1);
+        for (j = 0; j < NUMBER_OF_DIMENSIONS; j++)
+                center[j] = randomValue(-2., 2.);
+        for (i = 0; i < NUMBER_OF_CONDITIONS; i++) {
+                constant = randomValue(0.5, 1.5);
+                for (j = 0; j < NUMBER_OF_DIMENSIONS; j++) {
+                        direction = randomValue(-1., 1.);
+                        DSMatrixSetDoubleValue(U, i, j, direction);
+                        constant -= direction*center[j];
+                }
+                DSMatrixSetDoubleValue(zeta, i, 0, constant);
+        }
+        randomCase = DSCaseCopy(aCase);
+        DSMatrixFree(DSCaseU(randomCase));
+        DSMatrixFree(DSCaseZeta(randomCase));
+        DSCaseU(randomCase) = U;
+        DSCaseZeta(randomCase) = zeta;
+        DSCaseNum(randomCase) = caseNumber;
+        return randomCase;
+}
+
+static int testValidityMasks(const char * name, const DSCaseIndex * index, DSCase ** cases, const DSUInteger numberOfPoints)
+{
+        int failed = 0;
+        DSUInteger i, j, k, caseNumber, numberOfWords = 0, numberValid = 0;
+        double * points;
+        bool isValid, isSet;
+        unsigned long * masks;
+        DSVariablePool * point;
+        points = DSSecureMalloc(sizeof(double)*numberOfPoints*NUMBER_OF_DIMENSIONS);
+        for (i = 0; i < numberOfPoints*NUMBER_OF_DIMENSIONS; i++)
+                points[i] = randomValue(-3., 3.);
+        masks = DSCaseIndexValidityMasksAtPoints(index, numberOfPoints, points, &numberOfWords);
+        if (masks == NULL || numberOfWords != 2) {
+                printf("%s: %u words in each mask, expected 2\n", name, numberOfWords);
+                failed++;
+                goto bail;
+        }
+        point = DSVariablePoolCopy(DSCaseXi(cases[0]));
+        for (i = 0; i < numberOfPoints; i++) {
+                for (j = 0; j < NUMBER_OF_DIMENSIONS; j++)
+                        DSVariablePoolSetValueForVariableWithName(point, DSVariableName(DSVariablePoolVariableAtIndex(point, j)), pow(10, points[i*NUMBER_OF_DIMENSIONS+j]));
+                for (k = 0; k < DSCaseIndexNumberOfCases(index); k++) {
+                        caseNumber = DSCaseIndexCaseNumberAtIndex(index, k);
+                        isValid = DSCaseIsValidAtPoint(cases[caseNumber-1], point);
+                        isSet = ((masks[i*numberOfWords+k/(sizeof(unsigned long)*8)] >> (k % (sizeof(unsigned long)*8))) & 1UL) != 0;
+                        if (isValid != isSet) {
+                                printf("%s: validity of case %u at point %u differs\n", name, caseNumber, i);
+                                failed++;
+                        }
+                        numberValid += (isValid == true);
+                }
+                /** Bits past the last case are never set **/
+                if ((masks[i*numberOfWords+numberOfWords-1] >> (DSCaseIndexNumberOfCases(index) % (sizeof(unsigned long)*8))) != 0) {
+                        printf("%s: unused bits of point %u are set\n", name, i);
+                        failed++;
+                }
+        }
+        if (numberValid == 0) {
+                printf("%s: no case is valid at any point\n", name);
+                failed++;
+        }
+        DSVariablePoolFree(point);
+bail:
+        if (masks != NULL)
+                DSSecureFree(masks);
+        DSSecureFree(points);
+        return failed;
+}
+
+int main(int argc, const char ** argv) {
+        int failed = 0, count;
+        DSUInteger i;
+        char * strings[2] = {NULL};
+        DSDesignSpace * ds;
+        DSCase * aCase, * cases[NUMBER_OF_CASES];
+        DSCaseIndex * index;
+        strings[0] = strdup("x1. = a + b*x1*x2 - c*x1");
+        strings[1] = strdup("x2. = c*x1 - x2");
+        ds = DSDesignSpaceByParsingStrings(strings, NULL, 2);
+        aCase = DSDesignSpaceCaseWithCaseNumber(ds, 1);
+        srand(1);
+        for (i = 0; i < NUMBER_OF_CASES; i++)
+                cases[i] = randomCase(aCase, i+1);
+        DSThreadPoolSetNumberOfThreads(4);
+        index = DSCaseIndexForCases(NUMBER_OF_CASES, cases);
+        if (DSCaseIndexNumberOfCases(index) != NUMBER_OF_CASES) {
+                printf("%u cases indexed, expected %i\n", DSCaseIndexNumberOfCases(index), NUMBER_OF_CASES);
+                failed++;
+        }
+        failed += (count = testValidityMasks("Serial masks", index, cases, NUMBER_OF_SERIAL_POINTS));
+        if (count == 0)
+                printf("Validity masks of a single tile passed!\n");
+        failed += (count = testValidityMasks("Parallel masks", index, cases, NUMBER_OF_PARALLEL_POINTS));
+        if (count == 0)
+                printf("Validity masks over the thread pool passed!\n");
+        DSCaseIndexFree(index);
+        for (i = 0; i < NUMBER_OF_CASES; i++)
+                DSCaseFree(cases[i]);
+        DSCaseFree(aCase);
+        DSDesignSpaceFree(ds);
+        free(strings[0]);
+        free(strings[1]);
+        if (failed > 0)
+                printf("%i comparisons failed\n", failed);
+        return (failed > 0);
+}
@@ -0,0 +1,237 @@
+//
+//  clippingtest.c
+//
+//
+//  Compares the vertices of 2D slices calculated by clipping the slice
+//  rectangle with the vertices enumerated by lrs, and tests the clipping of
+//  degenerate sets of half-planes.
+//
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <designspace/DSStd.h>
+
+#define TOLERANCE       1E-5
+
+static bool vertexIsInVertices(const double * vertex, const DSVertices * vertices)
+{
+        DSUInteger i;
+        const double * other;
+        for (i = 0; i < vertices->numberOfVertices; i++) {
+                other = DSVerticesVertexAtIndex(vertices, i);
+                if (fabs(vertex[0]-other[0]) < TOLERANCE && fabs(vertex[1]-other[1]) < TOLERANCE)
+                        return true;
+        }
+        return false;
+}
+
+/**
+ * Compares two sets of vertices, ignoring their order.
+ */
+static int compareVertices(const char * name, const DSVertices * vertices, const DSVertices * expected)
+{
+        DSUInteger i;
+        int failed = 0;
+        for (i = 0; i < vertices->numberOfVertices; i++) {
+                if (vertexIsInVertices(DSVerticesVertexAtIndex(vertices, i), expected) == false) {
+                        printf("%s: vertex %u is not expected\n", name, i);
+                        failed++;
+                }
+        }
+        for (i = 0; i < expected->numberOfVertices; i++) {
+                if (vertexIsInVertices(DSVerticesVertexAtIndex(expected, i), vertices) == false) {
+                        printf("%s: expected vertex %u is missing\n", name, i);
+                        failed++;
+                }
+        }
+        return failed;
+}
+
+/**
+ * The vertices of a clipped polygon are in counter-clockwise order, so its
+ * signed area is positive.
+ */
+static int checkCounterClockwise(const char * name, const DSVertices * vertices)
+{
+        DSUInteger i;
+        const double * current, * next;
+        double area = 0;
+        if (vertices->numberOfVertices < 3)
+                return 0;
+        for (i = 0; i < vertices->numberOfVertices; i++) {
+                current = DSVerticesVertexAtIndex(vertices, i);
+                next = DSVerticesVertexAtIndex(vertices, (i+1) % vertices->numberOfVertices);
+                area += current[0]*next[1]-next[0]*current[1];
+        }
+        if (area > 0)
+                return 0;
+        printf("%s: vertices are not in counter-clockwise order\n", name);
+        return 1;
+}
+
+/**
+ * Calculates the vertices of a slice of a case with vertex enumeration.  The
+ * boundaries of the case are restricted to the x and y variables by
+ * substituting the value of the fixed variable.  The two dimensional slice
+ * functions never solve linear problems with a free variable, as the old
+ * linear programming path evaluates the boundaries at the upper bound of
+ * every variable that is not in the slice.
+ */
+static DSVertices * verticesByEnumeration(const DSCase * aCase, const char * fixedVariable, const double value, const DSVariablePool * lower, const DSVariablePool * upper)
+{
+        DSUInteger i, j, k, fixedIndex, indices[2];
+        double constant, coordinates[2];
+        DSCase * sliceCase;
+        DSMatrix * U, * zeta, * vertexMatrix;
+        DSMatrixArray * enumeration;
+        DSVertices * vertices;
+        fixedIndex = DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), fixedVariable);
+        for (i = 0; i < 2; i++)
+                indices[i] = DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), DSVariableName(DSVariablePoolVariableAtIndex(lower, i)));
+        U = DSMatrixAlloc(DSMatrixRows(DSCaseU(aCase)), 2);
+        zeta = DSMatrixAlloc(DSMatrixRows(DSCaseU(aCase)), 1);
+        for (i = 0; i < DSMatrixRows(DSCaseU(aCase)); i++) {
+                constant = DSMatrixDoubleValue(DSCaseZeta(aCase), i, 0);
+                constant += DSMatrixDoubleValue(DSCaseU(aCase), i, fixedIndex)*log10(value);
+                DSMatrixSetDoubleValue(zeta, i, 0, constant);
+                for (k = 0; k < 2; k++)
+                        DSMatrixSetDoubleValue(U, i, k, DSMatrixDoubleValue(DSCaseU(aCase), i, indices[k]));
+        }
+        /** Only U and zeta are used by the vertex enumeration **/
+        sliceCase = DSCaseCopy(aCase);
+        DSMatrixFree(DSCaseU(sliceCase));
+        DSMatrixFree(DSCaseZeta(sliceCase));
+        DSCaseU(sliceCase) = U;
+        DSCaseZeta(sliceCase) = zeta;
+        enumeration = DSCaseNDVertexEnumeration(sliceCase, lower, upper);
+        vertices = DSVerticesAlloc(2);
+        vertexMatrix = DSMatrixArrayMatrix(enumeration, 0);
+        for (j = 0; j < DSMatrixRows(vertexMatrix); j++) {
+                for (k = 0; k < 2; k++)
+                        coordinates[k] = DSMatrixDoubleValue(vertexMatrix, j, k);
+                DSVerticesAddVertex(vertices, coordinates);
+        }
+        DSMatrixArrayFree(enumeration);
+        DSCaseFree(sliceCase);
+        return vertices;
+}
+
+/**
+ * Compares the slices of the valid cases with c fixed, calculated by
+ * clipping, with the vertices enumerated by lrs.
+ */
+static int testCaseSlices(DSDesignSpace * ds)
+{
+        DSUInteger caseNumber, numberOfSlices = 0;
+        int failed = 0;
+        char name[100];
+        DSCase * aCase;
+        DSVariablePool * lower, * upper, * sliceLower, * sliceUpper;
+        DSVertices * clipped, * expected;
+        lower = DSVariablePoolByParsingString("a : 1E-3, b : 1E-3, c : 10");
+        upper = DSVariablePoolByParsingString("a : 1E3, b : 1E3, c : 10");
+        sliceLower = DSVariablePoolByParsingString("a : 1E-3, b : 1E-3");
+        sliceUpper = DSVariablePoolByParsingString("a : 1E3, b : 1E3");
+        for (caseNumber = 1; caseNumber <= DSDesignSpaceNumberOfCases(ds); caseNumber++) {
+                aCase = DSDesignSpaceCaseWithCaseNumber(ds, caseNumber);
+                if (DSCaseIsValidAtSlice(aCase, lower, upper, true) == false) {
+                        DSCaseFree(aCase);
+                        continue;
+                }
+                sprintf(name, "Case %u", caseNumber);
+                clipped = DSCaseVerticesFor2DSlice(aCase, lower, upper, "a", "b");
+                expected = verticesByEnumeration(aCase, "c", 10, sliceLower, sliceUpper);
+                if (clipped == NULL) {
+                        printf("%s: vertices were not calculated\n", name);
+                        failed++;
+                } else {
+                        failed += compareVertices(name, clipped, expected);
+                        failed += checkCounterClockwise(name, clipped);
+                        DSVerticesFree(clipped);
+                        numberOfSlices++;
+                }
+                DSVerticesFree(expected);
+                DSCaseFree(aCase);
+        }
+        if (numberOfSlices == 0) {
+                printf("No case is valid in the slice\n");
+                failed++;
+        }
+        DSVariablePoolFree(lower);
+        DSVariablePoolFree(upper);
+        DSVariablePoolFree(sliceLower);
+        DSVariablePoolFree(sliceUpper);
+        return failed;
+}
+
+static int testHalfPlanes(const char * name, const double (*halfPlanes)[3], const DSUInteger numberOfHalfPlanes, const double (*expectedVertices)[2], const DSUInteger numberOfExpected)
+{
+        int failed = 0;
+        DSUInteger i;
+        double lower[2] = {0., 0.}, upper[2] = {1., 1.};
+        DSMatrix * coefficients, * constants;
+        DSVertices * vertices, * expected;
+        coefficients = DSMatrixAlloc(numberOfHalfPlanes, 2);
+        constants = DSMatrixAlloc(numberOfHalfPlanes, 1);
+        for (i = 0; i < numberOfHalfPlanes; i++) {
+                DSMatrixSetDoubleValue(coefficients, i, 0, halfPlanes[i][0]);
+                DSMatrixSetDoubleValue(coefficients, i, 1, halfPlanes[i][1]);
+                DSMatrixSetDoubleValue(constants, i, 0, halfPlanes[i][2]);
+        }
+        expected = DSVerticesAlloc(2);
+        for (i = 0; i < numberOfExpected; i++)
+                DSVerticesAddVertex(expected, expectedVertices[i]);
+        vertices = DSVertices2DFromHalfPlanes(coefficients, constants, lower, upper);
+        if (vertices->numberOfVertices != numberOfExpected) {
+                printf("%s: %u vertices, expected %u\n", name, vertices->numberOfVertices, numberOfExpected);
+                failed++;
+        }
+        failed += compareVertices(name, vertices, expected);
+        failed += checkCounterClockwise(name, vertices);
+        DSVerticesFree(vertices);
+        DSVerticesFree(expected);
+        DSMatrixFree(coefficients);
+        DSMatrixFree(constants);
+        return failed;
+}
+
+/**
+ * Half-planes a*x + b*y + c >= 0 clipping the unit square.
+ */
+static int testDegenerateHalfPlanes(void)
+{
+        int failed = 0;
+        /** x + y >= 3 does not intersect the square **/
+        const double empty[1][3] = {{1., 1., -3.}};
+        /** x <= 0.5 twice, and x >= 0 on the edge of the square **/
+        const double parallel[3][3] = {{-1., 0., 0.5}, {-1., 0., 0.5}, {1., 0., 0.}};
+        const double parallelVertices[4][2] = {{0., 0.}, {0.5, 0.}, {0.5, 1.}, {0., 1.}};
+        /** x + y <= 1 crosses the square at two of its corners **/
+        const double diagonal[1][3] = {{-1., -1., 1.}};
+        const double diagonalVertices[3][2] = {{0., 0.}, {1., 0.}, {0., 1.}};
+        failed += testHalfPlanes("Empty slice", empty, 1, NULL, 0);
+        failed += testHalfPlanes("Parallel boundaries", parallel, 3, parallelVertices, 4);
+        failed += testHalfPlanes("Vertices on the box", diagonal, 1, diagonalVertices, 3);
+        return failed;
+}
+
+int main(int argc, const char ** argv) {
+        int failed = 0, count;
+        char * strings[2] = {NULL};
+        DSDesignSpace * ds;
+        strings[0] = strdup("x1. = a + b*x1*x2 - c*x1");
+        strings[1] = strdup("x2. = c*x1 - x2");
+        ds = DSDesignSpaceByParsingStrings(strings, NULL, 2);
+        failed += (count = testCaseSlices(ds));
+        if (count == 0)
+                printf("Clipped 2D slices passed!\n");
+        failed += (count = testDegenerateHalfPlanes());
+        if (count == 0)
+                printf("DSVertices2DFromHalfPlanes passed!\n");
+        DSDesignSpaceFree(ds);
+        free(strings[0]);
+        free(strings[1]);
+        if (failed > 0)
+                printf("%i comparisons failed\n", failed);
+        return (failed > 0);
+}
@@ -0,0 +1,121 @@
+//
+//  expressionprogramtest.c
+//
+//
+//  Compares the evaluation of expression trees with the evaluation of the
+//  programs they are compiled to.
+//
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#include <designspace/DSStd.h>
+
+static const char * expressions[] = {
+        "x+y*2",
+        "x-y-z",
+        "x*y*z*2.5",
+        "x/y-4*(x+y)^0.5",
+        "x^2+3*y^-1",
+        "-x^z",
+        "log(x)+ln(y)-log10(x*y)",
+        "sqrt(x*y)+abs(z-x)",
+        "sign(x-y)*abs(y-x)",
+        "cos(x)+sin(y)^2",
+        "3.25",
+        "2*&i+x",
+        "sqrt(-1*x)+2*&i",
+        "real(sqrt(-1*x))+imag(sqrt(-1*x))",
+        "real(x+y*&i)*imag(x+y*&i)",
+        NULL
+};
+
+static bool valuesAreEqual(double complex a, double complex b)
+{
+        bool equal = true;
+        if (isnan(creal(a)) || isnan(creal(b)))
+                equal = (isnan(creal(a)) && isnan(creal(b)));
+        else if (fabs(creal(a)-creal(b)) > 1E-12*(1.+fabs(creal(a))))
+                equal = false;
+        if (isnan(cimag(a)) || isnan(cimag(b)))
+                equal = equal && (isnan(cimag(a)) && isnan(cimag(b)));
+        else if (fabs(cimag(a)-cimag(b)) > 1E-12*(1.+fabs(cimag(a))))
+                equal = false;
+        return equal;
+}
+
+int main(int argc, const char ** argv) {
+        int i, k, failed = 0;
+        double values[3];
+        double complex treeValue, programValue;
+        DSVariablePool * layout;
+        DSExpression * expression;
+        DSExpressionProgram * program;
+
+        layout = DSVariablePoolAlloc();
+        DSVariablePoolAddVariableWithName(layout, "x");
+        DSVariablePoolAddVariableWithName(layout, "y");
+        DSVariablePoolAddVariableWithName(layout, "z");
+        srand(3);
+        for (i = 0; expressions[i] != NULL; i++) {
+                expression = DSExpressionByParsingString(expressions[i]);
+                program = DSExpressionProgramCompile(expression, layout);
+                if (program == NULL) {
+                        printf("%s did not compile\n", expressions[i]);
+                        failed++;
+                        DSExpressionFree(expression);
+                        continue;
+                }
+                for (k = 0; k < 100; k++) {
+                        values[0] = (rand() % 1000)/100. + 0.01;
+                        values[1] = (rand() % 1000)/100. + 0.01;
+                        values[2] = (rand() % 7) - 3.;
+                        DSVariablePoolSetValueForVariableWithName(layout, "x", values[0]);
+                        DSVariablePoolSetValueForVariableWithName(layout, "y", values[1]);
+                        DSVariablePoolSetValueForVariableWithName(layout, "z", values[2]);
+                        /** The real evaluation of a tree does not accept the imaginary number **/
+                        if (strchr(expressions[i], '&') == NULL) {
+                                treeValue = DSExpressionEvaluateWithVariablePool(expression, layout);
+                                programValue = DSExpressionProgramEvaluate(program, values);
+                                if (valuesAreEqual(treeValue, programValue) == false) {
+                                        printf("%s: tree %g, program %g\n", expressions[i], creal(treeValue), creal(programValue));
+                                        failed++;
+                                }
+                        }
+                        treeValue = DSExpressionEvaluateComplexWithVariablePool(expression, layout);
+                        programValue = DSExpressionProgramEvaluateComplex(program, values);
+                        if (valuesAreEqual(treeValue, programValue) == false) {
+                                printf("%s: tree %g%+gi, program %g%+gi\n", expressions[i],
+                                       creal(treeValue), cimag(treeValue),
+                                       creal(programValue), cimag(programValue));
+                                failed++;
+                        }
+                }
+                DSExpressionProgramFree(program);
+                DSExpressionFree(expression);
+        }
+        printf("DSExpressionProgramEvaluate passed!\n");
+
+        expression = DSExpressionByParsingString("x+w");
+        program = DSExpressionProgramCompile(expression, layout);
+        if (program != NULL) {
+                printf("x+w compiled with an unknown variable\n");
+                DSExpressionProgramFree(program);
+                failed++;
+        }
+        DSExpressionFree(expression);
+        expression = DSExpressionByParsingString("2*x+1");
+        program = DSExpressionProgramCompile(expression, NULL);
+        if (program != NULL) {
+                printf("2*x+1 compiled without a layout\n");
+                DSExpressionProgramFree(program);
+                failed++;
+        }
+        DSExpressionFree(expression);
+        printf("Unknown variables passed!\n");
+
+        DSVariablePoolFree(layout);
+        if (failed > 0)
+                printf("%i comparisons failed\n", failed);
+        return (failed > 0);
+}
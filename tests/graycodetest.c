@@ -0,0 +1,191 @@
+//
+//  graycodetest.c
+//
+//
+//  Compares the enumeration of the cases of a design space in Gray code
+//  order, where each S-System is solved by updating the solution of the
+//  previous case, with the enumeration in case number order.
+//
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <designspace/DSStd.h>
+
+#define NUMBER_OF_EQUATIONS     4
+
+static const char * equations[NUMBER_OF_EQUATIONS] = {
+        "x1. = a1*x2 + b1 - c1*x1",
+        "x2. = a2*x1 + b2*x3 - c2*x2",
+        "x3. = a3*x2 + b3 - c3*x3 - d3*x1*x3",
+        "x4. = a4*x3 + b4 - c4*x4"
+};
+
+static DSDesignSpace * designSpaceForTest(bool grayCode)
+{
+        DSUInteger i;
+        char * strings[NUMBER_OF_EQUATIONS];
+        DSDesignSpace * ds;
+        for (i = 0; i < NUMBER_OF_EQUATIONS; i++)
+                strings[i] = strdup(equations[i]);
+        ds = DSDesignSpaceByParsingStrings(strings, NULL, NUMBER_OF_EQUATIONS);
+        DSDesignSpaceSetGrayCodeEnumeration(ds, grayCode);
+        for (i = 0; i < NUMBER_OF_EQUATIONS; i++)
+                free(strings[i]);
+        return ds;
+}
+
+static bool matricesAreEqual(const DSMatrix * A, const DSMatrix * B)
+{
+        DSUInteger i, j;
+        double a, b;
+        if (DSMatrixRows(A) != DSMatrixRows(B) || DSMatrixColumns(A) != DSMatrixColumns(B))
+                return false;
+        for (i = 0; i < DSMatrixRows(A); i++) {
+                for (j = 0; j < DSMatrixColumns(A); j++) {
+                        a = DSMatrixDoubleValue(A, i, j);
+                        b = DSMatrixDoubleValue(B, i, j);
+                        if (fabs(a-b) > 1E-9*(1.+fabs(a)))
+                                return false;
+                }
+        }
+        return true;
+}
+
+/**
+ * Compares the steady-state solution log(Xd) = Ay*log(Xi) + By of two
+ * S-Systems, with Ay = -M*Ai and By = M*B.
+ */
+static int compareSolutions(const char * name, DSUInteger caseNumber, const DSSSystem * ssys, const DSSSystem * expected)
+{
+        int failed = 0;
+        DSMatrix *Ai, *B, *Ay, *By, *expectedAy, *expectedBy;
+        if (DSSSystemIsSingular(ssys) != DSSSystemIsSingular(expected)) {
+                printf("%s: case %u is %ssingular\n", name, caseNumber, (DSSSystemIsSingular(ssys) ? "" : "not "));
+                return 1;
+        }
+        if (DSSSystemIsSingular(ssys) == true)
+                return 0;
+        Ai = DSSSystemAi(ssys);
+        B = DSSSystemB(ssys);
+        Ay = DSMatrixByMultiplyingMatrix(DSSSystemM(ssys), Ai);
+        By = DSMatrixByMultiplyingMatrix(DSSSystemM(ssys), B);
+        expectedAy = DSMatrixByMultiplyingMatrix(DSSSystemM(expected), Ai);
+        expectedBy = DSMatrixByMultiplyingMatrix(DSSSystemM(expected), B);
+        if (matricesAreEqual(Ay, expectedAy) == false || matricesAreEqual(By, expectedBy) == false) {
+                printf("%s: steady state of case %u differs\n", name, caseNumber);
+                failed++;
+        }
+        DSMatrixFree(Ai);
+        DSMatrixFree(B);
+        DSMatrixFree(Ay);
+        DSMatrixFree(By);
+        DSMatrixFree(expectedAy);
+        DSMatrixFree(expectedBy);
+        return failed;
+}
+
+static int testValidCases(DSDesignSpace * grayCodeDs, DSDesignSpace * orderedDs)
+{
+        DSUInteger caseNumber;
+        int failed = 0;
+        if (DSDesignSpaceNumberOfValidCases(grayCodeDs) != DSDesignSpaceNumberOfValidCases(orderedDs)) {
+                printf("%u valid cases in Gray code order, %u in case number order\n",
+                       DSDesignSpaceNumberOfValidCases(grayCodeDs), DSDesignSpaceNumberOfValidCases(orderedDs));
+                failed++;
+        }
+        for (caseNumber = 1; caseNumber <= DSDesignSpaceNumberOfCases(orderedDs); caseNumber++) {
+                if (DSDesignSpaceCaseWithCaseNumberIsValid(grayCodeDs, caseNumber) != DSDesignSpaceCaseWithCaseNumberIsValid(orderedDs, caseNumber)) {
+                        printf("Validity of case %u differs\n", caseNumber);
+                        failed++;
+                }
+        }
+        return failed;
+}
+
+/**
+ * Solves the cases in Gray code order as the validity workers do, each lazy
+ * case with the previous solved case as its neighbor, and compares them with
+ * cases solved from scratch.
+ */
+static int testGrayCodeSolutions(DSDesignSpace * ds)
+{
+        DSUInteger i, caseNumber, numberUpdated = 0;
+        int failed = 0;
+        DSCase *aCase, *expected, *neighbor = NULL;
+        for (i = 0; i < DSDesignSpaceNumberOfCases(ds); i++) {
+                caseNumber = DSDesignSpaceCaseNumberForGrayCodeIndex(ds, i);
+                aCase = DSDesignSpaceLazyCaseWithCaseNumber(ds, caseNumber);
+                DSCaseIsValidWithNeighbor(aCase, true, neighbor);
+                if (DSCaseIsLazy(aCase) == true) {
+                        DSCaseFree(aCase);
+                        continue;
+                }
+                expected = DSDesignSpaceCaseWithCaseNumber(ds, caseNumber);
+                failed += compareSolutions("Gray code order", caseNumber, DSCaseSSystem(aCase), DSCaseSSystem(expected));
+                if (DSCaseSSystem(aCase)->numberOfUpdates > 0)
+                        numberUpdated++;
+                DSCaseFree(expected);
+                if (neighbor != NULL)
+                        DSCaseFree(neighbor);
+                neighbor = aCase;
+        }
+        if (neighbor != NULL)
+                DSCaseFree(neighbor);
+        if (numberUpdated == 0) {
+                printf("No S-System was solved by updating its neighbor\n");
+                failed++;
+        }
+        return failed;
+}
+
+/**
+ * The case with the first terms of x1 and x2 has a singular Ad, so updating
+ * the solution of its nonsingular neighbor fails and the S-System is solved
+ * from scratch.
+ */
+static int testSingularUpdate(DSDesignSpace * ds)
+{
+        int failed = 0;
+        DSUInteger neighborSignature[2*NUMBER_OF_EQUATIONS] = {2, 1, 1, 1, 1, 1, 1, 1};
+        DSUInteger singularSignature[2*NUMBER_OF_EQUATIONS] = {1, 1, 1, 1, 1, 1, 1, 1};
+        DSUInteger caseNumber;
+        DSCase *neighbor, *aCase, *expected;
+        neighbor = DSDesignSpaceCaseWithCaseSignature(ds, neighborSignature);
+        caseNumber = DSCaseNumberForSignature(singularSignature, DSDesignSpaceGMASystem(ds));
+        aCase = DSDesignSpaceCaseWithCaseNumberAndNeighbor(ds, caseNumber, neighbor);
+        expected = DSDesignSpaceCaseWithCaseNumber(ds, caseNumber);
+        if (DSSSystemIsSingular(DSCaseSSystem(neighbor)) == true) {
+                printf("Neighbor of the singular case is singular\n");
+                failed++;
+        }
+        if (DSSSystemIsSingular(DSCaseSSystem(aCase)) == false || DSCaseSSystem(aCase)->numberOfUpdates != 0) {
+                printf("Singular case was not solved from scratch\n");
+                failed++;
+        }
+        failed += compareSolutions("Singular update", caseNumber, DSCaseSSystem(aCase), DSCaseSSystem(expected));
+        DSCaseFree(neighbor);
+        DSCaseFree(aCase);
+        DSCaseFree(expected);
+        return failed;
+}
+
+int main(int argc, const char ** argv) {
+        int failed = 0, count;
+        DSDesignSpace *grayCodeDs, *orderedDs;
+        grayCodeDs = designSpaceForTest(true);
+        orderedDs = designSpaceForTest(false);
+        failed += (count = testValidCases(grayCodeDs, orderedDs));
+        if (count == 0)
+                printf("Valid cases in Gray code order passed!\n");
+        failed += (count = testGrayCodeSolutions(grayCodeDs));
+        if (count == 0)
+                printf("Updated S-System solutions passed!\n");
+        failed += (count = testSingularUpdate(grayCodeDs));
+        if (count == 0)
+                printf("Singular S-System update passed!\n");
+        DSDesignSpaceFree(grayCodeDs);
+        DSDesignSpaceFree(orderedDs);
+        if (failed > 0)
+                printf("%i comparisons failed\n", failed);
+        return (failed > 0);
+}
@@ -0,0 +1,392 @@
+//
+//  linearproblemtest.c
+//
+//
+//  Compares the solutions of DSLinearProblem with the solutions of the same
+//  problems solved directly by GLPK.
+//
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <glpk.h>
+#include <designspace/DSStd.h>
+
+typedef struct {
+        int rows;
+        int columns;
+        double * A;
+        double * b;
+        bool * isEquality;
+        double * lower;
+        double * upper;
+        double * c;
+        bool maximize;
+} lp_test_t;
+
+static void allocProblem(lp_test_t * lp, int rows, int columns)
+{
+        int j;
+        lp->rows = rows;
+        lp->columns = columns;
+        lp->A = calloc(rows*columns+1, sizeof(double));
+        lp->b = calloc(rows+1, sizeof(double));
+        lp->isEquality = calloc(rows+1, sizeof(bool));
+        lp->lower = calloc(columns, sizeof(double));
+        lp->upper = calloc(columns, sizeof(double));
+        lp->c = calloc(columns, sizeof(double));
+        lp->maximize = false;
+        for (j = 0; j < columns; j++) {
+                lp->lower[j] = -INFINITY;
+                lp->upper[j] = INFINITY;
+        }
+}
+
+static void freeProblem(lp_test_t * lp)
+{
+        free(lp->A);
+        free(lp->b);
+        free(lp->isEquality);
+        free(lp->lower);
+        free(lp->upper);
+        free(lp->c);
+}
+
+static double randomValue(void)
+{
+        return (rand() % 2001)/1000. - 1.;
+}
+
+/**
+ * Random constraints A*x <= b with b chosen so that a random point in
+ * [-1, 1] is feasible, and random bounds around that point.
+ */
+static void randomProblem(lp_test_t * lp, int rows, int columns, bool bounded)
+{
+        int i, j;
+        double * point, value;
+        allocProblem(lp, rows, columns);
+        point = calloc(columns, sizeof(double));
+        for (j = 0; j < columns; j++) {
+                point[j] = randomValue();
+                lp->c[j] = randomValue();
+                switch (bounded ? 3 : rand() % 5) {
+                        case 0:
+                                break;
+                        case 1:
+                                lp->lower[j] = point[j]-(rand() % 100)/50.;
+                                break;
+                        case 2:
+                                lp->upper[j] = point[j]+(rand() % 100)/50.;
+                                break;
+                        case 3:
+                                lp->lower[j] = point[j]-(rand() % 100)/50.-0.01;
+                                lp->upper[j] = point[j]+(rand() % 100)/50.+0.01;
+                                break;
+                        default:
+                                lp->lower[j] = point[j];
+                                lp->upper[j] = point[j];
+                                break;
+                }
+        }
+        for (i = 0; i < rows; i++) {
+                value = 0.;
+                for (j = 0; j < columns; j++) {
+                        lp->A[i*columns+j] = (rand() % 4 == 0) ? 0. : randomValue();
+                        value += lp->A[i*columns+j]*point[j];
+                }
+                lp->b[i] = value+(rand() % 100)/100.;
+        }
+        lp->maximize = (rand() % 2 == 0);
+        free(point);
+}
+
+static DSLinearProblem * dsProblemForTest(const lp_test_t * lp)
+{
+        DSLinearProblem * problem;
+        int i, j, row, numberOfEqualities = 0;
+        for (i = 0; i < lp->rows; i++)
+                numberOfEqualities += (lp->isEquality[i] == true);
+        problem = DSLinearProblemAlloc();
+        DSLinearProblemResize(problem, lp->rows+numberOfEqualities, lp->columns);
+        for (i = 0, row = lp->rows; i < lp->rows; i++) {
+                for (j = 0; j < lp->columns; j++)
+                        DSLinearProblemSetCoefficient(problem, i, j, lp->A[i*lp->columns+j]);
+                DSLinearProblemSetConstant(problem, i, lp->b[i]);
+                /** Equalities are written as a*x <= b and -a*x <= -b **/
+                if (lp->isEquality[i] == false)
+                        continue;
+                for (j = 0; j < lp->columns; j++)
+                        DSLinearProblemSetCoefficient(problem, row, j, -lp->A[i*lp->columns+j]);
+                DSLinearProblemSetConstant(problem, row, -lp->b[i]);
+                row++;
+        }
+        for (j = 0; j < lp->columns; j++) {
+                DSLinearProblemSetColumnBounds(problem, j, lp->lower[j], lp->upper[j]);
+                DSLinearProblemSetObjectiveCoefficient(problem, j, lp->c[j]);
+        }
+        DSLinearProblemSetMaximize(problem, lp->maximize);
+        return problem;
+}
+
+static glp_prob * glpkProblemForTest(const lp_test_t * lp)
+{
+        glp_prob * problem;
+        int i, j, count, * indices;
+        double * values, lower, upper;
+        problem = glp_create_prob();
+        indices = calloc(lp->columns+1, sizeof(int));
+        values = calloc(lp->columns+1, sizeof(double));
+        glp_add_rows(problem, lp->rows);
+        glp_add_cols(problem, lp->columns);
+        for (i = 0; i < lp->rows; i++) {
+                count = 0;
+                for (j = 0; j < lp->columns; j++) {
+                        if (lp->A[i*lp->columns+j] == 0.)
+                                continue;
+                        count++;
+                        indices[count] = j+1;
+                        values[count] = lp->A[i*lp->columns+j];
+                }
+                glp_set_mat_row(problem, i+1, count, indices, values);
+                glp_set_row_bnds(problem, i+1, (lp->isEquality[i] ? GLP_FX : GLP_UP), lp->b[i], lp->b[i]);
+        }
+        for (j = 0; j < lp->columns; j++) {
+                lower = lp->lower[j];
+                upper = lp->upper[j];
+                if (lower == -INFINITY && upper == INFINITY)
+                        glp_set_col_bnds(problem, j+1, GLP_FR, 0., 0.);
+                else if (lower == -INFINITY)
+                        glp_set_col_bnds(problem, j+1, GLP_UP, 0., upper);
+                else if (upper == INFINITY)
+                        glp_set_col_bnds(problem, j+1, GLP_LO, lower, 0.);
+                else if (lower == upper)
+                        glp_set_col_bnds(problem, j+1, GLP_FX, lower, upper);
+                else
+                        glp_set_col_bnds(problem, j+1, GLP_DB, lower, upper);
+                glp_set_obj_coef(problem, j+1, lp->c[j]);
+        }
+        glp_set_obj_dir(problem, (lp->maximize ? GLP_MAX : GLP_MIN));
+        free(indices);
+        free(values);
+        return problem;
+}
+
+static DSUInteger statusForGLPK(glp_prob * problem)
+{
+        switch (glp_get_status(problem)) {
+                case GLP_OPT:
+                        return DS_LINEAR_PROBLEM_OPTIMAL;
+                case GLP_FEAS:
+                        return DS_LINEAR_PROBLEM_FEASIBLE;
+                case GLP_NOFEAS:
+                        return DS_LINEAR_PROBLEM_INFEASIBLE;
+                case GLP_UNBND:
+                        return DS_LINEAR_PROBLEM_UNBOUNDED;
+                default:
+                        return DS_LINEAR_PROBLEM_FAILED;
+        }
+}
+
+static bool valuesAreEqual(double a, double b)
+{
+        return (fabs(a-b) <= 1E-6*(1.+fabs(a)));
+}
+
+/**
+ * Solves a problem with DSLinearProblem and with GLPK, and compares the
+ * status, the objective value and, for optimal solutions, the solution.  The
+ * objective coefficients are random, so the optimal solution is unique.
+ */
+static int compareWithGLPK(const char * name, const lp_test_t * lp, const DSUInteger expected)
+{
+        int j, failed = 0;
+        DSUInteger status, glpkStatus;
+        double objective;
+        DSLinearProblem * problem = dsProblemForTest(lp);
+        glp_prob * glpkProblem = glpkProblemForTest(lp);
+        status = DSLinearProblemSolve(problem);
+        glp_simplex(glpkProblem, NULL);
+        glpkStatus = statusForGLPK(glpkProblem);
+        if (status != glpkStatus || (expected != DS_LINEAR_PROBLEM_UNSOLVED && status != expected)) {
+                printf("%s: status %u, GLPK status %u\n", name, status, glpkStatus);
+                failed++;
+                goto bail;
+        }
+        if (status != DSLinearProblemStatus(problem)) {
+                printf("%s: DSLinearProblemStatus is %u\n", name, DSLinearProblemStatus(problem));
+                failed++;
+        }
+        objective = DSLinearProblemObjectiveValue(problem);
+        if (status == DS_LINEAR_PROBLEM_UNBOUNDED) {
+                if (objective != (lp->maximize ? INFINITY : -INFINITY)) {
+                        printf("%s: unbounded objective is %g\n", name, objective);
+                        failed++;
+                }
+                goto bail;
+        }
+        if (status != DS_LINEAR_PROBLEM_OPTIMAL)
+                goto bail;
+        if (valuesAreEqual(glp_get_obj_val(glpkProblem), objective) == false) {
+                printf("%s: objective %.12g, GLPK objective %.12g\n", name, objective, glp_get_obj_val(glpkProblem));
+                failed++;
+        }
+        for (j = 0; j < lp->columns; j++) {
+                if (valuesAreEqual(glp_get_col_prim(glpkProblem, j+1), DSLinearProblemColumnValue(problem, j)) == false) {
+                        printf("%s: x%i is %.12g, GLPK x%i is %.12g\n", name, j,
+                               DSLinearProblemColumnValue(problem, j), j,
+                               glp_get_col_prim(glpkProblem, j+1));
+                        failed++;
+                        break;
+                }
+        }
+bail:
+        DSLinearProblemFree(problem);
+        glp_delete_prob(glpkProblem);
+        return failed;
+}
+
+static int testFeasibleProblems(void)
+{
+        int k, failed = 0;
+        lp_test_t lp;
+        for (k = 0; k < 500; k++) {
+                randomProblem(&lp, 1+rand() % DS_LINEAR_PROBLEM_DENSE_MAXIMUM_ROWS,
+                              1+rand() % DS_LINEAR_PROBLEM_DENSE_MAXIMUM_COLUMNS, (k % 2 == 0));
+                failed += compareWithGLPK("Feasible problem", &lp, ((k % 2 == 0) ? DS_LINEAR_PROBLEM_OPTIMAL : DS_LINEAR_PROBLEM_UNSOLVED));
+                freeProblem(&lp);
+        }
+        /** Equalities as a pair of rows, as in the steady-state and vertex problems of cases **/
+        for (k = 0; k < 200; k++) {
+                randomProblem(&lp, 2+rand() % 30, 2+rand() % 20, true);
+                lp.isEquality[0] = true;
+                lp.isEquality[rand() % lp.rows] = true;
+                failed += compareWithGLPK("Problem with equalities", &lp, DS_LINEAR_PROBLEM_UNSOLVED);
+                freeProblem(&lp);
+        }
+        return failed;
+}
+
+static int testInfeasibleProblems(void)
+{
+        int k, j, failed = 0;
+        lp_test_t lp;
+        for (k = 0; k < 200; k++) {
+                randomProblem(&lp, 2+rand() % 40, 1+rand() % 20, (k % 2 == 0));
+                /** The first two rows are a*x <= -1 and -a*x <= 0 **/
+                for (j = 0; j < lp.columns; j++) {
+                        lp.A[j] = randomValue();
+                        lp.A[lp.columns+j] = -lp.A[j];
+                }
+                lp.A[0] = 1.;
+                lp.A[lp.columns] = -1.;
+                lp.b[0] = -1.;
+                lp.b[1] = 0.;
+                failed += compareWithGLPK("Infeasible problem", &lp, DS_LINEAR_PROBLEM_INFEASIBLE);
+                freeProblem(&lp);
+        }
+        return failed;
+}
+
+static int testUnboundedProblems(void)
+{
+        int i, k, failed = 0;
+        lp_test_t lp;
+        for (k = 0; k < 200; k++) {
+                randomProblem(&lp, 1+rand() % 40, 1+rand() % 20, true);
+                /** x0 can increase without bounds, improving the objective **/
+                lp.lower[0] = -INFINITY;
+                lp.upper[0] = INFINITY;
+                for (i = 0; i < lp.rows; i++)
+                        lp.A[i*lp.columns] = -fabs(lp.A[i*lp.columns]);
+                lp.c[0] = (lp.maximize ? 1. : -1.)*(0.5+fabs(lp.c[0]));
+                failed += compareWithGLPK("Unbounded problem", &lp, DS_LINEAR_PROBLEM_UNBOUNDED);
+                freeProblem(&lp);
+        }
+        return failed;
+}
+
+static int testDegenerateProblems(void)
+{
+        int i, j, k, failed = 0;
+        lp_test_t lp;
+        /** Beale's example, which cycles with the largest coefficient rule **/
+        static const double bealeA[] = {0.25, -60., -0.04, 9., 0.5, -90., -0.02, 3., 0., 0., 1., 0.};
+        static const double bealeB[] = {0., 0., 1.};
+        static const double bealeC[] = {-0.75, 150., -0.02, 6.};
+        /** Example of Chvatal, which cycles with the largest coefficient rule **/
+        static const double chvatalA[] = {0.5, -5.5, -2.5, 9., 0.5, -1.5, -0.5, 1., 1., 0., 0., 0.};
+        static const double chvatalB[] = {0., 0., 1.};
+        static const double chvatalC[] = {10., -57., -9., -24.};
+        allocProblem(&lp, 3, 4);
+        memcpy(lp.A, bealeA, sizeof(bealeA));
+        memcpy(lp.b, bealeB, sizeof(bealeB));
+        memcpy(lp.c, bealeC, sizeof(bealeC));
+        for (j = 0; j < 4; j++)
+                lp.lower[j] = 0.;
+        failed += compareWithGLPK("Beale's example", &lp, DS_LINEAR_PROBLEM_OPTIMAL);
+        memcpy(lp.A, chvatalA, sizeof(chvatalA));
+        memcpy(lp.b, chvatalB, sizeof(chvatalB));
+        memcpy(lp.c, chvatalC, sizeof(chvatalC));
+        lp.maximize = true;
+        failed += compareWithGLPK("Chvatal's example", &lp, DS_LINEAR_PROBLEM_OPTIMAL);
+        freeProblem(&lp);
+        /** Many constraints active at the origin **/
+        for (k = 0; k < 200; k++) {
+                randomProblem(&lp, 5+rand() % 50, 2+rand() % 10, true);
+                for (j = 0; j < lp.columns; j++) {
+                        lp.lower[j] = -1.;
+                        lp.upper[j] = 1.;
+                }
+                for (i = 0; i < lp.rows; i++) {
+                        lp.b[i] = 0.;
+                        if (i % 3 == 0) {
+                                for (j = 0; j < lp.columns; j++)
+                                        lp.A[i*lp.columns+j] = lp.A[(i/3)*lp.columns+j];
+                        }
+                }
+                failed += compareWithGLPK("Degenerate problem", &lp, DS_LINEAR_PROBLEM_OPTIMAL);
+                freeProblem(&lp);
+        }
+        return failed;
+}
+
+static int testLargeProblems(void)
+{
+        int k, failed = 0;
+        lp_test_t lp;
+        for (k = 0; k < 20; k++) {
+                randomProblem(&lp, DS_LINEAR_PROBLEM_DENSE_MAXIMUM_ROWS+1+rand() % 40,
+                              1+rand() % DS_LINEAR_PROBLEM_DENSE_MAXIMUM_COLUMNS, true);
+                failed += compareWithGLPK("Problem with many rows", &lp, DS_LINEAR_PROBLEM_OPTIMAL);
+                freeProblem(&lp);
+                randomProblem(&lp, 1+rand() % DS_LINEAR_PROBLEM_DENSE_MAXIMUM_ROWS,
+                              DS_LINEAR_PROBLEM_DENSE_MAXIMUM_COLUMNS+1+rand() % 20, true);
+                failed += compareWithGLPK("Problem with many columns", &lp, DS_LINEAR_PROBLEM_OPTIMAL);
+                freeProblem(&lp);
+        }
+        return failed;
+}
+
+int main(int argc, const char ** argv) {
+        int failed = 0, count;
+        glp_term_out(GLP_OFF);
+        srand(5);
+        failed += (count = testFeasibleProblems());
+        if (count == 0)
+                printf("Feasible problems passed!\n");
+        failed += (count = testInfeasibleProblems());
+        if (count == 0)
+                printf("Infeasible problems passed!\n");
+        failed += (count = testUnboundedProblems());
+        if (count == 0)
+                printf("Unbounded problems passed!\n");
+        failed += (count = testDegenerateProblems());
+        if (count == 0)
+                printf("Degenerate problems passed!\n");
+        failed += (count = testLargeProblems());
+        if (count == 0)
+                printf("Problems solved by GLPK passed!\n");
+        if (failed > 0)
+                printf("%i comparisons failed\n", failed);
+        return (failed > 0);
+}
@@ -0,0 +1,283 @@
+//
+//  polytopetest.c
+//
+//
+//  Compares the vertices, connectivity and faces of 3D slices calculated
+//  with DSPolytopeFromHalfSpaces with those calculated with linear
+//  programming, and tests polytopes with degenerate sets of half-spaces.
+//
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <designspace/DSStd.h>
+
+#define TOLERANCE       1E-6
+
+static bool verticesAreEqual(const double * vertex1, const double * vertex2)
+{
+        DSUInteger k;
+        for (k = 0; k < 3; k++) {
+                if (fabs(vertex1[k]-vertex2[k]) >= TOLERANCE)
+                        return false;
+        }
+        return true;
+}
+
+/**
+ * \return The index of the vertex of a matrix with one vertex per row at the
+ *         given coordinates, or the number of rows if there is none.
+ */
+static DSUInteger indexOfVertex(const DSMatrix * vertices, const double * vertex)
+{
+        DSUInteger i, k;
+        double other[3];
+        for (i = 0; i < DSMatrixRows(vertices); i++) {
+                for (k = 0; k < 3; k++)
+                        other[k] = DSMatrixDoubleValue(vertices, i, k);
+                if (verticesAreEqual(vertex, other) == true)
+                        break;
+        }
+        return i;
+}
+
+/**
+ * \return A boolean value indicating if every vertex of a matrix with one
+ *         vertex per row is also a vertex of the other matrix.
+ */
+static bool verticesAreInMatrix(const DSMatrix * vertices, const DSMatrix * other)
+{
+        DSUInteger i, k;
+        double vertex[3];
+        for (i = 0; i < DSMatrixRows(vertices); i++) {
+                for (k = 0; k < 3; k++)
+                        vertex[k] = DSMatrixDoubleValue(vertices, i, k);
+                if (indexOfVertex(other, vertex) == DSMatrixRows(other))
+                        return false;
+        }
+        return true;
+}
+
+/**
+ * Compares two sets of vertices and the edges joining them, ignoring the
+ * order of the vertices.
+ */
+static int compareVerticesAndConnectivity(const char * name, const DSMatrixArray * polytope, const DSMatrixArray * expected)
+{
+        int failed = 0;
+        DSUInteger i, j, k, mapped[2];
+        DSMatrix * vertices, * expectedVertices;
+        double vertex[3];
+        vertices = DSMatrixArrayMatrix(polytope, 0);
+        expectedVertices = DSMatrixArrayMatrix(expected, 0);
+        if (DSMatrixRows(vertices) != DSMatrixRows(expectedVertices)
+            || verticesAreInMatrix(vertices, expectedVertices) == false
+            || verticesAreInMatrix(expectedVertices, vertices) == false) {
+                printf("%s: vertices differ\n", name);
+                return 1;
+        }
+        for (i = 0; i < DSMatrixRows(vertices); i++) {
+                for (j = i+1; j < DSMatrixRows(vertices); j++) {
+                        for (k = 0; k < 3; k++)
+                                vertex[k] = DSMatrixDoubleValue(vertices, i, k);
+                        mapped[0] = indexOfVertex(expectedVertices, vertex);
+                        for (k = 0; k < 3; k++)
+                                vertex[k] = DSMatrixDoubleValue(vertices, j, k);
+                        mapped[1] = indexOfVertex(expectedVertices, vertex);
+                        if (DSMatrixDoubleValue(DSMatrixArrayMatrix(polytope, 1), i, j) != DSMatrixDoubleValue(DSMatrixArrayMatrix(expected, 1), mapped[0], mapped[1])) {
+                                printf("%s: connectivity of vertices %u and %u differs\n", name, i, j);
+                                failed++;
+                        }
+                }
+        }
+        return failed;
+}
+
+/**
+ * Compares two sets of faces, each face being compared as the set of its
+ * vertices.
+ */
+static int compareFaces(const char * name, const DSMatrixArray * faces, const DSMatrixArray * expected)
+{
+        int failed = 0;
+        DSUInteger i, j;
+        DSMatrix * face, * other;
+        for (i = 0; i < DSMatrixArrayNumberOfMatrices(faces); i++) {
+                face = DSMatrixArrayMatrix(faces, i);
+                for (j = 0; j < DSMatrixArrayNumberOfMatrices(expected); j++) {
+                        other = DSMatrixArrayMatrix(expected, j);
+                        if (verticesAreInMatrix(face, other) == true && verticesAreInMatrix(other, face) == true)
+                                break;
+                }
+                if (j == DSMatrixArrayNumberOfMatrices(expected)) {
+                        printf("%s: face %u is not expected\n", name, i);
+                        failed++;
+                }
+        }
+        if (DSMatrixArrayNumberOfMatrices(faces) != DSMatrixArrayNumberOfMatrices(expected)) {
+                printf("%s: %u faces, expected %u\n", name, DSMatrixArrayNumberOfMatrices(faces), DSMatrixArrayNumberOfMatrices(expected));
+                failed++;
+        }
+        return failed;
+}
+
+/**
+ * Substitutes the value of an independent variable in the boundaries of a
+ * case, so that the slice of the case is the same when the variable is not
+ * fixed.
+ */
+static void substituteVariable(DSCase * aCase, const char * name, const double value)
+{
+        DSUInteger i, index;
+        double constant;
+        index = DSVariablePoolIndexOfVariableWithName(DSCaseXi(aCase), name);
+        for (i = 0; i < DSMatrixRows(DSCaseU(aCase)); i++) {
+                constant = DSMatrixDoubleValue(DSCaseZeta(aCase), i, 0);
+                constant += DSMatrixDoubleValue(DSCaseU(aCase), i, index)*log10(value);
+                DSMatrixSetDoubleValue(DSCaseZeta(aCase), i, 0, constant);
+                DSMatrixSetDoubleValue(DSCaseU(aCase), i, index, 0.0);
+        }
+}
+
+/**
+ * The slice of a case with d fixed is calculated with
+ * DSPolytopeFromHalfSpaces.  The same slice of a case where d has been
+ * substituted, with d left out of the bounds, is calculated with linear
+ * programming.
+ */
+static int testCaseSlices(DSDesignSpace * ds)
+{
+        DSUInteger caseNumber, numberOfSlices = 0;
+        int failed = 0;
+        char name[100];
+        DSCase * aCase, * reference;
+        DSVariablePool * lower, * upper, * freeLower, * freeUpper;
+        DSMatrixArray * polytope, * expected, * faces, * expectedFaces;
+        lower = DSVariablePoolByParsingString("a : 1E-3, b : 1E-3, c : 1E-3, d : 10");
+        upper = DSVariablePoolByParsingString("a : 1E3, b : 1E3, c : 1E3, d : 10");
+        freeLower = DSVariablePoolByParsingString("a : 1E-3, b : 1E-3, c : 1E-3");
+        freeUpper = DSVariablePoolByParsingString("a : 1E3, b : 1E3, c : 1E3");
+        for (caseNumber = 1; caseNumber <= DSDesignSpaceNumberOfCases(ds); caseNumber++) {
+                aCase = DSDesignSpaceCaseWithCaseNumber(ds, caseNumber);
+                if (DSCaseIsValidAtSlice(aCase, lower, upper, true) == false) {
+                        DSCaseFree(aCase);
+                        continue;
+                }
+                sprintf(name, "Case %u", caseNumber);
+                reference = DSDesignSpaceCaseWithCaseNumber(ds, caseNumber);
+                substituteVariable(reference, "d", 10);
+                polytope = DSCaseVerticesFor3DSliceAndConnectivity(aCase, lower, upper, "a", "b", "c");
+                expected = DSCaseVerticesFor3DSliceAndConnectivity(reference, freeLower, freeUpper, "a", "b", "c");
+                faces = DSCaseFacesFor3DSliceAndConnectivity(aCase, lower, upper, "a", "b", "c");
+                expectedFaces = DSCaseFacesFor3DSliceAndConnectivity(reference, freeLower, freeUpper, "a", "b", "c");
+                if (polytope == NULL || expected == NULL || faces == NULL || expectedFaces == NULL) {
+                        printf("%s: slice was not calculated\n", name);
+                        failed++;
+                } else {
+                        failed += compareVerticesAndConnectivity(name, polytope, expected);
+                        failed += compareFaces(name, faces, expectedFaces);
+                        numberOfSlices++;
+                }
+                if (polytope != NULL)
+                        DSMatrixArrayFree(polytope);
+                if (expected != NULL)
+                        DSMatrixArrayFree(expected);
+                if (faces != NULL)
+                        DSMatrixArrayFree(faces);
+                if (expectedFaces != NULL)
+                        DSMatrixArrayFree(expectedFaces);
+                DSCaseFree(reference);
+                DSCaseFree(aCase);
+        }
+        if (numberOfSlices == 0) {
+                printf("No case is valid in the slice\n");
+                failed++;
+        }
+        DSVariablePoolFree(lower);
+        DSVariablePoolFree(upper);
+        DSVariablePoolFree(freeLower);
+        DSVariablePoolFree(freeUpper);
+        return failed;
+}
+
+static int testHalfSpaces(const char * name, const double (*halfSpaces)[4], const DSUInteger numberOfHalfSpaces, const DSUInteger numberOfVertices, const DSUInteger numberOfEdges, const DSUInteger numberOfFaces)
+{
+        int failed = 0;
+        DSUInteger i, j, edges = 0;
+        double lower[3] = {0., 0., 0.}, upper[3] = {1., 1., 1.};
+        DSMatrix * coefficients, * constants, * connectivity;
+        DSMatrixArray * faces;
+        DSPolytope * polytope;
+        coefficients = DSMatrixAlloc(numberOfHalfSpaces, 3);
+        constants = DSMatrixAlloc(numberOfHalfSpaces, 1);
+        for (i = 0; i < numberOfHalfSpaces; i++) {
+                for (j = 0; j < 3; j++)
+                        DSMatrixSetDoubleValue(coefficients, i, j, halfSpaces[i][j]);
+                DSMatrixSetDoubleValue(constants, i, 0, halfSpaces[i][3]);
+        }
+        polytope = DSPolytopeFromHalfSpaces(coefficients, constants, lower, upper);
+        connectivity = DSPolytopeConnectivityMatrix(polytope);
+        faces = DSPolytope3DFaces(polytope);
+        for (i = 0; connectivity != NULL && i < DSMatrixRows(connectivity); i++) {
+                for (j = i+1; j < DSMatrixColumns(connectivity); j++)
+                        edges += (DSMatrixDoubleValue(connectivity, i, j) != 0);
+        }
+        if (DSPolytopeNumberOfVertices(polytope) != numberOfVertices) {
+                printf("%s: %u vertices, expected %u\n", name, DSPolytopeNumberOfVertices(polytope), numberOfVertices);
+                failed++;
+        }
+        if (edges != numberOfEdges) {
+                printf("%s: %u edges, expected %u\n", name, edges, numberOfEdges);
+                failed++;
+        }
+        if (DSMatrixArrayNumberOfMatrices(faces) != numberOfFaces) {
+                printf("%s: %u faces, expected %u\n", name, DSMatrixArrayNumberOfMatrices(faces), numberOfFaces);
+                failed++;
+        }
+        if (connectivity != NULL)
+                DSMatrixFree(connectivity);
+        DSMatrixArrayFree(faces);
+        DSPolytopeFree(polytope);
+        DSMatrixFree(coefficients);
+        DSMatrixFree(constants);
+        return failed;
+}
+
+/**
+ * Half-spaces a*x + c >= 0 cutting the unit cube.
+ */
+static int testDegenerateHalfSpaces(void)
+{
+        int failed = 0;
+        /** x + y + z >= 4 does not intersect the cube **/
+        const double empty[1][4] = {{1., 1., 1., -4.}};
+        /** x <= 0.5 twice, and x >= 0 on a face of the cube **/
+        const double parallel[3][4] = {{-1., 0., 0., 0.5}, {-1., 0., 0., 0.5}, {1., 0., 0., 0.}};
+        /** x + y + z <= 1 crosses the cube at three of its corners **/
+        const double diagonal[1][4] = {{-1., -1., -1., 1.}};
+        failed += testHalfSpaces("Empty slice", empty, 1, 0, 0, 0);
+        failed += testHalfSpaces("Parallel boundaries", parallel, 3, 8, 12, 6);
+        failed += testHalfSpaces("Vertices on the box", diagonal, 1, 4, 6, 4);
+        return failed;
+}
+
+int main(int argc, const char ** argv) {
+        int failed = 0, count;
+        char * strings[2] = {NULL};
+        DSDesignSpace * ds;
+        /** The test model, with a rate constant for the degradation of x2 **/
+        strings[0] = strdup("x1. = a + b*x1*x2 - c*x1");
+        strings[1] = strdup("x2. = c*x1 - d*x2");
+        ds = DSDesignSpaceByParsingStrings(strings, NULL, 2);
+        failed += (count = testCaseSlices(ds));
+        if (count == 0)
+                printf("3D slice polytopes passed!\n");
+        failed += (count = testDegenerateHalfSpaces());
+        if (count == 0)
+                printf("DSPolytopeFromHalfSpaces passed!\n");
+        DSDesignSpaceFree(ds);
+        free(strings[0]);
+        free(strings[1]);
+        if (failed > 0)
+                printf("%i comparisons failed\n", failed);
+        return (failed > 0);
+}
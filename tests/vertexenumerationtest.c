@@ -0,0 +1,204 @@
+//
+//  vertexenumerationtest.c
+//
+//
+//  Compares the vertices of the polytope of a case enumerated with
+//  fixed-width integer arithmetic, serially and over the thread pool, with
+//  the vertices enumerated by lrs.
+//
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <designspace/DSStd.h>
+
+#define NUMBER_OF_DIMENSIONS    3
+
+/**
+ * A tetrahedron-like cut of the box [-3, 3]^3, with rational coefficients.
+ */
+#define NUMBER_OF_SMALL_CONDITIONS      4
+
+static const double smallDirections[NUMBER_OF_SMALL_CONDITIONS][NUMBER_OF_DIMENSIONS] = {
+        {-1., -1., -1.},
+        {1., -0.5, 0.},
+        {0.25, 1., -1.},
+        {0., 0., 1.}
+};
+
+static const double smallConstants[NUMBER_OF_SMALL_CONDITIONS] = {2., 1.5, 2., 2.5};
+
+/**
+ * The first conditions are planes near a1 = 2.5 with large coprime
+ * coefficients, so that the homogeneous coordinates of the vertices created by
+ * the first cut overflow 128 bits when cut by the second condition.  The last
+ * condition, a1 <= 1, removes the vertices created by these planes, leaving a
+ * box with integer vertices.
+ */
+#define NUMBER_OF_LARGE_CONDITIONS      4
+
+static const double largeDirections[NUMBER_OF_LARGE_CONDITIONS][NUMBER_OF_DIMENSIONS] = {
+        {-1000000000000037., 50000000000021., 30000000000007.},
+        {-999999999999989., -40000000000003., 60000000000011.},
+        {-1000000000000091., 20000000000023., -70000000000001.},
+        {-1., 0., 0.}
+};
+
+static const double largeConstants[NUMBER_OF_LARGE_CONDITIONS] = {
+        2500000000000093.,
+        2399999999999977.,
+        2600000000000231.,
+        1.
+};
+
+static const double largeVertices[8][NUMBER_OF_DIMENSIONS] = {
+        {-3., -3., -3.},
+        {1., -3., -3.},
+        {-3., 3., -3.},
+        {1., 3., -3.},
+        {-3., -3., 3.},
+        {1., -3., 3.},
+        {-3., 3., 3.},
+        {1., 3., 3.}
+};
+
+static void setCaseConditions(DSCase * aCase, const double (*directions)[NUMBER_OF_DIMENSIONS], const double * constants, const DSUInteger numberOfConditions)
+{
+        DSUInteger i, j;
+        DSMatrix *U, *zeta;
+        U = DSMatrixCalloc(numberOfConditions, NUMBER_OF_DIMENSIONS);
+        zeta = DSMatrixCalloc(numberOfConditions, 1);
+        for (i = 0; i < numberOfConditions; i++) {
+                for (j = 0; j < NUMBER_OF_DIMENSIONS; j++)
+                        DSMatrixSetDoubleValue(U, i, j, directions[i][j]);
+                DSMatrixSetDoubleValue(zeta, i, 0, constants[i]);
+        }
+        DSMatrixFree(DSCaseU(aCase));
+        DSMatrixFree(DSCaseZeta(aCase));
+        DSCaseU(aCase) = U;
+        DSCaseZeta(aCase) = zeta;
+}
+
+static bool vertexIsInMatrix(const DSMatrix * vertices, const DSUInteger row, const DSMatrix * other)
+{
+        DSUInteger i, j;
+        for (i = 0; i < DSMatrixRows(other); i++) {
+                for (j = 0; j < DSMatrixColumns(other); j++) {
+                        if (fabs(DSMatrixDoubleValue(vertices, row, j)-DSMatrixDoubleValue(other, i, j)) > 1E-4)
+                                break;
+                }
+                if (j == DSMatrixColumns(other))
+                        return true;
+        }
+        return false;
+}
+
+/**
+ * Compares two sets of vertices, ignoring their order and repeated vertices.
+ */
+static int compareVertices(const char * name, const DSMatrix * vertices, const DSMatrix * expected)
+{
+        DSUInteger i;
+        int failed = 0;
+        if (DSMatrixRows(vertices) == 0 || DSMatrixRows(expected) == 0) {
+                printf("%s: no vertices enumerated\n", name);
+                return 1;
+        }
+        for (i = 0; i < DSMatrixRows(vertices); i++) {
+                if (vertexIsInMatrix(vertices, i, expected) == false) {
+                        printf("%s: vertex %u is not expected\n", name, i);
+                        failed++;
+                }
+        }
+        for (i = 0; i < DSMatrixRows(expected); i++) {
+                if (vertexIsInMatrix(expected, i, vertices) == false) {
+                        printf("%s: expected vertex %u is missing\n", name, i);
+                        failed++;
+                }
+        }
+        return failed;
+}
+
+static DSMatrixArray * vertexEnumerationWithOptions(const DSCase * aCase, const DSVariablePool * lower, const DSVariablePool * upper, const unsigned char options)
+{
+        DSMatrixArray * enumeration;
+        unsigned char defaultOptions = DSNVertexEnumerationOptions();
+        DSNVertexEnumerationSetOptions(options);
+        enumeration = DSCaseNDVertexEnumeration(aCase, lower, upper);
+        DSNVertexEnumerationSetOptions(defaultOptions);
+        return enumeration;
+}
+
+/**
+ * Enumerates the vertices with the fixed-width arithmetic, in parallel and
+ * serially, and with lrs only, and compares them with each other and with the
+ * expected vertices when given.
+ */
+static int testVertexEnumeration(const char * name, DSCase * aCase, const DSVariablePool * lower, const DSVariablePool * upper, const DSMatrix * expected)
+{
+        int failed = 0;
+        DSMatrixArray *parallel, *serial, *lrs;
+        parallel = vertexEnumerationWithOptions(aCase, lower, upper, DS_VERTEX_ENUMERATION_FIXED_WIDTH | DS_VERTEX_ENUMERATION_PARALLEL);
+        serial = vertexEnumerationWithOptions(aCase, lower, upper, DS_VERTEX_ENUMERATION_FIXED_WIDTH);
+        lrs = vertexEnumerationWithOptions(aCase, lower, upper, 0);
+        if (parallel == NULL || serial == NULL || lrs == NULL) {
+                printf("%s: vertex enumeration failed\n", name);
+                failed++;
+                goto bail;
+        }
+        failed += compareVertices(name, DSMatrixArrayMatrix(parallel, 0), DSMatrixArrayMatrix(lrs, 0));
+        failed += compareVertices(name, DSMatrixArrayMatrix(serial, 0), DSMatrixArrayMatrix(lrs, 0));
+        if (expected != NULL)
+                failed += compareVertices(name, DSMatrixArrayMatrix(lrs, 0), expected);
+bail:
+        if (parallel != NULL)
+                DSMatrixArrayFree(parallel);
+        if (serial != NULL)
+                DSMatrixArrayFree(serial);
+        if (lrs != NULL)
+                DSMatrixArrayFree(lrs);
+        return failed;
+}
+
+int main(int argc, const char ** argv) {
+        int failed = 0, count;
+        DSUInteger i, j;
+        char * strings[2] = {NULL};
+        DSDesignSpace * ds;
+        DSCase * aCase;
+        DSVariablePool *lower, *upper;
+        DSMatrix * expected;
+        strings[0] = strdup("x1. = a + b*x1*x2 - c*x1");
+        strings[1] = strdup("x2. = c*x1 - x2");
+        ds = DSDesignSpaceByParsingStrings(strings, NULL, 2);
+        aCase = DSDesignSpaceCaseWithCaseNumber(ds, 1);
+        /** The bounds are powers of ten, the box [-3, 3]^3 in logarithmic coordinates **/
+        lower = DSVariablePoolCopy(DSCaseXi(aCase));
+        upper = DSVariablePoolCopy(DSCaseXi(aCase));
+        for (i = 0; i < NUMBER_OF_DIMENSIONS; i++) {
+                DSVariablePoolSetValueForVariableWithName(lower, DSVariableName(DSVariablePoolVariableAtIndex(lower, i)), 1E-3);
+                DSVariablePoolSetValueForVariableWithName(upper, DSVariableName(DSVariablePoolVariableAtIndex(upper, i)), 1E3);
+        }
+        setCaseConditions(aCase, smallDirections, smallConstants, NUMBER_OF_SMALL_CONDITIONS);
+        failed += (count = testVertexEnumeration("Fixed-width vertices", aCase, lower, upper, NULL));
+        if (count == 0)
+                printf("Fixed-width vertex enumeration passed!\n");
+        setCaseConditions(aCase, largeDirections, largeConstants, NUMBER_OF_LARGE_CONDITIONS);
+        expected = DSMatrixAlloc(8, NUMBER_OF_DIMENSIONS);
+        for (i = 0; i < 8; i++) {
+                for (j = 0; j < NUMBER_OF_DIMENSIONS; j++)
+                        DSMatrixSetDoubleValue(expected, i, j, largeVertices[i][j]);
+        }
+        failed += (count = testVertexEnumeration("Overflowing vertices", aCase, lower, upper, expected));
+        if (count == 0)
+                printf("Vertex enumeration after overflow passed!\n");
+        DSMatrixFree(expected);
+        DSVariablePoolFree(lower);
+        DSVariablePoolFree(upper);
+        DSCaseFree(aCase);
+        DSDesignSpaceFree(ds);
+        free(strings[0]);
+        free(strings[1]);
+        if (failed > 0)
+                printf("%i comparisons failed\n", failed);
+        return (failed > 0);
+}